@@ -0,0 +1,35 @@
+/** Copyright (c) 2014-present, Facebook, Inc. */
+
+// Timing helpers shared by the layout core benchmarks. Trees and measure functions come from
+// the test helpers so both exercise the same inputs.
+
+#ifndef YG_BENCHMARK_H
+#define YG_BENCHMARK_H
+
+#include "YGTestUtils.h"
+
+#include <time.h>
+
+static inline double YGBenchmarkNow(void) {
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return now.tv_sec * 1e3 + now.tv_nsec / 1e6;
+}
+
+// Milliseconds per run of the statements given last, the best of rounds rounds of iterations runs each.
+#define YG_BENCHMARK(result, rounds, iterations, ...)                                 \
+  do {                                                                                \
+    (result) = INFINITY;                                                              \
+    for (int round_ = 0; round_ < (rounds); round_++) {                               \
+      const double start_ = YGBenchmarkNow();                                         \
+      for (int iteration_ = 0; iteration_ < (iterations); iteration_++) {             \
+        __VA_ARGS__;                                                                  \
+      }                                                                               \
+      const double elapsed_ = (YGBenchmarkNow() - start_) / (iterations);             \
+      if (elapsed_ < (result)) {                                                      \
+        (result) = elapsed_;                                                          \
+      }                                                                               \
+    }                                                                                 \
+  } while (0)
+
+#endif
@@ -0,0 +1,112 @@
+/** Copyright (c) 2014-present, Facebook, Inc. */
+
+// Lays out a list of rows of text leaves with a synthetic text measurer that, like a platform
+// text engine, pays a fixed cost per call on top of the work per string, once through the leaves'
+// measure functions and once through a batch measure function on each row.
+
+#include "YGBenchmark.h"
+
+#define ROW_COUNT 500
+#define LEAVES_PER_ROW 4
+
+static int gMeasureCalls = 0;
+
+static void spin(const int iterations) {
+  volatile float sink = 0;
+  for (int i = 0; i < iterations; i++) {
+    sink += sinf(i * 0.1f);
+  }
+}
+
+static YGSize measureString(const YGNodeRef node,
+                            const float width,
+                            const YGMeasureMode widthMode) {
+  const int context = (int) (long) YGNodeGetContext(node);
+  spin(40);
+  const float naturalWidth = 20 + (context % 11) * 17;
+  const float lineHeight = 14;
+  if (widthMode != YGMeasureModeUndefined && naturalWidth > width) {
+    return (YGSize){.width = width, .height = lineHeight * ceilf(naturalWidth / width)};
+  }
+  return (YGSize){.width = naturalWidth, .height = lineHeight};
+}
+
+static YGSize measureLeaf(YGNodeRef node,
+                          float width,
+                          YGMeasureMode widthMode,
+                          float height,
+                          YGMeasureMode heightMode) {
+  (void) height;
+  (void) heightMode;
+  gMeasureCalls++;
+  spin(400);
+  return measureString(node, width, widthMode);
+}
+
+static void measureBatch(YGNodeRef node,
+                         const YGMeasureRequest *requests,
+                         YGSize *sizes,
+                         const uint32_t count) {
+  (void) node;
+  gMeasureCalls++;
+  spin(400);
+  for (uint32_t i = 0; i < count; i++) {
+    sizes[i] = measureString(requests[i].node, requests[i].width, requests[i].widthMode);
+  }
+}
+
+static YGNodeRef buildList(const bool batched) {
+  const YGNodeRef root = YGNodeNew();
+  for (uint32_t i = 0; i < ROW_COUNT; i++) {
+    const YGNodeRef row = YGNodeNew();
+    YGNodeStyleSetFlexDirection(row, YGFlexDirectionRow);
+    YGNodeStyleSetPadding(row, YGEdgeAll, 8);
+    if (batched) {
+      YGNodeSetBatchMeasureFunc(row, measureBatch);
+    }
+    for (uint32_t j = 0; j < LEAVES_PER_ROW; j++) {
+      const YGNodeRef text = YGNodeNew();
+      YGNodeSetContext(text, (void *) (long) (i * LEAVES_PER_ROW + j + 1));
+      YGNodeSetMeasureFunc(text, measureLeaf);
+      YGNodeStyleSetFlexShrink(text, 1);
+      YGNodeInsertChild(row, text, j);
+    }
+    YGNodeInsertChild(root, row, i);
+  }
+  return root;
+}
+
+static void markTextDirty(const YGNodeRef root) {
+  for (uint32_t i = 0; i < YGNodeGetChildCount(root); i++) {
+    const YGNodeRef row = YGNodeGetChild(root, i);
+    for (uint32_t j = 0; j < YGNodeGetChildCount(row); j++) {
+      YGNodeMarkDirty(YGNodeGetChild(row, j));
+    }
+  }
+}
+
+// Milliseconds per layout of the list with every text changed, and measure calls per layout.
+static double benchmarkList(const bool batched, int *const calls) {
+  const YGNodeRef root = buildList(batched);
+  YGNodeCalculateLayout(root, 375, YGUndefined, YGDirectionLTR);
+  double elapsed;
+  YG_BENCHMARK(elapsed, 5, 10, {
+    markTextDirty(root);
+    gMeasureCalls = 0;
+    YGNodeCalculateLayout(root, 375, YGUndefined, YGDirectionLTR);
+  });
+  *calls = gMeasureCalls;
+  YGNodeFreeRecursive(root);
+  return elapsed;
+}
+
+int main(void) {
+  int leafCalls;
+  int batchCalls;
+  const double leaf = benchmarkList(false, &leafCalls);
+  const double batch = benchmarkList(true, &batchCalls);
+  printf("%d rows of %d text leaves: measure functions %.2f ms (%d calls), "
+         "batch measure functions %.2f ms (%d calls)\n",
+         ROW_COUNT, LEAVES_PER_ROW, leaf, leafCalls, batch, batchCalls);
+  return 0;
+}
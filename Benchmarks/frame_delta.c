@@ -0,0 +1,80 @@
+/** Copyright (c) 2014-present, Facebook, Inc. */
+
+// Mirrors the frames of a 50k-node tree of rows of fixed height through frame deltas: the first
+// frame, 200 frames that each change the text of one leaf, moving the leaves after it in its row,
+// and a resize. Reports the bytes per frame against a full export, and the time to emit and to
+// apply them.
+
+#include "YGBenchmark.h"
+
+#define ROW_COUNT 5000
+#define NODE_CAPACITY 65536
+#define FRAME_COUNT 200
+
+static YGFrameRecord gMirror[NODE_CAPACITY];
+
+static YGNodeRef buildTree(void) {
+  const YGNodeRef root = YGNodeNew();
+  for (uint32_t i = 0; i < ROW_COUNT; i++) {
+    const YGNodeRef row = YGNodeNew();
+    YGNodeStyleSetFlexDirection(row, YGFlexDirectionRow);
+    YGNodeStyleSetHeight(row, 30);
+    for (uint32_t j = 0; j < 9; j++) {
+      const YGNodeRef leaf = YGNodeNew();
+      YGNodeSetContext(leaf, (void *) (long) (i * 9 + j + 1));
+      YGNodeSetMeasureFunc(leaf, YGTestMeasure);
+      YGNodeInsertChild(row, leaf, j);
+    }
+    YGNodeInsertChild(root, row, i);
+  }
+  return root;
+}
+
+// Emits the delta of the last layout and applies it, adding the bytes and times.
+static void mirrorFrame(const YGNodeRef root, size_t *bytes, double *emitTime, double *applyTime) {
+  size_t length;
+  const double start = YGBenchmarkNow();
+  const uint8_t *const delta = YGNodeEmitFrameDelta(root, &length);
+  const double emitted = YGBenchmarkNow();
+  YGFrameDeltaApply(delta, length, gMirror, NODE_CAPACITY);
+  *applyTime += YGBenchmarkNow() - emitted;
+  *emitTime += emitted - start;
+  *bytes += length;
+}
+
+int main(void) {
+  const YGNodeRef root = buildTree();
+  YGNodeCalculateLayout(root, 375, YGUndefined, YGDirectionLTR);
+  const uint32_t count = YGTestNodeCount(root);
+  const double exportBytes = (double) sizeof(YGFrameRecord) * count;
+
+  size_t firstBytes = 0;
+  double firstEmit = 0, firstApply = 0;
+  mirrorFrame(root, &firstBytes, &firstEmit, &firstApply);
+
+  size_t leafBytes = 0;
+  double leafEmit = 0, leafApply = 0;
+  for (uint32_t i = 0; i < FRAME_COUNT; i++) {
+    const YGNodeRef row = YGNodeGetChild(root, (i * 7919) % ROW_COUNT);
+    const YGNodeRef leaf = YGNodeGetChild(row, i % 9);
+    YGNodeSetContext(leaf, (void *) ((long) YGNodeGetContext(leaf) + 1));
+    YGNodeMarkDirty(leaf);
+    YGNodeCalculateLayout(root, 375, YGUndefined, YGDirectionLTR);
+    mirrorFrame(root, &leafBytes, &leafEmit, &leafApply);
+  }
+
+  size_t resizeBytes = 0;
+  double resizeEmit = 0, resizeApply = 0;
+  YGNodeCalculateLayout(root, 667, YGUndefined, YGDirectionLTR);
+  mirrorFrame(root, &resizeBytes, &resizeEmit, &resizeApply);
+
+  printf("%u nodes, full export %.0f bytes\n", count, exportBytes);
+  printf("first frame: %zu bytes, emit %.2f ms, apply %.2f ms\n",
+         firstBytes, firstEmit, firstApply);
+  printf("one leaf changed, %d frames: %.1f bytes per frame, emit %.4f ms, apply %.4f ms\n",
+         FRAME_COUNT, (double) leafBytes / FRAME_COUNT, leafEmit / FRAME_COUNT,
+         leafApply / FRAME_COUNT);
+  printf("resize: %zu bytes, emit %.2f ms, apply %.2f ms\n", resizeBytes, resizeEmit, resizeApply);
+  YGNodeFreeRecursive(root);
+  return 0;
+}
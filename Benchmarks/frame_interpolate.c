@@ -0,0 +1,46 @@
+/** Copyright (c) 2014-present, Facebook, Inc. */
+
+// Interpolates 60 frames between two layouts of a 5k-node tree, as for an animated resize.
+
+#include "YGBenchmark.h"
+
+#define NODE_CAPACITY 8192
+#define FRAME_COUNT 60
+
+static YGFrameRecord gFrom[NODE_CAPACITY];
+static YGFrameRecord gTo[NODE_CAPACITY];
+static YGFrameRecord gFrames[NODE_CAPACITY * FRAME_COUNT];
+
+int main(void) {
+  const YGNodeRef root = YGNodeNew();
+  for (uint32_t i = 0; i < 500; i++) {
+    const YGNodeRef row = YGNodeNew();
+    YGNodeStyleSetFlexDirection(row, YGFlexDirectionRow);
+    for (uint32_t j = 0; j < 9; j++) {
+      const YGNodeRef leaf = YGNodeNew();
+      YGNodeSetContext(leaf, (void *) (long) (i * 9 + j + 1));
+      YGNodeSetMeasureFunc(leaf, YGTestMeasure);
+      YGNodeStyleSetFlexShrink(leaf, 1);
+      YGNodeInsertChild(row, leaf, j);
+    }
+    YGNodeInsertChild(root, row, i);
+  }
+
+  YGNodeCalculateLayout(root, 375, YGUndefined, YGDirectionLTR);
+  const uint32_t count = YGNodeExportFrames(root, gFrom, NODE_CAPACITY);
+  YGNodeCalculateLayout(root, 667, YGUndefined, YGDirectionLTR);
+  YG_TEST_CHECK(YGNodeExportFrames(root, gTo, NODE_CAPACITY) == count);
+
+  double linear;
+  double easeInOut;
+  YG_BENCHMARK(linear, 5, 20, YGFrameInterpolate(gFrom, gTo, count, YGEasingLinear, FRAME_COUNT,
+                                                 gFrames));
+  YG_BENCHMARK(easeInOut, 5, 20, YGFrameInterpolate(gFrom, gTo, count, YGEasingEaseInOut,
+                                                    FRAME_COUNT, gFrames));
+
+  const double megabytes = (double) sizeof(YGFrameRecord) * count * FRAME_COUNT / 1e6;
+  printf("%u nodes, %d frames (%.1f MB): linear %.2f ms, ease-in-out %.2f ms\n",
+         count, FRAME_COUNT, megabytes, linear, easeInOut);
+  YGNodeFreeRecursive(root);
+  return 0;
+}
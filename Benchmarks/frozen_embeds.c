@@ -0,0 +1,66 @@
+/** Copyright (c) 2014-present, Facebook, Inc. */
+
+// Resizes a feed of 200 prebuilt embeds of 121 nodes 300 times with pixel rounding on, with
+// the embeds live and frozen, at a fixed size and stretched to the width of the feed.
+
+#include "YGBenchmark.h"
+
+#define EMBED_COUNT 200
+#define RESIZE_COUNT 300
+
+static YGNodeRef buildEmbed(const int depth) {
+  const YGNodeRef node = YGNodeNew();
+  YGNodeStyleSetFlexDirection(node, depth % 2 ? YGFlexDirectionRow : YGFlexDirectionColumn);
+  YGNodeStyleSetPadding(node, YGEdgeAll, 2);
+  if (depth == 0) {
+    YGNodeSetContext(node, (void *) (long) (++gYGTestContext));
+    YGNodeSetMeasureFunc(node, YGTestMeasure);
+    return node;
+  }
+  for (uint32_t i = 0; i < 3; i++) {
+    YGNodeInsertChild(node, buildEmbed(depth - 1), i);
+  }
+  return node;
+}
+
+static double resizeFeed(const bool fixedSize, const bool frozen, int *const measureCalls) {
+  gYGTestContext = 0;
+  const YGNodeRef root = YGNodeNew();
+  for (uint32_t i = 0; i < EMBED_COUNT; i++) {
+    const YGNodeRef embed = buildEmbed(4);
+    if (fixedSize) {
+      YGNodeStyleSetWidth(embed, 320);
+      YGNodeStyleSetHeight(embed, 250);
+    }
+    YGNodeInsertChild(root, embed, i);
+  }
+  YGNodeCalculateLayout(root, 400, YGUndefined, YGDirectionLTR);
+  for (uint32_t i = 0; frozen && i < EMBED_COUNT; i++) {
+    YGNodeSetFrozen(YGNodeGetChild(root, i), true);
+  }
+  YGNodeCalculateLayout(root, 401, YGUndefined, YGDirectionLTR);
+
+  gYGTestMeasureCalls = 0;
+  const double start = YGBenchmarkNow();
+  for (uint32_t i = 0; i < RESIZE_COUNT; i++) {
+    YGNodeCalculateLayout(root, 360 + (i * 37) % 300 + 0.5f, YGUndefined, YGDirectionLTR);
+  }
+  const double elapsed = YGBenchmarkNow() - start;
+  *measureCalls = gYGTestMeasureCalls;
+  YGNodeFreeRecursive(root);
+  return elapsed;
+}
+
+int main(void) {
+  YGSetExperimentalFeatureEnabled(YGExperimentalFeatureRounding, true);
+  for (int fixedSize = 1; fixedSize >= 0; fixedSize--) {
+    int liveCalls;
+    int frozenCalls;
+    const double live = resizeFeed(fixedSize, false, &liveCalls);
+    const double frozen = resizeFeed(fixedSize, true, &frozenCalls);
+    printf("%s embeds, %d resizes: live %.1f ms (%d measures), frozen %.1f ms (%d measures)\n",
+           fixedSize ? "fixed-size" : "stretched", RESIZE_COUNT, live, liveCalls, frozen,
+           frozenCalls);
+  }
+  return 0;
+}
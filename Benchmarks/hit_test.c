@@ -0,0 +1,80 @@
+/** Copyright (c) 2014-present, Facebook, Inc. */
+
+// Hit tests on a wrapping grid of 50k nodes, by walking the whole tree and through
+// YGNodeHitTest. The first query builds the bounds and is reported apart.
+
+#include "YGBenchmark.h"
+
+#define CELL_COUNT 5000
+#define LEAVES_PER_CELL 9
+#define QUERY_COUNT 2000
+
+// Walks every node like YGNodeHitTest without its bounds: later siblings first, then the node.
+static YGNodeRef walkHitTest(const YGNodeRef node, const float x, const float y) {
+  for (uint32_t i = YGNodeGetChildCount(node); i > 0; i--) {
+    const YGNodeRef child = YGNodeGetChild(node, i - 1);
+    if (YGNodeStyleGetDisplay(child) == YGDisplayNone) {
+      continue;
+    }
+    const YGNodeRef hit =
+        walkHitTest(child, x - YGNodeLayoutGetLeft(child), y - YGNodeLayoutGetTop(child));
+    if (hit != NULL) {
+      return hit;
+    }
+  }
+  if (x >= 0 && x < YGNodeLayoutGetWidth(node) && y >= 0 && y < YGNodeLayoutGetHeight(node)) {
+    return node;
+  }
+  return NULL;
+}
+
+int main(void) {
+  const YGNodeRef root = YGNodeNew();
+  YGNodeStyleSetFlexDirection(root, YGFlexDirectionRow);
+  YGNodeStyleSetFlexWrap(root, YGWrapWrap);
+  for (uint32_t i = 0; i < CELL_COUNT; i++) {
+    const YGNodeRef cell = YGNodeNew();
+    YGNodeStyleSetWidth(cell, 40);
+    YGNodeStyleSetPadding(cell, YGEdgeAll, 2);
+    for (uint32_t j = 0; j < LEAVES_PER_CELL; j++) {
+      const YGNodeRef leaf = YGNodeNew();
+      YGNodeStyleSetHeight(leaf, 4);
+      YGNodeInsertChild(cell, leaf, j);
+    }
+    YGNodeInsertChild(root, cell, i);
+  }
+  YGNodeCalculateLayout(root, 1000, YGUndefined, YGDirectionLTR);
+  const float height = YGNodeLayoutGetHeight(root);
+
+  float xs[QUERY_COUNT];
+  float ys[QUERY_COUNT];
+  for (uint32_t i = 0; i < QUERY_COUNT; i++) {
+    xs[i] = YGTestRandom() % 1000 + 0.5f;
+    ys[i] = fmodf(YGTestRandom(), height) + 0.5f;
+  }
+
+  double start = YGBenchmarkNow();
+  for (uint32_t i = 0; i < QUERY_COUNT; i++) {
+    YG_TEST_CHECK(walkHitTest(root, xs[i], ys[i]) != NULL);
+  }
+  const double walk = (YGBenchmarkNow() - start) / QUERY_COUNT;
+
+  start = YGBenchmarkNow();
+  YGNodeHitTest(root, xs[0], ys[0]);
+  const double firstQuery = YGBenchmarkNow() - start;
+
+  YGNodeRef hits[QUERY_COUNT];
+  start = YGBenchmarkNow();
+  for (uint32_t i = 0; i < QUERY_COUNT; i++) {
+    hits[i] = YGNodeHitTest(root, xs[i], ys[i]);
+  }
+  const double hitTest = (YGBenchmarkNow() - start) / QUERY_COUNT;
+  for (uint32_t i = 0; i < QUERY_COUNT; i++) {
+    YG_TEST_CHECK(hits[i] == walkHitTest(root, xs[i], ys[i]));
+  }
+
+  printf("%u nodes: walk %.3f ms per hit test, YGNodeHitTest %.4f ms (first query %.2f ms)\n",
+         YGTestNodeCount(root), walk, hitTest, firstQuery);
+  YGNodeFreeRecursive(root);
+  return 0;
+}
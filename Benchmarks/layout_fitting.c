@@ -0,0 +1,78 @@
+/** Copyright (c) 2014-present, Facebook, Inc. */
+
+// Renders a content-sized root of 40 random subtrees 200 times, changing the text of one leaf
+// before each render, with the three layouts of Node.render (the bounds, the intrinsic size, then
+// that size), with YGNodeMeasure followed by YGNodeCalculateLayout, and with
+// YGNodeCalculateLayoutFitting.
+
+#include "YGBenchmark.h"
+
+#define SUBTREE_COUNT 40
+#define RENDER_COUNT 200
+#define WAY_COUNT 3
+
+static const char *const gWayNames[WAY_COUNT] = {"Node.render", "measure then layout", "fitting"};
+
+static YGNodeRef anyLeaf(YGNodeRef node, unsigned path) {
+  while (YGNodeGetChildCount(node) > 0) {
+    node = YGNodeGetChild(node, path % YGNodeGetChildCount(node));
+    path /= 3;
+  }
+  return node;
+}
+
+static void render(const uint32_t way, const YGNodeRef root) {
+  switch (way) {
+    case 0: {
+      YGNodeCalculateLayout(root, 375, 667, YGDirectionLTR);
+      YGNodeCalculateLayout(root, YGUndefined, YGUndefined, YGDirectionLTR);
+      const float width = YGNodeLayoutGetWidth(root);
+      const float height = YGNodeLayoutGetHeight(root);
+      YGNodeCalculateLayout(root, width, height, YGDirectionLTR);
+      break;
+    }
+    case 1: {
+      const YGSize size = YGNodeMeasure(root, 375, YGMeasureModeAtMost, 667, YGMeasureModeAtMost);
+      YGNodeCalculateLayout(root, size.width, size.height, YGDirectionLTR);
+      break;
+    }
+    default:
+      YGNodeCalculateLayoutFitting(root, 375, 667, YGDirectionLTR);
+      break;
+  }
+}
+
+int main(void) {
+  YGNodeRef roots[WAY_COUNT];
+  for (uint32_t i = 0; i < WAY_COUNT; i++) {
+    roots[i] = YGNodeNew();
+  }
+  for (uint32_t i = 0; i < SUBTREE_COUNT; i++) {
+    YGNodeRef subtrees[WAY_COUNT];
+    YGTestBuildTrees(3, subtrees, WAY_COUNT);
+    for (uint32_t j = 0; j < WAY_COUNT; j++) {
+      YGNodeInsertChild(roots[j], subtrees[j], i);
+    }
+  }
+
+  for (uint32_t way = 0; way < WAY_COUNT; way++) {
+    const YGNodeRef root = roots[way];
+    render(way, root);
+    gYGTestMeasureCalls = 0;
+    const double start = YGBenchmarkNow();
+    for (unsigned i = 0; i < RENDER_COUNT; i++) {
+      const YGNodeRef leaf = anyLeaf(root, i * 7919);
+      YGNodeSetContext(leaf, (void *) ((long) YGNodeGetContext(leaf) + 1));
+      YGNodeMarkDirty(leaf);
+      render(way, root);
+    }
+    const double elapsed = YGBenchmarkNow() - start;
+    printf("%s: %.3f ms per render, %.1f measures per render\n", gWayNames[way],
+           elapsed / RENDER_COUNT, (double) gYGTestMeasureCalls / RENDER_COUNT);
+  }
+
+  for (uint32_t i = 0; i < WAY_COUNT; i++) {
+    YGNodeFreeRecursive(roots[i]);
+  }
+  return 0;
+}
@@ -0,0 +1,76 @@
+/** Copyright (c) 2014-present, Facebook, Inc. */
+
+// Resizes a fixed screen of 1365 nodes 200 times, laid out by its compiled layout program and by
+// YGNodeCalculateLayout on a copy. The leaves are either boxes of a fixed size or text. Around
+// text, the engine reuses the layouts of containers over ranges of sizes; programs only reuse
+// them at the same size, so they measure the text more often.
+
+#include "YGBenchmark.h"
+
+#define RESIZE_COUNT 200
+
+// Four children per container, rows and columns in turn.
+static YGNodeRef buildScreen(const int depth, const bool text) {
+  const YGNodeRef node = YGNodeNew();
+  if (depth == 0) {
+    const int context = ++gYGTestContext;
+    if (text) {
+      YGNodeSetContext(node, (void *) (long) context);
+      YGNodeSetMeasureFunc(node, YGTestMeasure);
+    } else {
+      YGNodeStyleSetWidth(node, 10 + context % 30);
+      YGNodeStyleSetHeight(node, 10 + context % 20);
+    }
+    return node;
+  }
+  YGNodeStyleSetFlexDirection(node, depth % 2 == 0 ? YGFlexDirectionRow : YGFlexDirectionColumn);
+  YGNodeStyleSetPadding(node, YGEdgeAll, 4);
+  YGNodeStyleSetAlignItems(node, depth % 3 == 0 ? YGAlignCenter : YGAlignStretch);
+  for (uint32_t i = 0; i < 4; i++) {
+    const YGNodeRef child = buildScreen(depth - 1, text);
+    if (i % 2 == 0) {
+      YGNodeStyleSetFlexGrow(child, 1);
+    }
+    YGNodeStyleSetMargin(child, YGEdgeRight, 2);
+    YGNodeInsertChild(node, child, i);
+  }
+  return node;
+}
+
+static void resize(const bool text) {
+  gYGTestContext = 0;
+  const YGNodeRef compiled = buildScreen(5, text);
+  gYGTestContext = 0;
+  const YGNodeRef plain = buildScreen(5, text);
+  const YGLayoutProgramRef program = YGLayoutProgramNew(compiled, YGDirectionLTR);
+  if (program == NULL) {
+    fprintf(stderr, "the screen did not compile\n");
+    exit(1);
+  }
+
+  double programTime;
+  YG_BENCHMARK(programTime, 5, 1, {
+    for (uint32_t i = 0; i < RESIZE_COUNT; i++) {
+      YGLayoutProgramRun(program, 400 + (i * 37) % 400, 800);
+    }
+  });
+  double engineTime;
+  YG_BENCHMARK(engineTime, 5, 1, {
+    for (uint32_t i = 0; i < RESIZE_COUNT; i++) {
+      YGNodeCalculateLayout(plain, 400 + (i * 37) % 400, 800, YGDirectionLTR);
+    }
+  });
+  printf("%u nodes, %s, %d resizes: program %.2f ms, YGNodeCalculateLayout %.2f ms (%.2fx)\n",
+         YGTestNodeCount(compiled), text ? "text" : "boxes", RESIZE_COUNT, programTime,
+         engineTime, engineTime / programTime);
+
+  YGLayoutProgramFree(program);
+  YGNodeFreeRecursive(compiled);
+  YGNodeFreeRecursive(plain);
+}
+
+int main(void) {
+  resize(false);
+  resize(true);
+  return 0;
+}
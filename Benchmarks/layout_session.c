@@ -0,0 +1,95 @@
+/** Copyright (c) 2014-present, Facebook, Inc. */
+
+// Lays out 3000 cards sized by their text, directly under the root and in sections of 20, in one
+// go and through a session stepped with a 2 ms budget. Reports the total time, the number of
+// steps and the longest step, for the first layout and a resize.
+
+#include "YGBenchmark.h"
+
+#define CARD_COUNT 3000
+#define SECTION_SIZE 20
+#define BUDGET_MICROS 2000
+
+static YGNodeRef buildText(const bool shrinks) {
+  const YGNodeRef text = YGNodeNew();
+  YGNodeSetContext(text, (void *) (long) ++gYGTestContext);
+  YGNodeSetMeasureFunc(text, YGTestMeasure);
+  YGNodeStyleSetFlexShrink(text, shrinks ? 1 : 0);
+  return text;
+}
+
+// A row of three texts over three more.
+static YGNodeRef buildCard(void) {
+  const YGNodeRef card = YGNodeNew();
+  YGNodeStyleSetPadding(card, YGEdgeAll, 8);
+  const YGNodeRef row = YGNodeNew();
+  YGNodeStyleSetFlexDirection(row, YGFlexDirectionRow);
+  for (uint32_t i = 0; i < 3; i++) {
+    YGNodeInsertChild(row, buildText(true), i);
+  }
+  YGNodeInsertChild(card, row, 0);
+  for (uint32_t i = 0; i < 3; i++) {
+    YGNodeInsertChild(card, buildText(false), i + 1);
+  }
+  return card;
+}
+
+static YGNodeRef buildFeed(const bool sectioned) {
+  gYGTestContext = 0;
+  const YGNodeRef root = YGNodeNew();
+  YGNodeStyleSetWidth(root, 375);
+  YGNodeRef section = root;
+  for (uint32_t i = 0; i < CARD_COUNT; i++) {
+    if (sectioned && i % SECTION_SIZE == 0) {
+      section = YGNodeNew();
+      YGNodeStyleSetPadding(section, YGEdgeAll, 4);
+      YGNodeInsertChild(root, section, i / SECTION_SIZE);
+    }
+    YGNodeInsertChild(section, buildCard(), YGNodeGetChildCount(section));
+  }
+  return root;
+}
+
+static void step(const YGNodeRef root, const float width, const char *what) {
+  const YGLayoutSessionRef session = YGLayoutBegin(root, width, YGUndefined, YGDirectionLTR);
+  const double start = YGBenchmarkNow();
+  double worst = 0;
+  int steps = 0;
+  bool done;
+  do {
+    const double stepStart = YGBenchmarkNow();
+    done = YGLayoutStep(session, BUDGET_MICROS);
+    worst = fmax(worst, YGBenchmarkNow() - stepStart);
+    steps++;
+  } while (!done);
+  const double total = YGBenchmarkNow() - start;
+  YGLayoutCommit(session);
+  printf("  %s in steps: %.2f ms, %d steps, longest %.2f ms\n", what, total, steps, worst);
+}
+
+static void layout(const bool sectioned) {
+  if (sectioned) {
+    printf("%d cards in sections of %d:\n", CARD_COUNT, SECTION_SIZE);
+  } else {
+    printf("%d cards:\n", CARD_COUNT);
+  }
+  const YGNodeRef eager = buildFeed(sectioned);
+  double start = YGBenchmarkNow();
+  YGNodeCalculateLayout(eager, YGUndefined, YGUndefined, YGDirectionLTR);
+  printf("  first layout in one go: %.2f ms\n", YGBenchmarkNow() - start);
+  start = YGBenchmarkNow();
+  YGNodeCalculateLayout(eager, 300, YGUndefined, YGDirectionLTR);
+  printf("  resize in one go: %.2f ms\n", YGBenchmarkNow() - start);
+  YGNodeFreeRecursive(eager);
+
+  const YGNodeRef sliced = buildFeed(sectioned);
+  step(sliced, YGUndefined, "first layout");
+  step(sliced, 300, "resize");
+  YGNodeFreeRecursive(sliced);
+}
+
+int main(void) {
+  layout(false);
+  layout(true);
+  return 0;
+}
@@ -0,0 +1,112 @@
+/** Copyright (c) 2014-present, Facebook, Inc. */
+
+// Cold-start layout of 2000 rows of two text leaves at 375 pt with a synthetic text measurer:
+// without a measurement cache, on a first launch with an empty cache file, and on the next
+// launch reading it back. The file is created in the temporary directory and removed after.
+
+#include "YGBenchmark.h"
+
+#include <unistd.h>
+
+#define ROW_COUNT 2000
+#define CACHE_CAPACITY 65536
+
+static int gMeasureCalls = 0;
+static char gCachePath[256];
+
+// Lays out words of 6 pt glyphs in lines of the given width, paying for every glyph shaped.
+static YGSize measureText(YGNodeRef node,
+                          float width,
+                          YGMeasureMode widthMode,
+                          float height,
+                          YGMeasureMode heightMode) {
+  (void) height;
+  (void) heightMode;
+  gMeasureCalls++;
+  const long context = (long) YGNodeGetContext(node);
+  const unsigned hash = (unsigned) context * 2654435761u;
+  const int words = 20 + context % 60;
+  float lineWidth = 0;
+  float maxLineWidth = 0;
+  float lines = 1;
+  volatile float sink = 0;
+  for (int i = 0; i < words; i++) {
+    const int length = 2 + (hash >> (i % 24)) % 8;
+    for (int glyph = 0; glyph < length * 40; glyph++) {
+      sink += sinf(glyph * 0.1f);
+    }
+    const float wordWidth = length * 6;
+    if (widthMode != YGMeasureModeUndefined && lineWidth + wordWidth > width && lineWidth > 0) {
+      lines++;
+      lineWidth = 0;
+    }
+    lineWidth += wordWidth + 3;
+    maxLineWidth = lineWidth > maxLineWidth ? lineWidth : maxLineWidth;
+  }
+  return (YGSize){
+      .width = widthMode == YGMeasureModeExactly ? width : maxLineWidth, .height = lines * 14,
+  };
+}
+
+static YGNodeRef buildList(void) {
+  const YGNodeRef root = YGNodeNew();
+  for (uint32_t i = 0; i < ROW_COUNT; i++) {
+    const YGNodeRef row = YGNodeNew();
+    YGNodeStyleSetFlexDirection(row, YGFlexDirectionRow);
+    YGNodeStyleSetPadding(row, YGEdgeAll, 8);
+    for (uint32_t j = 0; j < 2; j++) {
+      const YGNodeRef text = YGNodeNew();
+      const long content = 1 + (i * 2 + j) % 700;
+      YGNodeSetContext(text, (void *) content);
+      YGNodeSetMeasureFunc(text, measureText);
+      YGNodeSetMeasureKey(text, content);
+      if (j == 1) {
+        YGNodeStyleSetFlexShrink(text, 1);
+      }
+      YGNodeInsertChild(row, text, j);
+    }
+    YGNodeInsertChild(root, row, i);
+  }
+  return root;
+}
+
+// Opens the cache file, if any, and lays out a new list as an app launch would.
+static void launch(const char *const name, const bool cached) {
+  double start = YGBenchmarkNow();
+  const YGMeasureCacheRef cache = cached ? YGMeasureCacheOpen(gCachePath, CACHE_CAPACITY) : NULL;
+  const double open = YGBenchmarkNow() - start;
+  YG_TEST_CHECK(cache != NULL || !cached);
+  YGSetMeasureCache(cache);
+
+  const YGNodeRef root = buildList();
+  gMeasureCalls = 0;
+  start = YGBenchmarkNow();
+  YGNodeCalculateLayout(root, 375, YGUndefined, YGDirectionLTR);
+  const double layout = YGBenchmarkNow() - start;
+  printf("%s: layout %.1f ms, %d measures", name, layout, gMeasureCalls);
+  if (cached) {
+    printf(", opening the file %.2f ms, %u entries after", open, YGMeasureCacheGetCount(cache));
+  }
+  printf("\n");
+
+  YGNodeFreeRecursive(root);
+  YGSetMeasureCache(NULL);
+  if (cache != NULL) {
+    YGMeasureCacheClose(cache);
+  }
+}
+
+int main(void) {
+  const char *const directory = getenv("TMPDIR");
+  snprintf(gCachePath, sizeof(gCachePath), "%s/yoga_measure_cache_XXXXXX",
+           directory != NULL ? directory : "/tmp");
+  const int fd = mkstemp(gCachePath);
+  YG_TEST_CHECK(fd >= 0);
+  close(fd);
+
+  launch("no cache", false);
+  launch("first launch", true);
+  launch("next launch", true);
+  unlink(gCachePath);
+  return 0;
+}
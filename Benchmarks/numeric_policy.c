@@ -0,0 +1,46 @@
+/** Copyright (c) 2014-present, Facebook, Inc. */
+
+// Built once per numeric policy, see YGMacros.h: compare the output of the three binaries.
+
+#include "YGBenchmark.h"
+
+#define TREE_COUNT 20
+
+int main(void) {
+  YGNodeRef roots[TREE_COUNT];
+  double cold = INFINITY;
+  for (int round = 0; round < 5; round++) {
+    gYGTestSeed = 12345;
+    for (uint32_t i = 0; i < TREE_COUNT; i++) {
+      roots[i] = YGTestBuildTree(6);
+    }
+    const double start = YGBenchmarkNow();
+    for (uint32_t i = 0; i < TREE_COUNT; i++) {
+      YGNodeCalculateLayout(roots[i], 375, YGUndefined, YGDirectionLTR);
+    }
+    const double elapsed = YGBenchmarkNow() - start;
+    cold = elapsed < cold ? elapsed : cold;
+    if (round < 4) {
+      for (uint32_t i = 0; i < TREE_COUNT; i++) {
+        YGNodeFreeRecursive(roots[i]);
+      }
+    }
+  }
+
+  double resize;
+  uint32_t step = 0;
+  YG_BENCHMARK(resize, 5, 20, {
+    step++;
+    for (uint32_t i = 0; i < TREE_COUNT; i++) {
+      YGNodeCalculateLayout(roots[i], 300 + step % 100, YGUndefined, YGDirectionLTR);
+    }
+  });
+
+  const char *policy = YG_DOUBLE_PRECISION ? "double" : "float";
+  printf("%s: cold layout %.2f ms, resize %.2f ms (%d random trees)\n",
+         policy, cold, resize, TREE_COUNT);
+  for (uint32_t i = 0; i < TREE_COUNT; i++) {
+    YGNodeFreeRecursive(roots[i]);
+  }
+  return 0;
+}
@@ -0,0 +1,70 @@
+/** Copyright (c) 2014-present, Facebook, Inc. */
+
+// The layouts of a render of a feed of 500 cards: the bounds, the intrinsic size, the content
+// size, then the bounds again. The first render of a new tree measures everything; the next ones
+// get every layout back from the caches, the content size from the containers' layout caches.
+
+#include "YGBenchmark.h"
+
+#define CARD_COUNT 500
+
+static YGNodeRef buildText(void) {
+  const YGNodeRef text = YGNodeNew();
+  YGNodeSetContext(text, (void *) (long) (++gYGTestContext));
+  YGNodeSetMeasureFunc(text, YGTestMeasure);
+  YGNodeStyleSetFlexShrink(text, 1);
+  return text;
+}
+
+static YGNodeRef buildFeed(void) {
+  gYGTestContext = 0;
+  const YGNodeRef root = YGNodeNew();
+  for (uint32_t i = 0; i < CARD_COUNT; i++) {
+    const YGNodeRef card = YGNodeNew();
+    YGNodeStyleSetFlexDirection(card, YGFlexDirectionRow);
+    YGNodeStyleSetPadding(card, YGEdgeAll, 8);
+    YGNodeStyleSetMargin(card, YGEdgeBottom, 4);
+    const YGNodeRef image = YGNodeNew();
+    YGNodeStyleSetWidth(image, 48);
+    YGNodeStyleSetHeight(image, 48);
+    YGNodeInsertChild(card, image, 0);
+    const YGNodeRef column = YGNodeNew();
+    YGNodeStyleSetFlexShrink(column, 1);
+    for (uint32_t j = 0; j < 3; j++) {
+      YGNodeInsertChild(column, buildText(), j);
+    }
+    YGNodeInsertChild(card, column, 1);
+    YGNodeInsertChild(root, card, i);
+  }
+  return root;
+}
+
+static void render(const YGNodeRef root) {
+  YGNodeCalculateLayout(root, 375, 667, YGDirectionLTR);
+  const YGSize intrinsic = YGNodeMeasure(
+      root, YGUndefined, YGMeasureModeUndefined, YGUndefined, YGMeasureModeUndefined);
+  YGNodeCalculateLayout(root, intrinsic.width, intrinsic.height, YGDirectionLTR);
+  YGNodeCalculateLayout(root, 375, 667, YGDirectionLTR);
+}
+
+int main(void) {
+  YGNodeRef roots[5];
+  for (uint32_t i = 0; i < 5; i++) {
+    roots[i] = buildFeed();
+  }
+  gYGTestMeasureCalls = 0;
+  uint32_t next = 0;
+  double first;
+  YG_BENCHMARK(first, 5, 1, render(roots[next++]));
+  const int firstCalls = gYGTestMeasureCalls / 5;
+
+  gYGTestMeasureCalls = 0;
+  double again;
+  YG_BENCHMARK(again, 5, 20, render(roots[0]));
+  printf("%d cards: first render %.2f ms (%d measures), next renders %.3f ms (%d measures)\n",
+         CARD_COUNT, first, firstCalls, again, gYGTestMeasureCalls / 100);
+  for (uint32_t i = 0; i < 5; i++) {
+    YGNodeFreeRecursive(roots[i]);
+  }
+  return 0;
+}
@@ -0,0 +1,69 @@
+/** Copyright (c) 2014-present, Facebook, Inc. */
+
+// Resizes a feed of 2000 cards 200 times between 400 and 800 pt wide. Cards sized by their
+// content keep their layouts while it fits; stretched cards depend on the width and are laid
+// out again on every resize, like every card was before layouts recorded what they depend on.
+
+#include "YGBenchmark.h"
+
+#define CARD_COUNT 2000
+#define RESIZE_COUNT 200
+
+static YGNodeRef buildText(void) {
+  const YGNodeRef text = YGNodeNew();
+  YGNodeSetContext(text, (void *) (long) (++gYGTestContext));
+  YGNodeSetMeasureFunc(text, YGTestMeasure);
+  return text;
+}
+
+static YGNodeRef buildCard(const bool stretched) {
+  const YGNodeRef card = YGNodeNew();
+  YGNodeStyleSetFlexDirection(card, YGFlexDirectionRow);
+  if (!stretched) {
+    YGNodeStyleSetAlignSelf(card, YGAlignFlexStart);
+  }
+  YGNodeStyleSetPadding(card, YGEdgeAll, 8);
+  YGNodeStyleSetMargin(card, YGEdgeBottom, 4);
+  for (uint32_t i = 0; i < 3; i++) {
+    const YGNodeRef text = buildText();
+    YGNodeStyleSetMargin(text, YGEdgeRight, 4);
+    YGNodeInsertChild(card, text, i);
+  }
+  const YGNodeRef column = YGNodeNew();
+  for (uint32_t i = 0; i < 2; i++) {
+    YGNodeInsertChild(column, buildText(), i);
+  }
+  YGNodeInsertChild(card, column, 3);
+  return card;
+}
+
+static double resizeStorm(const bool stretched, int *const measureCalls) {
+  gYGTestContext = 0;
+  const YGNodeRef root = YGNodeNew();
+  for (uint32_t i = 0; i < CARD_COUNT; i++) {
+    YGNodeInsertChild(root, buildCard(stretched), i);
+  }
+  YGNodeCalculateLayout(root, 800, YGUndefined, YGDirectionLTR);
+
+  gYGTestMeasureCalls = 0;
+  double elapsed;
+  YG_BENCHMARK(elapsed, 3, 1, {
+    for (uint32_t i = 0; i < RESIZE_COUNT; i++) {
+      YGNodeCalculateLayout(root, 400 + (i * 37) % 400, YGUndefined, YGDirectionLTR);
+    }
+  });
+  *measureCalls = gYGTestMeasureCalls;
+  YGNodeFreeRecursive(root);
+  return elapsed;
+}
+
+int main(void) {
+  int fittedCalls;
+  int stretchedCalls;
+  const double fitted = resizeStorm(false, &fittedCalls);
+  const double stretched = resizeStorm(true, &stretchedCalls);
+  printf("%d cards, %d resizes: cards sized by content %.1f ms (%d measures), "
+         "stretched cards %.1f ms (%d measures)\n",
+         CARD_COUNT, RESIZE_COUNT, fitted, fittedCalls, stretched, stretchedCalls);
+  return 0;
+}
@@ -0,0 +1,85 @@
+/** Copyright (c) 2014-present, Facebook, Inc. */
+
+// Lays out a grid of 1000 identical tiles of 18 text leaves, first when it is new and then at
+// other widths, with keyed leaves whose tiles share their layouts and with unkeyed ones that lay
+// out every tile.
+
+#include "YGBenchmark.h"
+
+#define TILE_COUNT 1000
+#define RESIZE_COUNT 10
+
+// Three rows of six texts, each keyed by its place in the tile when keyed. Tiles take a share of
+// the width of the grid, so a resize lays them out again.
+static YGNodeRef buildTile(const bool keyed) {
+  const YGNodeRef tile = YGNodeNew();
+  YGNodeStyleSetWidthPercent(tile, 15);
+  YGNodeStyleSetPadding(tile, YGEdgeAll, 4);
+  YGNodeStyleSetMargin(tile, YGEdgeAll, 2);
+  for (uint32_t i = 0; i < 3; i++) {
+    const YGNodeRef row = YGNodeNew();
+    YGNodeStyleSetFlexDirection(row, YGFlexDirectionRow);
+    YGNodeStyleSetFlexWrap(row, YGWrapWrap);
+    YGNodeStyleSetAlignItems(row, i == 1 ? YGAlignCenter : YGAlignStretch);
+    for (uint32_t j = 0; j < 6; j++) {
+      const YGNodeRef text = YGNodeNew();
+      const long context = 1 + 6 * i + j;
+      YGNodeSetContext(text, (void *) context);
+      YGNodeSetMeasureFunc(text, YGTestMeasure);
+      YGNodeSetMeasureKey(text, keyed ? (uintptr_t) context : 0);
+      if (j % 3 == 0) {
+        YGNodeStyleSetFlexGrow(text, 1);
+      }
+      YGNodeInsertChild(row, text, j);
+    }
+    YGNodeInsertChild(tile, row, i);
+  }
+  return tile;
+}
+
+static YGNodeRef buildGrid(const bool keyed) {
+  const YGNodeRef root = YGNodeNew();
+  YGNodeStyleSetFlexDirection(root, YGFlexDirectionRow);
+  YGNodeStyleSetFlexWrap(root, YGWrapWrap);
+  for (uint32_t i = 0; i < TILE_COUNT; i++) {
+    YGNodeInsertChild(root, buildTile(keyed), i);
+  }
+  return root;
+}
+
+static void layout(const bool keyed) {
+  // The first layout of a new grid, best of 5, without building and freeing it.
+  double firstTime = INFINITY;
+  int firstCalls = 0;
+  for (int round = 0; round < 5; round++) {
+    const YGNodeRef root = buildGrid(keyed);
+    gYGTestMeasureCalls = 0;
+    const double start = YGBenchmarkNow();
+    YGNodeCalculateLayout(root, 1200, YGUndefined, YGDirectionLTR);
+    firstTime = fmin(firstTime, YGBenchmarkNow() - start);
+    firstCalls = gYGTestMeasureCalls;
+    YGNodeFreeRecursive(root);
+  }
+
+  const YGNodeRef root = buildGrid(keyed);
+  YGNodeCalculateLayout(root, 1200, YGUndefined, YGDirectionLTR);
+  double resizeTime;
+  gYGTestMeasureCalls = 0;
+  YG_BENCHMARK(resizeTime, 5, 1, {
+    for (uint32_t i = 0; i < RESIZE_COUNT; i++) {
+      YGNodeCalculateLayout(root, 800 + (i * 97) % 600, YGUndefined, YGDirectionLTR);
+    }
+  });
+  const int resizeCalls = gYGTestMeasureCalls / 5;
+  YGNodeFreeRecursive(root);
+
+  printf("%u tiles, %s: first layout %.2f ms, %d measures; %d resizes %.2f ms, %d measures\n",
+         TILE_COUNT, keyed ? "keyed" : "unkeyed", firstTime, firstCalls, RESIZE_COUNT,
+         resizeTime, resizeCalls);
+}
+
+int main(void) {
+  layout(false);
+  layout(true);
+  return 0;
+}
@@ -0,0 +1,80 @@
+/** Copyright (c) 2014-present, Facebook, Inc. */
+
+// Appends rows to a feed in batches of 100, laying it out after each batch: 20k rows in a plain
+// container and in a streaming one, then 1M rows streaming while the head is retired.
+
+#include "YGBenchmark.h"
+
+#include <sys/resource.h>
+
+#define BATCH_SIZE 100
+#define RETIRE_ABOVE 2000
+#define KEEP_COUNT 1000
+
+static long maxResidentKilobytes(void) {
+  struct rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+  return usage.ru_maxrss;
+}
+
+static YGNodeRef buildRow(const uint32_t index) {
+  const YGNodeRef row = YGNodeNew();
+  YGNodeStyleSetHeight(row, 30 + index % 20);
+  YGNodeStyleSetPadding(row, YGEdgeAll, 4);
+  const YGNodeRef content = YGNodeNew();
+  YGNodeStyleSetHeight(content, 10);
+  YGNodeInsertChild(row, content, 0);
+  return row;
+}
+
+// Detaches and frees all but the last KEEP_COUNT rows once the feed holds too many.
+static void retireHead(const YGNodeRef feed) {
+  const uint32_t childCount = YGNodeGetChildCount(feed);
+  if (childCount <= RETIRE_ABOVE) {
+    return;
+  }
+  const uint32_t count = childCount - KEEP_COUNT;
+  YGNodeRef *const retired = malloc(sizeof(YGNodeRef) * count);
+  for (uint32_t i = 0; i < count; i++) {
+    retired[i] = YGNodeGetChild(feed, i);
+  }
+  YGNodeRetireChildren(feed, count);
+  for (uint32_t i = 0; i < count; i++) {
+    YGNodeFreeRecursive(retired[i]);
+  }
+  free(retired);
+}
+
+static void appendRows(const uint32_t rowCount, const bool streaming) {
+  const YGNodeRef feed = YGNodeNew();
+  YGNodeStyleSetWidth(feed, 375);
+  YGNodeSetStreaming(feed, streaming);
+
+  const long residentBefore = maxResidentKilobytes();
+  int32_t maxLiveNodes = 0;
+  const double start = YGBenchmarkNow();
+  for (uint32_t i = 0; i < rowCount;) {
+    for (uint32_t j = 0; j < BATCH_SIZE; j++, i++) {
+      YGNodeInsertChild(feed, buildRow(i), YGNodeGetChildCount(feed));
+    }
+    YGNodeCalculateLayout(feed, YGUndefined, YGUndefined, YGDirectionLTR);
+    const int32_t liveNodes = YGNodeGetInstanceCount();
+    maxLiveNodes = liveNodes > maxLiveNodes ? liveNodes : maxLiveNodes;
+    if (streaming) {
+      retireHead(feed);
+    }
+  }
+  const double elapsed = YGBenchmarkNow() - start;
+
+  printf("%s, %u rows: %.0f ms, height %.0f, at most %d live nodes, max RSS +%ld KB\n",
+         streaming ? "streaming" : "plain", rowCount, elapsed, YGNodeLayoutGetHeight(feed),
+         maxLiveNodes, maxResidentKilobytes() - residentBefore);
+  YGNodeFreeRecursive(feed);
+}
+
+int main(void) {
+  appendRows(20000, false);
+  appendRows(20000, true);
+  appendRows(1000000, true);
+  return 0;
+}
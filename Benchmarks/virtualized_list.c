@@ -0,0 +1,54 @@
+/** Copyright (c) 2014-present, Facebook, Inc. */
+
+// Scrolls through a column of 100k text rows, laid out in full and virtualized.
+
+#include "YGBenchmark.h"
+
+#define ROW_COUNT 100000
+#define VIEWPORT_LENGTH 800
+#define SCROLL_STEPS 200
+
+static YGNodeRef buildColumn(void) {
+  const YGNodeRef root = YGNodeNew();
+  YGNodeStyleSetWidth(root, 375);
+  YGNodeStyleSetHeight(root, VIEWPORT_LENGTH);
+  for (uint32_t i = 0; i < ROW_COUNT; i++) {
+    const YGNodeRef row = YGNodeNew();
+    YGNodeSetContext(row, (void *) (long) (i + 1));
+    YGNodeSetMeasureFunc(row, YGTestMeasure);
+    YGNodeInsertChild(root, row, i);
+  }
+  return root;
+}
+
+int main(void) {
+  const YGNodeRef full = buildColumn();
+  gYGTestMeasureCalls = 0;
+  double start = YGBenchmarkNow();
+  YGNodeCalculateLayout(full, YGUndefined, YGUndefined, YGDirectionLTR);
+  const double fullLayout = YGBenchmarkNow() - start;
+  const int fullCalls = gYGTestMeasureCalls;
+  YGNodeFreeRecursive(full);
+
+  const YGNodeRef virtualized = buildColumn();
+  YGNodeSetVirtualized(virtualized, 0, VIEWPORT_LENGTH);
+  YGNodeCalculateLayout(virtualized, YGUndefined, YGUndefined, YGDirectionLTR);
+  // Each step scrolls by a bit more than a window, so every pass lays out new rows.
+  int minCalls = INT32_MAX;
+  int maxCalls = 0;
+  start = YGBenchmarkNow();
+  for (uint32_t step = 1; step <= SCROLL_STEPS; step++) {
+    YGNodeSetVirtualized(virtualized, step * 2.5f * VIEWPORT_LENGTH, VIEWPORT_LENGTH);
+    gYGTestMeasureCalls = 0;
+    YGNodeCalculateLayout(virtualized, YGUndefined, YGUndefined, YGDirectionLTR);
+    minCalls = gYGTestMeasureCalls < minCalls ? gYGTestMeasureCalls : minCalls;
+    maxCalls = gYGTestMeasureCalls > maxCalls ? gYGTestMeasureCalls : maxCalls;
+  }
+  const double scroll = (YGBenchmarkNow() - start) / SCROLL_STEPS;
+  YGNodeFreeRecursive(virtualized);
+
+  printf("%d rows: full layout %.2f ms (%d measures), virtualized scroll %.3f ms per pass "
+         "(%d-%d measures)\n",
+         ROW_COUNT, fullLayout, fullCalls, scroll, minCalls, maxCalls);
+  return 0;
+}
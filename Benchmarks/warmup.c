@@ -0,0 +1,89 @@
+/** Copyright (c) 2014-present, Facebook, Inc. */
+
+// Time to the first layout of a new cell of 60 text leaves, cold and after YGNodeWarmup at the
+// two widths it may get.
+
+#include "YGBenchmark.h"
+
+#define CELL_COUNT 200
+#define ROWS_PER_CELL 20
+
+// Costs about as much as measuring a short string with a platform text engine.
+static YGSize measureText(YGNodeRef node,
+                          float width,
+                          YGMeasureMode widthMode,
+                          float height,
+                          YGMeasureMode heightMode) {
+  (void) height;
+  (void) heightMode;
+  volatile double sink = 0;
+  for (int i = 0; i < 400; i++) {
+    sink += i * 0.5;
+  }
+  const int context = (int) (long) YGNodeGetContext(node);
+  const float naturalWidth = 40 + (context % 9) * 25;
+  const float measuredWidth = widthMode == YGMeasureModeExactly ||
+                                      (widthMode == YGMeasureModeAtMost && width < naturalWidth)
+                                  ? width
+                                  : naturalWidth;
+  const float lines = measuredWidth > 1 ? ceilf(naturalWidth / measuredWidth) : naturalWidth;
+  return (YGSize){.width = measuredWidth, .height = lines * 16};
+}
+
+static YGNodeRef buildCell(void) {
+  const YGNodeRef cell = YGNodeNew();
+  YGNodeStyleSetPadding(cell, YGEdgeAll, 8);
+  for (uint32_t i = 0; i < ROWS_PER_CELL; i++) {
+    const YGNodeRef row = YGNodeNew();
+    YGNodeStyleSetFlexDirection(row, YGFlexDirectionRow);
+    YGNodeStyleSetAlignItems(row, YGAlignCenter);
+    for (uint32_t j = 0; j < 3; j++) {
+      const YGNodeRef text = YGNodeNew();
+      YGNodeSetContext(text, (void *) (long) (++gYGTestContext));
+      YGNodeSetMeasureFunc(text, measureText);
+      if (j == 1) {
+        YGNodeStyleSetFlexShrink(text, 1);
+        YGNodeStyleSetFlexGrow(text, 1);
+      }
+      YGNodeStyleSetMargin(text, YGEdgeHorizontal, 4);
+      YGNodeInsertChild(row, text, j);
+    }
+    YGNodeInsertChild(cell, row, i);
+  }
+  return cell;
+}
+
+int main(void) {
+  const YGSize anticipatedSizes[] = {{375, YGUndefined}, {667, YGUndefined}};
+  double cold = 0;
+  double warm = 0;
+  double warmup = 0;
+  for (uint32_t i = 0; i < CELL_COUNT; i++) {
+    const int context = gYGTestContext;
+    const YGNodeRef coldCell = buildCell();
+    gYGTestContext = context;
+    const YGNodeRef warmCell = buildCell();
+
+    double start = YGBenchmarkNow();
+    YGNodeCalculateLayout(coldCell, 375, YGUndefined, YGDirectionLTR);
+    cold += YGBenchmarkNow() - start;
+
+    start = YGBenchmarkNow();
+    YG_TEST_CHECK(YGNodeWarmup(warmCell, anticipatedSizes, 2, 100000) == 2);
+    warmup += YGBenchmarkNow() - start;
+
+    start = YGBenchmarkNow();
+    YGNodeCalculateLayout(warmCell, 375, YGUndefined, YGDirectionLTR);
+    warm += YGBenchmarkNow() - start;
+
+    YG_TEST_CHECK(YGTestSameLayout(coldCell, warmCell));
+    YGNodeFreeRecursive(coldCell);
+    YGNodeFreeRecursive(warmCell);
+  }
+
+  printf("first layout of a cell of %d text leaves: cold %.1f us, after warmup %.1f us "
+         "(warmup %.1f us)\n",
+         ROWS_PER_CELL * 3, cold * 1e3 / CELL_COUNT, warm * 1e3 / CELL_COUNT,
+         warmup * 1e3 / CELL_COUNT);
+  return 0;
+}
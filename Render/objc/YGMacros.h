@@ -20,6 +20,12 @@
 #define FB_ASSERTIONS_ENABLED 1
 #endif
 
+// Set to 1 to run the layout arithmetic in double instead of float, e.g. for canvases large
+// enough for float positions to lose precision. The public API is float in both modes.
+#ifndef YG_DOUBLE_PRECISION
+#define YG_DOUBLE_PRECISION 0
+#endif
+
 #if FB_ASSERTIONS_ENABLED
 #define YG_ABORT() abort()
 #else
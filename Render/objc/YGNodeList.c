@@ -78,6 +78,16 @@ YGNodeRef YGNodeListRemove(const YGNodeListRef list, const uint32_t index) {
   return removed;
 }
 
+void YGNodeListRemoveRange(const YGNodeListRef list, const uint32_t index, const uint32_t count) {
+  for (uint32_t i = index; i + count < list->count; i++) {
+    list->items[i] = list->items[i + count];
+  }
+  for (uint32_t i = list->count - count; i < list->count; i++) {
+    list->items[i] = NULL;
+  }
+  list->count -= count;
+}
+
 YGNodeRef YGNodeListDelete(const YGNodeListRef list, const YGNodeRef node) {
   for (uint32_t i = 0; i < list->count; i++) {
     if (list->items[i] == node) {
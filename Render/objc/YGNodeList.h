@@ -20,6 +20,7 @@ uint32_t YGNodeListCount(const YGNodeListRef list);
 void YGNodeListAdd(YGNodeListRef *listp, const YGNodeRef node);
 void YGNodeListInsert(YGNodeListRef *listp, const YGNodeRef node, const uint32_t index);
 YGNodeRef YGNodeListRemove(const YGNodeListRef list, const uint32_t index);
+void YGNodeListRemoveRange(const YGNodeListRef list, const uint32_t index, const uint32_t count);
 YGNodeRef YGNodeListDelete(const YGNodeListRef list, const YGNodeRef node);
 YGNodeRef YGNodeListGet(const YGNodeListRef list, const uint32_t index);
 
@@ -1,6 +1,22 @@
 /** Copyright (c) 2014-present, Facebook, Inc. */
 
+// clock_gettime for time-sliced layout, mmap for the persistent measurement cache, pthread keys
+// to free the buffers of exiting threads.
+#if !defined(_MSC_VER) && !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#include <stddef.h>
 #include <string.h>
+#include <time.h>
+
+#ifndef _MSC_VER
+#include <fcntl.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
 
 #include "YGNodeList.h"
 #include "Yoga.h"
@@ -23,30 +39,88 @@ __forceinline const float fmaxf(const float a, const float b) {
 #endif
 #endif
 
+// State of a layout pass lives in thread locals and the counters shared by all trees are updated
+// atomically, so separate trees can be laid out on separate threads.
+#ifdef _MSC_VER
+#include <intrin.h>
+#define YG_THREAD_LOCAL __declspec(thread)
+#define YG_ATOMIC_ADD(value, delta) \
+  (_InterlockedExchangeAdd((volatile long *) &(value), (delta)) + (delta))
+#define YG_ATOMIC_LOAD(value) (*(volatile long *) &(value))
+#else
+#define YG_THREAD_LOCAL __thread
+#define YG_ATOMIC_ADD(value, delta) __atomic_add_fetch(&(value), (delta), __ATOMIC_RELAXED)
+#define YG_ATOMIC_LOAD(value) __atomic_load_n(&(value), __ATOMIC_RELAXED)
+#endif
+
+// Numeric type of the layout arithmetic, see YG_DOUBLE_PRECISION. Values are converted from and
+// to float at the public API boundary.
+#if YG_DOUBLE_PRECISION
+typedef double YGFloat;
+#define YGFloatMax fmax
+#define YGFloatMin fmin
+#define YGFloatFloor floor
+#define YGFloatRound round
+#define YGFloatEpsilon 1e-7
+#else
+typedef float YGFloat;
+#define YGFloatMax fmaxf
+#define YGFloatMin fminf
+#define YGFloatFloor floorf
+#define YGFloatRound roundf
+#define YGFloatEpsilon 0.0001f
+#endif
+
+// Available sizes, per axis, over which a layout result stays the same. An axis the result
+// depends on is narrowed to the single size it was computed for.
+typedef struct YGAvailableRange {
+  YGFloat min[2];
+  YGFloat max[2];
+} YGAvailableRange;
+
 typedef struct YGCachedMeasurement {
-  float availableWidth;
-  float availableHeight;
+  YGFloat availableWidth;
+  YGFloat availableHeight;
   YGMeasureMode widthMeasureMode;
   YGMeasureMode heightMeasureMode;
 
-  float computedWidth;
-  float computedHeight;
+  YGFloat computedWidth;
+  YGFloat computedHeight;
+
+  // Only meaningful for nodes without a measure function, see YGNodeCanReuseLayout.
+  YGAvailableRange range;
 } YGCachedMeasurement;
 
 // This value was chosen based on empiracle data. Even the most complicated
 // layouts should not require more than 16 entries to fit within the cache.
 #define YG_MAX_CACHED_RESULT_COUNT 16
 
+// Complete layouts of a container kept besides the single layout cache entry, enough for a
+// root alternating between the handful of sizes a render asks for.
+#define YG_MAX_CACHED_LAYOUT_COUNT 4
+
+// Arguments of the last layout pass that positioned a node.
+typedef struct YGLayoutRequest {
+  YGFloat availableWidth;
+  YGFloat availableHeight;
+  YGMeasureMode widthMeasureMode;
+  YGMeasureMode heightMeasureMode;
+  YGFloat parentWidth;
+  YGFloat parentHeight;
+  YGDirection parentDirection;
+  uint32_t generationCount;
+} YGLayoutRequest;
+
 typedef struct YGLayout {
-  float position[4];
-  float dimensions[2];
-  float margin[6];
-  float border[6];
-  float padding[6];
+  YGFloat position[4];
+  YGFloat dimensions[2];
+  YGFloat margin[6];
+  YGFloat border[6];
+  YGFloat padding[6];
   YGDirection direction;
 
   uint32_t computedFlexBasisGeneration;
-  float computedFlexBasis;
+  YGFloat computedFlexBasis;
 
   // Instead of recomputing the entire layout every single time, we
   // cache some information to break early when nothing changed
@@ -55,9 +129,16 @@ typedef struct YGLayout {
 
   uint32_t nextCachedMeasurementsIndex;
   YGCachedMeasurement cachedMeasurements[YG_MAX_CACHED_RESULT_COUNT];
-  float measuredDimensions[2];
+  YGFloat measuredDimensions[2];
 
   YGCachedMeasurement cachedLayout;
+  YGLayoutRequest lastLayoutRequest;
+  // Size the last layout pass gave the node, before rounding. A frozen node keeps reporting it.
+  YGFloat laidOutDimensions[2];
+
+  // Range of available sizes over which the last computed or reused result holds, read by the
+  // parent to narrow its own range.
+  YGAvailableRange availableRange;
 } YGLayout;
 
 typedef struct YGStyle {
@@ -87,6 +168,47 @@ typedef struct YGStyle {
   float aspectRatio;
 } YGStyle;
 
+typedef struct YGVirtualizedList *YGVirtualizedListRef;
+typedef struct YGLayoutCache *YGLayoutCacheRef;
+
+// State of the features a node may use besides flexbox layout. Nodes using none of them share
+// the read-only gYGNodeExtrasDefaults, so reads need no check; YGNodeGetExtras allocates a node
+// its own on the first write.
+typedef struct YGNodeExtras {
+  // Viewport and child sizes of a virtualized or streaming container.
+  YGVirtualizedListRef virtualized;
+  // Keeps its last layout instead of being laid out again, see YGNodeSetFrozen.
+  bool frozen;
+  // Sized by a deferred layout pass, with the positioning of its children still pending.
+  bool layoutDeferred;
+  // Position the parent gave the node in the last pass that laid it out, before rounding. A node
+  // laid out again on its own, without its parent, is rounded from it. Only kept apart from the
+  // rounded position when the two differ, see YGNodeSetUnroundedPosition.
+  YGFloat unroundedPosition[2];
+  // Index of the first earlier sibling with the same style, set by the parent as a hint for
+  // sharing layouts between identical siblings. Checked in full before it is relied on.
+  uint32_t instanceIndex;
+
+  // Size delivered by the parent's batch measure function, consumed by the next measurement
+  // of this node with the same constraints.
+  YGCachedMeasurement batchedMeasurement;
+
+  // Union of the frames of this node and all its descendants, relative to the node's own
+  // origin. Only computed for spatial queries and only for nodes visited by a layout pass since
+  // the last query.
+  uint32_t boundsGeneration;
+  YGFloat bounds[4];
+
+  // Depth-first index, absolute frame and subtree node count last reported by
+  // YGNodeEmitFrameDelta, and whether the node, or any of its children, was laid out since.
+  // Unlike hasNewLayout, which belongs to the host, only YGNodeEmitFrameDelta clears them.
+  uint32_t committedIndex;
+  uint32_t committedSubtreeCount;
+  YGFloat committedFrame[4];
+  bool frameChanged;
+  bool childFrameChanged;
+} YGNodeExtras;
+
 typedef struct YGNode {
   YGStyle style;
   YGLayout layout;
@@ -94,16 +216,35 @@ typedef struct YGNode {
 
   YGNodeRef parent;
   YGNodeListRef children;
+  YGNodeExtras *extras;
+  YGLayoutCacheRef layoutCache;
+  // Program compiled with this node as its root, while it is still valid.
+  YGLayoutProgramRef layoutProgram;
 
   struct YGNode *nextChild;
 
   YGMeasureFunc measure;
+  YGBatchMeasureFunc batchMeasure;
   YGBaselineFunc baseline;
   YGPrintFunc print;
   void *context;
 
   bool isDirty;
   bool hasNewLayout;
+  // Set on the ancestors of a dirty layout boundary, the path a layout pass has to walk down to
+  // reach it.
+  bool hasDirtyDescendant;
+  // Some style value is a percentage, making the layout depend on the size of the parent.
+  bool hasPercentStyle;
+  // Dirty, but its measurement caches were filled by YGNodeWarmup after the change and still
+  // hold for it.
+  bool cachesWarm;
+  // Bumped by every change that marks the node dirty, so a speculative layout can tell whether
+  // the live tree moved on.
+  uint32_t revision;
+  // Promises that nodes with the same measure function and key measure the same, see
+  // YGNodeSetMeasureKey.
+  uintptr_t measureKey;
 
   YGValue const *resolvedDimensions[2];
 } YGNode;
@@ -132,11 +273,30 @@ typedef struct YGNode {
 #define YG_DEFAULT_DIMENSION_VALUES_AUTO_UNIT \
 { [YGDimensionWidth] = YG_AUTO_VALUES, [YGDimensionHeight] = YG_AUTO_VALUES, }
 
+static const YGNodeExtras gYGNodeExtrasDefaults = {
+  .virtualized = NULL,
+  .instanceIndex = UINT32_MAX,
+
+  .batchedMeasurement =
+  {
+    .widthMeasureMode = (YGMeasureMode) -1,
+    .heightMeasureMode = (YGMeasureMode) -1,
+  },
+
+  .committedIndex = UINT32_MAX,
+  .frameChanged = true,
+  .childFrameChanged = true,
+};
+
 static YGNode gYGNodeDefaults = {
   .parent = NULL,
   .children = NULL,
+  .extras = (YGNodeExtras *) &gYGNodeExtrasDefaults,
+  .layoutCache = NULL,
+  .layoutProgram = NULL,
   .hasNewLayout = true,
   .isDirty = false,
+  .measureKey = 0,
   .resolvedDimensions = {[YGDimensionWidth] = &YGValueUndefined,
     [YGDimensionHeight] = &YGValueUndefined},
 
@@ -181,13 +341,118 @@ static YGNode gYGNodeDefaults = {
   },
 };
 
+static inline bool YGNodeHasExtras(const YGNodeRef node) {
+  return node->extras != &gYGNodeExtrasDefaults;
+}
+
+// Makes the next spatial query compute the bounds of the node again. Nodes without extras have
+// none computed.
+static inline void YGNodeInvalidateBounds(const YGNodeRef node) {
+  if (YGNodeHasExtras(node)) {
+    node->extras->boundsGeneration = node->layout.generationCount - 1;
+  }
+}
+
+// Flags the frame and the children of the node as changed since YGNodeEmitFrameDelta last
+// reported them. Nodes it never reported count as changed without extras.
+static inline void YGNodeMarkFrameChanged(const YGNodeRef node) {
+  if (YGNodeHasExtras(node)) {
+    node->extras->frameChanged = true;
+    node->extras->childFrameChanged = true;
+  }
+  if (node->parent != NULL && YGNodeHasExtras(node->parent)) {
+    node->parent->extras->childFrameChanged = true;
+  }
+}
+
+// Position of the node before rounding, on the horizontal (0) or vertical (1) axis.
+static inline YGFloat YGNodeGetUnroundedPosition(const YGNodeRef node, const uint32_t axis) {
+  if (YGNodeHasExtras(node)) {
+    return node->extras->unroundedPosition[axis];
+  }
+  return node->layout.position[axis == 0 ? YGEdgeLeft : YGEdgeTop];
+}
+
 static void YGNodeMarkDirtyInternal(const YGNodeRef node);
 
+// Flags a node the pass wrote a layout to, for the host and for YGNodeEmitFrameDelta.
+static inline void YGNodeSetNewLayout(const YGNodeRef node) {
+  node->hasNewLayout = true;
+  if (YGNodeHasExtras(node)) {
+    node->extras->frameChanged = true;
+  }
+  if (node->parent != NULL && YGNodeHasExtras(node->parent)) {
+    node->parent->extras->childFrameChanged = true;
+  }
+}
+
+// Nodes whose children still wait to be positioned, and while a deferred pass runs the node
+// being laid out in full. A tree is deferred and resolved by the thread owning it, so the count
+// only covers the trees of the calling thread.
+static YG_THREAD_LOCAL uint32_t gDeferredLayoutCount = 0;
+static YG_THREAD_LOCAL YGNodeRef gDeferredLayoutRoot = NULL;
+
+// Set while YGNodeCalculateLayoutMulti or YGNodeWarmup runs so windows of virtual children stay
+// as they are.
+static YG_THREAD_LOCAL bool gVirtualWindowsPinned = false;
+
+static void YGNodeResolveDeferredPath(const YGNodeRef node);
+
+static inline void YGNodeResolveDeferredLayout(const YGNodeRef node) {
+  if (gDeferredLayoutCount > 0) {
+    YGNodeResolveDeferredPath(node);
+  }
+}
+
+// Compiled layout programs that are still valid.
+static uint32_t gLayoutProgramCount = 0;
+
+static void YGLayoutProgramInvalidatePath(YGNodeRef node);
+
+// Structure and style changes invalidate the programs compiled for the trees the node is in.
+static inline void YGNodeInvalidateLayoutProgram(const YGNodeRef node) {
+  if (YG_ATOMIC_LOAD(gLayoutProgramCount) > 0) {
+    YGLayoutProgramInvalidatePath(node);
+  }
+}
+
 YGMalloc gYGMalloc = &malloc;
 YGCalloc gYGCalloc = &calloc;
 YGRealloc gYGRealloc = &realloc;
 YGFree gYGFree = &free;
 
+// Extras of the node to write to, allocated on the first write.
+static YGNodeExtras *YGNodeGetExtras(const YGNodeRef node) {
+  if (!YGNodeHasExtras(node)) {
+    YGNodeExtras *const extras = gYGMalloc(sizeof(YGNodeExtras));
+    YG_ASSERT(extras, "Could not allocate memory for node");
+    *extras = gYGNodeExtrasDefaults;
+    extras->unroundedPosition[0] = node->layout.position[YGEdgeLeft];
+    extras->unroundedPosition[1] = node->layout.position[YGEdgeTop];
+    node->extras = extras;
+  }
+  return node->extras;
+}
+
+static void YGNodeFreeExtras(const YGNodeRef node) {
+  if (YGNodeHasExtras(node)) {
+    gYGFree(node->extras);
+    node->extras = (YGNodeExtras *) &gYGNodeExtrasDefaults;
+  }
+}
+
+// A position in whole points is its own rounding, which the node keeps in its layout, so only a
+// fractional one needs extras.
+static void YGNodeSetUnroundedPosition(const YGNodeRef node,
+                                       const YGFloat left,
+                                       const YGFloat top) {
+  if (YGNodeHasExtras(node) || left != YGFloatRound(left) || top != YGFloatRound(top)) {
+    YGNodeExtras *const extras = YGNodeGetExtras(node);
+    extras->unroundedPosition[0] = left;
+    extras->unroundedPosition[1] = top;
+  }
+}
+
 static YGValue YGValueZero = {.value = 0, .unit = YGUnitPoint};
 
 #ifdef ANDROID
@@ -261,7 +526,7 @@ static inline const YGValue *YGComputedEdgeValue(const YGValue edges[YGEdgeCount
   return defaultValue;
 }
 
-static inline float YGValueResolve(const YGValue *const value, const float parentSize) {
+static inline YGFloat YGValueResolve(const YGValue *const value, const YGFloat parentSize) {
   switch (value->unit) {
     case YGUnitUndefined:
     case YGUnitAuto:
@@ -274,24 +539,289 @@ static inline float YGValueResolve(const YGValue *const value, const float paren
   return YGUndefined;
 }
 
-static inline float YGValueResolveMargin(const YGValue *const value, const float parentSize) {
+static inline YGFloat YGValueResolveMargin(const YGValue *const value, const YGFloat parentSize) {
   return value->unit == YGUnitAuto ? 0 : YGValueResolve(value, parentSize);
 }
 
+// Main-axis bookkeeping of a virtualized container. Every child that has been laid out keeps
+// its outer main-axis size here, the others count with the average known size. Both the known
+// sizes and how many of them are known are kept in Fenwick trees so the offset of any child can
+// be found in O(log n) without visiting the children before it.
+typedef struct YGVirtualizedList {
+  YGFloat viewportStart;
+  YGFloat viewportLength;
+  YGFlexDirection mainAxis;
+  bool needsRebuild;
+
+  uint32_t count;
+  uint32_t capacity;
+  YGFloat *sizes;
+  double *knownSizeTree;
+  uint32_t *knownCountTree;
+  double knownSizeTotal;
+  uint32_t knownCountTotal;
+
+  // Largest cross-axis size seen so far, used to size the container on its cross axis.
+  YGFloat maxCrossSize;
+
+  // Children laid out by the last pass, [firstVisible, endVisible).
+  uint32_t firstVisible;
+  uint32_t endVisible;
+
+  // Data source of virtual children (see YGNodeSetVirtualChildren). The container's child list
+  // then only holds the window, the first of them being child firstMaterialized, and
+  // firstVisible and endVisible index that list.
+  YGChildCountFunc countFunc;
+  YGChildFunc childFunc;
+  YGRecycleChildFunc recycleFunc;
+  uint32_t firstMaterialized;
+
+  // Streaming containers (see YGNodeSetStreaming) keep no per-child sizes and lay out from the
+  // head again when needsRebuild is set. The first laidOutCount children were laid out with the
+  // constraints below and span laidOutExtent, after the retiredExtent of the retired ones.
+  bool streaming;
+  uint32_t laidOutCount;
+  YGFloat laidOutExtent;
+  double retiredExtent;
+  YGFloat laidOutInnerWidth;
+  YGFloat laidOutInnerHeight;
+  YGFloat laidOutParentWidth;
+  YGDirection laidOutDirection;
+} YGVirtualizedList;
+
+static inline uint32_t YGLowestBit(const uint32_t index) {
+  return index & (0u - index);
+}
+
+static void YGVirtualizedListFree(const YGVirtualizedListRef list) {
+  if (list) {
+    gYGFree(list->sizes);
+    gYGFree(list->knownSizeTree);
+    gYGFree(list->knownCountTree);
+    gYGFree(list);
+  }
+}
+
+static void YGVirtualizedListReserve(const YGVirtualizedListRef list, const uint32_t count) {
+  if (count <= list->capacity) {
+    return;
+  }
+
+  uint32_t capacity = list->capacity == 0 ? 16 : list->capacity;
+  while (capacity < count) {
+    capacity *= 2;
+  }
+  list->sizes = gYGRealloc(list->sizes, sizeof(YGFloat) * capacity);
+  list->knownSizeTree = gYGRealloc(list->knownSizeTree, sizeof(double) * (capacity + 1));
+  list->knownCountTree = gYGRealloc(list->knownCountTree, sizeof(uint32_t) * (capacity + 1));
+  YG_ASSERT(list->sizes != NULL && list->knownSizeTree != NULL && list->knownCountTree != NULL,
+            "Could not extend allocation for virtualized list");
+  list->capacity = capacity;
+}
+
+// Rebuilds both trees from the sizes array in O(n).
+static void YGVirtualizedListBuildTrees(const YGVirtualizedListRef list) {
+  list->knownSizeTotal = 0;
+  list->knownCountTotal = 0;
+  for (uint32_t i = 1; i <= list->count; i++) {
+    const YGFloat size = list->sizes[i - 1];
+    const bool known = !YGFloatIsUndefined(size);
+    list->knownSizeTree[i] = known ? size : 0;
+    list->knownCountTree[i] = known ? 1 : 0;
+    list->knownSizeTotal += list->knownSizeTree[i];
+    list->knownCountTotal += list->knownCountTree[i];
+  }
+
+  for (uint32_t i = 1; i <= list->count; i++) {
+    const uint32_t parent = i + YGLowestBit(i);
+    if (parent <= list->count) {
+      list->knownSizeTree[parent] += list->knownSizeTree[i];
+      list->knownCountTree[parent] += list->knownCountTree[i];
+    }
+  }
+}
+
+// Sums of the known sizes and of the known count over the first `count` children.
+static void YGVirtualizedListPrefix(const YGVirtualizedListRef list,
+                                    uint32_t count,
+                                    double *knownSize,
+                                    uint32_t *knownCount) {
+  *knownSize = 0;
+  *knownCount = 0;
+  for (; count > 0; count -= YGLowestBit(count)) {
+    *knownSize += list->knownSizeTree[count];
+    *knownCount += list->knownCountTree[count];
+  }
+}
+
+// Appends a child whose size is not known yet.
+static void YGVirtualizedListAppend(const YGVirtualizedListRef list) {
+  YGVirtualizedListReserve(list, list->count + 1);
+  list->sizes[list->count] = YGUndefined;
+  list->count++;
+
+  // The new tree slot covers (index - lowestBit, index], of which only the new child is
+  // missing from the existing prefixes.
+  const uint32_t index = list->count;
+  double size, coveredSize;
+  uint32_t count, coveredCount;
+  YGVirtualizedListPrefix(list, index - 1, &size, &count);
+  YGVirtualizedListPrefix(list, index - YGLowestBit(index), &coveredSize, &coveredCount);
+  list->knownSizeTree[index] = size - coveredSize;
+  list->knownCountTree[index] = count - coveredCount;
+}
+
+static void YGVirtualizedListSetSize(const YGVirtualizedListRef list,
+                                     const uint32_t index,
+                                     const YGFloat size) {
+  if (list->streaming) {
+    return;
+  }
+
+  const YGFloat oldSize = list->sizes[index];
+  const double sizeDelta =
+      (YGFloatIsUndefined(size) ? 0 : size) - (YGFloatIsUndefined(oldSize) ? 0 : oldSize);
+  const int32_t countDelta =
+      (YGFloatIsUndefined(size) ? 0 : 1) - (YGFloatIsUndefined(oldSize) ? 0 : 1);
+  list->sizes[index] = size;
+  if (sizeDelta == 0 && countDelta == 0) {
+    return;
+  }
+
+  list->knownSizeTotal += sizeDelta;
+  list->knownCountTotal += countDelta;
+  for (uint32_t i = index + 1; i <= list->count; i += YGLowestBit(i)) {
+    list->knownSizeTree[i] += sizeDelta;
+    list->knownCountTree[i] += countDelta;
+  }
+}
+
+// Estimated distance from the start of the first child to the start of child `index`.
+static YGFloat YGVirtualizedListOffset(const YGVirtualizedListRef list, const uint32_t index) {
+  double knownSize;
+  uint32_t knownCount;
+  YGVirtualizedListPrefix(list, index, &knownSize, &knownCount);
+  const double estimate =
+      list->knownCountTotal > 0 ? list->knownSizeTotal / list->knownCountTotal : 0;
+  return knownSize + (index - knownCount) * estimate;
+}
+
+// Index of the first child that ends after `offset`, clamped to the last child.
+static uint32_t YGVirtualizedListIndexAt(const YGVirtualizedListRef list, const YGFloat offset) {
+  if (list->knownCountTotal == 0) {
+    return 0;
+  }
+
+  uint32_t low = 0;
+  uint32_t high = list->count - 1;
+  while (low < high) {
+    const uint32_t mid = low + (high - low) / 2;
+    if (YGVirtualizedListOffset(list, mid + 1) > offset) {
+      high = mid;
+    } else {
+      low = mid + 1;
+    }
+  }
+  return low;
+}
+
+// Position of a child and the request it was laid out with, as left by one layout of its parent.
+typedef struct YGCachedChildLayout {
+  YGFloat position[4];
+  YGLayoutRequest request;
+} YGCachedChildLayout;
+
+typedef struct YGCachedLayoutEntry {
+  YGCachedMeasurement measurement;
+  YGDirection direction;
+  YGFloat margin[6];
+  YGFloat border[6];
+  YGFloat padding[6];
+
+  uint32_t childCount;
+  uint32_t childCapacity;
+  YGCachedChildLayout *children;
+} YGCachedLayoutEntry;
+
+// Layouts of a container for the last few distinct constraints it was laid out with. Unlike the
+// single cachedLayout entry these keep where every child went, so going back to one of the
+// constraints only replays the children's own (cached) layouts instead of the flex algorithm.
+typedef struct YGLayoutCache {
+  uint32_t count;
+  uint32_t next;
+  YGCachedLayoutEntry entries[YG_MAX_CACHED_LAYOUT_COUNT];
+} YGLayoutCache;
+
+static void YGLayoutCacheFree(const YGLayoutCacheRef cache) {
+  if (cache) {
+    for (uint32_t i = 0; i < YG_MAX_CACHED_LAYOUT_COUNT; i++) {
+      gYGFree(cache->entries[i].children);
+    }
+    gYGFree(cache);
+  }
+}
+
+// Makes the layout cache of the node hold copies of the given entries, reusing its allocations.
+static void YGLayoutCacheAssign(const YGNodeRef node,
+                                const YGCachedLayoutEntry *const entries,
+                                const uint32_t count,
+                                const uint32_t next) {
+  if (count > 0 && node->layoutCache == NULL) {
+    node->layoutCache = gYGCalloc(1, sizeof(YGLayoutCache));
+    YG_ASSERT(node->layoutCache, "Could not allocate memory for layout cache");
+  }
+  if (node->layoutCache == NULL) {
+    return;
+  }
+
+  const YGLayoutCacheRef cache = node->layoutCache;
+  cache->count = count;
+  cache->next = next;
+  for (uint32_t i = 0; i < count; i++) {
+    YGCachedLayoutEntry *const entry = &cache->entries[i];
+    if (entry->childCapacity < entries[i].childCount) {
+      entry->children =
+          gYGRealloc(entry->children, sizeof(YGCachedChildLayout) * entries[i].childCount);
+      YG_ASSERT(entry->children, "Could not extend allocation for layout cache");
+      entry->childCapacity = entries[i].childCount;
+    }
+    YGCachedChildLayout *const children = entry->children;
+    const uint32_t childCapacity = entry->childCapacity;
+    *entry = entries[i];
+    entry->children = children;
+    entry->childCapacity = childCapacity;
+    memcpy(children, entries[i].children, sizeof(YGCachedChildLayout) * entries[i].childCount);
+  }
+}
+
+// Dirty flags stop at nodes that are already dirty, which nodes in a display: none subtree stay,
+// so structural changes clear the subtree counts YGNodeEmitFrameDelta skips subtrees with on
+// their own.
+static void YGNodeInvalidateCommittedSubtree(YGNodeRef node) {
+  for (; node != NULL && node->extras->committedSubtreeCount != 0; node = node->parent) {
+    node->extras->committedSubtreeCount = 0;
+  }
+}
+
 int32_t gNodeInstanceCount = 0;
 
 YGNodeRef YGNodeNew(void) {
   const YGNodeRef node = gYGMalloc(sizeof(YGNode));
   YG_ASSERT(node, "Could not allocate memory for node");
-  gNodeInstanceCount++;
+  YG_ATOMIC_ADD(gNodeInstanceCount, 1);
 
   memcpy(node, &gYGNodeDefaults, sizeof(YGNode));
   return node;
 }
 
 void YGNodeFree(const YGNodeRef node) {
+  YGNodeInvalidateLayoutProgram(node);
   if (node->parent) {
     YGNodeListDelete(node->parent->children, node);
+    if (node->parent->extras->virtualized) {
+      node->parent->extras->virtualized->needsRebuild = true;
+    }
+    YGNodeInvalidateCommittedSubtree(node->parent);
     node->parent = NULL;
   }
 
@@ -301,9 +831,16 @@ void YGNodeFree(const YGNodeRef node) {
     child->parent = NULL;
   }
 
+  if (node->extras->layoutDeferred) {
+    gDeferredLayoutCount--;
+  }
+
   YGNodeListFree(node->children);
+  YGVirtualizedListFree(node->extras->virtualized);
+  YGNodeFreeExtras(node);
+  YGLayoutCacheFree(node->layoutCache);
   gYGFree(node);
-  gNodeInstanceCount--;
+  YG_ATOMIC_ADD(gNodeInstanceCount, -1);
 }
 
 void YGNodeFreeRecursive(const YGNodeRef root) {
@@ -320,22 +857,116 @@ void YGNodeReset(const YGNodeRef node) {
             "Cannot reset a node which still has children attached");
   YG_ASSERT(node->parent == NULL, "Cannot reset a node still attached to a parent");
 
+  YGNodeInvalidateLayoutProgram(node);
+  if (node->extras->layoutDeferred) {
+    gDeferredLayoutCount--;
+  }
+
   YGNodeListFree(node->children);
+  YGVirtualizedListFree(node->extras->virtualized);
+  YGNodeFreeExtras(node);
+  YGLayoutCacheFree(node->layoutCache);
   memcpy(node, &gYGNodeDefaults, sizeof(YGNode));
 }
 
 int32_t YGNodeGetInstanceCount(void) {
-  return gNodeInstanceCount;
+  return YG_ATOMIC_LOAD(gNodeInstanceCount);
+}
+
+// A node whose size does not depend on its content: both dimensions are given in points and no
+// ancestor can read its baseline. Changes inside it cannot move anything outside it.
+static bool YGNodeIsLayoutBoundary(const YGNodeRef node) {
+  if (node->parent == NULL) {
+    return false;
+  }
+
+  // Percentages count as content sized, they fall back to it when the parent's size is not known.
+  if (node->style.dimensions[YGDimensionWidth].unit != YGUnitPoint ||
+      node->style.dimensions[YGDimensionHeight].unit != YGUnitPoint) {
+    return false;
+  }
+
+  // The baseline of a container is the one of a child in its first line, see YGBaseline, so an
+  // ancestor aligned by its baseline reads the node's through every container in between. Any
+  // child not positioned absolutely may be that child once the lines are broken again.
+  for (YGNodeRef child = node; child->parent != NULL; child = child->parent) {
+    const YGNodeRef parent = child->parent;
+    const YGAlign align =
+        child->style.alignSelf == YGAlignAuto ? parent->style.alignItems : child->style.alignSelf;
+    if (align == YGAlignBaseline) {
+      return false;
+    }
+    if (parent->baseline != NULL || child->style.positionType == YGPositionTypeAbsolute) {
+      break;
+    }
+  }
+  return true;
 }
 
+// Marks a node dirty because its content changed. Dirtiness travels up to the root, except past
+// a layout boundary: above one only the path down to it is flagged. Nodes below a deferred one
+// were only measured and stay dirty, so while any are deferred it is not cut short at nodes
+// that are already dirty.
 static void YGNodeMarkDirtyInternal(const YGNodeRef node) {
-  if (!node->isDirty) {
+  node->revision++;
+  if (!node->isDirty || node->cachesWarm || gDeferredLayoutCount > 0) {
     node->isDirty = true;
+    node->cachesWarm = false;
     node->layout.computedFlexBasis = YGUndefined;
+    if (YGNodeHasExtras(node)) {
+      node->extras->batchedMeasurement.widthMeasureMode = (YGMeasureMode) -1;
+    }
     if (node->parent) {
-      YGNodeMarkDirtyInternal(node->parent);
+      // A streaming container lays out from the head again once a child it laid out changes.
+      const YGVirtualizedListRef list = node->parent->extras->virtualized;
+      if (list != NULL && list->streaming && node->layout.generationCount != 0) {
+        list->needsRebuild = true;
+      }
+      if (YGNodeIsLayoutBoundary(node)) {
+        for (YGNodeRef ancestor = node->parent;
+             ancestor != NULL && !ancestor->hasDirtyDescendant;
+             ancestor = ancestor->parent) {
+          ancestor->hasDirtyDescendant = true;
+        }
+      } else {
+        YGNodeMarkDirtyInternal(node->parent);
+      }
+    }
+  }
+}
+
+static bool YGStyleHasPercent(const YGStyle *const style) {
+  if (style->flexBasis.unit == YGUnitPercent) {
+    return true;
+  }
+  for (YGEdge edge = YGEdgeLeft; edge < YGEdgeCount; edge++) {
+    if (style->margin[edge].unit == YGUnitPercent || style->position[edge].unit == YGUnitPercent ||
+        style->padding[edge].unit == YGUnitPercent || style->border[edge].unit == YGUnitPercent) {
+      return true;
+    }
+  }
+  for (YGDimension dim = YGDimensionWidth; dim <= YGDimensionHeight; dim++) {
+    if (style->dimensions[dim].unit == YGUnitPercent ||
+        style->minDimensions[dim].unit == YGUnitPercent ||
+        style->maxDimensions[dim].unit == YGUnitPercent) {
+      return true;
     }
   }
+  return false;
+}
+
+// Marks a node dirty because its own style changed, which can change how its parent places it
+// even when it is a layout boundary.
+static void YGNodeMarkStyleDirty(const YGNodeRef node) {
+  YGNodeInvalidateLayoutProgram(node);
+  node->hasPercentStyle = YGStyleHasPercent(&node->style);
+  if (node->extras->virtualized != NULL && node->extras->virtualized->streaming) {
+    node->extras->virtualized->needsRebuild = true;
+  }
+  YGNodeMarkDirtyInternal(node);
+  if (node->parent) {
+    YGNodeMarkDirtyInternal(node->parent);
+  }
 }
 
 void YGNodeSetMeasureFunc(const YGNodeRef node, YGMeasureFunc measureFunc) {
@@ -362,18 +993,222 @@ void YGNodeInsertChild(const YGNodeRef node, const YGNodeRef child, const uint32
   YG_ASSERT(child->parent == NULL, "Child already has a parent, it must be removed first.");
   YG_ASSERT(node->measure == NULL,
             "Cannot add child: Nodes with measure functions cannot have children.");
+  YG_ASSERT(node->extras->virtualized == NULL || node->extras->virtualized->childFunc == NULL,
+            "Cannot add child: Nodes with virtual children get them from their data source.");
+  YGNodeInvalidateLayoutProgram(node);
   YGNodeListInsert(&node->children, child, index);
   child->parent = node;
+  if (node->extras->virtualized) {
+    // Appending keeps the known sizes, anything else shifts them.
+    if (node->extras->virtualized->streaming) {
+      if (index + 1 != YGNodeListCount(node->children)) {
+        node->extras->virtualized->needsRebuild = true;
+      }
+    } else if (!node->extras->virtualized->needsRebuild &&
+               index == node->extras->virtualized->count) {
+      YGVirtualizedListAppend(node->extras->virtualized);
+    } else {
+      node->extras->virtualized->needsRebuild = true;
+    }
+  }
+  YGNodeInvalidateCommittedSubtree(node);
   YGNodeMarkDirtyInternal(node);
 }
 
 void YGNodeRemoveChild(const YGNodeRef node, const YGNodeRef child) {
   if (YGNodeListDelete(node->children, child) != NULL) {
+    YGNodeInvalidateLayoutProgram(node);
     child->parent = NULL;
+    if (node->extras->virtualized) {
+      node->extras->virtualized->needsRebuild = true;
+    }
+    YGNodeInvalidateCommittedSubtree(node);
     YGNodeMarkDirtyInternal(node);
   }
 }
 
+// Takes the window of virtual children off the container so a new one can be built with
+// YGVirtualWindowAdd. Returns the old window for YGVirtualWindowEnd.
+static YGNodeListRef YGVirtualWindowBegin(const YGNodeRef node) {
+  const YGNodeListRef window = node->children;
+  node->children = NULL;
+  return window;
+}
+
+// Asks the data source for the child at index. It may be a recycled node laid out for other data
+// before, so its own layout is not trusted.
+static YGNodeRef YGVirtualChildFetch(const YGNodeRef node, const uint32_t index) {
+  const YGNodeRef child = node->extras->virtualized->childFunc(node, index);
+  YG_ASSERT(child != NULL, "Data source returned no child");
+  YG_ASSERT(child->parent == NULL, "Data source returned a child that already has a parent");
+  YGNodeMarkDirtyInternal(child);
+  child->parent = node;
+  return child;
+}
+
+// Appends the child at index to the new window, taken from the old window when it was already
+// there and from the data source otherwise.
+static YGNodeRef YGVirtualWindowAdd(const YGNodeRef node,
+                                    const YGNodeListRef previousWindow,
+                                    const uint32_t index) {
+  const YGVirtualizedListRef list = node->extras->virtualized;
+  YGNodeRef child;
+  if (index >= list->firstMaterialized &&
+      index - list->firstMaterialized < YGNodeListCount(previousWindow)) {
+    child = YGNodeListGet(previousWindow, index - list->firstMaterialized);
+  } else {
+    child = YGVirtualChildFetch(node, index);
+  }
+  YGNodeListAdd(&node->children, child);
+  return child;
+}
+
+// Recycles the children of the old window outside of the new one, [firstIndex, endIndex).
+static void YGVirtualWindowEnd(const YGNodeRef node,
+                               const YGNodeListRef previousWindow,
+                               const uint32_t firstIndex,
+                               const uint32_t endIndex) {
+  const YGVirtualizedListRef list = node->extras->virtualized;
+  const uint32_t previousCount = YGNodeListCount(previousWindow);
+  for (uint32_t i = 0; i < previousCount; i++) {
+    const uint32_t index = list->firstMaterialized + i;
+    if (index < firstIndex || index >= endIndex) {
+      const YGNodeRef child = YGNodeListGet(previousWindow, i);
+      child->parent = NULL;
+      if (list->recycleFunc != NULL) {
+        list->recycleFunc(node, child);
+      }
+    }
+  }
+  YGNodeListFree(previousWindow);
+  list->firstMaterialized = firstIndex;
+}
+
+static void YGVirtualWindowMaterialize(const YGNodeRef node,
+                                       const uint32_t firstIndex,
+                                       const uint32_t endIndex) {
+  const YGNodeListRef previousWindow = YGVirtualWindowBegin(node);
+  for (uint32_t i = firstIndex; i < endIndex; i++) {
+    YGVirtualWindowAdd(node, previousWindow, i);
+  }
+  YGVirtualWindowEnd(node, previousWindow, firstIndex, endIndex);
+}
+
+void YGNodeSetVirtualChildren(const YGNodeRef node,
+                              YGChildCountFunc countFunc,
+                              YGChildFunc childFunc,
+                              YGRecycleChildFunc recycleFunc) {
+  YG_ASSERT(node->extras->virtualized != NULL && !node->extras->virtualized->streaming,
+            "Virtual children need a virtualized container");
+  YG_ASSERT((countFunc == NULL) == (childFunc == NULL),
+            "Virtual children need both a count and a child function");
+  const YGVirtualizedListRef list = node->extras->virtualized;
+  if (list->childFunc != NULL) {
+    // Whatever the window holds may stand for other data now.
+    YGVirtualWindowMaterialize(node, 0, 0);
+  } else {
+    YG_ASSERT(YGNodeListCount(node->children) == 0,
+              "Cannot use virtual children: Node already has children.");
+  }
+
+  YGNodeInvalidateLayoutProgram(node);
+  // Sizes known from an earlier data source keep serving as estimates.
+  list->needsRebuild = list->needsRebuild || list->childFunc == NULL;
+  list->countFunc = countFunc;
+  list->childFunc = childFunc;
+  list->recycleFunc = recycleFunc;
+  list->firstMaterialized = 0;
+  list->firstVisible = 0;
+  list->endVisible = 0;
+  YGNodeInvalidateCommittedSubtree(node);
+  YGNodeMarkDirtyInternal(node);
+}
+
+void YGNodeSetVirtualized(const YGNodeRef node,
+                          const float viewportStart,
+                          const float viewportLength) {
+  YG_ASSERT(node->extras->virtualized == NULL || !node->extras->virtualized->streaming,
+            "Cannot virtualize a streaming container");
+  YGNodeInvalidateLayoutProgram(node);
+  if (YGFloatIsUndefined(viewportLength)) {
+    if (node->extras->virtualized) {
+      if (node->extras->virtualized->childFunc != NULL) {
+        YGVirtualWindowMaterialize(node, 0, 0);
+        YGNodeInvalidateCommittedSubtree(node);
+      }
+      YGVirtualizedListFree(node->extras->virtualized);
+      node->extras->virtualized = NULL;
+      YGNodeMarkDirtyInternal(node);
+    }
+    return;
+  }
+
+  if (node->extras->virtualized == NULL) {
+    YGNodeExtras *const extras = YGNodeGetExtras(node);
+    extras->virtualized = gYGCalloc(1, sizeof(YGVirtualizedList));
+    YG_ASSERT(extras->virtualized, "Could not allocate memory for virtualized list");
+    extras->virtualized->needsRebuild = true;
+  } else if (node->extras->virtualized->viewportStart == viewportStart &&
+             node->extras->virtualized->viewportLength == viewportLength) {
+    return;
+  }
+
+  node->extras->virtualized->viewportStart = viewportStart;
+  node->extras->virtualized->viewportLength = viewportLength;
+  YGNodeMarkDirtyInternal(node);
+}
+
+void YGNodeSetStreaming(const YGNodeRef node, const bool streaming) {
+  YG_ASSERT(node->extras->virtualized == NULL || node->extras->virtualized->streaming,
+            "Cannot stream a virtualized container");
+  if (streaming == (node->extras->virtualized != NULL)) {
+    return;
+  }
+
+  YGNodeInvalidateLayoutProgram(node);
+  if (streaming) {
+    YGNodeExtras *const extras = YGNodeGetExtras(node);
+    extras->virtualized = gYGCalloc(1, sizeof(YGVirtualizedList));
+    YG_ASSERT(extras->virtualized, "Could not allocate memory for streaming list");
+    extras->virtualized->streaming = true;
+    extras->virtualized->needsRebuild = true;
+  } else {
+    YGVirtualizedListFree(node->extras->virtualized);
+    node->extras->virtualized = NULL;
+  }
+  YGNodeMarkDirtyInternal(node);
+}
+
+void YGNodeRetireChildren(const YGNodeRef node, const uint32_t count) {
+  const YGVirtualizedListRef list = node->extras->virtualized;
+  YG_ASSERT(list != NULL && list->streaming, "Only streaming containers retire children");
+  YG_ASSERT(count <= list->laidOutCount, "Cannot retire children that were not laid out");
+
+  // Streaming only applies to forward main axes.
+  const bool isMainAxisRow = list->mainAxis == YGFlexDirectionRow;
+  YGFloat extent = 0;
+  for (uint32_t i = 0; i < count; i++) {
+    const YGNodeRef child = YGNodeListGet(node->children, i);
+    if (child->style.display != YGDisplayNone &&
+        child->style.positionType != YGPositionTypeAbsolute) {
+      const YGFloat *const margin = child->layout.margin;
+      extent += isMainAxisRow ? child->layout.measuredDimensions[YGDimensionWidth] +
+                                    margin[YGEdgeStart] + margin[YGEdgeEnd]
+                              : child->layout.measuredDimensions[YGDimensionHeight] +
+                                    margin[YGEdgeTop] + margin[YGEdgeBottom];
+    }
+    child->parent = NULL;
+  }
+  YGNodeListRemoveRange(node->children, 0, count);
+
+  // The container keeps its size and the remaining children their positions.
+  list->retiredExtent += extent;
+  list->laidOutExtent -= extent;
+  list->laidOutCount -= count;
+  YGNodeInvalidateLayoutProgram(node);
+  YGNodeInvalidateCommittedSubtree(node);
+}
+
 YGNodeRef YGNodeGetChild(const YGNodeRef node, const uint32_t index) {
   return YGNodeListGet(node->children, index);
 }
@@ -394,13 +1229,51 @@ void YGNodeMarkDirty(const YGNodeRef node) {
 }
 
 bool YGNodeIsDirty(const YGNodeRef node) {
-  return node->isDirty;
+  // Above a dirty layout boundary only the path down to it is flagged, but it needs a layout all
+  // the same.
+  return node->isDirty || node->hasDirtyDescendant;
+}
+
+void YGNodeSetFrozen(const YGNodeRef node, const bool frozen) {
+  if (node->extras->frozen == frozen) {
+    return;
+  }
+
+  YGNodeGetExtras(node)->frozen = frozen;
+  YGNodeInvalidateLayoutProgram(node);
+  if (frozen) {
+    // The parent cached what the node gave for other constraints, which no longer holds.
+    if (node->parent) {
+      YGNodeMarkDirtyInternal(node->parent);
+    }
+  } else {
+    YGNodeMarkDirtyInternal(node);
+  }
+}
+
+bool YGNodeIsFrozen(const YGNodeRef node) {
+  return node->extras->frozen;
+}
+
+void YGNodeSetMeasureKey(const YGNodeRef node, const uintptr_t measureKey) {
+  if (node->measureKey == measureKey) {
+    return;
+  }
+
+  node->measureKey = measureKey;
+  if (node->measure != NULL) {
+    YGNodeMarkDirtyInternal(node);
+  }
+}
+
+uintptr_t YGNodeGetMeasureKey(const YGNodeRef node) {
+  return node->measureKey;
 }
 
 void YGNodeCopyStyle(const YGNodeRef dstNode, const YGNodeRef srcNode) {
   if (memcmp(&dstNode->style, &srcNode->style, sizeof(YGStyle)) != 0) {
     memcpy(&dstNode->style, &srcNode->style, sizeof(YGStyle));
-    YGNodeMarkDirtyInternal(dstNode);
+    YGNodeMarkStyleDirty(dstNode);
   }
 }
 
@@ -441,7 +1314,7 @@ inline YGValue YGNodeStyleGetFlexBasis(const YGNodeRef node) {
 void YGNodeStyleSetFlex(const YGNodeRef node, const float flex) {
   if (node->style.flex != flex) {
     node->style.flex = flex;
-    YGNodeMarkDirtyInternal(node);
+    YGNodeMarkStyleDirty(node);
   }
 }
 
@@ -458,7 +1331,7 @@ return node->instanceName;                                     \
 void YGNodeStyleSet##name(const YGNodeRef node, const type paramName) {       \
 if (node->style.instanceName != paramName) {                                \
 node->style.instanceName = paramName;                                     \
-YGNodeMarkDirtyInternal(node);                                            \
+YGNodeMarkStyleDirty(node);                                               \
 }                                                                           \
 }
 
@@ -469,7 +1342,7 @@ node->style.instanceName.unit != YGUnitPoint) {                              \
 node->style.instanceName.value = paramName;                                    \
 node->style.instanceName.unit =                                                \
 YGFloatIsUndefined(paramName) ? YGUnitAuto : YGUnitPoint;                  \
-YGNodeMarkDirtyInternal(node);                                                 \
+YGNodeMarkStyleDirty(node);                                                    \
 }                                                                                \
 }                                                                                  \
 \
@@ -479,7 +1352,7 @@ node->style.instanceName.unit != YGUnitPercent) {                            \
 node->style.instanceName.value = paramName;                                    \
 node->style.instanceName.unit =                                                \
 YGFloatIsUndefined(paramName) ? YGUnitAuto : YGUnitPercent;                \
-YGNodeMarkDirtyInternal(node);                                                 \
+YGNodeMarkStyleDirty(node);                                                    \
 }                                                                                \
 }
 
@@ -489,7 +1362,7 @@ if (node->style.instanceName.value != paramName ||
 node->style.instanceName.unit != YGUnitPoint) {                                           \
 node->style.instanceName.value = paramName;                                                 \
 node->style.instanceName.unit = YGFloatIsUndefined(paramName) ? YGUnitAuto : YGUnitPoint;   \
-YGNodeMarkDirtyInternal(node);                                                              \
+YGNodeMarkStyleDirty(node);                                                                 \
 }                                                                                             \
 }                                                                                               \
 \
@@ -498,7 +1371,7 @@ if (node->style.instanceName.value != paramName ||
 node->style.instanceName.unit != YGUnitPercent) {                                         \
 node->style.instanceName.value = paramName;                                                 \
 node->style.instanceName.unit = YGFloatIsUndefined(paramName) ? YGUnitAuto : YGUnitPercent; \
-YGNodeMarkDirtyInternal(node);                                                              \
+YGNodeMarkStyleDirty(node);                                                                 \
 }                                                                                             \
 }                                                                                               \
 \
@@ -506,7 +1379,7 @@ void YGNodeStyleSet##name##Auto(const YGNodeRef node) {
 if (node->style.instanceName.unit != YGUnitAuto) {                                            \
 node->style.instanceName.value = YGUndefined;                                               \
 node->style.instanceName.unit = YGUnitAuto;                                                 \
-YGNodeMarkDirtyInternal(node);                                                              \
+YGNodeMarkStyleDirty(node);                                                                 \
 }                                                                                             \
 }
 
@@ -536,7 +1409,7 @@ void YGNodeStyleSet##name##Auto(const YGNodeRef node, const YGEdge edge) { \
 if (node->style.instanceName[edge].unit != YGUnitAuto) {                 \
 node->style.instanceName[edge].value = YGUndefined;                    \
 node->style.instanceName[edge].unit = YGUnitAuto;                      \
-YGNodeMarkDirtyInternal(node);                                         \
+YGNodeMarkStyleDirty(node);                                            \
 }                                                                        \
 }
 
@@ -547,7 +1420,7 @@ node->style.instanceName[edge].unit != YGUnitPoint) {
 node->style.instanceName[edge].value = paramName;                                       \
 node->style.instanceName[edge].unit =                                                   \
 YGFloatIsUndefined(paramName) ? YGUnitUndefined : YGUnitPoint;                      \
-YGNodeMarkDirtyInternal(node);                                                          \
+YGNodeMarkStyleDirty(node);                                                             \
 }                                                                                         \
 }                                                                                           \
 \
@@ -559,7 +1432,7 @@ node->style.instanceName[edge].unit != YGUnitPercent) {
 node->style.instanceName[edge].value = paramName;                                       \
 node->style.instanceName[edge].unit =                                                   \
 YGFloatIsUndefined(paramName) ? YGUnitUndefined : YGUnitPercent;                    \
-YGNodeMarkDirtyInternal(node);                                                          \
+YGNodeMarkStyleDirty(node);                                                             \
 }                                                                                         \
 }                                                                                           \
 \
@@ -574,7 +1447,7 @@ node->style.instanceName[edge].unit != YGUnitPoint) {
 node->style.instanceName[edge].value = paramName;                                       \
 node->style.instanceName[edge].unit =                                                   \
 YGFloatIsUndefined(paramName) ? YGUnitUndefined : YGUnitPoint;                      \
-YGNodeMarkDirtyInternal(node);                                                          \
+YGNodeMarkStyleDirty(node);                                                             \
 }                                                                                         \
 }                                                                                           \
 \
@@ -584,12 +1457,14 @@ return node->style.instanceName[edge].value;
 
 #define YG_NODE_LAYOUT_PROPERTY_IMPL(type, name, instanceName) \
 type YGNodeLayoutGet##name(const YGNodeRef node) {           \
+YGNodeResolveDeferredLayout(node);                         \
 return node->layout.instanceName;                          \
 }
 
 #define YG_NODE_LAYOUT_RESOLVED_PROPERTY_IMPL(type, name, instanceName)                    \
 type YGNodeLayoutGet##name(const YGNodeRef node, const YGEdge edge) {                    \
 YG_ASSERT(edge <= YGEdgeEnd, "Cannot get layout properties of multi-edge shorthands"); \
+YGNodeResolveDeferredLayout(node);                                                     \
 \
 if (edge == YGEdgeLeft) {                                                              \
 if (node->layout.direction == YGDirectionRTL) {                                      \
@@ -611,6 +1486,7 @@ return node->layout.instanceName[edge];
 }
 
 YG_NODE_PROPERTY_IMPL(void *, Context, context, context);
+YG_NODE_PROPERTY_IMPL(YGBatchMeasureFunc, BatchMeasureFunc, batchMeasureFunc, batchMeasure);
 YG_NODE_PROPERTY_IMPL(YGPrintFunc, PrintFunc, printFunc, print);
 YG_NODE_PROPERTY_IMPL(bool, HasNewLayout, hasNewLayout, hasNewLayout);
 
@@ -657,16 +1533,23 @@ YG_NODE_LAYOUT_RESOLVED_PROPERTY_IMPL(float, Margin, margin);
 YG_NODE_LAYOUT_RESOLVED_PROPERTY_IMPL(float, Border, border);
 YG_NODE_LAYOUT_RESOLVED_PROPERTY_IMPL(float, Padding, padding);
 
-uint32_t gCurrentGenerationCount = 0;
+// Generation of the pass running on this thread. Generations are drawn from one counter so a
+// node never sees the same one from passes on different threads.
+YG_THREAD_LOCAL uint32_t gCurrentGenerationCount = 0;
+static uint32_t gLastGenerationCount = 0;
+
+static inline void YGNextGeneration(void) {
+  gCurrentGenerationCount = YG_ATOMIC_ADD(gLastGenerationCount, 1);
+}
 
 bool YGLayoutNodeInternal(const YGNodeRef node,
-                          const float availableWidth,
-                          const float availableHeight,
+                          const YGFloat availableWidth,
+                          const YGFloat availableHeight,
                           const YGDirection parentDirection,
                           const YGMeasureMode widthMeasureMode,
                           const YGMeasureMode heightMeasureMode,
-                          const float parentWidth,
-                          const float parentHeight,
+                          const YGFloat parentWidth,
+                          const YGFloat parentHeight,
                           const bool performLayout,
                           const char *reason);
 
@@ -697,11 +1580,17 @@ static inline void YGResolveDimensions(YGNodeRef node) {
   }
 }
 
-static inline bool YGFloatsEqual(const float a, const float b) {
+static inline bool YGFloatsEqual(const YGFloat a, const YGFloat b) {
   if (YGFloatIsUndefined(a)) {
     return YGFloatIsUndefined(b);
   }
-  return fabs(a - b) < 0.0001f;
+  return fabs(a - b) < YGFloatEpsilon;
+}
+
+// Whether a size leaves no room. Sizes equal to zero as YGFloatsEqual sees it count too: the
+// caches reuse a result for constraints that differ by that much, so the result must not.
+static inline bool YGFloatIsEmpty(const YGFloat value) {
+  return value <= 0.0f || YGFloatsEqual(value, 0.0f);
 }
 
 static void YGIndent(const uint32_t n) {
@@ -720,7 +1609,7 @@ static void YGPrintNumberIfNotZero(const char *str, const YGValue *const number)
   }
 }
 
-static void YGPrintNumberIfNotUndefinedf(const char *str, const float number) {
+static void YGPrintNumberIfNotUndefinedf(const char *str, const YGFloat number) {
   if (!YGFloatIsUndefined(number)) {
     YGLog(YGLogLevelDebug, "%s: %g, ", str, number);
   }
@@ -944,9 +1833,9 @@ static inline bool YGFlexDirectionIsColumn(const YGFlexDirection flexDirection)
   return flexDirection == YGFlexDirectionColumn || flexDirection == YGFlexDirectionColumnReverse;
 }
 
-static inline float YGNodeLeadingMargin(const YGNodeRef node,
-                                        const YGFlexDirection axis,
-                                        const float widthSize) {
+static inline YGFloat YGNodeLeadingMargin(const YGNodeRef node,
+                                          const YGFlexDirection axis,
+                                          const YGFloat widthSize) {
   if (YGFlexDirectionIsRow(axis) && node->style.margin[YGEdgeStart].unit != YGUnitUndefined) {
     return YGValueResolveMargin(&node->style.margin[YGEdgeStart], widthSize);
   }
@@ -955,9 +1844,9 @@ static inline float YGNodeLeadingMargin(const YGNodeRef node,
                               widthSize);
 }
 
-static float YGNodeTrailingMargin(const YGNodeRef node,
-                                  const YGFlexDirection axis,
-                                  const float widthSize) {
+static YGFloat YGNodeTrailingMargin(const YGNodeRef node,
+                                    const YGFlexDirection axis,
+                                    const YGFloat widthSize) {
   if (YGFlexDirectionIsRow(axis) && node->style.margin[YGEdgeEnd].unit != YGUnitUndefined) {
     return YGValueResolveMargin(&node->style.margin[YGEdgeEnd], widthSize);
   }
@@ -966,71 +1855,71 @@ static float YGNodeTrailingMargin(const YGNodeRef node,
                               widthSize);
 }
 
-static float YGNodeLeadingPadding(const YGNodeRef node,
-                                  const YGFlexDirection axis,
-                                  const float widthSize) {
+static YGFloat YGNodeLeadingPadding(const YGNodeRef node,
+                                    const YGFlexDirection axis,
+                                    const YGFloat widthSize) {
   if (YGFlexDirectionIsRow(axis) && node->style.padding[YGEdgeStart].unit != YGUnitUndefined &&
       YGValueResolve(&node->style.padding[YGEdgeStart], widthSize) >= 0.0f) {
     return YGValueResolve(&node->style.padding[YGEdgeStart], widthSize);
   }
 
-  return fmaxf(YGValueResolve(YGComputedEdgeValue(node->style.padding, leading[axis], &YGValueZero),
+  return YGFloatMax(YGValueResolve(YGComputedEdgeValue(node->style.padding, leading[axis], &YGValueZero),
                               widthSize),
                0.0f);
 }
 
-static float YGNodeTrailingPadding(const YGNodeRef node,
-                                   const YGFlexDirection axis,
-                                   const float widthSize) {
+static YGFloat YGNodeTrailingPadding(const YGNodeRef node,
+                                     const YGFlexDirection axis,
+                                     const YGFloat widthSize) {
   if (YGFlexDirectionIsRow(axis) && node->style.padding[YGEdgeEnd].unit != YGUnitUndefined &&
       YGValueResolve(&node->style.padding[YGEdgeEnd], widthSize) >= 0.0f) {
     return YGValueResolve(&node->style.padding[YGEdgeEnd], widthSize);
   }
 
-  return fmaxf(YGValueResolve(YGComputedEdgeValue(node->style.padding, trailing[axis], &YGValueZero),
+  return YGFloatMax(YGValueResolve(YGComputedEdgeValue(node->style.padding, trailing[axis], &YGValueZero),
                               widthSize),
                0.0f);
 }
 
-static float YGNodeLeadingBorder(const YGNodeRef node, const YGFlexDirection axis) {
+static YGFloat YGNodeLeadingBorder(const YGNodeRef node, const YGFlexDirection axis) {
   if (YGFlexDirectionIsRow(axis) && node->style.border[YGEdgeStart].unit != YGUnitUndefined &&
       node->style.border[YGEdgeStart].value >= 0.0f) {
     return node->style.border[YGEdgeStart].value;
   }
 
-  return fmaxf(YGComputedEdgeValue(node->style.border, leading[axis], &YGValueZero)->value, 0.0f);
+  return YGFloatMax(YGComputedEdgeValue(node->style.border, leading[axis], &YGValueZero)->value, 0.0f);
 }
 
-static float YGNodeTrailingBorder(const YGNodeRef node, const YGFlexDirection axis) {
+static YGFloat YGNodeTrailingBorder(const YGNodeRef node, const YGFlexDirection axis) {
   if (YGFlexDirectionIsRow(axis) && node->style.border[YGEdgeEnd].unit != YGUnitUndefined &&
       node->style.border[YGEdgeEnd].value >= 0.0f) {
     return node->style.border[YGEdgeEnd].value;
   }
 
-  return fmaxf(YGComputedEdgeValue(node->style.border, trailing[axis], &YGValueZero)->value, 0.0f);
+  return YGFloatMax(YGComputedEdgeValue(node->style.border, trailing[axis], &YGValueZero)->value, 0.0f);
 }
 
-static inline float YGNodeLeadingPaddingAndBorder(const YGNodeRef node,
-                                                  const YGFlexDirection axis,
-                                                  const float widthSize) {
+static inline YGFloat YGNodeLeadingPaddingAndBorder(const YGNodeRef node,
+                                                    const YGFlexDirection axis,
+                                                    const YGFloat widthSize) {
   return YGNodeLeadingPadding(node, axis, widthSize) + YGNodeLeadingBorder(node, axis);
 }
 
-static inline float YGNodeTrailingPaddingAndBorder(const YGNodeRef node,
-                                                   const YGFlexDirection axis,
-                                                   const float widthSize) {
+static inline YGFloat YGNodeTrailingPaddingAndBorder(const YGNodeRef node,
+                                                     const YGFlexDirection axis,
+                                                     const YGFloat widthSize) {
   return YGNodeTrailingPadding(node, axis, widthSize) + YGNodeTrailingBorder(node, axis);
 }
 
-static inline float YGNodeMarginForAxis(const YGNodeRef node,
-                                        const YGFlexDirection axis,
-                                        const float widthSize) {
+static inline YGFloat YGNodeMarginForAxis(const YGNodeRef node,
+                                          const YGFlexDirection axis,
+                                          const YGFloat widthSize) {
   return YGNodeLeadingMargin(node, axis, widthSize) + YGNodeTrailingMargin(node, axis, widthSize);
 }
 
-static inline float YGNodePaddingAndBorderForAxis(const YGNodeRef node,
-                                                  const YGFlexDirection axis,
-                                                  const float widthSize) {
+static inline YGFloat YGNodePaddingAndBorderForAxis(const YGNodeRef node,
+                                                    const YGFlexDirection axis,
+                                                    const YGFloat widthSize) {
   return YGNodeLeadingPaddingAndBorder(node, axis, widthSize) +
   YGNodeTrailingPaddingAndBorder(node, axis, widthSize);
 }
@@ -1053,11 +1942,24 @@ static inline YGDirection YGNodeResolveDirection(const YGNodeRef node,
   }
 }
 
-static float YGBaseline(const YGNodeRef node) {
+// Top of a node within its parent before rounding. A node the current pass has not laid out keeps
+// the position the last pass rounded.
+static inline YGFloat YGNodeLaidOutTop(const YGNodeRef node) {
+  if (YGIsExperimentalFeatureEnabled(YGExperimentalFeatureRounding) &&
+      node->layout.lastLayoutRequest.generationCount != 0 &&
+      node->layout.lastLayoutRequest.generationCount != gCurrentGenerationCount) {
+    return YGNodeGetUnroundedPosition(node, 1);
+  }
+  return node->layout.position[YGEdgeTop];
+}
+
+// Reads the sizes of the last layout pass, like the positions it adds up: a measurement of the
+// node since, with other constraints, does not move its content.
+static YGFloat YGBaseline(const YGNodeRef node) {
   if (node->baseline != NULL) {
-    const float baseline = node->baseline(node,
-                                          node->layout.measuredDimensions[YGDimensionWidth],
-                                          node->layout.measuredDimensions[YGDimensionHeight]);
+    const YGFloat baseline = node->baseline(node,
+                                            node->layout.laidOutDimensions[YGDimensionWidth],
+                                            node->layout.laidOutDimensions[YGDimensionHeight]);
     YG_ASSERT(!YGFloatIsUndefined(baseline), "Expect custom baseline function to not return NaN")
     return baseline;
   }
@@ -1083,11 +1985,11 @@ static float YGBaseline(const YGNodeRef node) {
   }
 
   if (baselineChild == NULL) {
-    return node->layout.measuredDimensions[YGDimensionHeight];
+    return node->layout.laidOutDimensions[YGDimensionHeight];
   }
 
-  const float baseline = YGBaseline(baselineChild);
-  return baseline + baselineChild->layout.position[YGEdgeTop];
+  const YGFloat baseline = YGBaseline(baselineChild);
+  return baseline + YGNodeLaidOutTop(baselineChild);
 }
 
 static inline YGFlexDirection YGFlexDirectionResolve(const YGFlexDirection flexDirection,
@@ -1110,9 +2012,24 @@ static YGFlexDirection YGFlexDirectionCross(const YGFlexDirection flexDirection,
   : YGFlexDirectionColumn;
 }
 
+// A frozen node keeps its last layout until it is dirtied, see YGNodeSetFrozen.
+static inline bool YGNodeKeepsFrozenLayout(const YGNodeRef node) {
+  return node->extras->frozen && !node->isDirty && !node->hasDirtyDescendant &&
+         node->layout.lastLayoutRequest.generationCount != 0;
+}
+
+// Flex factors as the parent applies them: a node keeping a frozen layout does not flex.
+static inline float YGNodeResolveFlexGrow(const YGNodeRef node) {
+  return YGNodeKeepsFrozenLayout(node) ? 0.0f : YGNodeStyleGetFlexGrow(node);
+}
+
+static inline float YGNodeResolveFlexShrink(const YGNodeRef node) {
+  return YGNodeKeepsFrozenLayout(node) ? 0.0f : YGNodeStyleGetFlexShrink(node);
+}
+
 static inline bool YGNodeIsFlex(const YGNodeRef node) {
   return (node->style.positionType == YGPositionTypeRelative &&
-          (YGNodeStyleGetFlexGrow(node) != 0 || YGNodeStyleGetFlexShrink(node) != 0));
+          (YGNodeResolveFlexGrow(node) != 0 || YGNodeResolveFlexShrink(node) != 0));
 }
 
 static bool YGIsBaselineLayout(const YGNodeRef node) {
@@ -1134,16 +2051,16 @@ static bool YGIsBaselineLayout(const YGNodeRef node) {
   return false;
 }
 
-static inline float YGNodeDimWithMargin(const YGNodeRef node,
-                                        const YGFlexDirection axis,
-                                        const float widthSize) {
+static inline YGFloat YGNodeDimWithMargin(const YGNodeRef node,
+                                          const YGFlexDirection axis,
+                                          const YGFloat widthSize) {
   return node->layout.measuredDimensions[dim[axis]] + YGNodeLeadingMargin(node, axis, widthSize) +
   YGNodeTrailingMargin(node, axis, widthSize);
 }
 
 static inline bool YGNodeIsStyleDimDefined(const YGNodeRef node,
                                            const YGFlexDirection axis,
-                                           const float parentSize) {
+                                           const YGFloat parentSize) {
   return !(node->resolvedDimensions[dim[axis]]->unit == YGUnitAuto ||
            node->resolvedDimensions[dim[axis]]->unit == YGUnitUndefined ||
            (node->resolvedDimensions[dim[axis]]->unit == YGUnitPoint &&
@@ -1153,7 +2070,7 @@ static inline bool YGNodeIsStyleDimDefined(const YGNodeRef node,
 }
 
 static inline bool YGNodeIsLayoutDimDefined(const YGNodeRef node, const YGFlexDirection axis) {
-  const float value = node->layout.measuredDimensions[dim[axis]];
+  const YGFloat value = node->layout.measuredDimensions[dim[axis]];
   return !YGFloatIsUndefined(value) && value >= 0.0f;
 }
 
@@ -1173,9 +2090,9 @@ static inline bool YGNodeIsTrailingPosDefined(const YGNodeRef node, const YGFlex
   YGUnitUndefined;
 }
 
-static float YGNodeLeadingPosition(const YGNodeRef node,
-                                   const YGFlexDirection axis,
-                                   const float axisSize) {
+static YGFloat YGNodeLeadingPosition(const YGNodeRef node,
+                                     const YGFlexDirection axis,
+                                     const YGFloat axisSize) {
   if (YGFlexDirectionIsRow(axis)) {
     const YGValue *leadingPosition =
     YGComputedEdgeValue(node->style.position, YGEdgeStart, &YGValueUndefined);
@@ -1191,9 +2108,9 @@ static float YGNodeLeadingPosition(const YGNodeRef node,
   : YGValueResolve(leadingPosition, axisSize);
 }
 
-static float YGNodeTrailingPosition(const YGNodeRef node,
-                                    const YGFlexDirection axis,
-                                    const float axisSize) {
+static YGFloat YGNodeTrailingPosition(const YGNodeRef node,
+                                      const YGFlexDirection axis,
+                                      const YGFloat axisSize) {
   if (YGFlexDirectionIsRow(axis)) {
     const YGValue *trailingPosition =
     YGComputedEdgeValue(node->style.position, YGEdgeEnd, &YGValueUndefined);
@@ -1209,12 +2126,12 @@ static float YGNodeTrailingPosition(const YGNodeRef node,
   : YGValueResolve(trailingPosition, axisSize);
 }
 
-static float YGNodeBoundAxisWithinMinAndMax(const YGNodeRef node,
-                                            const YGFlexDirection axis,
-                                            const float value,
-                                            const float axisSize) {
-  float min = YGUndefined;
-  float max = YGUndefined;
+static YGFloat YGNodeBoundAxisWithinMinAndMax(const YGNodeRef node,
+                                              const YGFlexDirection axis,
+                                              const YGFloat value,
+                                              const YGFloat axisSize) {
+  YGFloat min = YGUndefined;
+  YGFloat max = YGUndefined;
 
   if (YGFlexDirectionIsColumn(axis)) {
     min = YGValueResolve(&node->style.minDimensions[YGDimensionHeight], axisSize);
@@ -1224,7 +2141,7 @@ static float YGNodeBoundAxisWithinMinAndMax(const YGNodeRef node,
     max = YGValueResolve(&node->style.maxDimensions[YGDimensionWidth], axisSize);
   }
 
-  float boundValue = value;
+  YGFloat boundValue = value;
 
   if (!YGFloatIsUndefined(max) && max >= 0.0f && boundValue > max) {
     boundValue = max;
@@ -1240,33 +2157,33 @@ static float YGNodeBoundAxisWithinMinAndMax(const YGNodeRef node,
 // Like YGNodeBoundAxisWithinMinAndMax but also ensures that the value doesn't go
 // below the
 // padding and border amount.
-static inline float YGNodeBoundAxis(const YGNodeRef node,
-                                    const YGFlexDirection axis,
-                                    const float value,
-                                    const float axisSize,
-                                    const float widthSize) {
-  return fmaxf(YGNodeBoundAxisWithinMinAndMax(node, axis, value, axisSize),
+static inline YGFloat YGNodeBoundAxis(const YGNodeRef node,
+                                      const YGFlexDirection axis,
+                                      const YGFloat value,
+                                      const YGFloat axisSize,
+                                      const YGFloat widthSize) {
+  return YGFloatMax(YGNodeBoundAxisWithinMinAndMax(node, axis, value, axisSize),
                YGNodePaddingAndBorderForAxis(node, axis, widthSize));
 }
 
 static void YGNodeSetChildTrailingPosition(const YGNodeRef node,
                                            const YGNodeRef child,
                                            const YGFlexDirection axis) {
-  const float size = child->layout.measuredDimensions[dim[axis]];
+  const YGFloat size = child->layout.measuredDimensions[dim[axis]];
   child->layout.position[trailing[axis]] =
   node->layout.measuredDimensions[dim[axis]] - size - child->layout.position[pos[axis]];
 }
 
 // If both left and right are defined, then use left. Otherwise return
 // +left or -right depending on which is defined.
-static float YGNodeRelativePosition(const YGNodeRef node,
-                                    const YGFlexDirection axis,
-                                    const float axisSize) {
+static YGFloat YGNodeRelativePosition(const YGNodeRef node,
+                                      const YGFlexDirection axis,
+                                      const YGFloat axisSize) {
   return YGNodeIsLeadingPosDefined(node, axis) ? YGNodeLeadingPosition(node, axis, axisSize)
   : -YGNodeTrailingPosition(node, axis, axisSize);
 }
 
-static void YGConstrainMaxSizeForMode(const float maxSize, YGMeasureMode *mode, float *size) {
+static void YGConstrainMaxSizeForMode(const YGFloat maxSize, YGMeasureMode *mode, YGFloat *size) {
   switch (*mode) {
     case YGMeasureModeExactly:
     case YGMeasureModeAtMost:
@@ -1283,13 +2200,13 @@ static void YGConstrainMaxSizeForMode(const float maxSize, YGMeasureMode *mode,
 
 static void YGNodeSetPosition(const YGNodeRef node,
                               const YGDirection direction,
-                              const float mainSize,
-                              const float crossSize,
-                              const float parentWidth) {
+                              const YGFloat mainSize,
+                              const YGFloat crossSize,
+                              const YGFloat parentWidth) {
   const YGFlexDirection mainAxis = YGFlexDirectionResolve(node->style.flexDirection, direction);
   const YGFlexDirection crossAxis = YGFlexDirectionCross(mainAxis, direction);
-  const float relativePositionMain = YGNodeRelativePosition(node, mainAxis, mainSize);
-  const float relativePositionCross = YGNodeRelativePosition(node, crossAxis, crossSize);
+  const YGFloat relativePositionMain = YGNodeRelativePosition(node, mainAxis, mainSize);
+  const YGFloat relativePositionCross = YGNodeRelativePosition(node, crossAxis, crossSize);
 
   node->layout.position[leading[mainAxis]] =
   YGNodeLeadingMargin(node, mainAxis, parentWidth) + relativePositionMain;
@@ -1301,26 +2218,144 @@ static void YGNodeSetPosition(const YGNodeRef node,
   YGNodeTrailingMargin(node, crossAxis, parentWidth) + relativePositionCross;
 }
 
+// If there is only one child with flexGrow + flexShrink in a container of exact main size, it
+// means we can set the computedFlexBasis to 0 instead of measuring and shrinking / flexing the
+// child to exactly match the remaining space
+static YGNodeRef YGNodeFindSingleFlexChild(const YGNodeRef node, const uint32_t childCount) {
+  YGNodeRef singleFlexChild = NULL;
+  for (uint32_t i = 0; i < childCount; i++) {
+    const YGNodeRef child = YGNodeGetChild(node, i);
+    if (singleFlexChild) {
+      if (YGNodeIsFlex(child)) {
+        // There is already a flexible child, abort.
+        return NULL;
+      }
+    } else if (YGNodeResolveFlexGrow(child) > 0.0f && YGNodeResolveFlexShrink(child) > 0.0f) {
+      singleFlexChild = child;
+    }
+  }
+  return singleFlexChild;
+}
+
+// Determines the constraints a child whose flex basis is its content is measured with. Returns
+// false when the basis follows from its aspect ratio and the exact cross size, which is then
+// left in the out parameters.
+static bool YGNodeFlexBasisMeasureConstraints(const YGNodeRef node,
+                                              const YGNodeRef child,
+                                              const YGFloat width,
+                                              const YGMeasureMode widthMode,
+                                              const YGFloat height,
+                                              const YGFloat parentWidth,
+                                              const YGFloat parentHeight,
+                                              const YGMeasureMode heightMode,
+                                              const YGDirection direction,
+                                              YGFloat *outWidth,
+                                              YGFloat *outHeight,
+                                              YGMeasureMode *outWidthMeasureMode,
+                                              YGMeasureMode *outHeightMeasureMode) {
+  const YGFlexDirection mainAxis = YGFlexDirectionResolve(node->style.flexDirection, direction);
+  const bool isMainAxisRow = YGFlexDirectionIsRow(mainAxis);
+  const bool isRowStyleDimDefined = YGNodeIsStyleDimDefined(child, YGFlexDirectionRow, parentWidth);
+  const bool isColumnStyleDimDefined =
+  YGNodeIsStyleDimDefined(child, YGFlexDirectionColumn, parentHeight);
+
+  YGFloat childWidth = YGUndefined;
+  YGFloat childHeight = YGUndefined;
+  YGMeasureMode childWidthMeasureMode = YGMeasureModeUndefined;
+  YGMeasureMode childHeightMeasureMode = YGMeasureModeUndefined;
+
+  const YGFloat marginRow = YGNodeMarginForAxis(child, YGFlexDirectionRow, parentWidth);
+  const YGFloat marginColumn = YGNodeMarginForAxis(child, YGFlexDirectionColumn, parentWidth);
+
+  if (isRowStyleDimDefined) {
+    childWidth =
+    YGValueResolve(child->resolvedDimensions[YGDimensionWidth], parentWidth) + marginRow;
+    childWidthMeasureMode = YGMeasureModeExactly;
+  }
+  if (isColumnStyleDimDefined) {
+    childHeight =
+    YGValueResolve(child->resolvedDimensions[YGDimensionHeight], parentHeight) + marginColumn;
+    childHeightMeasureMode = YGMeasureModeExactly;
+  }
+
+  // The W3C spec doesn't say anything about the 'overflow' property,
+  // but all major browsers appear to implement the following logic.
+  if ((!isMainAxisRow && node->style.overflow == YGOverflowScroll) ||
+      node->style.overflow != YGOverflowScroll) {
+    if (YGFloatIsUndefined(childWidth) && !YGFloatIsUndefined(width)) {
+      childWidth = width;
+      childWidthMeasureMode = YGMeasureModeAtMost;
+    }
+  }
+
+  if ((isMainAxisRow && node->style.overflow == YGOverflowScroll) ||
+      node->style.overflow != YGOverflowScroll) {
+    if (YGFloatIsUndefined(childHeight) && !YGFloatIsUndefined(height)) {
+      childHeight = height;
+      childHeightMeasureMode = YGMeasureModeAtMost;
+    }
+  }
+
+  // If child has no defined size in the cross axis and is set to stretch,
+  // set the cross
+  // axis to be measured exactly with the available inner width
+  if (!isMainAxisRow && !YGFloatIsUndefined(width) && !isRowStyleDimDefined &&
+      widthMode == YGMeasureModeExactly && YGNodeAlignItem(node, child) == YGAlignStretch) {
+    childWidth = width;
+    childWidthMeasureMode = YGMeasureModeExactly;
+  }
+  if (isMainAxisRow && !YGFloatIsUndefined(height) && !isColumnStyleDimDefined &&
+      heightMode == YGMeasureModeExactly && YGNodeAlignItem(node, child) == YGAlignStretch) {
+    childHeight = height;
+    childHeightMeasureMode = YGMeasureModeExactly;
+  }
+
+  *outWidth = childWidth;
+  *outHeight = childHeight;
+  *outWidthMeasureMode = childWidthMeasureMode;
+  *outHeightMeasureMode = childHeightMeasureMode;
+  if (!YGFloatIsUndefined(child->style.aspectRatio) &&
+      (isMainAxisRow ? childHeightMeasureMode : childWidthMeasureMode) == YGMeasureModeExactly) {
+    return false;
+  }
+
+  YGConstrainMaxSizeForMode(YGValueResolve(&child->style.maxDimensions[YGDimensionWidth],
+                                           parentWidth),
+                            outWidthMeasureMode,
+                            outWidth);
+  YGConstrainMaxSizeForMode(YGValueResolve(&child->style.maxDimensions[YGDimensionHeight],
+                                           parentHeight),
+                            outHeightMeasureMode,
+                            outHeight);
+  return true;
+}
+
 static void YGNodeComputeFlexBasisForChild(const YGNodeRef node,
                                            const YGNodeRef child,
-                                           const float width,
+                                           const YGFloat width,
                                            const YGMeasureMode widthMode,
-                                           const float height,
-                                           const float parentWidth,
-                                           const float parentHeight,
+                                           const YGFloat height,
+                                           const YGFloat parentWidth,
+                                           const YGFloat parentHeight,
                                            const YGMeasureMode heightMode,
                                            const YGDirection direction) {
   const YGFlexDirection mainAxis = YGFlexDirectionResolve(node->style.flexDirection, direction);
   const bool isMainAxisRow = YGFlexDirectionIsRow(mainAxis);
-  const float mainAxisSize = isMainAxisRow ? width : height;
-  const float mainAxisParentSize = isMainAxisRow ? parentWidth : parentHeight;
+  const YGFloat mainAxisSize = isMainAxisRow ? width : height;
+
+  if (YGNodeKeepsFrozenLayout(child)) {
+    child->layout.computedFlexBasisGeneration = gCurrentGenerationCount;
+    child->layout.computedFlexBasis = child->layout.laidOutDimensions[dim[mainAxis]];
+    return;
+  }
+  const YGFloat mainAxisParentSize = isMainAxisRow ? parentWidth : parentHeight;
 
-  float childWidth;
-  float childHeight;
+  YGFloat childWidth;
+  YGFloat childHeight;
   YGMeasureMode childWidthMeasureMode;
   YGMeasureMode childHeightMeasureMode;
 
-  const float resolvedFlexBasis =
+  const YGFloat resolvedFlexBasis =
   YGValueResolve(YGNodeStyleGetFlexBasisPtr(child), mainAxisParentSize);
   const bool isRowStyleDimDefined = YGNodeIsStyleDimDefined(child, YGFlexDirectionRow, parentWidth);
   const bool isColumnStyleDimDefined =
@@ -1331,96 +2366,47 @@ static void YGNodeComputeFlexBasisForChild(const YGNodeRef node,
         (YGIsExperimentalFeatureEnabled(YGExperimentalFeatureWebFlexBasis) &&
          child->layout.computedFlexBasisGeneration != gCurrentGenerationCount)) {
           child->layout.computedFlexBasis =
-          fmaxf(resolvedFlexBasis, YGNodePaddingAndBorderForAxis(child, mainAxis, parentWidth));
+          YGFloatMax(resolvedFlexBasis, YGNodePaddingAndBorderForAxis(child, mainAxis, parentWidth));
         }
   } else if (isMainAxisRow && isRowStyleDimDefined) {
     // The width is definite, so use that as the flex basis.
     child->layout.computedFlexBasis =
-    fmaxf(YGValueResolve(child->resolvedDimensions[YGDimensionWidth], parentWidth),
+    YGFloatMax(YGValueResolve(child->resolvedDimensions[YGDimensionWidth], parentWidth),
           YGNodePaddingAndBorderForAxis(child, YGFlexDirectionRow, parentWidth));
   } else if (!isMainAxisRow && isColumnStyleDimDefined) {
     // The height is definite, so use that as the flex basis.
     child->layout.computedFlexBasis =
-    fmaxf(YGValueResolve(child->resolvedDimensions[YGDimensionHeight], parentHeight),
+    YGFloatMax(YGValueResolve(child->resolvedDimensions[YGDimensionHeight], parentHeight),
           YGNodePaddingAndBorderForAxis(child, YGFlexDirectionColumn, parentWidth));
+  } else if (!YGNodeFlexBasisMeasureConstraints(node,
+                                                child,
+                                                width,
+                                                widthMode,
+                                                height,
+                                                parentWidth,
+                                                parentHeight,
+                                                heightMode,
+                                                direction,
+                                                &childWidth,
+                                                &childHeight,
+                                                &childWidthMeasureMode,
+                                                &childHeightMeasureMode)) {
+    // The exact cross size and the aspect ratio give the basis.
+    if (isMainAxisRow) {
+      const YGFloat marginColumn = YGNodeMarginForAxis(child, YGFlexDirectionColumn, parentWidth);
+      child->layout.computedFlexBasis =
+      YGFloatMax((childHeight - marginColumn) * child->style.aspectRatio,
+            YGNodePaddingAndBorderForAxis(child, YGFlexDirectionRow, parentWidth));
+    } else {
+      const YGFloat marginRow = YGNodeMarginForAxis(child, YGFlexDirectionRow, parentWidth);
+      child->layout.computedFlexBasis =
+      YGFloatMax((childWidth - marginRow) / child->style.aspectRatio,
+            YGNodePaddingAndBorderForAxis(child, YGFlexDirectionColumn, parentWidth));
+    }
+    return;
   } else {
     // Compute the flex basis and hypothetical main size (i.e. the clamped
-    // flex basis).
-    childWidth = YGUndefined;
-    childHeight = YGUndefined;
-    childWidthMeasureMode = YGMeasureModeUndefined;
-    childHeightMeasureMode = YGMeasureModeUndefined;
-
-    const float marginRow = YGNodeMarginForAxis(child, YGFlexDirectionRow, parentWidth);
-    const float marginColumn = YGNodeMarginForAxis(child, YGFlexDirectionColumn, parentWidth);
-
-    if (isRowStyleDimDefined) {
-      childWidth =
-      YGValueResolve(child->resolvedDimensions[YGDimensionWidth], parentWidth) + marginRow;
-      childWidthMeasureMode = YGMeasureModeExactly;
-    }
-    if (isColumnStyleDimDefined) {
-      childHeight =
-      YGValueResolve(child->resolvedDimensions[YGDimensionHeight], parentHeight) + marginColumn;
-      childHeightMeasureMode = YGMeasureModeExactly;
-    }
-
-    // The W3C spec doesn't say anything about the 'overflow' property,
-    // but all major browsers appear to implement the following logic.
-    if ((!isMainAxisRow && node->style.overflow == YGOverflowScroll) ||
-        node->style.overflow != YGOverflowScroll) {
-      if (YGFloatIsUndefined(childWidth) && !YGFloatIsUndefined(width)) {
-        childWidth = width;
-        childWidthMeasureMode = YGMeasureModeAtMost;
-      }
-    }
-
-    if ((isMainAxisRow && node->style.overflow == YGOverflowScroll) ||
-        node->style.overflow != YGOverflowScroll) {
-      if (YGFloatIsUndefined(childHeight) && !YGFloatIsUndefined(height)) {
-        childHeight = height;
-        childHeightMeasureMode = YGMeasureModeAtMost;
-      }
-    }
-
-    // If child has no defined size in the cross axis and is set to stretch,
-    // set the cross
-    // axis to be measured exactly with the available inner width
-    if (!isMainAxisRow && !YGFloatIsUndefined(width) && !isRowStyleDimDefined &&
-        widthMode == YGMeasureModeExactly && YGNodeAlignItem(node, child) == YGAlignStretch) {
-      childWidth = width;
-      childWidthMeasureMode = YGMeasureModeExactly;
-    }
-    if (isMainAxisRow && !YGFloatIsUndefined(height) && !isColumnStyleDimDefined &&
-        heightMode == YGMeasureModeExactly && YGNodeAlignItem(node, child) == YGAlignStretch) {
-      childHeight = height;
-      childHeightMeasureMode = YGMeasureModeExactly;
-    }
-
-    if (!YGFloatIsUndefined(child->style.aspectRatio)) {
-      if (!isMainAxisRow && childWidthMeasureMode == YGMeasureModeExactly) {
-        child->layout.computedFlexBasis =
-        fmaxf((childWidth - marginRow) / child->style.aspectRatio,
-              YGNodePaddingAndBorderForAxis(child, YGFlexDirectionColumn, parentWidth));
-        return;
-      } else if (isMainAxisRow && childHeightMeasureMode == YGMeasureModeExactly) {
-        child->layout.computedFlexBasis =
-        fmaxf((childHeight - marginColumn) * child->style.aspectRatio,
-              YGNodePaddingAndBorderForAxis(child, YGFlexDirectionRow, parentWidth));
-        return;
-      }
-    }
-
-    YGConstrainMaxSizeForMode(YGValueResolve(&child->style.maxDimensions[YGDimensionWidth],
-                                             parentWidth),
-                              &childWidthMeasureMode,
-                              &childWidth);
-    YGConstrainMaxSizeForMode(YGValueResolve(&child->style.maxDimensions[YGDimensionHeight],
-                                             parentHeight),
-                              &childHeightMeasureMode,
-                              &childHeight);
-
-    // Measure the child
+    // flex basis) by measuring the child.
     YGLayoutNodeInternal(child,
                          childWidth,
                          childHeight,
@@ -1433,7 +2419,7 @@ static void YGNodeComputeFlexBasisForChild(const YGNodeRef node,
                          "measure");
 
     child->layout.computedFlexBasis =
-    fmaxf(child->layout.measuredDimensions[dim[mainAxis]],
+    YGFloatMax(child->layout.measuredDimensions[dim[mainAxis]],
           YGNodePaddingAndBorderForAxis(child, mainAxis, parentWidth));
   }
 
@@ -1442,21 +2428,21 @@ static void YGNodeComputeFlexBasisForChild(const YGNodeRef node,
 
 static void YGNodeAbsoluteLayoutChild(const YGNodeRef node,
                                       const YGNodeRef child,
-                                      const float width,
+                                      const YGFloat width,
                                       const YGMeasureMode widthMode,
-                                      const float height,
+                                      const YGFloat height,
                                       const YGDirection direction) {
   const YGFlexDirection mainAxis = YGFlexDirectionResolve(node->style.flexDirection, direction);
   const YGFlexDirection crossAxis = YGFlexDirectionCross(mainAxis, direction);
   const bool isMainAxisRow = YGFlexDirectionIsRow(mainAxis);
 
-  float childWidth = YGUndefined;
-  float childHeight = YGUndefined;
+  YGFloat childWidth = YGUndefined;
+  YGFloat childHeight = YGUndefined;
   YGMeasureMode childWidthMeasureMode = YGMeasureModeUndefined;
   YGMeasureMode childHeightMeasureMode = YGMeasureModeUndefined;
 
-  const float marginRow = YGNodeMarginForAxis(child, YGFlexDirectionRow, width);
-  const float marginColumn = YGNodeMarginForAxis(child, YGFlexDirectionColumn, width);
+  const YGFloat marginRow = YGNodeMarginForAxis(child, YGFlexDirectionRow, width);
+  const YGFloat marginColumn = YGNodeMarginForAxis(child, YGFlexDirectionColumn, width);
 
   if (YGNodeIsStyleDimDefined(child, YGFlexDirectionRow, width)) {
     childWidth = YGValueResolve(child->resolvedDimensions[YGDimensionWidth], width) + marginRow;
@@ -1499,11 +2485,11 @@ static void YGNodeAbsoluteLayoutChild(const YGNodeRef node,
     if (!YGFloatIsUndefined(child->style.aspectRatio)) {
       if (YGFloatIsUndefined(childWidth)) {
         childWidth =
-        marginRow + fmaxf((childHeight - marginColumn) * child->style.aspectRatio,
+        marginRow + YGFloatMax((childHeight - marginColumn) * child->style.aspectRatio,
                           YGNodePaddingAndBorderForAxis(child, YGFlexDirectionColumn, width));
       } else if (YGFloatIsUndefined(childHeight)) {
         childHeight =
-        marginColumn + fmaxf((childWidth - marginRow) / child->style.aspectRatio,
+        marginColumn + YGFloatMax((childWidth - marginRow) / child->style.aspectRatio,
                              YGNodePaddingAndBorderForAxis(child, YGFlexDirectionRow, width));
       }
     }
@@ -1587,24 +2573,576 @@ static void YGNodeAbsoluteLayoutChild(const YGNodeRef node,
   }
 }
 
+// Measurements of keyed leaves kept across launches in a memory-mapped file: a header followed
+// by entries appended in order, of which the last one for given constraints is the valid one.
+// The count in the header only covers entries written completely, and each entry carries a
+// checksum against pages that did not make it to disk. The file stays locked while it is open,
+// and is synced to disk when compacted and closed.
+#define YG_MEASURE_CACHE_MAGIC 0x434d4759
+#define YG_MEASURE_CACHE_VERSION 1
+#define YG_MEASURE_CACHE_MAX_ENTRIES (1u << 24)
+
+typedef struct YGMeasureCacheHeader {
+  uint32_t magic;
+  uint32_t version;
+  uint32_t entrySize;
+  uint32_t count;
+} YGMeasureCacheHeader;
+
+typedef struct YGMeasureCacheEntry {
+  uint64_t key;
+  double width;
+  double height;
+  double measuredWidth;
+  double measuredHeight;
+  uint32_t modes;
+  uint32_t checksum;
+} YGMeasureCacheEntry;
+
+typedef struct YGMeasureCache {
+  int fd;
+  YGMeasureCacheHeader *header;
+  YGMeasureCacheEntry *entries;
+  size_t mappedSize;
+  uint32_t capacity;
+  // Whether each entry was looked up or added since the file was opened.
+  uint8_t *used;
+  // Open addressing table of entry indices plus one, zero when empty, twice as large as needed.
+  uint32_t *slots;
+  uint32_t slotMask;
+} YGMeasureCache;
+
+// Layouts on a thread consult the cache installed on it, see YGSetMeasureCache.
+static YG_THREAD_LOCAL YGMeasureCacheRef gMeasureCache = NULL;
+
+static uint32_t YGMeasureCacheChecksum(const YGMeasureCacheEntry *const entry) {
+  const uint8_t *const bytes = (const uint8_t *) entry;
+  uint32_t hash = 2166136261u;
+  for (size_t i = 0; i < offsetof(YGMeasureCacheEntry, checksum); i++) {
+    hash = (hash ^ bytes[i]) * 16777619u;
+  }
+  return hash;
+}
+
+// Measure functions ignore the size of an undefined axis, which may be any NaN.
+static inline double YGMeasureCacheConstraint(const YGFloat size, const YGMeasureMode mode) {
+  return mode == YGMeasureModeUndefined || isnan(size) ? 0 : (double) size;
+}
+
+static uint32_t YGMeasureCacheHash(const uint64_t key,
+                                   const double width,
+                                   const double height,
+                                   const uint32_t modes) {
+  uint64_t widthBits, heightBits;
+  memcpy(&widthBits, &width, sizeof(widthBits));
+  memcpy(&heightBits, &height, sizeof(heightBits));
+  uint64_t hash = key * 0x9e3779b97f4a7c15ull;
+  hash = (hash ^ widthBits) * 0xff51afd7ed558ccdull;
+  hash = (hash ^ heightBits) * 0xc4ceb9fe1a85ec53ull;
+  hash ^= modes;
+  return (uint32_t) (hash ^ (hash >> 32));
+}
+
+// The slot holding the entry for the constraints, or the empty one where it would go.
+static uint32_t *YGMeasureCacheSlot(const YGMeasureCacheRef cache,
+                                    const uint64_t key,
+                                    const double width,
+                                    const double height,
+                                    const uint32_t modes) {
+  uint32_t i = YGMeasureCacheHash(key, width, height, modes) & cache->slotMask;
+  while (cache->slots[i] != 0) {
+    const YGMeasureCacheEntry *const entry = &cache->entries[cache->slots[i] - 1];
+    if (entry->key == key && entry->width == width && entry->height == height &&
+        entry->modes == modes) {
+      break;
+    }
+    i = (i + 1) & cache->slotMask;
+  }
+  return &cache->slots[i];
+}
+
+static inline void YGMeasureCacheIndex(const YGMeasureCacheRef cache, const uint32_t index) {
+  const YGMeasureCacheEntry *const entry = &cache->entries[index];
+  *YGMeasureCacheSlot(cache, entry->key, entry->width, entry->height, entry->modes) = index + 1;
+}
+
+static void YGMeasureCacheReindex(const YGMeasureCacheRef cache) {
+  memset(cache->slots, 0, sizeof(uint32_t) * (cache->slotMask + 1));
+  for (uint32_t i = 0; i < cache->header->count; i++) {
+    YGMeasureCacheIndex(cache, i);
+  }
+}
+
+// Drops the entries later ones replaced, then, newest first, keeps those used since the file was
+// opened and, unless onlyUsed, the others, up to limit entries in all.
+static void YGMeasureCacheCompactTo(const YGMeasureCacheRef cache,
+                                    const uint32_t limit,
+                                    const bool onlyUsed) {
+  enum { YGMeasureCacheUsed = 1, YGMeasureCacheLive = 2, YGMeasureCacheKept = 4 };
+  uint8_t *const flags = cache->used;
+  const uint32_t count = cache->header->count;
+  for (uint32_t i = 0; i <= cache->slotMask; i++) {
+    if (cache->slots[i] != 0) {
+      flags[cache->slots[i] - 1] |= YGMeasureCacheLive;
+    }
+  }
+
+  uint32_t kept = 0;
+  for (uint32_t pass = 0; pass < (onlyUsed ? 1u : 2u); pass++) {
+    const uint8_t wanted = pass == 0 ? YGMeasureCacheUsed | YGMeasureCacheLive : YGMeasureCacheLive;
+    for (uint32_t i = count; i-- > 0 && kept < limit;) {
+      if ((flags[i] & (YGMeasureCacheUsed | YGMeasureCacheLive | YGMeasureCacheKept)) == wanted) {
+        flags[i] |= YGMeasureCacheKept;
+        kept++;
+      }
+    }
+  }
+
+  // A crash halfway through leaves an empty cache rather than entries out of order.
+  cache->header->count = 0;
+  uint32_t next = 0;
+  for (uint32_t i = 0; i < count; i++) {
+    if (flags[i] & YGMeasureCacheKept) {
+      cache->entries[next] = cache->entries[i];
+      flags[next++] = flags[i] & YGMeasureCacheUsed;
+    }
+  }
+  memset(&flags[next], 0, count - next);
+  cache->header->count = next;
+  YGMeasureCacheReindex(cache);
+}
+
+static bool YGMeasureCacheFind(const YGMeasureCacheRef cache,
+                               const uint64_t key,
+                               const YGFloat width,
+                               const YGMeasureMode widthMode,
+                               const YGFloat height,
+                               const YGMeasureMode heightMode,
+                               YGSize *const size) {
+  const uint32_t slot = *YGMeasureCacheSlot(cache,
+                                            key,
+                                            YGMeasureCacheConstraint(width, widthMode),
+                                            YGMeasureCacheConstraint(height, heightMode),
+                                            (uint32_t) widthMode | (uint32_t) heightMode << 8);
+  if (slot == 0) {
+    return false;
+  }
+
+  const YGMeasureCacheEntry *const entry = &cache->entries[slot - 1];
+  cache->used[slot - 1] = 1;
+  size->width = (float) entry->measuredWidth;
+  size->height = (float) entry->measuredHeight;
+  return true;
+}
+
+static void YGMeasureCacheAdd(const YGMeasureCacheRef cache,
+                              const uint64_t key,
+                              const YGFloat width,
+                              const YGMeasureMode widthMode,
+                              const YGFloat height,
+                              const YGMeasureMode heightMode,
+                              const YGSize size) {
+  if (cache->header->count == cache->capacity) {
+    YGMeasureCacheCompactTo(cache, cache->capacity / 2, false);
+  }
+
+  const uint32_t index = cache->header->count;
+  YGMeasureCacheEntry *const entry = &cache->entries[index];
+  entry->key = key;
+  entry->width = YGMeasureCacheConstraint(width, widthMode);
+  entry->height = YGMeasureCacheConstraint(height, heightMode);
+  entry->measuredWidth = size.width;
+  entry->measuredHeight = size.height;
+  entry->modes = (uint32_t) widthMode | (uint32_t) heightMode << 8;
+  entry->checksum = YGMeasureCacheChecksum(entry);
+  cache->used[index] = 1;
+  cache->header->count = index + 1;
+  YGMeasureCacheIndex(cache, index);
+}
+
+YGMeasureCacheRef YGMeasureCacheOpen(const char *path, const uint32_t maxEntries) {
+#ifdef _MSC_VER
+  (void) path;
+  (void) maxEntries;
+  return NULL;
+#else
+  if (maxEntries < 2 || maxEntries > YG_MEASURE_CACHE_MAX_ENTRIES) {
+    return NULL;
+  }
+
+  const int fd = open(path, O_RDWR | O_CREAT, 0644);
+  if (fd < 0) {
+    return NULL;
+  }
+
+  // Another process appending to the same file would interleave its entries with ours.
+  struct flock lock = {.l_type = F_WRLCK, .l_whence = SEEK_SET, .l_start = 0, .l_len = 0};
+  struct stat status;
+  const size_t mappedSize =
+      sizeof(YGMeasureCacheHeader) + sizeof(YGMeasureCacheEntry) * (size_t) maxEntries;
+  if (fcntl(fd, F_SETLK, &lock) != 0 || fstat(fd, &status) != 0 ||
+      ftruncate(fd, (off_t) mappedSize) != 0) {
+    close(fd);
+    return NULL;
+  }
+  void *const mapped = mmap(NULL, mappedSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  if (mapped == MAP_FAILED) {
+    close(fd);
+    return NULL;
+  }
+
+  uint32_t slotCount = 1;
+  while (slotCount < maxEntries * 2) {
+    slotCount *= 2;
+  }
+  const YGMeasureCacheRef cache =
+      gYGCalloc(1, sizeof(YGMeasureCache) + sizeof(uint32_t) * slotCount + maxEntries);
+  if (cache == NULL) {
+    munmap(mapped, mappedSize);
+    close(fd);
+    return NULL;
+  }
+  cache->fd = fd;
+  cache->header = mapped;
+  cache->entries = (YGMeasureCacheEntry *) (cache->header + 1);
+  cache->mappedSize = mappedSize;
+  cache->capacity = maxEntries;
+  cache->slots = (uint32_t *) (cache + 1);
+  cache->slotMask = slotCount - 1;
+  cache->used = (uint8_t *) (cache->slots + slotCount);
+
+  // A new file, one from another build or a cut down one starts empty. Otherwise the entries are
+  // taken up to the first one not completely written.
+  YGMeasureCacheHeader *const header = cache->header;
+  if ((size_t) status.st_size < sizeof(YGMeasureCacheHeader) ||
+      header->magic != YG_MEASURE_CACHE_MAGIC || header->version != YG_MEASURE_CACHE_VERSION ||
+      header->entrySize != sizeof(YGMeasureCacheEntry)) {
+    header->magic = YG_MEASURE_CACHE_MAGIC;
+    header->version = YG_MEASURE_CACHE_VERSION;
+    header->entrySize = sizeof(YGMeasureCacheEntry);
+    header->count = 0;
+  }
+  const size_t storedEntries =
+      ((size_t) status.st_size - sizeof(YGMeasureCacheHeader)) / sizeof(YGMeasureCacheEntry);
+  uint32_t count = header->count;
+  if (count > storedEntries) {
+    count = (uint32_t) storedEntries;
+  }
+  if (count > maxEntries) {
+    count = maxEntries;
+  }
+  for (uint32_t i = 0; i < count; i++) {
+    if (cache->entries[i].checksum != YGMeasureCacheChecksum(&cache->entries[i])) {
+      count = i;
+      break;
+    }
+  }
+  header->count = count;
+  YGMeasureCacheReindex(cache);
+  return cache;
+#endif
+}
+
+static void YGMeasureCacheSync(const YGMeasureCacheRef cache) {
+#ifndef _MSC_VER
+  msync(cache->header, cache->mappedSize, MS_SYNC);
+#else
+  (void) cache;
+#endif
+}
+
+void YGMeasureCacheClose(const YGMeasureCacheRef cache) {
+  if (gMeasureCache == cache) {
+    gMeasureCache = NULL;
+  }
+  YGMeasureCacheSync(cache);
+#ifndef _MSC_VER
+  munmap(cache->header, cache->mappedSize);
+  close(cache->fd);
+#endif
+  gYGFree(cache);
+}
+
+void YGMeasureCacheCompact(const YGMeasureCacheRef cache) {
+  YGMeasureCacheCompactTo(cache, cache->capacity, true);
+  YGMeasureCacheSync(cache);
+}
+
+uint32_t YGMeasureCacheGetCount(const YGMeasureCacheRef cache) {
+  return cache->header->count;
+}
+
+void YGSetMeasureCache(const YGMeasureCacheRef cache) {
+  gMeasureCache = cache;
+}
+
+static void YGThreadBuffersRegister(void);
+
+// Pending leaf measurements of the container currently being batched. Containers never
+// collect recursively (only leaves are visited while collecting) so a single buffer is
+// enough.
+typedef struct YGMeasureBatch {
+  uint32_t capacity;
+  uint32_t count;
+  bool collecting;
+  YGMeasureRequest *requests;
+  YGSize *sizes;
+} YGMeasureBatch;
+
+static YG_THREAD_LOCAL YGMeasureBatch gMeasureBatch = {
+  .capacity = 0, .count = 0, .collecting = false, .requests = NULL, .sizes = NULL,
+};
+
+static void YGMeasureBatchBegin(void) {
+  gMeasureBatch.count = 0;
+  gMeasureBatch.collecting = true;
+}
+
+static void YGMeasureBatchAdd(const YGNodeRef node,
+                              const YGFloat width,
+                              const YGMeasureMode widthMode,
+                              const YGFloat height,
+                              const YGMeasureMode heightMode) {
+  if (gMeasureBatch.count == gMeasureBatch.capacity) {
+    YGThreadBuffersRegister();
+    gMeasureBatch.capacity = gMeasureBatch.capacity == 0 ? 16 : gMeasureBatch.capacity * 2;
+    gMeasureBatch.requests =
+    gYGRealloc(gMeasureBatch.requests, sizeof(YGMeasureRequest) * gMeasureBatch.capacity);
+    gMeasureBatch.sizes = gYGRealloc(gMeasureBatch.sizes, sizeof(YGSize) * gMeasureBatch.capacity);
+    YG_ASSERT(gMeasureBatch.requests != NULL && gMeasureBatch.sizes != NULL,
+              "Could not extend allocation for batched measurements");
+  }
+
+  YGMeasureRequest *const request = &gMeasureBatch.requests[gMeasureBatch.count++];
+  request->node = node;
+  request->width = width;
+  request->widthMode = widthMode;
+  request->height = height;
+  request->heightMode = heightMode;
+}
+
+// Hands every collected request to the container's batch measure function and leaves each
+// result on its leaf, where the regular measurement picks it up.
+static void YGMeasureBatchFlush(const YGNodeRef node) {
+  gMeasureBatch.collecting = false;
+  if (gMeasureBatch.count == 0) {
+    return;
+  }
+
+  node->batchMeasure(node, gMeasureBatch.requests, gMeasureBatch.sizes, gMeasureBatch.count);
+
+  for (uint32_t i = 0; i < gMeasureBatch.count; i++) {
+    const YGMeasureRequest *const request = &gMeasureBatch.requests[i];
+    YGCachedMeasurement *const batched = &YGNodeGetExtras(request->node)->batchedMeasurement;
+    batched->availableWidth = request->width;
+    batched->availableHeight = request->height;
+    batched->widthMeasureMode = request->widthMode;
+    batched->heightMeasureMode = request->heightMode;
+    batched->computedWidth = gMeasureBatch.sizes[i].width;
+    batched->computedHeight = gMeasureBatch.sizes[i].height;
+    if (gMeasureCache != NULL && request->node->measureKey != 0) {
+      YGMeasureCacheAdd(gMeasureCache,
+                        request->node->measureKey,
+                        request->width,
+                        request->widthMode,
+                        request->height,
+                        request->heightMode,
+                        gMeasureBatch.sizes[i]);
+    }
+  }
+  gMeasureBatch.count = 0;
+}
+
+static YGSize YGNodeMeasureLeaf(const YGNodeRef node,
+                                const YGFloat width,
+                                const YGMeasureMode widthMode,
+                                const YGFloat height,
+                                const YGMeasureMode heightMode) {
+  YGCachedMeasurement *const batched = &node->extras->batchedMeasurement;
+  if (batched->widthMeasureMode == widthMode && batched->heightMeasureMode == heightMode &&
+      YGFloatsEqual(batched->availableWidth, width) &&
+      YGFloatsEqual(batched->availableHeight, height)) {
+    batched->widthMeasureMode = (YGMeasureMode) -1;
+    return (YGSize){.width = batched->computedWidth, .height = batched->computedHeight};
+  }
+
+  if (gMeasureCache == NULL || node->measureKey == 0) {
+    return node->measure(node, width, widthMode, height, heightMode);
+  }
+
+  YGSize size;
+  if (!YGMeasureCacheFind(
+          gMeasureCache, node->measureKey, width, widthMode, height, heightMode, &size)) {
+    size = node->measure(node, width, widthMode, height, heightMode);
+    YGMeasureCacheAdd(
+        gMeasureCache, node->measureKey, width, widthMode, height, heightMode, size);
+  }
+  return size;
+}
+
+static inline YGAvailableRange YGAvailableRangePoint(const YGFloat availableWidth,
+                                                     const YGFloat availableHeight) {
+  return (YGAvailableRange){
+      .min = {[YGDimensionWidth] = availableWidth, [YGDimensionHeight] = availableHeight},
+      .max = {[YGDimensionWidth] = availableWidth, [YGDimensionHeight] = availableHeight},
+  };
+}
+
+static inline void YGAvailableRangeCollapseAxis(YGAvailableRange *const range,
+                                                const YGDimension dim,
+                                                const YGFloat availableSize) {
+  range->min[dim] = availableSize;
+  range->max[dim] = availableSize;
+}
+
+static inline void YGAvailableRangeOpenAxis(YGAvailableRange *const range, const YGDimension dim) {
+  range->min[dim] = -INFINITY;
+  range->max[dim] = INFINITY;
+}
+
+// Whether a result cached for a node without a measure function holds for the given
+// constraints. Each available size has to be the same, or for an at-most constraint lie within
+// the range the result was found not to depend on. At-most sizes that are not positive take the
+// fixed size shortcut and only match exactly.
+static inline bool YGNodeCanReuseLayout(const YGCachedMeasurement *const entry,
+                                        const YGFloat availableWidth,
+                                        const YGFloat availableHeight,
+                                        const YGMeasureMode widthMeasureMode,
+                                        const YGMeasureMode heightMeasureMode) {
+  if (entry->widthMeasureMode != widthMeasureMode ||
+      entry->heightMeasureMode != heightMeasureMode) {
+    return false;
+  }
+
+  const bool widthIsCompatible =
+      YGFloatsEqual(entry->availableWidth, availableWidth) ||
+      (widthMeasureMode == YGMeasureModeAtMost && availableWidth > 0 &&
+       availableWidth >= entry->range.min[YGDimensionWidth] &&
+       availableWidth <= entry->range.max[YGDimensionWidth]);
+  const bool heightIsCompatible =
+      YGFloatsEqual(entry->availableHeight, availableHeight) ||
+      (heightMeasureMode == YGMeasureModeAtMost && availableHeight > 0 &&
+       availableHeight >= entry->range.min[YGDimensionHeight] &&
+       availableHeight <= entry->range.max[YGDimensionHeight]);
+  return widthIsCompatible && heightIsCompatible;
+}
+
+// Range of the container being laid out. Children measured at most against its inner available
+// size narrow it with their own range, shifted by the space the container takes for itself.
+typedef struct YGAvailableRangeScope {
+  YGNodeRef node;
+  YGAvailableRange range;
+  YGFloat availableInnerSize[2];
+  YGFloat offset[2];
+} YGAvailableRangeScope;
+
+static YG_THREAD_LOCAL YGAvailableRangeScope *gAvailableRangeScope = NULL;
+
+static void YGAvailableRangeScopeNarrow(YGAvailableRangeScope *const scope,
+                                        const YGAvailableRange *const childRange,
+                                        const YGFloat availableWidth,
+                                        const YGFloat availableHeight,
+                                        const YGMeasureMode widthMeasureMode,
+                                        const YGMeasureMode heightMeasureMode) {
+  const YGFloat availableSize[2] = {[YGDimensionWidth] = availableWidth,
+                                    [YGDimensionHeight] = availableHeight};
+  const YGMeasureMode measureMode[2] = {[YGDimensionWidth] = widthMeasureMode,
+                                        [YGDimensionHeight] = heightMeasureMode};
+  for (YGDimension dim = YGDimensionWidth; dim <= YGDimensionHeight; dim++) {
+    if (measureMode[dim] == YGMeasureModeAtMost &&
+        availableSize[dim] == scope->availableInnerSize[dim]) {
+      scope->range.min[dim] =
+          YGFloatMax(scope->range.min[dim], childRange->min[dim] + scope->offset[dim]);
+      scope->range.max[dim] =
+          YGFloatMin(scope->range.max[dim], childRange->max[dim] + scope->offset[dim]);
+    }
+  }
+}
+
+// Narrows an at-most axis of the container being laid out to the available sizes its content
+// still fits in. Content that overflows gets clamped to the current size.
+static void YGAvailableRangeScopeRequire(YGAvailableRangeScope *const scope,
+                                         const YGDimension dim,
+                                         const YGFloat contentSize) {
+  if (contentSize > scope->availableInnerSize[dim]) {
+    YGAvailableRangeCollapseAxis(&scope->range,
+                                 dim,
+                                 scope->availableInnerSize[dim] + scope->offset[dim]);
+  } else {
+    scope->range.min[dim] = YGFloatMax(scope->range.min[dim], contentSize + scope->offset[dim]);
+  }
+}
+
+// Whether a max size can cut the measured size of the node short of the one it asked for.
+static inline bool YGNodeHasMaxDimension(const YGNodeRef node) {
+  return node->style.maxDimensions[YGDimensionWidth].unit != YGUnitUndefined ||
+         node->style.maxDimensions[YGDimensionHeight].unit != YGUnitUndefined;
+}
+
+// A measured leaf returns the same size for any stricter at-most constraint its measured size
+// still fits in, see YGMeasureModeNewMeasureSizeIsStricterAndStillValid.
+static void YGNodeSetLeafAvailableRange(const YGNodeRef node,
+                                        const YGFloat availableWidth,
+                                        const YGFloat availableHeight,
+                                        const YGMeasureMode widthMeasureMode,
+                                        const YGMeasureMode heightMeasureMode,
+                                        const YGFloat parentWidth) {
+  YGAvailableRange *const range = &node->layout.availableRange;
+  *range = YGAvailableRangePoint(availableWidth, availableHeight);
+  if (node->hasPercentStyle || YGNodeHasMaxDimension(node)) {
+    return;
+  }
+
+  if (widthMeasureMode == YGMeasureModeAtMost) {
+    const YGFloat minWidth = node->layout.measuredDimensions[YGDimensionWidth] +
+                             YGNodeMarginForAxis(node, YGFlexDirectionRow, parentWidth);
+    range->min[YGDimensionWidth] = YGFloatMin(minWidth, availableWidth);
+  }
+  if (heightMeasureMode == YGMeasureModeAtMost) {
+    const YGFloat minHeight = node->layout.measuredDimensions[YGDimensionHeight] +
+                              YGNodeMarginForAxis(node, YGFlexDirectionColumn, parentWidth);
+    range->min[YGDimensionHeight] = YGFloatMin(minHeight, availableHeight);
+  }
+}
+
+// Whether the node is sized without calling its measure function for these constraints, because
+// one of its inner dimensions leaves no room. Such a result is not the one the measure function
+// would give, so the caches only reuse it for constraints that also leave no room.
+static bool YGNodeSkipsMeasurement(const YGNodeRef node,
+                                   const YGFloat availableWidth,
+                                   const YGFloat availableHeight,
+                                   const YGMeasureMode widthMeasureMode,
+                                   const YGMeasureMode heightMeasureMode) {
+  if (widthMeasureMode == YGMeasureModeExactly && heightMeasureMode == YGMeasureModeExactly) {
+    return false;
+  }
+  const YGFloat innerWidth =
+      availableWidth - YGNodeMarginForAxis(node, YGFlexDirectionRow, availableWidth) -
+      YGNodePaddingAndBorderForAxis(node, YGFlexDirectionRow, availableWidth);
+  const YGFloat innerHeight =
+      availableHeight - YGNodeMarginForAxis(node, YGFlexDirectionColumn, availableWidth) -
+      YGNodePaddingAndBorderForAxis(node, YGFlexDirectionColumn, availableWidth);
+  return YGFloatIsEmpty(innerWidth) || YGFloatIsEmpty(innerHeight);
+}
+
 static void YGNodeWithMeasureFuncSetMeasuredDimensions(const YGNodeRef node,
-                                                       const float availableWidth,
-                                                       const float availableHeight,
+                                                       const YGFloat availableWidth,
+                                                       const YGFloat availableHeight,
                                                        const YGMeasureMode widthMeasureMode,
                                                        const YGMeasureMode heightMeasureMode,
-                                                       const float parentWidth,
-                                                       const float parentHeight) {
+                                                       const YGFloat parentWidth,
+                                                       const YGFloat parentHeight) {
   YG_ASSERT(node->measure, "Expected node to have custom measure function");
 
-  const float paddingAndBorderAxisRow =
+  const YGFloat paddingAndBorderAxisRow =
   YGNodePaddingAndBorderForAxis(node, YGFlexDirectionRow, availableWidth);
-  const float paddingAndBorderAxisColumn =
+  const YGFloat paddingAndBorderAxisColumn =
   YGNodePaddingAndBorderForAxis(node, YGFlexDirectionColumn, availableWidth);
-  const float marginAxisRow = YGNodeMarginForAxis(node, YGFlexDirectionRow, availableWidth);
-  const float marginAxisColumn = YGNodeMarginForAxis(node, YGFlexDirectionColumn, availableWidth);
+  const YGFloat marginAxisRow = YGNodeMarginForAxis(node, YGFlexDirectionRow, availableWidth);
+  const YGFloat marginAxisColumn = YGNodeMarginForAxis(node, YGFlexDirectionColumn, availableWidth);
 
-  const float innerWidth = availableWidth - marginAxisRow - paddingAndBorderAxisRow;
-  const float innerHeight = availableHeight - marginAxisColumn - paddingAndBorderAxisColumn;
+  const YGFloat innerWidth = availableWidth - marginAxisRow - paddingAndBorderAxisRow;
+  const YGFloat innerHeight = availableHeight - marginAxisColumn - paddingAndBorderAxisColumn;
 
   if (widthMeasureMode == YGMeasureModeExactly && heightMeasureMode == YGMeasureModeExactly) {
     // Don't bother sizing the text if both dimensions are already defined.
@@ -1612,7 +3150,7 @@ static void YGNodeWithMeasureFuncSetMeasuredDimensions(const YGNodeRef node,
                                                                         node, YGFlexDirectionRow, availableWidth - marginAxisRow, parentWidth, parentWidth);
     node->layout.measuredDimensions[YGDimensionHeight] = YGNodeBoundAxis(
                                                                          node, YGFlexDirectionColumn, availableHeight - marginAxisColumn, parentHeight, parentWidth);
-  } else if (innerWidth <= 0.0f || innerHeight <= 0.0f) {
+  } else if (YGFloatIsEmpty(innerWidth) || YGFloatIsEmpty(innerHeight)) {
     // Don't bother sizing the text if there's no horizontal or vertical
     // space.
     node->layout.measuredDimensions[YGDimensionWidth] =
@@ -1620,9 +3158,28 @@ static void YGNodeWithMeasureFuncSetMeasuredDimensions(const YGNodeRef node,
     node->layout.measuredDimensions[YGDimensionHeight] =
     YGNodeBoundAxis(node, YGFlexDirectionColumn, 0.0f, availableHeight, availableWidth);
   } else {
+    YGSize persistedSize;
+    if (gMeasureBatch.collecting &&
+        !(gMeasureCache != NULL && node->measureKey != 0 &&
+          YGMeasureCacheFind(gMeasureCache,
+                             node->measureKey,
+                             innerWidth,
+                             widthMeasureMode,
+                             innerHeight,
+                             heightMeasureMode,
+                             &persistedSize))) {
+      // Only record the constraints, the parent measures all of its leaves at once. The
+      // placeholder size is never cached, see YGLayoutNodeInternal. Measurements found in the
+      // persistent cache are taken right away.
+      YGMeasureBatchAdd(node, innerWidth, widthMeasureMode, innerHeight, heightMeasureMode);
+      node->layout.measuredDimensions[YGDimensionWidth] = 0;
+      node->layout.measuredDimensions[YGDimensionHeight] = 0;
+      return;
+    }
+
     // Measure the text under the current constraints.
     const YGSize measuredSize =
-    node->measure(node, innerWidth, widthMeasureMode, innerHeight, heightMeasureMode);
+    YGNodeMeasureLeaf(node, innerWidth, widthMeasureMode, innerHeight, heightMeasureMode);
 
     node->layout.measuredDimensions[YGDimensionWidth] =
     YGNodeBoundAxis(node,
@@ -1648,18 +3205,18 @@ static void YGNodeWithMeasureFuncSetMeasuredDimensions(const YGNodeRef node,
 // For nodes with no children, use the available values if they were provided,
 // or the minimum size as indicated by the padding and border sizes.
 static void YGNodeEmptyContainerSetMeasuredDimensions(const YGNodeRef node,
-                                                      const float availableWidth,
-                                                      const float availableHeight,
+                                                      const YGFloat availableWidth,
+                                                      const YGFloat availableHeight,
                                                       const YGMeasureMode widthMeasureMode,
                                                       const YGMeasureMode heightMeasureMode,
-                                                      const float parentWidth,
-                                                      const float parentHeight) {
-  const float paddingAndBorderAxisRow =
+                                                      const YGFloat parentWidth,
+                                                      const YGFloat parentHeight) {
+  const YGFloat paddingAndBorderAxisRow =
   YGNodePaddingAndBorderForAxis(node, YGFlexDirectionRow, parentWidth);
-  const float paddingAndBorderAxisColumn =
+  const YGFloat paddingAndBorderAxisColumn =
   YGNodePaddingAndBorderForAxis(node, YGFlexDirectionColumn, parentWidth);
-  const float marginAxisRow = YGNodeMarginForAxis(node, YGFlexDirectionRow, parentWidth);
-  const float marginAxisColumn = YGNodeMarginForAxis(node, YGFlexDirectionColumn, parentWidth);
+  const YGFloat marginAxisRow = YGNodeMarginForAxis(node, YGFlexDirectionRow, parentWidth);
+  const YGFloat marginAxisColumn = YGNodeMarginForAxis(node, YGFlexDirectionColumn, parentWidth);
 
   node->layout.measuredDimensions[YGDimensionWidth] =
   YGNodeBoundAxis(node,
@@ -1682,17 +3239,17 @@ static void YGNodeEmptyContainerSetMeasuredDimensions(const YGNodeRef node,
 }
 
 static bool YGNodeFixedSizeSetMeasuredDimensions(const YGNodeRef node,
-                                                 const float availableWidth,
-                                                 const float availableHeight,
+                                                 const YGFloat availableWidth,
+                                                 const YGFloat availableHeight,
                                                  const YGMeasureMode widthMeasureMode,
                                                  const YGMeasureMode heightMeasureMode,
-                                                 const float parentWidth,
-                                                 const float parentHeight) {
-  if ((widthMeasureMode == YGMeasureModeAtMost && availableWidth <= 0.0f) ||
-      (heightMeasureMode == YGMeasureModeAtMost && availableHeight <= 0.0f) ||
+                                                 const YGFloat parentWidth,
+                                                 const YGFloat parentHeight) {
+  if ((widthMeasureMode == YGMeasureModeAtMost && YGFloatIsEmpty(availableWidth)) ||
+      (heightMeasureMode == YGMeasureModeAtMost && YGFloatIsEmpty(availableHeight)) ||
       (widthMeasureMode == YGMeasureModeExactly && heightMeasureMode == YGMeasureModeExactly)) {
-    const float marginAxisColumn = YGNodeMarginForAxis(node, YGFlexDirectionColumn, parentWidth);
-    const float marginAxisRow = YGNodeMarginForAxis(node, YGFlexDirectionRow, parentWidth);
+    const YGFloat marginAxisColumn = YGNodeMarginForAxis(node, YGFlexDirectionColumn, parentWidth);
+    const YGFloat marginAxisRow = YGNodeMarginForAxis(node, YGFlexDirectionRow, parentWidth);
 
     node->layout.measuredDimensions[YGDimensionWidth] =
     YGNodeBoundAxis(node,
@@ -1721,6 +3278,7 @@ static bool YGNodeFixedSizeSetMeasuredDimensions(const YGNodeRef node,
 }
 
 static void YGZeroOutLayoutRecursivly(const YGNodeRef node) {
+  YGNodeSetNewLayout(node);
   node->layout.dimensions[YGDimensionHeight] = 0;
   node->layout.dimensions[YGDimensionWidth] = 0;
   node->layout.position[YGEdgeTop] = 0;
@@ -1734,262 +3292,306 @@ static void YGZeroOutLayoutRecursivly(const YGNodeRef node) {
   }
 }
 
-//
-// This is the main routine that implements a subset of the flexbox layout
-// algorithm
-// described in the W3C YG documentation: https://www.w3.org/TR/YG3-flexbox/.
-//
-// Limitations of this algorithm, compared to the full standard:
-//  * Display property is always assumed to be 'flex' except for Text nodes,
-//  which
-//    are assumed to be 'inline-flex'.
-//  * The 'zIndex' property (or any form of z ordering) is not supported. Nodes
-//  are
-//    stacked in document order.
-//  * The 'order' property is not supported. The order of flex items is always
-//  defined
-//    by document order.
-//  * The 'visibility' property is always assumed to be 'visible'. Values of
-//  'collapse'
-//    and 'hidden' are not supported.
-//  * There is no support for forced breaks.
-//  * It does not support vertical inline directions (top-to-bottom or
-//  bottom-to-top text).
-//
-// Deviations from standard:
-//  * Section 4.5 of the spec indicates that all flex items have a default
-//  minimum
-//    main size. For text blocks, for example, this is the width of the widest
-//    word.
-//    Calculating the minimum width is expensive, so we forego it and assume a
-//    default
-//    minimum main size of 0.
-//  * Min/Max sizes in the main axis are not honored when resolving flexible
-//  lengths.
-//  * The spec indicates that the default value for 'flexDirection' is 'row',
-//  but
-//    the algorithm below assumes a default of 'column'.
-//
-// Input parameters:
-//    - node: current node to be sized and layed out
-//    - availableWidth & availableHeight: available size to be used for sizing
-//    the node
-//      or YGUndefined if the size is not available; interpretation depends on
-//      layout
-//      flags
-//    - parentDirection: the inline (text) direction within the parent
-//    (left-to-right or
-//      right-to-left)
-//    - widthMeasureMode: indicates the sizing rules for the width (see below
-//    for explanation)
-//    - heightMeasureMode: indicates the sizing rules for the height (see below
-//    for explanation)
-//    - performLayout: specifies whether the caller is interested in just the
-//    dimensions
-//      of the node or it requires the entire node and its subtree to be layed
-//      out
-//      (with final positions)
-//
-// Details:
-//    This routine is called recursively to lay out subtrees of flexbox
-//    elements. It uses the
-//    information in node.style, which is treated as a read-only input. It is
-//    responsible for
-//    setting the layout.direction and layout.measuredDimensions fields for the
-//    input node as well
-//    as the layout.position and layout.lineIndex fields for its child nodes.
-//    The
-//    layout.measuredDimensions field includes any border or padding for the
-//    node but does
-//    not include margins.
-//
-//    The spec describes four different layout modes: "fill available", "max
-//    content", "min
-//    content",
-//    and "fit content". Of these, we don't use "min content" because we don't
-//    support default
-//    minimum main sizes (see above for details). Each of our measure modes maps
-//    to a layout mode
-//    from the spec (https://www.w3.org/TR/YG3-sizing/#terms):
-//      - YGMeasureModeUndefined: max content
-//      - YGMeasureModeExactly: fill available
-//      - YGMeasureModeAtMost: fit content
-//
-//    When calling YGNodelayoutImpl and YGLayoutNodeInternal, if the caller passes
-//    an available size of
-//    undefined then it must also pass a measure mode of YGMeasureModeUndefined
-//    in that dimension.
-//
-static void YGNodelayoutImpl(const YGNodeRef node,
-                             const float availableWidth,
-                             const float availableHeight,
-                             const YGDirection parentDirection,
-                             const YGMeasureMode widthMeasureMode,
-                             const YGMeasureMode heightMeasureMode,
-                             const float parentWidth,
-                             const float parentHeight,
-                             const bool performLayout) {
-  YG_ASSERT(YGFloatIsUndefined(availableWidth) ? widthMeasureMode == YGMeasureModeUndefined : true,
-            "availableWidth is indefinite so widthMeasureMode must be "
-            "YGMeasureModeUndefined");
-  YG_ASSERT(YGFloatIsUndefined(availableHeight) ? heightMeasureMode == YGMeasureModeUndefined
-            : true,
-            "availableHeight is indefinite so heightMeasureMode must be "
-            "YGMeasureModeUndefined");
-
-  // Set the resolved resolution in the node's layout.
-  const YGDirection direction = YGNodeResolveDirection(node, parentDirection);
-  node->layout.direction = direction;
-
-  const YGFlexDirection flexRowDirection = YGFlexDirectionResolve(YGFlexDirectionRow, direction);
-  const YGFlexDirection flexColumnDirection =
-  YGFlexDirectionResolve(YGFlexDirectionColumn, direction);
-
-  node->layout.margin[YGEdgeStart] = YGNodeLeadingMargin(node, flexRowDirection, parentWidth);
-  node->layout.margin[YGEdgeEnd] = YGNodeTrailingMargin(node, flexRowDirection, parentWidth);
-  node->layout.margin[YGEdgeTop] = YGNodeLeadingMargin(node, flexColumnDirection, parentWidth);
-  node->layout.margin[YGEdgeBottom] = YGNodeTrailingMargin(node, flexColumnDirection, parentWidth);
+// Layout of a virtualized container (see YGNodeSetVirtualized). Only the children around the
+// viewport are laid out and positioned, the extent of the others comes from the sizes they had
+// when last laid out or, for children never laid out, from the average of the known sizes.
+// Children are sized by their flex basis: flexible lengths, justification and multi-line
+// alignment are not resolved in virtualized containers.
+// Lays out one in-flow child of a virtualized container along its main axis.
+static void YGVirtualizedLayoutChild(const YGNodeRef node,
+                                     const YGNodeRef child,
+                                     const YGDirection direction,
+                                     const YGFlexDirection mainAxis,
+                                     const YGFlexDirection crossAxis,
+                                     const YGFloat availableInnerWidth,
+                                     const YGFloat availableInnerHeight,
+                                     const YGMeasureMode widthMeasureMode,
+                                     const YGMeasureMode heightMeasureMode,
+                                     const YGMeasureMode measureModeCrossDim,
+                                     const bool performLayout) {
+  const bool isMainAxisRow = YGFlexDirectionIsRow(mainAxis);
+  const YGFloat availableInnerCrossDim = isMainAxisRow ? availableInnerHeight : availableInnerWidth;
+
+  YGNodeComputeFlexBasisForChild(node,
+                                 child,
+                                 availableInnerWidth,
+                                 widthMeasureMode,
+                                 availableInnerHeight,
+                                 availableInnerWidth,
+                                 availableInnerHeight,
+                                 heightMeasureMode,
+                                 direction);
+
+  const YGFloat marginMain = YGNodeMarginForAxis(child, mainAxis, availableInnerWidth);
+  const YGFloat marginCross = YGNodeMarginForAxis(child, crossAxis, availableInnerWidth);
+
+  YGFloat childCrossSize;
+  YGFloat childMainSize = child->layout.computedFlexBasis + marginMain;
+  YGMeasureMode childCrossMeasureMode;
+  YGMeasureMode childMainMeasureMode = YGMeasureModeExactly;
+
+  if (!YGFloatIsUndefined(availableInnerCrossDim) &&
+      !YGNodeIsStyleDimDefined(child, crossAxis, availableInnerCrossDim) &&
+      measureModeCrossDim == YGMeasureModeExactly &&
+      YGNodeAlignItem(node, child) == YGAlignStretch) {
+    childCrossSize = availableInnerCrossDim;
+    childCrossMeasureMode = YGMeasureModeExactly;
+  } else if (!YGNodeIsStyleDimDefined(child, crossAxis, availableInnerCrossDim)) {
+    childCrossSize = availableInnerCrossDim;
+    childCrossMeasureMode =
+    YGFloatIsUndefined(childCrossSize) ? YGMeasureModeUndefined : YGMeasureModeAtMost;
+  } else {
+    childCrossSize =
+    YGValueResolve(child->resolvedDimensions[dim[crossAxis]], availableInnerCrossDim) +
+    marginCross;
+    childCrossMeasureMode =
+    YGFloatIsUndefined(childCrossSize) ? YGMeasureModeUndefined : YGMeasureModeExactly;
+  }
 
-  node->layout.border[YGEdgeStart] = YGNodeLeadingBorder(node, flexRowDirection);
-  node->layout.border[YGEdgeEnd] = YGNodeTrailingBorder(node, flexRowDirection);
-  node->layout.border[YGEdgeTop] = YGNodeLeadingBorder(node, flexColumnDirection);
-  node->layout.border[YGEdgeBottom] = YGNodeTrailingBorder(node, flexColumnDirection);
+  if (!YGFloatIsUndefined(child->style.aspectRatio)) {
+    childCrossSize = marginCross +
+    YGFloatMax(isMainAxisRow ? (childMainSize - marginMain) / child->style.aspectRatio
+               : (childMainSize - marginMain) * child->style.aspectRatio,
+               YGNodePaddingAndBorderForAxis(child, crossAxis, availableInnerWidth));
+    childCrossMeasureMode = YGMeasureModeExactly;
+  }
 
-  node->layout.padding[YGEdgeStart] = YGNodeLeadingPadding(node, flexRowDirection, parentWidth);
-  node->layout.padding[YGEdgeEnd] = YGNodeTrailingPadding(node, flexRowDirection, parentWidth);
-  node->layout.padding[YGEdgeTop] = YGNodeLeadingPadding(node, flexColumnDirection, parentWidth);
-  node->layout.padding[YGEdgeBottom] =
-  YGNodeTrailingPadding(node, flexColumnDirection, parentWidth);
+  YGConstrainMaxSizeForMode(YGValueResolve(&child->style.maxDimensions[dim[mainAxis]],
+                                           availableInnerWidth),
+                            &childMainMeasureMode,
+                            &childMainSize);
+  YGConstrainMaxSizeForMode(YGValueResolve(&child->style.maxDimensions[dim[crossAxis]],
+                                           availableInnerHeight),
+                            &childCrossMeasureMode,
+                            &childCrossSize);
 
-  if (node->measure) {
-    YGNodeWithMeasureFuncSetMeasuredDimensions(node,
-                                               availableWidth,
-                                               availableHeight,
-                                               widthMeasureMode,
-                                               heightMeasureMode,
-                                               parentWidth,
-                                               parentHeight);
-    return;
-  }
+  const bool requiresStretchLayout =
+  !YGNodeIsStyleDimDefined(child, crossAxis, availableInnerCrossDim) &&
+  YGNodeAlignItem(node, child) == YGAlignStretch;
 
-  const uint32_t childCount = YGNodeListCount(node->children);
-  if (childCount == 0) {
-    YGNodeEmptyContainerSetMeasuredDimensions(node,
-                                              availableWidth,
-                                              availableHeight,
-                                              widthMeasureMode,
-                                              heightMeasureMode,
-                                              parentWidth,
-                                              parentHeight);
-    return;
-  }
+  YGLayoutNodeInternal(child,
+                       isMainAxisRow ? childMainSize : childCrossSize,
+                       isMainAxisRow ? childCrossSize : childMainSize,
+                       direction,
+                       isMainAxisRow ? childMainMeasureMode : childCrossMeasureMode,
+                       isMainAxisRow ? childCrossMeasureMode : childMainMeasureMode,
+                       availableInnerWidth,
+                       availableInnerHeight,
+                       performLayout && !requiresStretchLayout,
+                       "virtualized");
+}
 
-  // If we're not being asked to perform a full layout we can skip the algorithm if we already know
-  // the size
-  if (!performLayout && YGNodeFixedSizeSetMeasuredDimensions(node,
-                                                             availableWidth,
-                                                             availableHeight,
-                                                             widthMeasureMode,
-                                                             heightMeasureMode,
-                                                             parentWidth,
-                                                             parentHeight)) {
-    return;
-  }
+static void YGNodeVirtualizedLayoutImpl(const YGNodeRef node,
+                                        const uint32_t childCount,
+                                        const YGFloat availableWidth,
+                                        const YGFloat availableHeight,
+                                        const YGDirection direction,
+                                        const YGMeasureMode widthMeasureMode,
+                                        const YGMeasureMode heightMeasureMode,
+                                        const YGFloat parentWidth,
+                                        const YGFloat parentHeight,
+                                        const bool performLayout) {
+  const YGVirtualizedListRef list = node->extras->virtualized;
 
-  // STEP 1: CALCULATE VALUES FOR REMAINDER OF ALGORITHM
   const YGFlexDirection mainAxis = YGFlexDirectionResolve(node->style.flexDirection, direction);
   const YGFlexDirection crossAxis = YGFlexDirectionCross(mainAxis, direction);
   const bool isMainAxisRow = YGFlexDirectionIsRow(mainAxis);
-  const YGJustify justifyContent = node->style.justifyContent;
-  const bool isNodeFlexWrap = node->style.flexWrap != YGWrapNoWrap;
 
-  const float mainAxisParentSize = isMainAxisRow ? parentWidth : parentHeight;
-  const float crossAxisParentSize = isMainAxisRow ? parentHeight : parentWidth;
+  if (!list->streaming &&
+      (list->needsRebuild || list->count != childCount || list->mainAxis != mainAxis)) {
+    YGVirtualizedListReserve(list, childCount);
+    if (list->childFunc != NULL) {
+      // Virtual children only exist as nodes within the window. The sizes known for them stay
+      // valid when the data source grew or shrank at its end, otherwise they are measured again.
+      const uint32_t keptCount = list->needsRebuild || list->mainAxis != mainAxis
+                                     ? 0
+                                     : (list->count < childCount ? list->count : childCount);
+      if (keptCount == 0) {
+        list->maxCrossSize = 0;
+      }
+      for (uint32_t i = keptCount; i < childCount; i++) {
+        list->sizes[i] = YGUndefined;
+      }
+    } else {
+      list->maxCrossSize = 0;
+      for (uint32_t i = 0; i < childCount; i++) {
+        const YGNodeRef child = YGNodeListGet(node->children, i);
+        const YGFloat *const margin = child->layout.margin;
+        const YGFloat marginRow = margin[YGEdgeStart] + margin[YGEdgeEnd];
+        const YGFloat marginColumn = margin[YGEdgeTop] + margin[YGEdgeBottom];
+        if (child->style.display == YGDisplayNone ||
+            child->style.positionType == YGPositionTypeAbsolute) {
+          list->sizes[i] = 0;
+        } else if (YGFloatIsUndefined(child->layout.measuredDimensions[dim[mainAxis]])) {
+          list->sizes[i] = YGUndefined;
+        } else {
+          list->sizes[i] = child->layout.measuredDimensions[dim[mainAxis]] +
+          (isMainAxisRow ? marginRow : marginColumn);
+          const YGFloat crossSize = child->layout.measuredDimensions[dim[crossAxis]] +
+          (isMainAxisRow ? marginColumn : marginRow);
+          if (!YGFloatIsUndefined(crossSize)) {
+            list->maxCrossSize = YGFloatMax(list->maxCrossSize, crossSize);
+          }
+        }
+      }
+    }
+    list->count = childCount;
+    list->mainAxis = mainAxis;
+    YGVirtualizedListBuildTrees(list);
+    list->needsRebuild = false;
+  }
 
-  YGNodeRef firstAbsoluteChild = NULL;
-  YGNodeRef currentAbsoluteChild = NULL;
+  const YGFloat mainAxisParentSize = isMainAxisRow ? parentWidth : parentHeight;
+  const YGFloat crossAxisParentSize = isMainAxisRow ? parentHeight : parentWidth;
 
-  const float leadingPaddingAndBorderMain =
+  const YGFloat leadingPaddingAndBorderMain =
   YGNodeLeadingPaddingAndBorder(node, mainAxis, parentWidth);
-  const float trailingPaddingAndBorderMain =
-  YGNodeTrailingPaddingAndBorder(node, mainAxis, parentWidth);
-  const float leadingPaddingAndBorderCross =
+  const YGFloat leadingPaddingAndBorderCross =
   YGNodeLeadingPaddingAndBorder(node, crossAxis, parentWidth);
-  const float paddingAndBorderAxisMain = YGNodePaddingAndBorderForAxis(node, mainAxis, parentWidth);
-  const float paddingAndBorderAxisCross =
+  const YGFloat paddingAndBorderAxisMain = YGNodePaddingAndBorderForAxis(node, mainAxis, parentWidth);
+  const YGFloat paddingAndBorderAxisCross =
   YGNodePaddingAndBorderForAxis(node, crossAxis, parentWidth);
 
   const YGMeasureMode measureModeMainDim = isMainAxisRow ? widthMeasureMode : heightMeasureMode;
   const YGMeasureMode measureModeCrossDim = isMainAxisRow ? heightMeasureMode : widthMeasureMode;
 
-  const float paddingAndBorderAxisRow =
+  const YGFloat paddingAndBorderAxisRow =
   isMainAxisRow ? paddingAndBorderAxisMain : paddingAndBorderAxisCross;
-  const float paddingAndBorderAxisColumn =
+  const YGFloat paddingAndBorderAxisColumn =
   isMainAxisRow ? paddingAndBorderAxisCross : paddingAndBorderAxisMain;
 
-  const float marginAxisRow = YGNodeMarginForAxis(node, YGFlexDirectionRow, parentWidth);
-  const float marginAxisColumn = YGNodeMarginForAxis(node, YGFlexDirectionColumn, parentWidth);
+  const YGFloat marginAxisRow = YGNodeMarginForAxis(node, YGFlexDirectionRow, parentWidth);
+  const YGFloat marginAxisColumn = YGNodeMarginForAxis(node, YGFlexDirectionColumn, parentWidth);
 
-  // STEP 2: DETERMINE AVAILABLE SIZE IN MAIN AND CROSS DIRECTIONS
-  const float minInnerWidth =
+  const YGFloat minInnerWidth =
   YGValueResolve(&node->style.minDimensions[YGDimensionWidth], parentWidth) - marginAxisRow -
   paddingAndBorderAxisRow;
-  const float maxInnerWidth =
+  const YGFloat maxInnerWidth =
   YGValueResolve(&node->style.maxDimensions[YGDimensionWidth], parentWidth) - marginAxisRow -
   paddingAndBorderAxisRow;
-  const float minInnerHeight =
+  const YGFloat minInnerHeight =
   YGValueResolve(&node->style.minDimensions[YGDimensionHeight], parentHeight) -
   marginAxisColumn - paddingAndBorderAxisColumn;
-  const float maxInnerHeight =
+  const YGFloat maxInnerHeight =
   YGValueResolve(&node->style.maxDimensions[YGDimensionHeight], parentHeight) -
   marginAxisColumn - paddingAndBorderAxisColumn;
-  const float minInnerMainDim = isMainAxisRow ? minInnerWidth : minInnerHeight;
-  const float maxInnerMainDim = isMainAxisRow ? maxInnerWidth : maxInnerHeight;
 
-  // Max dimension overrides predefined dimension value; Min dimension in turn overrides both of the
-  // above
-  float availableInnerWidth = availableWidth - marginAxisRow - paddingAndBorderAxisRow;
+  YGFloat availableInnerWidth = availableWidth - marginAxisRow - paddingAndBorderAxisRow;
   if (!YGFloatIsUndefined(availableInnerWidth)) {
-    availableInnerWidth = fmaxf(fminf(availableInnerWidth, maxInnerWidth), minInnerWidth);
+    availableInnerWidth = YGFloatMax(YGFloatMin(availableInnerWidth, maxInnerWidth), minInnerWidth);
   }
 
-  float availableInnerHeight = availableHeight - marginAxisColumn - paddingAndBorderAxisColumn;
+  YGFloat availableInnerHeight = availableHeight - marginAxisColumn - paddingAndBorderAxisColumn;
   if (!YGFloatIsUndefined(availableInnerHeight)) {
-    availableInnerHeight = fmaxf(fminf(availableInnerHeight, maxInnerHeight), minInnerHeight);
+    availableInnerHeight = YGFloatMax(YGFloatMin(availableInnerHeight, maxInnerHeight), minInnerHeight);
   }
 
-  float availableInnerMainDim = isMainAxisRow ? availableInnerWidth : availableInnerHeight;
-  const float availableInnerCrossDim = isMainAxisRow ? availableInnerHeight : availableInnerWidth;
+  const YGFloat availableInnerMainDim = isMainAxisRow ? availableInnerWidth : availableInnerHeight;
+  const YGFloat availableInnerCrossDim = isMainAxisRow ? availableInnerHeight : availableInnerWidth;
+
+  // The window spans the viewport plus half a viewport of overscan on either side. It starts at
+  // the child covering its leading edge and grows until the children laid out reach its
+  // trailing edge, so it stays covered however far the estimates were off.
+  const YGFloat overscan = list->viewportLength / 2;
+  const YGFloat windowStart = list->viewportStart - overscan - leadingPaddingAndBorderMain;
+  const YGFloat windowEnd =
+  list->viewportStart + list->viewportLength + overscan - leadingPaddingAndBorderMain;
+
+  // A streaming container continues after the children it laid out before, as long as they
+  // were laid out the same way and its cross size cannot grow with the new ones.
+  const bool continueStream =
+  list->streaming && !list->needsRebuild && !node->hasDirtyDescendant &&
+  list->laidOutCount <= childCount && list->mainAxis == mainAxis &&
+  list->laidOutDirection == direction && measureModeCrossDim == YGMeasureModeExactly &&
+  YGFloatsEqual(list->laidOutInnerWidth, availableInnerWidth) &&
+  YGFloatsEqual(list->laidOutInnerHeight, availableInnerHeight) &&
+  YGFloatsEqual(list->laidOutParentWidth, parentWidth);
+
+  // While the windows are pinned, virtual children keep the window they have.
+  const bool pinned = list->childFunc != NULL && gVirtualWindowsPinned;
+
+  // Without a known size to estimate by the window could only be found by laying out every child
+  // before it, so children are measured from the first until one gives an estimate to jump by.
+  if (!list->streaming && !pinned && list->knownSizeTotal <= 0 && windowStart > 0) {
+    for (uint32_t index = 0; index < childCount && list->knownSizeTotal <= 0; index++) {
+      const bool inWindow = list->childFunc == NULL ||
+                            (index >= list->firstMaterialized &&
+                             index - list->firstMaterialized < YGNodeListCount(node->children));
+      YGNodeRef child;
+      if (list->childFunc == NULL) {
+        child = YGNodeListGet(node->children, index);
+      } else if (inWindow) {
+        child = YGNodeListGet(node->children, index - list->firstMaterialized);
+      } else {
+        child = YGVirtualChildFetch(node, index);
+      }
 
-  // If there is only one child with flexGrow + flexShrink it means we can set the
-  // computedFlexBasis to 0 instead of measuring and shrinking / flexing the child to exactly
-  // match the remaining space
-  YGNodeRef singleFlexChild = NULL;
-  if ((isMainAxisRow && widthMeasureMode == YGMeasureModeExactly) ||
-      (!isMainAxisRow && heightMeasureMode == YGMeasureModeExactly)) {
-    for (uint32_t i = 0; i < childCount; i++) {
-      const YGNodeRef child = YGNodeGetChild(node, i);
-      if (singleFlexChild) {
-        if (YGNodeIsFlex(child)) {
-          // There is already a flexible child, abort.
-          singleFlexChild = NULL;
-          break;
+      const bool inFlow = child->style.display != YGDisplayNone &&
+                          child->style.positionType != YGPositionTypeAbsolute;
+      if (inFlow) {
+        YGResolveDimensions(child);
+        YGVirtualizedLayoutChild(node,
+                                 child,
+                                 direction,
+                                 mainAxis,
+                                 crossAxis,
+                                 availableInnerWidth,
+                                 availableInnerHeight,
+                                 widthMeasureMode,
+                                 heightMeasureMode,
+                                 measureModeCrossDim,
+                                 false);
+      }
+      YGVirtualizedListSetSize(list,
+                               index,
+                               inFlow ? YGNodeDimWithMargin(child, mainAxis, availableInnerWidth)
+                                      : 0);
+
+      if (!inWindow) {
+        child->parent = NULL;
+        if (list->recycleFunc != NULL) {
+          list->recycleFunc(node, child);
         }
-      } else if (YGNodeStyleGetFlexGrow(child) > 0.0f && YGNodeStyleGetFlexShrink(child) > 0.0f) {
-        singleFlexChild = child;
       }
     }
   }
 
-  float totalFlexBasis = 0;
+  uint32_t firstVisible;
+  if (list->streaming) {
+    firstVisible = continueStream ? list->laidOutCount : 0;
+  } else if (pinned) {
+    firstVisible = list->firstMaterialized;
+  } else {
+    firstVisible = YGVirtualizedListIndexAt(list, windowStart);
+  }
+  const uint32_t pinnedEnd = firstVisible + YGNodeListCount(node->children);
+  const uint32_t endLimit = pinned && pinnedEnd < childCount ? pinnedEnd : childCount;
+  uint32_t endVisible = firstVisible;
+  YGFloat windowOffset = list->streaming ? (continueStream ? list->laidOutExtent : 0)
+                                         : YGVirtualizedListOffset(list, firstVisible);
+  const YGFloat firstVisibleOffset = windowOffset;
+  if (list->streaming && !continueStream) {
+    list->maxCrossSize = 0;
+  }
 
-  // STEP 3: DETERMINE FLEX BASIS FOR EACH ITEM
-  for (uint32_t i = 0; i < childCount; i++) {
-    const YGNodeRef child = YGNodeListGet(node->children, i);
+  // Virtual children are indexed in the container's child list from the start of the window.
+  const uint32_t childOffset = list->childFunc != NULL ? firstVisible : 0;
+  const YGNodeListRef previousWindow = list->childFunc != NULL ? YGVirtualWindowBegin(node) : NULL;
+
+  YGNodeRef firstAbsoluteChild = NULL;
+  YGNodeRef currentAbsoluteChild = NULL;
+
+  while (endVisible < endLimit &&
+         (pinned || list->streaming || endVisible == firstVisible || windowOffset < windowEnd)) {
+    const uint32_t index = endVisible++;
+    const YGNodeRef child = list->childFunc != NULL
+                                ? YGVirtualWindowAdd(node, previousWindow, index)
+                                : YGNodeListGet(node->children, index);
     if (child->style.display == YGDisplayNone) {
       YGZeroOutLayoutRecursivly(child);
-      child->hasNewLayout = true;
+      YGNodeSetNewLayout(child);
       child->isDirty = false;
+      YGVirtualizedListSetSize(list, index, 0);
       continue;
     }
     YGResolveDimensions(child);
@@ -2003,11 +3605,7 @@ static void YGNodelayoutImpl(const YGNodeRef node,
                         availableInnerWidth);
     }
 
-    // Absolute-positioned children don't participate in flex layout. Add them
-    // to a list that we can process later.
     if (child->style.positionType == YGPositionTypeAbsolute) {
-      // Store a private linked list of absolutely positioned children
-      // so that we can efficiently traverse them later.
       if (firstAbsoluteChild == NULL) {
         firstAbsoluteChild = child;
       }
@@ -2016,1019 +3614,5007 @@ static void YGNodelayoutImpl(const YGNodeRef node,
       }
       currentAbsoluteChild = child;
       child->nextChild = NULL;
-    } else {
-      if (child == singleFlexChild) {
-        child->layout.computedFlexBasisGeneration = gCurrentGenerationCount;
-        child->layout.computedFlexBasis = 0;
-      } else {
-        YGNodeComputeFlexBasisForChild(node,
-                                       child,
-                                       availableInnerWidth,
-                                       widthMeasureMode,
-                                       availableInnerHeight,
-                                       availableInnerWidth,
-                                       availableInnerHeight,
-                                       heightMeasureMode,
-                                       direction);
-      }
+      YGVirtualizedListSetSize(list, index, 0);
+      continue;
     }
 
-    totalFlexBasis += child->layout.computedFlexBasis;
+    YGVirtualizedLayoutChild(node,
+                             child,
+                             direction,
+                             mainAxis,
+                             crossAxis,
+                             availableInnerWidth,
+                             availableInnerHeight,
+                             widthMeasureMode,
+                             heightMeasureMode,
+                             measureModeCrossDim,
+                             performLayout);
+
+    const YGFloat outerMainSize = YGNodeDimWithMargin(child, mainAxis, availableInnerWidth);
+    YGVirtualizedListSetSize(list, index, outerMainSize);
+    windowOffset += outerMainSize;
+    list->maxCrossSize =
+    YGFloatMax(list->maxCrossSize, YGNodeDimWithMargin(child, crossAxis, availableInnerWidth));
   }
 
-  const bool flexBasisOverflows =
-  measureModeMainDim == YGMeasureModeUndefined ? false : totalFlexBasis > availableInnerMainDim;
-
-  // STEP 4: COLLECT FLEX ITEMS INTO FLEX LINES
-
-  // Indexes of children that represent the first and last items in the line.
-  uint32_t startOfLineIndex = 0;
-  uint32_t endOfLineIndex = 0;
-
-  // Number of lines.
-  uint32_t lineCount = 0;
-
-  // Accumulated cross dimensions of all lines so far.
-  float totalLineCrossDim = 0;
-
-  // Max main dimension of all the lines.
-  float maxLineMainDim = 0;
+  if (list->childFunc != NULL) {
+    YGVirtualWindowEnd(node, previousWindow, firstVisible, endVisible);
+  }
+  list->firstVisible = list->streaming ? 0 : firstVisible - childOffset;
+  list->endVisible = endVisible - childOffset;
+  if (list->streaming && performLayout) {
+    list->needsRebuild = false;
+    list->mainAxis = mainAxis;
+    list->laidOutCount = endVisible;
+    list->laidOutExtent = windowOffset;
+    list->laidOutInnerWidth = availableInnerWidth;
+    list->laidOutInnerHeight = availableInnerHeight;
+    list->laidOutParentWidth = parentWidth;
+    list->laidOutDirection = direction;
+  }
 
-  for (; endOfLineIndex < childCount; lineCount++, startOfLineIndex = endOfLineIndex) {
-    // Number of items on the currently line. May be different than the
-    // difference
-    // between start and end indicates because we skip over absolute-positioned
-    // items.
-    uint32_t itemsOnLine = 0;
+  // The sizes just measured refine the estimate for the children before the window as well.
+  const YGFloat contentMainDim = list->streaming ? list->retiredExtent + windowOffset
+                                                 : YGVirtualizedListOffset(list, childCount);
+  const YGFloat maxLineMainDim = contentMainDim + paddingAndBorderAxisMain;
 
-    // sizeConsumedOnCurrentLine is accumulation of the dimensions and margin
-    // of all the children on the current line. This will be used in order to
-    // either set the dimensions of the node if none already exist or to compute
-    // the remaining space left for the flexible children.
-    float sizeConsumedOnCurrentLine = 0;
+  YGFloat containerCrossAxis = availableInnerCrossDim;
+  if (measureModeCrossDim == YGMeasureModeUndefined ||
+      measureModeCrossDim == YGMeasureModeAtMost) {
+    containerCrossAxis = YGNodeBoundAxis(node,
+                                         crossAxis,
+                                         list->maxCrossSize + paddingAndBorderAxisCross,
+                                         crossAxisParentSize,
+                                         parentWidth) -
+    paddingAndBorderAxisCross;
 
-    float totalFlexGrowFactors = 0;
-    float totalFlexShrinkScaledFactors = 0;
+    if (measureModeCrossDim == YGMeasureModeAtMost) {
+      containerCrossAxis = YGFloatMin(containerCrossAxis, availableInnerCrossDim);
+    }
+  }
 
-    // Maintain a linked list of the child nodes that can shrink and/or grow.
-    YGNodeRef firstRelativeChild = NULL;
-    YGNodeRef currentRelativeChild = NULL;
+  YGFloat crossDim =
+  measureModeCrossDim == YGMeasureModeExactly ? availableInnerCrossDim : list->maxCrossSize;
+  crossDim = YGNodeBoundAxis(node,
+                             crossAxis,
+                             crossDim + paddingAndBorderAxisCross,
+                             crossAxisParentSize,
+                             parentWidth) -
+  paddingAndBorderAxisCross;
 
-    // Add items to the current line until it's full or we run out of items.
-    for (uint32_t i = startOfLineIndex; i < childCount; i++, endOfLineIndex++) {
-      const YGNodeRef child = YGNodeListGet(node->children, i);
+  if (performLayout) {
+    YGFloat mainDim = leadingPaddingAndBorderMain + firstVisibleOffset +
+    (list->streaming ? list->retiredExtent : 0);
+    for (uint32_t i = firstVisible; i < endVisible; i++) {
+      const YGNodeRef child = YGNodeListGet(node->children, i - childOffset);
       if (child->style.display == YGDisplayNone) {
         continue;
       }
-      child->lineIndex = lineCount;
-
-      if (child->style.positionType != YGPositionTypeAbsolute) {
-        const float outerFlexBasis =
-        fmaxf(YGValueResolve(&child->style.minDimensions[dim[mainAxis]], mainAxisParentSize),
-              child->layout.computedFlexBasis) +
-        YGNodeMarginForAxis(child, mainAxis, availableInnerWidth);
 
-        // If this is a multi-line flow and this item pushes us over the
-        // available size, we've
-        // hit the end of the current line. Break out of the loop and lay out
-        // the current line.
-        if (sizeConsumedOnCurrentLine + outerFlexBasis > availableInnerMainDim && isNodeFlexWrap &&
-            itemsOnLine > 0) {
-          break;
+      if (child->style.positionType == YGPositionTypeAbsolute) {
+        if (YGNodeIsLeadingPosDefined(child, mainAxis)) {
+          child->layout.position[pos[mainAxis]] =
+          YGNodeLeadingPosition(child, mainAxis, availableInnerMainDim) +
+          YGNodeLeadingBorder(node, mainAxis) +
+          YGNodeLeadingMargin(child, mainAxis, availableInnerWidth);
+        } else {
+          child->layout.position[pos[mainAxis]] += YGNodeLeadingBorder(node, mainAxis);
         }
-
-        sizeConsumedOnCurrentLine += outerFlexBasis;
-        itemsOnLine++;
-
-        if (YGNodeIsFlex(child)) {
-          totalFlexGrowFactors += YGNodeStyleGetFlexGrow(child);
-
-          // Unlike the grow factor, the shrink factor is scaled relative to the
-          // child
-          // dimension.
-          totalFlexShrinkScaledFactors +=
-          -YGNodeStyleGetFlexShrink(child) * child->layout.computedFlexBasis;
+        if (YGNodeIsLeadingPosDefined(child, crossAxis)) {
+          child->layout.position[pos[crossAxis]] =
+          YGNodeLeadingPosition(child, crossAxis, availableInnerCrossDim) +
+          YGNodeLeadingBorder(node, crossAxis) +
+          YGNodeLeadingMargin(child, crossAxis, availableInnerWidth);
+        } else {
+          child->layout.position[pos[crossAxis]] =
+          YGNodeLeadingBorder(node, crossAxis) +
+          YGNodeLeadingMargin(child, crossAxis, availableInnerWidth);
         }
+        continue;
+      }
 
-        // Store a private linked list of children that need to be layed out.
-        if (firstRelativeChild == NULL) {
-          firstRelativeChild = child;
+      child->layout.position[pos[mainAxis]] += mainDim;
+      mainDim += YGNodeDimWithMargin(child, mainAxis, availableInnerWidth);
+
+      YGFloat leadingCrossDim = leadingPaddingAndBorderCross;
+      const YGAlign alignItem = YGNodeAlignItem(node, child);
+      if (alignItem == YGAlignStretch &&
+          child->style.margin[leading[crossAxis]].unit != YGUnitAuto &&
+          child->style.margin[trailing[crossAxis]].unit != YGUnitAuto) {
+        if (!YGNodeIsStyleDimDefined(child, crossAxis, availableInnerCrossDim)) {
+          YGFloat childMainSize = child->layout.measuredDimensions[dim[mainAxis]];
+          YGFloat childCrossSize =
+          !YGFloatIsUndefined(child->style.aspectRatio)
+          ? ((YGNodeMarginForAxis(child, crossAxis, availableInnerWidth) +
+              (isMainAxisRow ? childMainSize / child->style.aspectRatio
+               : childMainSize * child->style.aspectRatio)))
+          : crossDim;
+
+          childMainSize += YGNodeMarginForAxis(child, mainAxis, availableInnerWidth);
+
+          YGMeasureMode childMainMeasureMode = YGMeasureModeExactly;
+          YGMeasureMode childCrossMeasureMode = YGMeasureModeExactly;
+          YGConstrainMaxSizeForMode(YGValueResolve(&child->style.maxDimensions[dim[mainAxis]],
+                                                   availableInnerMainDim),
+                                    &childMainMeasureMode,
+                                    &childMainSize);
+          YGConstrainMaxSizeForMode(YGValueResolve(&child->style.maxDimensions[dim[crossAxis]],
+                                                   availableInnerCrossDim),
+                                    &childCrossMeasureMode,
+                                    &childCrossSize);
+
+          const YGFloat childWidth = isMainAxisRow ? childMainSize : childCrossSize;
+          const YGFloat childHeight = !isMainAxisRow ? childMainSize : childCrossSize;
+
+          YGLayoutNodeInternal(child,
+                               childWidth,
+                               childHeight,
+                               direction,
+                               YGFloatIsUndefined(childWidth) ? YGMeasureModeUndefined
+                               : YGMeasureModeExactly,
+                               YGFloatIsUndefined(childHeight) ? YGMeasureModeUndefined
+                               : YGMeasureModeExactly,
+                               availableInnerWidth,
+                               availableInnerHeight,
+                               true,
+                               "stretch");
         }
-        if (currentRelativeChild != NULL) {
-          currentRelativeChild->nextChild = child;
+      } else {
+        const YGFloat remainingCrossDim =
+        containerCrossAxis - YGNodeDimWithMargin(child, crossAxis, availableInnerWidth);
+
+        if (child->style.margin[leading[crossAxis]].unit == YGUnitAuto &&
+            child->style.margin[trailing[crossAxis]].unit == YGUnitAuto) {
+          leadingCrossDim += remainingCrossDim / 2;
+        } else if (child->style.margin[trailing[crossAxis]].unit == YGUnitAuto) {
+          // No-Op
+        } else if (child->style.margin[leading[crossAxis]].unit == YGUnitAuto) {
+          leadingCrossDim += remainingCrossDim;
+        } else if (alignItem == YGAlignFlexStart || alignItem == YGAlignBaseline) {
+          // No-Op
+        } else if (alignItem == YGAlignCenter) {
+          leadingCrossDim += remainingCrossDim / 2;
+        } else {
+          leadingCrossDim += remainingCrossDim;
         }
-        currentRelativeChild = child;
-        child->nextChild = NULL;
       }
+      child->layout.position[pos[crossAxis]] += leadingCrossDim;
     }
+  }
 
-    // If we don't need to measure the cross axis, we can skip the entire flex
-    // step.
-    const bool canSkipFlex = !performLayout && measureModeCrossDim == YGMeasureModeExactly;
+  node->layout.measuredDimensions[YGDimensionWidth] =
+  YGNodeBoundAxis(node, YGFlexDirectionRow, availableWidth - marginAxisRow, parentWidth, parentWidth);
+  node->layout.measuredDimensions[YGDimensionHeight] = YGNodeBoundAxis(
+      node, YGFlexDirectionColumn, availableHeight - marginAxisColumn, parentHeight, parentWidth);
 
-    // In order to position the elements in the main axis, we have two
-    // controls. The space between the beginning and the first element
-    // and the space between each two elements.
-    float leadingMainDim = 0;
-    float betweenMainDim = 0;
+  if (measureModeMainDim == YGMeasureModeUndefined ||
+      (node->style.overflow != YGOverflowScroll && measureModeMainDim == YGMeasureModeAtMost)) {
+    node->layout.measuredDimensions[dim[mainAxis]] =
+    YGNodeBoundAxis(node, mainAxis, maxLineMainDim, mainAxisParentSize, parentWidth);
+  } else if (measureModeMainDim == YGMeasureModeAtMost &&
+             node->style.overflow == YGOverflowScroll) {
+    node->layout.measuredDimensions[dim[mainAxis]] =
+    YGFloatMax(YGFloatMin(availableInnerMainDim + paddingAndBorderAxisMain,
+                          YGNodeBoundAxisWithinMinAndMax(node,
+                                                         mainAxis,
+                                                         maxLineMainDim,
+                                                         mainAxisParentSize)),
+               paddingAndBorderAxisMain);
+  }
 
-    // STEP 5: RESOLVING FLEXIBLE LENGTHS ON MAIN AXIS
+  if (measureModeCrossDim == YGMeasureModeUndefined ||
+      (node->style.overflow != YGOverflowScroll && measureModeCrossDim == YGMeasureModeAtMost)) {
+    node->layout.measuredDimensions[dim[crossAxis]] =
+    YGNodeBoundAxis(node,
+                    crossAxis,
+                    crossDim + paddingAndBorderAxisCross,
+                    crossAxisParentSize,
+                    parentWidth);
+  } else if (measureModeCrossDim == YGMeasureModeAtMost &&
+             node->style.overflow == YGOverflowScroll) {
+    node->layout.measuredDimensions[dim[crossAxis]] =
+    YGFloatMax(YGFloatMin(availableInnerCrossDim + paddingAndBorderAxisCross,
+                          YGNodeBoundAxisWithinMinAndMax(node,
+                                                         crossAxis,
+                                                         crossDim + paddingAndBorderAxisCross,
+                                                         crossAxisParentSize)),
+               paddingAndBorderAxisCross);
+  }
+
+  if (performLayout) {
+    for (currentAbsoluteChild = firstAbsoluteChild; currentAbsoluteChild != NULL;
+         currentAbsoluteChild = currentAbsoluteChild->nextChild) {
+      YGNodeAbsoluteLayoutChild(node,
+                                currentAbsoluteChild,
+                                availableInnerWidth,
+                                widthMeasureMode,
+                                availableInnerHeight,
+                                direction);
+    }
+
+    if (crossAxis == YGFlexDirectionRowReverse || crossAxis == YGFlexDirectionColumnReverse) {
+      for (uint32_t i = firstVisible; i < endVisible; i++) {
+        const YGNodeRef child = YGNodeListGet(node->children, i - childOffset);
+        if (child->style.display != YGDisplayNone) {
+          YGNodeSetChildTrailingPosition(node, child, crossAxis);
+        }
+      }
+    }
+  }
+}
+
+// Distinct kinds of children a container tries to match each child with.
+#define YG_MAX_INSTANCE_CANDIDATES 4
+
+// Whether two nodes are laid out alike given the same constraints, their children aside. A leaf
+// measured through a measure function needs a key vouching for its measurements.
+static inline bool YGNodeMatchesInstance(const YGNodeRef node, const YGNodeRef instance) {
+  return node->measure == instance->measure && node->measureKey == instance->measureKey &&
+         (node->measure == NULL || node->measureKey != 0) &&
+         node->batchMeasure == instance->batchMeasure && node->extras->virtualized == NULL &&
+         instance->extras->virtualized == NULL && !node->extras->frozen &&
+         !instance->extras->frozen && !node->extras->layoutDeferred &&
+         !instance->extras->layoutDeferred &&
+         YGNodeListCount(node->children) == YGNodeListCount(instance->children) &&
+         memcmp(&node->style, &instance->style, sizeof(YGStyle)) == 0;
+}
+
+// Points every child at the first earlier sibling it matches, if any.
+static void YGNodeAssignInstances(const YGNodeRef node) {
+  uint32_t candidates[YG_MAX_INSTANCE_CANDIDATES];
+  uint32_t candidateCount = 0;
+  const uint32_t childCount = YGNodeListCount(node->children);
+  for (uint32_t i = 0; i < childCount; i++) {
+    const YGNodeRef child = YGNodeListGet(node->children, i);
+    uint32_t instanceIndex = UINT32_MAX;
+    for (uint32_t j = 0; j < candidateCount; j++) {
+      if (YGNodeMatchesInstance(child, YGNodeListGet(node->children, candidates[j]))) {
+        instanceIndex = candidates[j];
+        break;
+      }
+    }
+    // Children matching no earlier sibling need no extras for it.
+    if (instanceIndex != child->extras->instanceIndex) {
+      YGNodeGetExtras(child)->instanceIndex = instanceIndex;
+    }
+    if (instanceIndex == UINT32_MAX && candidateCount < YG_MAX_INSTANCE_CANDIDATES) {
+      candidates[candidateCount++] = i;
+    }
+  }
+}
+
+//
+// This is the main routine that implements a subset of the flexbox layout
+// algorithm
+// described in the W3C YG documentation: https://www.w3.org/TR/YG3-flexbox/.
+//
+// Limitations of this algorithm, compared to the full standard:
+//  * Display property is always assumed to be 'flex' except for Text nodes,
+//  which
+//    are assumed to be 'inline-flex'.
+//  * The 'zIndex' property (or any form of z ordering) is not supported. Nodes
+//  are
+//    stacked in document order.
+//  * The 'order' property is not supported. The order of flex items is always
+//  defined
+//    by document order.
+//  * The 'visibility' property is always assumed to be 'visible'. Values of
+//  'collapse'
+//    and 'hidden' are not supported.
+//  * There is no support for forced breaks.
+//  * It does not support vertical inline directions (top-to-bottom or
+//  bottom-to-top text).
+//
+// Deviations from standard:
+//  * Section 4.5 of the spec indicates that all flex items have a default
+//  minimum
+//    main size. For text blocks, for example, this is the width of the widest
+//    word.
+//    Calculating the minimum width is expensive, so we forego it and assume a
+//    default
+//    minimum main size of 0.
+//  * Min/Max sizes in the main axis are not honored when resolving flexible
+//  lengths.
+//  * The spec indicates that the default value for 'flexDirection' is 'row',
+//  but
+//    the algorithm below assumes a default of 'column'.
+//
+// Input parameters:
+//    - node: current node to be sized and layed out
+//    - availableWidth & availableHeight: available size to be used for sizing
+//    the node
+//      or YGUndefined if the size is not available; interpretation depends on
+//      layout
+//      flags
+//    - parentDirection: the inline (text) direction within the parent
+//    (left-to-right or
+//      right-to-left)
+//    - widthMeasureMode: indicates the sizing rules for the width (see below
+//    for explanation)
+//    - heightMeasureMode: indicates the sizing rules for the height (see below
+//    for explanation)
+//    - performLayout: specifies whether the caller is interested in just the
+//    dimensions
+//      of the node or it requires the entire node and its subtree to be layed
+//      out
+//      (with final positions)
+//
+// Details:
+//    This routine is called recursively to lay out subtrees of flexbox
+//    elements. It uses the
+//    information in node.style, which is treated as a read-only input. It is
+//    responsible for
+//    setting the layout.direction and layout.measuredDimensions fields for the
+//    input node as well
+//    as the layout.position and layout.lineIndex fields for its child nodes.
+//    The
+//    layout.measuredDimensions field includes any border or padding for the
+//    node but does
+//    not include margins.
+//
+//    The spec describes four different layout modes: "fill available", "max
+//    content", "min
+//    content",
+//    and "fit content". Of these, we don't use "min content" because we don't
+//    support default
+//    minimum main sizes (see above for details). Each of our measure modes maps
+//    to a layout mode
+//    from the spec (https://www.w3.org/TR/YG3-sizing/#terms):
+//      - YGMeasureModeUndefined: max content
+//      - YGMeasureModeExactly: fill available
+//      - YGMeasureModeAtMost: fit content
+//
+//    When calling YGNodelayoutImpl and YGLayoutNodeInternal, if the caller passes
+//    an available size of
+//    undefined then it must also pass a measure mode of YGMeasureModeUndefined
+//    in that dimension.
+//
+static void YGNodelayoutImpl(const YGNodeRef node,
+                             const YGFloat availableWidth,
+                             const YGFloat availableHeight,
+                             const YGDirection parentDirection,
+                             const YGMeasureMode widthMeasureMode,
+                             const YGMeasureMode heightMeasureMode,
+                             const YGFloat parentWidth,
+                             const YGFloat parentHeight,
+                             const bool performLayout) {
+  YG_ASSERT(YGFloatIsUndefined(availableWidth) ? widthMeasureMode == YGMeasureModeUndefined : true,
+            "availableWidth is indefinite so widthMeasureMode must be "
+            "YGMeasureModeUndefined");
+  YG_ASSERT(YGFloatIsUndefined(availableHeight) ? heightMeasureMode == YGMeasureModeUndefined
+            : true,
+            "availableHeight is indefinite so heightMeasureMode must be "
+            "YGMeasureModeUndefined");
+
+  // Set the resolved resolution in the node's layout.
+  const YGDirection direction = YGNodeResolveDirection(node, parentDirection);
+  node->layout.direction = direction;
+
+  const YGFlexDirection flexRowDirection = YGFlexDirectionResolve(YGFlexDirectionRow, direction);
+  const YGFlexDirection flexColumnDirection =
+  YGFlexDirectionResolve(YGFlexDirectionColumn, direction);
+
+  node->layout.margin[YGEdgeStart] = YGNodeLeadingMargin(node, flexRowDirection, parentWidth);
+  node->layout.margin[YGEdgeEnd] = YGNodeTrailingMargin(node, flexRowDirection, parentWidth);
+  node->layout.margin[YGEdgeTop] = YGNodeLeadingMargin(node, flexColumnDirection, parentWidth);
+  node->layout.margin[YGEdgeBottom] = YGNodeTrailingMargin(node, flexColumnDirection, parentWidth);
+
+  node->layout.border[YGEdgeStart] = YGNodeLeadingBorder(node, flexRowDirection);
+  node->layout.border[YGEdgeEnd] = YGNodeTrailingBorder(node, flexRowDirection);
+  node->layout.border[YGEdgeTop] = YGNodeLeadingBorder(node, flexColumnDirection);
+  node->layout.border[YGEdgeBottom] = YGNodeTrailingBorder(node, flexColumnDirection);
+
+  node->layout.padding[YGEdgeStart] = YGNodeLeadingPadding(node, flexRowDirection, parentWidth);
+  node->layout.padding[YGEdgeEnd] = YGNodeTrailingPadding(node, flexRowDirection, parentWidth);
+  node->layout.padding[YGEdgeTop] = YGNodeLeadingPadding(node, flexColumnDirection, parentWidth);
+  node->layout.padding[YGEdgeBottom] =
+  YGNodeTrailingPadding(node, flexColumnDirection, parentWidth);
+
+  // Until shown otherwise the result depends on the exact available size.
+  node->layout.availableRange = YGAvailableRangePoint(availableWidth, availableHeight);
+
+  if (node->measure) {
+    YGNodeWithMeasureFuncSetMeasuredDimensions(node,
+                                               availableWidth,
+                                               availableHeight,
+                                               widthMeasureMode,
+                                               heightMeasureMode,
+                                               parentWidth,
+                                               parentHeight);
+    if (gMeasureBatch.collecting) {
+      // The placeholder size says nothing, the measurement after the batch narrows the parent.
+      YGAvailableRangeOpenAxis(&node->layout.availableRange, YGDimensionWidth);
+      YGAvailableRangeOpenAxis(&node->layout.availableRange, YGDimensionHeight);
+    } else {
+      YGNodeSetLeafAvailableRange(node,
+                                  availableWidth,
+                                  availableHeight,
+                                  widthMeasureMode,
+                                  heightMeasureMode,
+                                  parentWidth);
+    }
+    return;
+  }
+
+  // Virtual children come from the data source, except while the windows are pinned when the
+  // window they have is all there is.
+  const bool hasVirtualChildren =
+      node->extras->virtualized != NULL && node->extras->virtualized->childFunc != NULL;
+  const bool materializeChildren = hasVirtualChildren && !gVirtualWindowsPinned;
+  const uint32_t childCount = materializeChildren ? node->extras->virtualized->countFunc(node)
+                                                  : YGNodeListCount(node->children);
+  // A streaming container whose children all retired keeps their extent.
+  if (childCount == 0 &&
+      (node->extras->virtualized == NULL || node->extras->virtualized->retiredExtent == 0)) {
+    if (materializeChildren) {
+      YGVirtualWindowMaterialize(node, 0, 0);
+    }
+    YGNodeEmptyContainerSetMeasuredDimensions(node,
+                                              availableWidth,
+                                              availableHeight,
+                                              widthMeasureMode,
+                                              heightMeasureMode,
+                                              parentWidth,
+                                              parentHeight);
+    // Without content an at-most size is padding and border, whatever the space available.
+    if (!node->hasPercentStyle) {
+      if (widthMeasureMode == YGMeasureModeAtMost) {
+        YGAvailableRangeOpenAxis(&node->layout.availableRange, YGDimensionWidth);
+      }
+      if (heightMeasureMode == YGMeasureModeAtMost) {
+        YGAvailableRangeOpenAxis(&node->layout.availableRange, YGDimensionHeight);
+      }
+    }
+    return;
+  }
+
+  // If we're not being asked to perform a full layout we can skip the algorithm if we already know
+  // the size
+  if (!performLayout && YGNodeFixedSizeSetMeasuredDimensions(node,
+                                                             availableWidth,
+                                                             availableHeight,
+                                                             widthMeasureMode,
+                                                             heightMeasureMode,
+                                                             parentWidth,
+                                                             parentHeight)) {
+    return;
+  }
+
+  // Virtualized single-line containers with a forward main axis only lay out the children
+  // around their viewport. Anything else falls back to the full algorithm.
+  if (node->extras->virtualized != NULL) {
+    const YGFlexDirection mainAxis = YGFlexDirectionResolve(node->style.flexDirection, direction);
+    node->extras->virtualized->firstVisible = 0;
+    node->extras->virtualized->endVisible = childCount;
+    if (node->style.flexWrap == YGWrapNoWrap &&
+        (mainAxis == YGFlexDirectionColumn || mainAxis == YGFlexDirectionRow)) {
+      YGNodeVirtualizedLayoutImpl(node,
+                                  hasVirtualChildren && !materializeChildren
+                                      ? node->extras->virtualized->count
+                                      : childCount,
+                                  availableWidth,
+                                  availableHeight,
+                                  direction,
+                                  widthMeasureMode,
+                                  heightMeasureMode,
+                                  parentWidth,
+                                  parentHeight,
+                                  performLayout);
+      return;
+    }
+    if (materializeChildren) {
+      YGVirtualWindowMaterialize(node, 0, childCount);
+    }
+    if (node->extras->virtualized->streaming) {
+      node->extras->virtualized->needsRebuild = true;
+    }
+  }
+
+  // Identical children given the same constraints share one layout, see YGLayoutNodeInternal.
+  YGNodeAssignInstances(node);
+
+  // STEP 1: CALCULATE VALUES FOR REMAINDER OF ALGORITHM
+  const YGFlexDirection mainAxis = YGFlexDirectionResolve(node->style.flexDirection, direction);
+  const YGFlexDirection crossAxis = YGFlexDirectionCross(mainAxis, direction);
+  const bool isMainAxisRow = YGFlexDirectionIsRow(mainAxis);
+  const YGJustify justifyContent = node->style.justifyContent;
+  const bool isNodeFlexWrap = node->style.flexWrap != YGWrapNoWrap;
+
+  const YGFloat mainAxisParentSize = isMainAxisRow ? parentWidth : parentHeight;
+  const YGFloat crossAxisParentSize = isMainAxisRow ? parentHeight : parentWidth;
+
+  YGNodeRef firstAbsoluteChild = NULL;
+  YGNodeRef currentAbsoluteChild = NULL;
+
+  const YGFloat leadingPaddingAndBorderMain =
+  YGNodeLeadingPaddingAndBorder(node, mainAxis, parentWidth);
+  const YGFloat trailingPaddingAndBorderMain =
+  YGNodeTrailingPaddingAndBorder(node, mainAxis, parentWidth);
+  const YGFloat leadingPaddingAndBorderCross =
+  YGNodeLeadingPaddingAndBorder(node, crossAxis, parentWidth);
+  const YGFloat paddingAndBorderAxisMain = YGNodePaddingAndBorderForAxis(node, mainAxis, parentWidth);
+  const YGFloat paddingAndBorderAxisCross =
+  YGNodePaddingAndBorderForAxis(node, crossAxis, parentWidth);
+
+  const YGMeasureMode measureModeMainDim = isMainAxisRow ? widthMeasureMode : heightMeasureMode;
+  const YGMeasureMode measureModeCrossDim = isMainAxisRow ? heightMeasureMode : widthMeasureMode;
+
+  const YGFloat paddingAndBorderAxisRow =
+  isMainAxisRow ? paddingAndBorderAxisMain : paddingAndBorderAxisCross;
+  const YGFloat paddingAndBorderAxisColumn =
+  isMainAxisRow ? paddingAndBorderAxisCross : paddingAndBorderAxisMain;
+
+  const YGFloat marginAxisRow = YGNodeMarginForAxis(node, YGFlexDirectionRow, parentWidth);
+  const YGFloat marginAxisColumn = YGNodeMarginForAxis(node, YGFlexDirectionColumn, parentWidth);
+
+  // STEP 2: DETERMINE AVAILABLE SIZE IN MAIN AND CROSS DIRECTIONS
+  const YGFloat minInnerWidth =
+  YGValueResolve(&node->style.minDimensions[YGDimensionWidth], parentWidth) - marginAxisRow -
+  paddingAndBorderAxisRow;
+  const YGFloat maxInnerWidth =
+  YGValueResolve(&node->style.maxDimensions[YGDimensionWidth], parentWidth) - marginAxisRow -
+  paddingAndBorderAxisRow;
+  const YGFloat minInnerHeight =
+  YGValueResolve(&node->style.minDimensions[YGDimensionHeight], parentHeight) -
+  marginAxisColumn - paddingAndBorderAxisColumn;
+  const YGFloat maxInnerHeight =
+  YGValueResolve(&node->style.maxDimensions[YGDimensionHeight], parentHeight) -
+  marginAxisColumn - paddingAndBorderAxisColumn;
+  const YGFloat minInnerMainDim = isMainAxisRow ? minInnerWidth : minInnerHeight;
+  const YGFloat maxInnerMainDim = isMainAxisRow ? maxInnerWidth : maxInnerHeight;
+
+  // Max dimension overrides predefined dimension value; Min dimension in turn overrides both of the
+  // above
+  YGFloat availableInnerWidth = availableWidth - marginAxisRow - paddingAndBorderAxisRow;
+  if (!YGFloatIsUndefined(availableInnerWidth)) {
+    availableInnerWidth = YGFloatMax(YGFloatMin(availableInnerWidth, maxInnerWidth), minInnerWidth);
+  }
+
+  YGFloat availableInnerHeight = availableHeight - marginAxisColumn - paddingAndBorderAxisColumn;
+  if (!YGFloatIsUndefined(availableInnerHeight)) {
+    availableInnerHeight = YGFloatMax(YGFloatMin(availableInnerHeight, maxInnerHeight), minInnerHeight);
+  }
+
+  YGFloat availableInnerMainDim = isMainAxisRow ? availableInnerWidth : availableInnerHeight;
+  const YGFloat availableInnerCrossDim = isMainAxisRow ? availableInnerHeight : availableInnerWidth;
+
+  // Track the available sizes this layout holds for. An at-most axis starts out open and is
+  // narrowed by every way the result turns out to depend on it. Percentages, min and max sizes,
+  // wrapping and scrolling make it depend on the exact size up front.
+  YGAvailableRangeScope rangeScope = {
+      .node = node,
+      .range = YGAvailableRangePoint(availableWidth, availableHeight),
+      .availableInnerSize = {[YGDimensionWidth] = availableInnerWidth,
+                             [YGDimensionHeight] = availableInnerHeight},
+      .offset = {[YGDimensionWidth] = availableWidth - availableInnerWidth,
+                 [YGDimensionHeight] = availableHeight - availableInnerHeight},
+  };
+  if (!node->hasPercentStyle && !isNodeFlexWrap && node->style.overflow != YGOverflowScroll) {
+    if (widthMeasureMode == YGMeasureModeAtMost &&
+        node->style.minDimensions[YGDimensionWidth].unit == YGUnitUndefined &&
+        node->style.maxDimensions[YGDimensionWidth].unit == YGUnitUndefined) {
+      YGAvailableRangeOpenAxis(&rangeScope.range, YGDimensionWidth);
+    }
+    if (heightMeasureMode == YGMeasureModeAtMost &&
+        node->style.minDimensions[YGDimensionHeight].unit == YGUnitUndefined &&
+        node->style.maxDimensions[YGDimensionHeight].unit == YGUnitUndefined) {
+      YGAvailableRangeOpenAxis(&rangeScope.range, YGDimensionHeight);
+    }
+  }
+  YGAvailableRangeScope *const parentRangeScope = gAvailableRangeScope;
+  gAvailableRangeScope = &rangeScope;
+
+  const YGNodeRef singleFlexChild = measureModeMainDim == YGMeasureModeExactly
+                                        ? YGNodeFindSingleFlexChild(node, childCount)
+                                        : NULL;
+
+  YGFloat totalFlexBasis = 0;
+
+  // STEP 3: DETERMINE FLEX BASIS FOR EACH ITEM
+  // With a batch measure function, first collect the leaf measurements the loop below would
+  // trigger and measure them together.
+  if (node->batchMeasure != NULL) {
+    YGMeasureBatchBegin();
+    for (uint32_t i = 0; i < childCount; i++) {
+      const YGNodeRef child = YGNodeListGet(node->children, i);
+      if (child->measure == NULL || child == singleFlexChild ||
+          child->style.display == YGDisplayNone ||
+          child->style.positionType == YGPositionTypeAbsolute) {
+        continue;
+      }
+      YGResolveDimensions(child);
+      YGNodeComputeFlexBasisForChild(node,
+                                     child,
+                                     availableInnerWidth,
+                                     widthMeasureMode,
+                                     availableInnerHeight,
+                                     availableInnerWidth,
+                                     availableInnerHeight,
+                                     heightMeasureMode,
+                                     direction);
+    }
+    YGMeasureBatchFlush(node);
+  }
+
+  for (uint32_t i = 0; i < childCount; i++) {
+    const YGNodeRef child = YGNodeListGet(node->children, i);
+    if (child->style.display == YGDisplayNone) {
+      YGZeroOutLayoutRecursivly(child);
+      YGNodeSetNewLayout(child);
+      child->isDirty = false;
+      continue;
+    }
+    YGResolveDimensions(child);
+    // Children sized or placed relative to the available size, or measured against their max
+    // size instead of it, tie the layout to the exact size.
+    if (child->hasPercentStyle || child->style.positionType == YGPositionTypeAbsolute ||
+        !YGFloatIsUndefined(child->style.aspectRatio) ||
+        child->style.maxDimensions[YGDimensionWidth].unit != YGUnitUndefined ||
+        child->style.maxDimensions[YGDimensionHeight].unit != YGUnitUndefined) {
+      rangeScope.range = YGAvailableRangePoint(availableWidth, availableHeight);
+    }
+    if (performLayout) {
+      // Set the initial position (relative to the parent).
+      const YGDirection childDirection = YGNodeResolveDirection(child, direction);
+      YGNodeSetPosition(child,
+                        childDirection,
+                        availableInnerMainDim,
+                        availableInnerCrossDim,
+                        availableInnerWidth);
+    }
+
+    // Absolute-positioned children don't participate in flex layout. Add them
+    // to a list that we can process later.
+    if (child->style.positionType == YGPositionTypeAbsolute) {
+      // Store a private linked list of absolutely positioned children
+      // so that we can efficiently traverse them later.
+      if (firstAbsoluteChild == NULL) {
+        firstAbsoluteChild = child;
+      }
+      if (currentAbsoluteChild != NULL) {
+        currentAbsoluteChild->nextChild = child;
+      }
+      currentAbsoluteChild = child;
+      child->nextChild = NULL;
+    } else {
+      if (child == singleFlexChild) {
+        child->layout.computedFlexBasisGeneration = gCurrentGenerationCount;
+        child->layout.computedFlexBasis = 0;
+      } else {
+        YGNodeComputeFlexBasisForChild(node,
+                                       child,
+                                       availableInnerWidth,
+                                       widthMeasureMode,
+                                       availableInnerHeight,
+                                       availableInnerWidth,
+                                       availableInnerHeight,
+                                       heightMeasureMode,
+                                       direction);
+      }
+    }
+
+    totalFlexBasis += child->layout.computedFlexBasis;
+  }
+
+  const bool flexBasisOverflows =
+  measureModeMainDim == YGMeasureModeUndefined ? false : totalFlexBasis > availableInnerMainDim;
+
+  // STEP 4: COLLECT FLEX ITEMS INTO FLEX LINES
+
+  // Indexes of children that represent the first and last items in the line.
+  uint32_t startOfLineIndex = 0;
+  uint32_t endOfLineIndex = 0;
+
+  // Number of lines.
+  uint32_t lineCount = 0;
+
+  // Accumulated cross dimensions of all lines so far.
+  YGFloat totalLineCrossDim = 0;
+
+  // Max main dimension of all the lines.
+  YGFloat maxLineMainDim = 0;
+
+  for (; endOfLineIndex < childCount; lineCount++, startOfLineIndex = endOfLineIndex) {
+    // Number of items on the currently line. May be different than the
+    // difference
+    // between start and end indicates because we skip over absolute-positioned
+    // items.
+    uint32_t itemsOnLine = 0;
+
+    // sizeConsumedOnCurrentLine is accumulation of the dimensions and margin
+    // of all the children on the current line. This will be used in order to
+    // either set the dimensions of the node if none already exist or to compute
+    // the remaining space left for the flexible children.
+    YGFloat sizeConsumedOnCurrentLine = 0;
+
+    YGFloat totalFlexGrowFactors = 0;
+    YGFloat totalFlexShrinkScaledFactors = 0;
+
+    // Maintain a linked list of the child nodes that can shrink and/or grow.
+    YGNodeRef firstRelativeChild = NULL;
+    YGNodeRef currentRelativeChild = NULL;
+
+    // Add items to the current line until it's full or we run out of items.
+    for (uint32_t i = startOfLineIndex; i < childCount; i++, endOfLineIndex++) {
+      const YGNodeRef child = YGNodeListGet(node->children, i);
+      if (child->style.display == YGDisplayNone) {
+        continue;
+      }
+      child->lineIndex = lineCount;
+
+      if (child->style.positionType != YGPositionTypeAbsolute) {
+        const YGFloat outerFlexBasis =
+        YGFloatMax(YGValueResolve(&child->style.minDimensions[dim[mainAxis]], mainAxisParentSize),
+              child->layout.computedFlexBasis) +
+        YGNodeMarginForAxis(child, mainAxis, availableInnerWidth);
+
+        // If this is a multi-line flow and this item pushes us over the
+        // available size, we've
+        // hit the end of the current line. Break out of the loop and lay out
+        // the current line. Sizes the caches take as equal break lines alike.
+        if (sizeConsumedOnCurrentLine + outerFlexBasis > availableInnerMainDim &&
+            !YGFloatsEqual(sizeConsumedOnCurrentLine + outerFlexBasis, availableInnerMainDim) &&
+            isNodeFlexWrap && itemsOnLine > 0) {
+          break;
+        }
+
+        sizeConsumedOnCurrentLine += outerFlexBasis;
+        itemsOnLine++;
+
+        if (YGNodeIsFlex(child)) {
+          totalFlexGrowFactors += YGNodeResolveFlexGrow(child);
+
+          // Unlike the grow factor, the shrink factor is scaled relative to the
+          // child
+          // dimension.
+          totalFlexShrinkScaledFactors +=
+          -YGNodeResolveFlexShrink(child) * child->layout.computedFlexBasis;
+        }
+
+        // Store a private linked list of children that need to be layed out.
+        if (firstRelativeChild == NULL) {
+          firstRelativeChild = child;
+        }
+        if (currentRelativeChild != NULL) {
+          currentRelativeChild->nextChild = child;
+        }
+        currentRelativeChild = child;
+        child->nextChild = NULL;
+      }
+    }
+
+    // If we don't need to measure the cross axis, we can skip the entire flex
+    // step.
+    const bool canSkipFlex = !performLayout && measureModeCrossDim == YGMeasureModeExactly;
+
+    // In order to position the elements in the main axis, we have two
+    // controls. The space between the beginning and the first element
+    // and the space between each two elements.
+    YGFloat leadingMainDim = 0;
+    YGFloat betweenMainDim = 0;
+
+    // STEP 5: RESOLVING FLEXIBLE LENGTHS ON MAIN AXIS
     // Calculate the remaining available space that needs to be allocated.
     // If the main dimension size isn't known, it is computed based on
     // the line length, so there's no more space left to distribute.
 
-    // We resolve main dimension to fit minimum and maximum values
-    if (YGFloatIsUndefined(availableInnerMainDim)) {
-      if (!YGFloatIsUndefined(minInnerMainDim) && sizeConsumedOnCurrentLine < minInnerMainDim) {
-        availableInnerMainDim = minInnerMainDim;
-      } else if (!YGFloatIsUndefined(maxInnerMainDim) &&
-                 sizeConsumedOnCurrentLine > maxInnerMainDim) {
-        availableInnerMainDim = maxInnerMainDim;
+    // We resolve main dimension to fit minimum and maximum values
+    if (YGFloatIsUndefined(availableInnerMainDim)) {
+      if (!YGFloatIsUndefined(minInnerMainDim) && sizeConsumedOnCurrentLine < minInnerMainDim) {
+        availableInnerMainDim = minInnerMainDim;
+      } else if (!YGFloatIsUndefined(maxInnerMainDim) &&
+                 sizeConsumedOnCurrentLine > maxInnerMainDim) {
+        availableInnerMainDim = maxInnerMainDim;
+      }
+    }
+
+    YGFloat remainingFreeSpace = 0;
+    if (!YGFloatIsUndefined(availableInnerMainDim)) {
+      remainingFreeSpace = availableInnerMainDim - sizeConsumedOnCurrentLine;
+    } else if (sizeConsumedOnCurrentLine < 0) {
+      // availableInnerMainDim is indefinite which means the node is being sized
+      // based on its
+      // content.
+      // sizeConsumedOnCurrentLine is negative which means the node will
+      // allocate 0 points for
+      // its content. Consequently, remainingFreeSpace is 0 -
+      // sizeConsumedOnCurrentLine.
+      remainingFreeSpace = -sizeConsumedOnCurrentLine;
+    }
+
+    const YGFloat originalRemainingFreeSpace = remainingFreeSpace;
+    YGFloat deltaFreeSpace = 0;
+
+    if (measureModeMainDim == YGMeasureModeAtMost) {
+      if (totalFlexGrowFactors > 0) {
+        YGAvailableRangeCollapseAxis(&rangeScope.range,
+                                     dim[mainAxis],
+                                     isMainAxisRow ? availableWidth : availableHeight);
+      } else {
+        YGAvailableRangeScopeRequire(&rangeScope, dim[mainAxis], sizeConsumedOnCurrentLine);
+      }
+    }
+
+    if (!canSkipFlex) {
+      YGFloat childFlexBasis;
+      YGFloat flexShrinkScaledFactor;
+      YGFloat flexGrowFactor;
+      YGFloat baseMainSize;
+      YGFloat boundMainSize;
+
+      // Do two passes over the flex items to figure out how to distribute the
+      // remaining space.
+      // The first pass finds the items whose min/max constraints trigger,
+      // freezes them at those
+      // sizes, and excludes those sizes from the remaining space. The second
+      // pass sets the size
+      // of each flexible item. It distributes the remaining space amongst the
+      // items whose min/max
+      // constraints didn't trigger in pass 1. For the other items, it sets
+      // their sizes by forcing
+      // their min/max constraints to trigger again.
+      //
+      // This two pass approach for resolving min/max constraints deviates from
+      // the spec. The
+      // spec (https://www.w3.org/TR/YG-flexbox-1/#resolve-flexible-lengths)
+      // describes a process
+      // that needs to be repeated a variable number of times. The algorithm
+      // implemented here
+      // won't handle all cases but it was simpler to implement and it mitigates
+      // performance
+      // concerns because we know exactly how many passes it'll do.
+
+      // First pass: detect the flex items whose min/max constraints trigger
+      YGFloat deltaFlexShrinkScaledFactors = 0;
+      YGFloat deltaFlexGrowFactors = 0;
+      currentRelativeChild = firstRelativeChild;
+      while (currentRelativeChild != NULL) {
+        childFlexBasis = currentRelativeChild->layout.computedFlexBasis;
+
+        if (remainingFreeSpace < 0) {
+          flexShrinkScaledFactor = -YGNodeResolveFlexShrink(currentRelativeChild) * childFlexBasis;
+
+          // Is this child able to shrink?
+          if (flexShrinkScaledFactor != 0) {
+            baseMainSize =
+            childFlexBasis +
+            remainingFreeSpace / totalFlexShrinkScaledFactors * flexShrinkScaledFactor;
+            boundMainSize = YGNodeBoundAxis(currentRelativeChild,
+                                            mainAxis,
+                                            baseMainSize,
+                                            availableInnerMainDim,
+                                            availableInnerWidth);
+            if (baseMainSize != boundMainSize) {
+              // By excluding this item's size and flex factor from remaining,
+              // this item's
+              // min/max constraints should also trigger in the second pass
+              // resulting in the
+              // item's size calculation being identical in the first and second
+              // passes.
+              deltaFreeSpace -= boundMainSize - childFlexBasis;
+              deltaFlexShrinkScaledFactors -= flexShrinkScaledFactor;
+            }
+          }
+        } else if (remainingFreeSpace > 0) {
+          flexGrowFactor = YGNodeResolveFlexGrow(currentRelativeChild);
+
+          // Is this child able to grow?
+          if (flexGrowFactor != 0) {
+            baseMainSize =
+            childFlexBasis + remainingFreeSpace / totalFlexGrowFactors * flexGrowFactor;
+            boundMainSize = YGNodeBoundAxis(currentRelativeChild,
+                                            mainAxis,
+                                            baseMainSize,
+                                            availableInnerMainDim,
+                                            availableInnerWidth);
+            if (baseMainSize != boundMainSize) {
+              // By excluding this item's size and flex factor from remaining,
+              // this item's
+              // min/max constraints should also trigger in the second pass
+              // resulting in the
+              // item's size calculation being identical in the first and second
+              // passes.
+              deltaFreeSpace -= boundMainSize - childFlexBasis;
+              deltaFlexGrowFactors -= flexGrowFactor;
+            }
+          }
+        }
+
+        currentRelativeChild = currentRelativeChild->nextChild;
+      }
+
+      totalFlexShrinkScaledFactors += deltaFlexShrinkScaledFactors;
+      totalFlexGrowFactors += deltaFlexGrowFactors;
+      remainingFreeSpace += deltaFreeSpace;
+
+      // Second pass: resolve the sizes of the flexible items. With a batch measure function the
+      // pass first runs over the measured leaves only to collect their measurements.
+      bool collectMeasurements = node->batchMeasure != NULL;
+      for (;;) {
+        if (collectMeasurements) {
+          YGMeasureBatchBegin();
+        }
+
+        deltaFreeSpace = 0;
+        currentRelativeChild = firstRelativeChild;
+        while (currentRelativeChild != NULL) {
+          if (collectMeasurements && currentRelativeChild->measure == NULL) {
+            currentRelativeChild = currentRelativeChild->nextChild;
+            continue;
+          }
+
+          childFlexBasis = currentRelativeChild->layout.computedFlexBasis;
+          YGFloat updatedMainSize = childFlexBasis;
+
+          if (remainingFreeSpace < 0) {
+            flexShrinkScaledFactor = -YGNodeResolveFlexShrink(currentRelativeChild) * childFlexBasis;
+            // Is this child able to shrink?
+            if (flexShrinkScaledFactor != 0) {
+              YGFloat childSize;
+
+              if (totalFlexShrinkScaledFactors == 0) {
+                childSize = childFlexBasis + flexShrinkScaledFactor;
+              } else {
+                childSize =
+                childFlexBasis +
+                (remainingFreeSpace / totalFlexShrinkScaledFactors) * flexShrinkScaledFactor;
+              }
+
+              updatedMainSize = YGNodeBoundAxis(currentRelativeChild,
+                                                mainAxis,
+                                                childSize,
+                                                availableInnerMainDim,
+                                                availableInnerWidth);
+            }
+          } else if (remainingFreeSpace > 0) {
+            flexGrowFactor = YGNodeResolveFlexGrow(currentRelativeChild);
+
+            // Is this child able to grow?
+            if (flexGrowFactor != 0) {
+              updatedMainSize =
+              YGNodeBoundAxis(currentRelativeChild,
+                              mainAxis,
+                              childFlexBasis +
+                              remainingFreeSpace / totalFlexGrowFactors * flexGrowFactor,
+                              availableInnerMainDim,
+                              availableInnerWidth);
+            }
+          }
+
+          deltaFreeSpace -= updatedMainSize - childFlexBasis;
+
+          const YGFloat marginMain =
+          YGNodeMarginForAxis(currentRelativeChild, mainAxis, availableInnerWidth);
+          const YGFloat marginCross =
+          YGNodeMarginForAxis(currentRelativeChild, crossAxis, availableInnerWidth);
+
+          YGFloat childCrossSize;
+          YGFloat childMainSize = updatedMainSize + marginMain;
+          YGMeasureMode childCrossMeasureMode;
+          YGMeasureMode childMainMeasureMode = YGMeasureModeExactly;
+
+          if (!YGFloatIsUndefined(availableInnerCrossDim) &&
+              !YGNodeIsStyleDimDefined(currentRelativeChild, crossAxis, availableInnerCrossDim) &&
+              measureModeCrossDim == YGMeasureModeExactly &&
+              !(isNodeFlexWrap && flexBasisOverflows) &&
+              YGNodeAlignItem(node, currentRelativeChild) == YGAlignStretch) {
+            childCrossSize = availableInnerCrossDim;
+            childCrossMeasureMode = YGMeasureModeExactly;
+          } else if (!YGNodeIsStyleDimDefined(currentRelativeChild,
+                                              crossAxis,
+                                              availableInnerCrossDim)) {
+            childCrossSize = availableInnerCrossDim;
+            childCrossMeasureMode =
+            YGFloatIsUndefined(childCrossSize) ? YGMeasureModeUndefined : YGMeasureModeAtMost;
+          } else {
+            childCrossSize = YGValueResolve(currentRelativeChild->resolvedDimensions[dim[crossAxis]],
+                                            availableInnerCrossDim) +
+            marginCross;
+            childCrossMeasureMode =
+            YGFloatIsUndefined(childCrossSize) ? YGMeasureModeUndefined : YGMeasureModeExactly;
+          }
+
+          if (!YGFloatIsUndefined(currentRelativeChild->style.aspectRatio)) {
+            childCrossSize = YGFloatMax(
+                                   isMainAxisRow
+                                   ? (childMainSize - marginMain) / currentRelativeChild->style.aspectRatio
+                                   : (childMainSize - marginMain) * currentRelativeChild->style.aspectRatio,
+                                   YGNodePaddingAndBorderForAxis(currentRelativeChild, crossAxis, availableInnerWidth));
+            childCrossMeasureMode = YGMeasureModeExactly;
+
+            // Parent size constraint should have higher priority than flex
+            if (YGNodeIsFlex(currentRelativeChild)) {
+              childCrossSize = YGFloatMin(childCrossSize - marginCross, availableInnerCrossDim);
+              childMainSize =
+              marginMain + (isMainAxisRow
+                            ? childCrossSize * currentRelativeChild->style.aspectRatio
+                            : childCrossSize / currentRelativeChild->style.aspectRatio);
+            }
+
+            childCrossSize += marginCross;
+          }
+
+          YGConstrainMaxSizeForMode(
+                                    YGValueResolve(&currentRelativeChild->style.maxDimensions[dim[mainAxis]],
+                                                   availableInnerWidth),
+                                    &childMainMeasureMode,
+                                    &childMainSize);
+          YGConstrainMaxSizeForMode(
+                                    YGValueResolve(&currentRelativeChild->style.maxDimensions[dim[crossAxis]],
+                                                   availableInnerHeight),
+                                    &childCrossMeasureMode,
+                                    &childCrossSize);
+
+          const bool requiresStretchLayout =
+          !YGNodeIsStyleDimDefined(currentRelativeChild, crossAxis, availableInnerCrossDim) &&
+          YGNodeAlignItem(node, currentRelativeChild) == YGAlignStretch;
+
+          const YGFloat childWidth = isMainAxisRow ? childMainSize : childCrossSize;
+          const YGFloat childHeight = !isMainAxisRow ? childMainSize : childCrossSize;
+
+          const YGMeasureMode childWidthMeasureMode =
+          isMainAxisRow ? childMainMeasureMode : childCrossMeasureMode;
+          const YGMeasureMode childHeightMeasureMode =
+          !isMainAxisRow ? childMainMeasureMode : childCrossMeasureMode;
+
+          // Recursively call the layout algorithm for this child with the updated
+          // main size.
+          YGLayoutNodeInternal(currentRelativeChild,
+                               childWidth,
+                               childHeight,
+                               direction,
+                               childWidthMeasureMode,
+                               childHeightMeasureMode,
+                               availableInnerWidth,
+                               availableInnerHeight,
+                               performLayout && !requiresStretchLayout && !collectMeasurements,
+                               collectMeasurements ? "batch" : "flex");
+
+          currentRelativeChild = currentRelativeChild->nextChild;
+        }
+
+        if (!collectMeasurements) {
+          break;
+        }
+        YGMeasureBatchFlush(node);
+        collectMeasurements = false;
+      }
+    }
+
+    remainingFreeSpace = originalRemainingFreeSpace + deltaFreeSpace;
+
+    // STEP 6: MAIN-AXIS JUSTIFICATION & CROSS-AXIS SIZE DETERMINATION
+
+    // At this point, all the children have their dimensions set in the main
+    // axis.
+    // Their dimensions are also set in the cross axis with the exception of
+    // items
+    // that are aligned "stretch". We need to compute these stretch values and
+    // set the final positions.
+
+    // If we are using "at most" rules in the main axis. Calculate the remaining space when
+    // constraint by the min size defined for the main axis.
+
+    if (measureModeMainDim == YGMeasureModeAtMost && remainingFreeSpace > 0) {
+      if (node->style.minDimensions[dim[mainAxis]].unit != YGUnitUndefined &&
+          YGValueResolve(&node->style.minDimensions[dim[mainAxis]], mainAxisParentSize) >= 0) {
+        remainingFreeSpace =
+        YGFloatMax(0,
+              YGValueResolve(&node->style.minDimensions[dim[mainAxis]], mainAxisParentSize) -
+              (availableInnerMainDim - remainingFreeSpace));
+      } else {
+        remainingFreeSpace = 0;
+      }
+    }
+
+    int numberOfAutoMarginsOnCurrentLine = 0;
+    for (uint32_t i = startOfLineIndex; i < endOfLineIndex; i++) {
+      const YGNodeRef child = YGNodeListGet(node->children, i);
+      if (child->style.positionType == YGPositionTypeRelative) {
+        if (child->style.margin[leading[mainAxis]].unit == YGUnitAuto) {
+          numberOfAutoMarginsOnCurrentLine++;
+        }
+        if (child->style.margin[trailing[mainAxis]].unit == YGUnitAuto) {
+          numberOfAutoMarginsOnCurrentLine++;
+        }
+      }
+    }
+
+    if (numberOfAutoMarginsOnCurrentLine == 0) {
+      switch (justifyContent) {
+        case YGJustifyCenter:
+          leadingMainDim = remainingFreeSpace / 2;
+          break;
+        case YGJustifyFlexEnd:
+          leadingMainDim = remainingFreeSpace;
+          break;
+        case YGJustifySpaceBetween:
+          if (itemsOnLine > 1) {
+            betweenMainDim = YGFloatMax(remainingFreeSpace, 0) / (itemsOnLine - 1);
+          } else {
+            betweenMainDim = 0;
+          }
+          break;
+        case YGJustifySpaceAround:
+          // Space on the edges is half of the space between elements
+          betweenMainDim = remainingFreeSpace / itemsOnLine;
+          leadingMainDim = betweenMainDim / 2;
+          break;
+        case YGJustifyFlexStart:
+          break;
+      }
+    }
+
+    YGFloat mainDim = leadingPaddingAndBorderMain + leadingMainDim;
+    YGFloat crossDim = 0;
+
+    for (uint32_t i = startOfLineIndex; i < endOfLineIndex; i++) {
+      const YGNodeRef child = YGNodeListGet(node->children, i);
+      if (child->style.display == YGDisplayNone) {
+        continue;
+      }
+      if (child->style.positionType == YGPositionTypeAbsolute &&
+          YGNodeIsLeadingPosDefined(child, mainAxis)) {
+        if (performLayout) {
+          // In case the child is position absolute and has left/top being
+          // defined, we override the position to whatever the user said
+          // (and margin/border).
+          child->layout.position[pos[mainAxis]] =
+          YGNodeLeadingPosition(child, mainAxis, availableInnerMainDim) +
+          YGNodeLeadingBorder(node, mainAxis) +
+          YGNodeLeadingMargin(child, mainAxis, availableInnerWidth);
+        }
+      } else {
+        // Now that we placed the element, we need to update the variables.
+        // We need to do that only for relative elements. Absolute elements
+        // do not take part in that phase.
+        if (child->style.positionType == YGPositionTypeRelative) {
+          if (child->style.margin[leading[mainAxis]].unit == YGUnitAuto) {
+            mainDim += remainingFreeSpace / numberOfAutoMarginsOnCurrentLine;
+          }
+
+          if (performLayout) {
+            child->layout.position[pos[mainAxis]] += mainDim;
+          }
+
+          if (child->style.margin[trailing[mainAxis]].unit == YGUnitAuto) {
+            mainDim += remainingFreeSpace / numberOfAutoMarginsOnCurrentLine;
+          }
+
+          if (canSkipFlex) {
+            // If we skipped the flex step, then we can't rely on the
+            // measuredDims because
+            // they weren't computed. This means we can't call YGNodeDimWithMargin.
+            mainDim += betweenMainDim + YGNodeMarginForAxis(child, mainAxis, availableInnerWidth) +
+            child->layout.computedFlexBasis;
+            crossDim = availableInnerCrossDim;
+          } else {
+            // The main dimension is the sum of all the elements dimension plus the spacing.
+            mainDim += betweenMainDim + YGNodeDimWithMargin(child, mainAxis, availableInnerWidth);
+
+            // The cross dimension is the max of the elements dimension since
+            // there can only be one element in that cross dimension.
+            crossDim = YGFloatMax(crossDim, YGNodeDimWithMargin(child, crossAxis, availableInnerWidth));
+          }
+        } else if (performLayout) {
+          child->layout.position[pos[mainAxis]] +=
+          YGNodeLeadingBorder(node, mainAxis) + leadingMainDim;
+        }
+      }
+    }
+
+    mainDim += trailingPaddingAndBorderMain;
+
+    YGFloat containerCrossAxis = availableInnerCrossDim;
+    if (measureModeCrossDim == YGMeasureModeUndefined ||
+        measureModeCrossDim == YGMeasureModeAtMost) {
+      // Compute the cross axis from the max cross dimension of the children.
+      containerCrossAxis = YGNodeBoundAxis(node,
+                                           crossAxis,
+                                           crossDim + paddingAndBorderAxisCross,
+                                           crossAxisParentSize,
+                                           parentWidth) -
+      paddingAndBorderAxisCross;
+
+      if (measureModeCrossDim == YGMeasureModeAtMost) {
+        YGAvailableRangeScopeRequire(&rangeScope, dim[crossAxis], containerCrossAxis);
+        containerCrossAxis = YGFloatMin(containerCrossAxis, availableInnerCrossDim);
+      }
+    }
+
+    // If there's no flex wrap, the cross dimension is defined by the container.
+    if (!isNodeFlexWrap && measureModeCrossDim == YGMeasureModeExactly) {
+      crossDim = availableInnerCrossDim;
+    }
+
+    // Clamp to the min/max size specified on the container.
+    crossDim = YGNodeBoundAxis(node,
+                               crossAxis,
+                               crossDim + paddingAndBorderAxisCross,
+                               crossAxisParentSize,
+                               parentWidth) -
+    paddingAndBorderAxisCross;
+
+    // STEP 7: CROSS-AXIS ALIGNMENT
+    // We can skip child alignment if we're just measuring the container.
+    if (performLayout) {
+      for (uint32_t i = startOfLineIndex; i < endOfLineIndex; i++) {
+        const YGNodeRef child = YGNodeListGet(node->children, i);
+        if (child->style.display == YGDisplayNone) {
+          continue;
+        }
+        if (child->style.positionType == YGPositionTypeAbsolute) {
+          // If the child is absolutely positioned and has a
+          // top/left/bottom/right
+          // set, override all the previously computed positions to set it
+          // correctly.
+          if (YGNodeIsLeadingPosDefined(child, crossAxis)) {
+            child->layout.position[pos[crossAxis]] =
+            YGNodeLeadingPosition(child, crossAxis, availableInnerCrossDim) +
+            YGNodeLeadingBorder(node, crossAxis) +
+            YGNodeLeadingMargin(child, crossAxis, availableInnerWidth);
+          } else {
+            child->layout.position[pos[crossAxis]] =
+            YGNodeLeadingBorder(node, crossAxis) +
+            YGNodeLeadingMargin(child, crossAxis, availableInnerWidth);
+          }
+        } else {
+          YGFloat leadingCrossDim = leadingPaddingAndBorderCross;
+
+          // For a relative children, we're either using alignItems (parent) or
+          // alignSelf (child) in order to determine the position in the cross
+          // axis
+          const YGAlign alignItem = YGNodeAlignItem(node, child);
+
+          // If the child uses align stretch, we need to lay it out one more
+          // time, this time
+          // forcing the cross-axis size to be the computed cross size for the
+          // current line.
+          if (alignItem == YGAlignStretch &&
+              child->style.margin[leading[crossAxis]].unit != YGUnitAuto &&
+              child->style.margin[trailing[crossAxis]].unit != YGUnitAuto) {
+            // If the child defines a definite size for its cross axis, there's
+            // no need to stretch.
+            if (!YGNodeIsStyleDimDefined(child, crossAxis, availableInnerCrossDim)) {
+              YGFloat childMainSize = child->layout.measuredDimensions[dim[mainAxis]];
+              YGFloat childCrossSize =
+              !YGFloatIsUndefined(child->style.aspectRatio)
+              ? ((YGNodeMarginForAxis(child, crossAxis, availableInnerWidth) +
+                  (isMainAxisRow ? childMainSize / child->style.aspectRatio
+                   : childMainSize * child->style.aspectRatio)))
+              : crossDim;
+
+              childMainSize += YGNodeMarginForAxis(child, mainAxis, availableInnerWidth);
+
+              YGMeasureMode childMainMeasureMode = YGMeasureModeExactly;
+              YGMeasureMode childCrossMeasureMode = YGMeasureModeExactly;
+              YGConstrainMaxSizeForMode(YGValueResolve(&child->style.maxDimensions[dim[mainAxis]],
+                                                       availableInnerMainDim),
+                                        &childMainMeasureMode,
+                                        &childMainSize);
+              YGConstrainMaxSizeForMode(YGValueResolve(&child->style.maxDimensions[dim[crossAxis]],
+                                                       availableInnerCrossDim),
+                                        &childCrossMeasureMode,
+                                        &childCrossSize);
+
+              const YGFloat childWidth = isMainAxisRow ? childMainSize : childCrossSize;
+              const YGFloat childHeight = !isMainAxisRow ? childMainSize : childCrossSize;
+
+              const YGMeasureMode childWidthMeasureMode =
+              YGFloatIsUndefined(childWidth) ? YGMeasureModeUndefined : YGMeasureModeExactly;
+              const YGMeasureMode childHeightMeasureMode =
+              YGFloatIsUndefined(childHeight) ? YGMeasureModeUndefined : YGMeasureModeExactly;
+
+              YGLayoutNodeInternal(child,
+                                   childWidth,
+                                   childHeight,
+                                   direction,
+                                   childWidthMeasureMode,
+                                   childHeightMeasureMode,
+                                   availableInnerWidth,
+                                   availableInnerHeight,
+                                   true,
+                                   "stretch");
+            }
+          } else {
+            const YGFloat remainingCrossDim =
+            containerCrossAxis - YGNodeDimWithMargin(child, crossAxis, availableInnerWidth);
+
+            if (child->style.margin[leading[crossAxis]].unit == YGUnitAuto &&
+                child->style.margin[trailing[crossAxis]].unit == YGUnitAuto) {
+              leadingCrossDim += remainingCrossDim / 2;
+            } else if (child->style.margin[trailing[crossAxis]].unit == YGUnitAuto) {
+              // No-Op
+            } else if (child->style.margin[leading[crossAxis]].unit == YGUnitAuto) {
+              leadingCrossDim += remainingCrossDim;
+            } else if (alignItem == YGAlignFlexStart) {
+              // No-Op
+            } else if (alignItem == YGAlignCenter) {
+              leadingCrossDim += remainingCrossDim / 2;
+            } else {
+              leadingCrossDim += remainingCrossDim;
+            }
+          }
+          // And we apply the position
+          child->layout.position[pos[crossAxis]] += totalLineCrossDim + leadingCrossDim;
+        }
+      }
+    }
+
+    totalLineCrossDim += crossDim;
+    maxLineMainDim = YGFloatMax(maxLineMainDim, mainDim);
+  }
+
+  // STEP 8: MULTI-LINE CONTENT ALIGNMENT
+  if (performLayout &&
+      (lineCount > 1 || node->style.alignContent == YGAlignStretch || YGIsBaselineLayout(node)) &&
+      !YGFloatIsUndefined(availableInnerCrossDim)) {
+    const YGFloat remainingAlignContentDim = availableInnerCrossDim - totalLineCrossDim;
+    if (measureModeCrossDim == YGMeasureModeAtMost) {
+      YGAvailableRangeCollapseAxis(&rangeScope.range,
+                                   dim[crossAxis],
+                                   isMainAxisRow ? availableHeight : availableWidth);
+    }
+
+    YGFloat crossDimLead = 0;
+    YGFloat currentLead = leadingPaddingAndBorderCross;
+
+    switch (node->style.alignContent) {
+      case YGAlignFlexEnd:
+        currentLead += remainingAlignContentDim;
+        break;
+      case YGAlignCenter:
+        currentLead += remainingAlignContentDim / 2;
+        break;
+      case YGAlignStretch:
+        if (availableInnerCrossDim > totalLineCrossDim) {
+          crossDimLead = remainingAlignContentDim / lineCount;
+        }
+        break;
+      case YGAlignSpaceAround:
+        if (availableInnerCrossDim > totalLineCrossDim) {
+          currentLead += remainingAlignContentDim / (2 * lineCount);
+          if (lineCount > 1) {
+            crossDimLead = remainingAlignContentDim / lineCount;
+          }
+        } else {
+          currentLead += remainingAlignContentDim / 2;
+        }
+        break;
+      case YGAlignSpaceBetween:
+        if (availableInnerCrossDim > totalLineCrossDim && lineCount > 1) {
+          crossDimLead = remainingAlignContentDim / (lineCount - 1);
+        }
+        break;
+      case YGAlignAuto:
+      case YGAlignFlexStart:
+      case YGAlignBaseline:
+        break;
+    }
+
+    uint32_t endIndex = 0;
+    for (uint32_t i = 0; i < lineCount; i++) {
+      const uint32_t startIndex = endIndex;
+      uint32_t ii;
+
+      // compute the line's height and find the endIndex
+      YGFloat lineHeight = 0;
+      YGFloat maxAscentForCurrentLine = 0;
+      YGFloat maxDescentForCurrentLine = 0;
+      for (ii = startIndex; ii < childCount; ii++) {
+        const YGNodeRef child = YGNodeListGet(node->children, ii);
+        if (child->style.display == YGDisplayNone) {
+          continue;
+        }
+        if (child->style.positionType == YGPositionTypeRelative) {
+          if (child->lineIndex != i) {
+            break;
+          }
+          if (YGNodeIsLayoutDimDefined(child, crossAxis)) {
+            lineHeight = YGFloatMax(lineHeight,
+                               child->layout.measuredDimensions[dim[crossAxis]] +
+                               YGNodeMarginForAxis(child, crossAxis, availableInnerWidth));
+          }
+          if (YGNodeAlignItem(node, child) == YGAlignBaseline) {
+            const YGFloat ascent =
+            YGBaseline(child) +
+            YGNodeLeadingMargin(child, YGFlexDirectionColumn, availableInnerWidth);
+            const YGFloat descent =
+            child->layout.measuredDimensions[YGDimensionHeight] +
+            YGNodeMarginForAxis(child, YGFlexDirectionColumn, availableInnerWidth) - ascent;
+            maxAscentForCurrentLine = YGFloatMax(maxAscentForCurrentLine, ascent);
+            maxDescentForCurrentLine = YGFloatMax(maxDescentForCurrentLine, descent);
+            lineHeight = YGFloatMax(lineHeight, maxAscentForCurrentLine + maxDescentForCurrentLine);
+          }
+        }
+      }
+      endIndex = ii;
+      lineHeight += crossDimLead;
+
+      if (performLayout) {
+        for (ii = startIndex; ii < endIndex; ii++) {
+          const YGNodeRef child = YGNodeListGet(node->children, ii);
+          if (child->style.display == YGDisplayNone) {
+            continue;
+          }
+          if (child->style.positionType == YGPositionTypeRelative) {
+            switch (YGNodeAlignItem(node, child)) {
+              case YGAlignFlexStart: {
+                child->layout.position[pos[crossAxis]] =
+                currentLead + YGNodeLeadingMargin(child, crossAxis, availableInnerWidth);
+                break;
+              }
+              case YGAlignFlexEnd: {
+                child->layout.position[pos[crossAxis]] =
+                currentLead + lineHeight -
+                YGNodeTrailingMargin(child, crossAxis, availableInnerWidth) -
+                child->layout.measuredDimensions[dim[crossAxis]];
+                break;
+              }
+              case YGAlignCenter: {
+                YGFloat childHeight = child->layout.measuredDimensions[dim[crossAxis]];
+                child->layout.position[pos[crossAxis]] =
+                currentLead + (lineHeight - childHeight) / 2;
+                break;
+              }
+              case YGAlignStretch: {
+                child->layout.position[pos[crossAxis]] =
+                currentLead + YGNodeLeadingMargin(child, crossAxis, availableInnerWidth);
+
+                // Remeasure child with the line height as it as been only measured with the
+                // parents height yet.
+                if (!YGNodeIsStyleDimDefined(child, crossAxis, availableInnerCrossDim)) {
+                  const YGFloat childWidth =
+                  isMainAxisRow ? (child->layout.measuredDimensions[YGDimensionWidth] +
+                                   YGNodeMarginForAxis(child, crossAxis, availableInnerWidth))
+                  : lineHeight;
+
+                  const YGFloat childHeight =
+                  !isMainAxisRow ? (child->layout.measuredDimensions[YGDimensionHeight] +
+                                    YGNodeMarginForAxis(child, crossAxis, availableInnerWidth))
+                  : lineHeight;
+
+                  if (!(YGFloatsEqual(childWidth,
+                                      child->layout.measuredDimensions[YGDimensionWidth]) &&
+                        YGFloatsEqual(childHeight,
+                                      child->layout.measuredDimensions[YGDimensionHeight]))) {
+                          YGLayoutNodeInternal(child,
+                                               childWidth,
+                                               childHeight,
+                                               direction,
+                                               YGMeasureModeExactly,
+                                               YGMeasureModeExactly,
+                                               availableInnerWidth,
+                                               availableInnerHeight,
+                                               true,
+                                               "stretch");
+                        }
+                }
+                break;
+              }
+              case YGAlignBaseline: {
+                child->layout.position[YGEdgeTop] =
+                currentLead + maxAscentForCurrentLine - YGBaseline(child) +
+                YGNodeLeadingPosition(child, YGFlexDirectionColumn, availableInnerCrossDim);
+                break;
+              }
+              case YGAlignAuto:
+              case YGAlignSpaceBetween:
+              case YGAlignSpaceAround:
+                break;
+            }
+          }
+        }
+      }
+
+      currentLead += lineHeight;
+    }
+  }
+
+  // STEP 9: COMPUTING FINAL DIMENSIONS
+  node->layout.measuredDimensions[YGDimensionWidth] = YGNodeBoundAxis(
+                                                                      node, YGFlexDirectionRow, availableWidth - marginAxisRow, parentWidth, parentWidth);
+  node->layout.measuredDimensions[YGDimensionHeight] = YGNodeBoundAxis(
+                                                                       node, YGFlexDirectionColumn, availableHeight - marginAxisColumn, parentHeight, parentWidth);
+
+  // If the user didn't specify a width or height for the node, set the
+  // dimensions based on the children.
+  if (measureModeMainDim == YGMeasureModeUndefined ||
+      (node->style.overflow != YGOverflowScroll && measureModeMainDim == YGMeasureModeAtMost)) {
+    // Clamp the size to the min/max size, if specified, and make sure it
+    // doesn't go below the padding and border amount.
+    node->layout.measuredDimensions[dim[mainAxis]] =
+    YGNodeBoundAxis(node, mainAxis, maxLineMainDim, mainAxisParentSize, parentWidth);
+  } else if (measureModeMainDim == YGMeasureModeAtMost &&
+             node->style.overflow == YGOverflowScroll) {
+    node->layout.measuredDimensions[dim[mainAxis]] = YGFloatMax(
+                                                           YGFloatMin(availableInnerMainDim + paddingAndBorderAxisMain,
+                                                                 YGNodeBoundAxisWithinMinAndMax(node, mainAxis, maxLineMainDim, mainAxisParentSize)),
+                                                           paddingAndBorderAxisMain);
+  }
+
+  if (measureModeCrossDim == YGMeasureModeUndefined ||
+      (node->style.overflow != YGOverflowScroll && measureModeCrossDim == YGMeasureModeAtMost)) {
+    // Clamp the size to the min/max size, if specified, and make sure it
+    // doesn't go below the padding and border amount.
+    node->layout.measuredDimensions[dim[crossAxis]] =
+    YGNodeBoundAxis(node,
+                    crossAxis,
+                    totalLineCrossDim + paddingAndBorderAxisCross,
+                    crossAxisParentSize,
+                    parentWidth);
+  } else if (measureModeCrossDim == YGMeasureModeAtMost &&
+             node->style.overflow == YGOverflowScroll) {
+    node->layout.measuredDimensions[dim[crossAxis]] =
+    YGFloatMax(YGFloatMin(availableInnerCrossDim + paddingAndBorderAxisCross,
+                YGNodeBoundAxisWithinMinAndMax(node,
+                                               crossAxis,
+                                               totalLineCrossDim + paddingAndBorderAxisCross,
+                                               crossAxisParentSize)),
+          paddingAndBorderAxisCross);
+  }
+
+  // As we only wrapped in normal direction yet, we need to reverse the positions on wrap-reverse.
+  if (performLayout && node->style.flexWrap == YGWrapWrapReverse) {
+    for (uint32_t i = 0; i < childCount; i++) {
+      const YGNodeRef child = YGNodeGetChild(node, i);
+      if (child->style.positionType == YGPositionTypeRelative) {
+        child->layout.position[pos[crossAxis]] = node->layout.measuredDimensions[dim[crossAxis]] -
+        child->layout.position[pos[crossAxis]] -
+        child->layout.measuredDimensions[dim[crossAxis]];
+      }
+    }
+  }
+
+  if (performLayout) {
+    // STEP 10: SIZING AND POSITIONING ABSOLUTE CHILDREN
+    for (currentAbsoluteChild = firstAbsoluteChild; currentAbsoluteChild != NULL;
+         currentAbsoluteChild = currentAbsoluteChild->nextChild) {
+      YGNodeAbsoluteLayoutChild(node,
+                                currentAbsoluteChild,
+                                availableInnerWidth,
+                                widthMeasureMode,
+                                availableInnerHeight,
+                                direction);
+    }
+
+    // STEP 11: SETTING TRAILING POSITIONS FOR CHILDREN
+    const bool needsMainTrailingPos =
+    mainAxis == YGFlexDirectionRowReverse || mainAxis == YGFlexDirectionColumnReverse;
+    const bool needsCrossTrailingPos =
+    crossAxis == YGFlexDirectionRowReverse || crossAxis == YGFlexDirectionColumnReverse;
+
+    // Set trailing position if necessary.
+    if (needsMainTrailingPos || needsCrossTrailingPos) {
+      for (uint32_t i = 0; i < childCount; i++) {
+        const YGNodeRef child = YGNodeListGet(node->children, i);
+        if (child->style.display == YGDisplayNone) {
+          continue;
+        }
+        if (needsMainTrailingPos) {
+          YGNodeSetChildTrailingPosition(node, child, mainAxis);
+        }
+
+        if (needsCrossTrailingPos) {
+          YGNodeSetChildTrailingPosition(node, child, crossAxis);
+        }
+      }
+    }
+  }
+
+  gAvailableRangeScope = parentRangeScope;
+  node->layout.availableRange = rangeScope.range;
+}
+
+YG_THREAD_LOCAL uint32_t gDepth = 0;
+bool gPrintTree = false;
+bool gPrintChanges = false;
+bool gPrintSkips = false;
+
+static const char *spacer = "                                                            ";
+
+static const char *YGSpacer(const unsigned long level) {
+  const size_t spacerLen = strlen(spacer);
+  if (level > spacerLen) {
+    return &spacer[0];
+  } else {
+    return &spacer[spacerLen - level];
+  }
+}
+
+static const char *YGMeasureModeName(const YGMeasureMode mode, const bool performLayout) {
+  const char *kMeasureModeNames[YGMeasureModeCount] = {"UNDEFINED", "EXACTLY", "AT_MOST"};
+  const char *kLayoutModeNames[YGMeasureModeCount] = {"LAY_UNDEFINED",
+    "LAY_EXACTLY",
+    "LAY_AT_"
+    "MOST"};
+
+  if (mode >= YGMeasureModeCount) {
+    return "";
+  }
+
+  return performLayout ? kLayoutModeNames[mode] : kMeasureModeNames[mode];
+}
+
+static inline bool YGMeasureModeSizeIsExactAndMatchesOldMeasuredSize(YGMeasureMode sizeMode,
+                                                                     YGFloat size,
+                                                                     YGFloat lastComputedSize) {
+  return sizeMode == YGMeasureModeExactly && YGFloatsEqual(size, lastComputedSize);
+}
+
+static inline bool YGMeasureModeOldSizeIsUnspecifiedAndStillFits(YGMeasureMode sizeMode,
+                                                                 YGFloat size,
+                                                                 YGMeasureMode lastSizeMode,
+                                                                 YGFloat lastComputedSize) {
+  return sizeMode == YGMeasureModeAtMost && lastSizeMode == YGMeasureModeUndefined &&
+  (size >= lastComputedSize || YGFloatsEqual(size, lastComputedSize));
+}
+
+static inline bool YGMeasureModeNewMeasureSizeIsStricterAndStillValid(YGMeasureMode sizeMode,
+                                                                      YGFloat size,
+                                                                      YGMeasureMode lastSizeMode,
+                                                                      YGFloat lastSize,
+                                                                      YGFloat lastComputedSize) {
+  return lastSizeMode == YGMeasureModeAtMost && sizeMode == YGMeasureModeAtMost &&
+  lastSize > size && (lastComputedSize <= size || YGFloatsEqual(size, lastComputedSize));
+}
+
+static bool YGCanUseCachedMeasurement(const YGMeasureMode widthMode,
+                                      const YGFloat width,
+                                      const YGMeasureMode heightMode,
+                                      const YGFloat height,
+                                      const YGMeasureMode lastWidthMode,
+                                      const YGFloat lastWidth,
+                                      const YGMeasureMode lastHeightMode,
+                                      const YGFloat lastHeight,
+                                      const YGFloat lastComputedWidth,
+                                      const YGFloat lastComputedHeight,
+                                      const YGFloat marginRow,
+                                      const YGFloat marginColumn) {
+  if (lastComputedHeight < 0 || lastComputedWidth < 0) {
+    return false;
+  }
+
+  const bool hasSameWidthSpec = lastWidthMode == widthMode && YGFloatsEqual(lastWidth, width);
+  const bool hasSameHeightSpec = lastHeightMode == heightMode && YGFloatsEqual(lastHeight, height);
+
+  const bool widthIsCompatible =
+  hasSameWidthSpec || YGMeasureModeSizeIsExactAndMatchesOldMeasuredSize(widthMode,
+                                                                        width - marginRow,
+                                                                        lastComputedWidth) ||
+  YGMeasureModeOldSizeIsUnspecifiedAndStillFits(widthMode,
+                                                width - marginRow,
+                                                lastWidthMode,
+                                                lastComputedWidth) ||
+  YGMeasureModeNewMeasureSizeIsStricterAndStillValid(widthMode,
+                                                     width - marginRow,
+                                                     lastWidthMode,
+                                                     lastWidth - marginRow,
+                                                     lastComputedWidth);
+
+  const bool heightIsCompatible =
+  hasSameHeightSpec || YGMeasureModeSizeIsExactAndMatchesOldMeasuredSize(heightMode,
+                                                                         height - marginColumn,
+                                                                         lastComputedHeight) ||
+  YGMeasureModeOldSizeIsUnspecifiedAndStillFits(heightMode,
+                                                height - marginColumn,
+                                                lastHeightMode,
+                                                lastComputedHeight) ||
+  YGMeasureModeNewMeasureSizeIsStricterAndStillValid(heightMode,
+                                                     height - marginColumn,
+                                                     lastHeightMode,
+                                                     lastHeight - marginColumn,
+                                                     lastComputedHeight);
+
+  return widthIsCompatible && heightIsCompatible;
+}
+
+bool YGNodeCanUseCachedMeasurement(const YGMeasureMode widthMode,
+                                   const float width,
+                                   const YGMeasureMode heightMode,
+                                   const float height,
+                                   const YGMeasureMode lastWidthMode,
+                                   const float lastWidth,
+                                   const YGMeasureMode lastHeightMode,
+                                   const float lastHeight,
+                                   const float lastComputedWidth,
+                                   const float lastComputedHeight,
+                                   const float marginRow,
+                                   const float marginColumn) {
+  return YGCanUseCachedMeasurement(widthMode,
+                                   width,
+                                   heightMode,
+                                   height,
+                                   lastWidthMode,
+                                   lastWidth,
+                                   lastHeightMode,
+                                   lastHeight,
+                                   lastComputedWidth,
+                                   lastComputedHeight,
+                                   marginRow,
+                                   marginColumn);
+}
+
+static YGCachedLayoutEntry *YGLayoutCacheFind(const YGNodeRef node,
+                                              const YGFloat availableWidth,
+                                              const YGFloat availableHeight,
+                                              const YGMeasureMode widthMeasureMode,
+                                              const YGMeasureMode heightMeasureMode) {
+  const YGLayoutCacheRef cache = node->layoutCache;
+  if (cache == NULL) {
+    return NULL;
+  }
+
+  for (uint32_t i = 0; i < cache->count; i++) {
+    YGCachedLayoutEntry *const entry = &cache->entries[i];
+    if (YGFloatsEqual(entry->measurement.availableWidth, availableWidth) &&
+        YGFloatsEqual(entry->measurement.availableHeight, availableHeight) &&
+        entry->measurement.widthMeasureMode == widthMeasureMode &&
+        entry->measurement.heightMeasureMode == heightMeasureMode) {
+      return entry;
+    }
+  }
+  return NULL;
+}
+
+// Records the layout just computed for the node, replacing an entry for the same constraints or
+// else the oldest one.
+static void YGLayoutCacheStore(const YGNodeRef node,
+                               const YGFloat availableWidth,
+                               const YGFloat availableHeight,
+                               const YGMeasureMode widthMeasureMode,
+                               const YGMeasureMode heightMeasureMode) {
+  const uint32_t childCount = YGNodeListCount(node->children);
+  if (childCount == 0) {
+    return;
+  }
+
+  if (node->layoutCache == NULL) {
+    node->layoutCache = gYGCalloc(1, sizeof(YGLayoutCache));
+    YG_ASSERT(node->layoutCache, "Could not allocate memory for layout cache");
+  }
+
+  const YGLayoutCacheRef cache = node->layoutCache;
+  YGCachedLayoutEntry *entry = YGLayoutCacheFind(
+      node, availableWidth, availableHeight, widthMeasureMode, heightMeasureMode);
+  if (entry == NULL) {
+    entry = &cache->entries[cache->next];
+    cache->next = (cache->next + 1) % YG_MAX_CACHED_LAYOUT_COUNT;
+    if (cache->count < YG_MAX_CACHED_LAYOUT_COUNT) {
+      cache->count++;
+    }
+  }
+
+  if (entry->childCapacity < childCount) {
+    entry->children = gYGRealloc(entry->children, sizeof(YGCachedChildLayout) * childCount);
+    YG_ASSERT(entry->children, "Could not extend allocation for layout cache");
+    entry->childCapacity = childCount;
+  }
+
+  const YGLayout *const layout = &node->layout;
+  entry->measurement.availableWidth = availableWidth;
+  entry->measurement.availableHeight = availableHeight;
+  entry->measurement.widthMeasureMode = widthMeasureMode;
+  entry->measurement.heightMeasureMode = heightMeasureMode;
+  entry->measurement.computedWidth = layout->measuredDimensions[YGDimensionWidth];
+  entry->measurement.computedHeight = layout->measuredDimensions[YGDimensionHeight];
+  entry->measurement.range = layout->availableRange;
+  entry->direction = layout->direction;
+  memcpy(entry->margin, layout->margin, sizeof(entry->margin));
+  memcpy(entry->border, layout->border, sizeof(entry->border));
+  memcpy(entry->padding, layout->padding, sizeof(entry->padding));
+
+  entry->childCount = childCount;
+  for (uint32_t i = 0; i < childCount; i++) {
+    const YGNodeRef child = YGNodeListGet(node->children, i);
+    YGCachedChildLayout *const record = &entry->children[i];
+    memcpy(record->position, child->layout.position, sizeof(record->position));
+    record->request = child->layout.lastLayoutRequest;
+    if (record->request.generationCount != gCurrentGenerationCount) {
+      // Not laid out by this pass, its layout is left as it is when restoring.
+      record->request.widthMeasureMode = (YGMeasureMode) -1;
+    }
+  }
+}
+
+static void YGLayoutCacheRestore(const YGNodeRef node, const YGCachedLayoutEntry *const entry) {
+  YGLayout *const layout = &node->layout;
+  layout->measuredDimensions[YGDimensionWidth] = entry->measurement.computedWidth;
+  layout->measuredDimensions[YGDimensionHeight] = entry->measurement.computedHeight;
+  layout->direction = entry->direction;
+  memcpy(layout->margin, entry->margin, sizeof(entry->margin));
+  memcpy(layout->border, entry->border, sizeof(entry->border));
+  memcpy(layout->padding, entry->padding, sizeof(entry->padding));
+
+  for (uint32_t i = 0; i < entry->childCount; i++) {
+    const YGNodeRef child = YGNodeListGet(node->children, i);
+    if (child->style.display == YGDisplayNone) {
+      YGZeroOutLayoutRecursivly(child);
+      continue;
+    }
+
+    const YGCachedChildLayout *const record = &entry->children[i];
+    if (record->request.widthMeasureMode != (YGMeasureMode) -1) {
+      YGLayoutNodeInternal(child,
+                           record->request.availableWidth,
+                           record->request.availableHeight,
+                           record->request.parentDirection,
+                           record->request.widthMeasureMode,
+                           record->request.heightMeasureMode,
+                           record->request.parentWidth,
+                           record->request.parentHeight,
+                           true,
+                           "cached");
+    }
+    memcpy(child->layout.position, record->position, sizeof(record->position));
+  }
+}
+
+// Rounds the frame of a node, without its children, to whole points.
+static void YGRoundFrameToPixelGrid(const YGNodeRef node) {
+  if (node->layout.lastLayoutRequest.generationCount == gCurrentGenerationCount) {
+    YGNodeSetUnroundedPosition(
+        node, node->layout.position[YGEdgeLeft], node->layout.position[YGEdgeTop]);
+  }
+  const YGFloat fractialLeft =
+  node->layout.position[YGEdgeLeft] - YGFloatFloor(node->layout.position[YGEdgeLeft]);
+  const YGFloat fractialTop =
+  node->layout.position[YGEdgeTop] - YGFloatFloor(node->layout.position[YGEdgeTop]);
+  node->layout.dimensions[YGDimensionWidth] =
+  YGFloatRound(fractialLeft + node->layout.dimensions[YGDimensionWidth]) -
+  YGFloatRound(fractialLeft);
+  node->layout.dimensions[YGDimensionHeight] =
+  YGFloatRound(fractialTop + node->layout.dimensions[YGDimensionHeight]) -
+  YGFloatRound(fractialTop);
+
+  node->layout.position[YGEdgeLeft] = YGFloatRound(node->layout.position[YGEdgeLeft]);
+  node->layout.position[YGEdgeTop] = YGFloatRound(node->layout.position[YGEdgeTop]);
+}
+
+// Lays a node out again on its own, with the request its parent last made. With rounding its new
+// frame is rounded from where the parent put it, as the pass that laid the parent out would round
+// it. Returns whether it was laid out; the frame of a cached layout is rounded here.
+static bool YGNodeLayoutAgain(const YGNodeRef node, const char *reason) {
+  YGLayout *const layout = &node->layout;
+  const YGLayoutRequest request = layout->lastLayoutRequest;
+  const bool rounding = YGIsExperimentalFeatureEnabled(YGExperimentalFeatureRounding);
+  if (rounding) {
+    layout->position[YGEdgeLeft] = YGNodeGetUnroundedPosition(node, 0);
+    layout->position[YGEdgeTop] = YGNodeGetUnroundedPosition(node, 1);
+  }
+
+  if (YGLayoutNodeInternal(node,
+                           request.availableWidth,
+                           request.availableHeight,
+                           request.parentDirection,
+                           request.widthMeasureMode,
+                           request.heightMeasureMode,
+                           request.parentWidth,
+                           request.parentHeight,
+                           true,
+                           reason)) {
+    return true;
+  }
+  if (rounding) {
+    YGRoundFrameToPixelGrid(node);
+  }
+  return false;
+}
+
+// Lays out again the dirty layout boundaries below a node whose own layout is cached, each with
+// the request it was last laid out with. Returns whether any of them was.
+static bool YGNodeLayoutDirtyBoundaries(const YGNodeRef node) {
+  node->hasDirtyDescendant = false;
+
+  bool laidOut = false;
+  const uint32_t childCount = YGNodeListCount(node->children);
+  for (uint32_t i = 0; i < childCount; i++) {
+    const YGNodeRef child = YGNodeListGet(node->children, i);
+    const YGLayoutRequest *const request = &child->layout.lastLayoutRequest;
+    if ((!child->isDirty && !child->hasDirtyDescendant) ||
+        child->style.display == YGDisplayNone || request->generationCount == 0) {
+      continue;
+    }
+
+    laidOut |= YGNodeLayoutAgain(child, "boundary");
+  }
+  return laidOut;
+}
+
+// Only containers sized exactly by their parent are deferred: for those a measure pass yields the
+// same size as a full layout, so the parent positions its children exactly as it would eagerly.
+// A baseline aligned ancestor reads the positions of the children to find the baseline, so
+// nothing below one is deferred.
+static bool YGNodeCanDeferLayout(const YGNodeRef node,
+                                 const YGMeasureMode widthMeasureMode,
+                                 const YGMeasureMode heightMeasureMode) {
+  if (node == gDeferredLayoutRoot || YGNodeListCount(node->children) == 0 ||
+      widthMeasureMode != YGMeasureModeExactly || heightMeasureMode != YGMeasureModeExactly) {
+    return false;
+  }
+
+  for (YGNodeRef ancestor = node->parent; ancestor != NULL; ancestor = ancestor->parent) {
+    if (YGIsBaselineLayout(ancestor)) {
+      return false;
+    }
+    if (ancestor == gDeferredLayoutRoot) {
+      break;
+    }
+  }
+  return true;
+}
+
+// Sizes a container for a deferred pass and keeps the request that is to position its children
+// once they are needed.
+static bool YGNodeDeferLayout(const YGNodeRef node,
+                              const YGFloat availableWidth,
+                              const YGFloat availableHeight,
+                              const YGDirection parentDirection,
+                              const YGMeasureMode widthMeasureMode,
+                              const YGMeasureMode heightMeasureMode,
+                              const YGFloat parentWidth,
+                              const YGFloat parentHeight,
+                              const char *reason) {
+  YGLayoutNodeInternal(node,
+                       availableWidth,
+                       availableHeight,
+                       parentDirection,
+                       widthMeasureMode,
+                       heightMeasureMode,
+                       parentWidth,
+                       parentHeight,
+                       false,
+                       reason);
+
+  YGLayout *const layout = &node->layout;
+  layout->dimensions[YGDimensionWidth] = layout->measuredDimensions[YGDimensionWidth];
+  layout->dimensions[YGDimensionHeight] = layout->measuredDimensions[YGDimensionHeight];
+  layout->lastLayoutRequest = (YGLayoutRequest){
+      .availableWidth = availableWidth,
+      .availableHeight = availableHeight,
+      .widthMeasureMode = widthMeasureMode,
+      .heightMeasureMode = heightMeasureMode,
+      .parentWidth = parentWidth,
+      .parentHeight = parentHeight,
+      .parentDirection = parentDirection,
+      .generationCount = gCurrentGenerationCount,
+  };
+  YGNodeSetNewLayout(node);
+
+  if (!node->extras->layoutDeferred) {
+    YGNodeGetExtras(node)->layoutDeferred = true;
+    gDeferredLayoutCount++;
+  }
+  return true;
+}
+
+// Finds the result of an earlier layout or measurement of the node with the same constraints,
+// or with a layout the node needs, the entry of its layout cache that restores one.
+static inline bool YGNodeCachedMeasurementSkipped(const YGNodeRef node,
+                                                  const YGCachedMeasurement *const entry) {
+  return YGNodeSkipsMeasurement(node,
+                                entry->availableWidth,
+                                entry->availableHeight,
+                                entry->widthMeasureMode,
+                                entry->heightMeasureMode);
+}
+
+// Whether the measurement of a node with a measure function in the entry holds for these
+// constraints. A max size cuts the measured size short of what the measure function returned, so
+// the cached size says nothing about other constraints and only the same ones can reuse it.
+static bool YGNodeCanUseCachedMeasurementEntry(const YGNodeRef node,
+                                               const YGCachedMeasurement *const entry,
+                                               const YGFloat availableWidth,
+                                               const YGFloat availableHeight,
+                                               const YGMeasureMode widthMeasureMode,
+                                               const YGMeasureMode heightMeasureMode,
+                                               const bool skipsMeasurement,
+                                               const YGFloat marginAxisRow,
+                                               const YGFloat marginAxisColumn) {
+  if (YGNodeHasMaxDimension(node)) {
+    return entry->computedWidth >= 0 && entry->computedHeight >= 0 &&
+           entry->widthMeasureMode == widthMeasureMode &&
+           YGFloatsEqual(entry->availableWidth, availableWidth) &&
+           entry->heightMeasureMode == heightMeasureMode &&
+           YGFloatsEqual(entry->availableHeight, availableHeight);
+  }
+  return YGNodeCachedMeasurementSkipped(node, entry) == skipsMeasurement &&
+         YGCanUseCachedMeasurement(widthMeasureMode,
+                                   availableWidth,
+                                   heightMeasureMode,
+                                   availableHeight,
+                                   entry->widthMeasureMode,
+                                   entry->availableWidth,
+                                   entry->heightMeasureMode,
+                                   entry->availableHeight,
+                                   entry->computedWidth,
+                                   entry->computedHeight,
+                                   marginAxisRow,
+                                   marginAxisColumn);
+}
+
+static YGCachedMeasurement *YGNodeFindCachedResults(const YGNodeRef node,
+                                                    const YGFloat availableWidth,
+                                                    const YGFloat availableHeight,
+                                                    const YGMeasureMode widthMeasureMode,
+                                                    const YGMeasureMode heightMeasureMode,
+                                                    const YGFloat parentWidth,
+                                                    const bool performLayout,
+                                                    const bool needToVisitNode,
+                                                    YGCachedLayoutEntry **const cachedLayoutEntry) {
+  YGLayout *const layout = &node->layout;
+  YGCachedMeasurement *cachedResults = NULL;
+  *cachedLayoutEntry = NULL;
+
+  // Determine whether the results are already cached. We maintain a separate
+  // cache for layouts and measurements. A layout operation modifies the
+  // positions
+  // and dimensions for nodes in the subtree. The algorithm assumes that each
+  // node
+  // gets layed out a maximum of one time per tree layout, but multiple
+  // measurements
+  // may be required to resolve all of the flex dimensions.
+  // We handle nodes with measure functions specially here because they are the
+  // most
+  // expensive to measure, so it's worth avoiding redundant measurements if at
+  // all possible.
+  if (node->measure) {
+    const YGFloat marginAxisRow = YGNodeMarginForAxis(node, YGFlexDirectionRow, parentWidth);
+    const YGFloat marginAxisColumn = YGNodeMarginForAxis(node, YGFlexDirectionColumn, parentWidth);
+    const bool skipsMeasurement = YGNodeSkipsMeasurement(
+        node, availableWidth, availableHeight, widthMeasureMode, heightMeasureMode);
+
+    // First, try to use the layout cache.
+    if (YGNodeCanUseCachedMeasurementEntry(node,
+                                           &layout->cachedLayout,
+                                           availableWidth,
+                                           availableHeight,
+                                           widthMeasureMode,
+                                           heightMeasureMode,
+                                           skipsMeasurement,
+                                           marginAxisRow,
+                                           marginAxisColumn)) {
+      cachedResults = &layout->cachedLayout;
+    } else {
+      // Try to use the measurement cache.
+      for (uint32_t i = 0; i < layout->nextCachedMeasurementsIndex; i++) {
+        if (YGNodeCanUseCachedMeasurementEntry(node,
+                                               &layout->cachedMeasurements[i],
+                                               availableWidth,
+                                               availableHeight,
+                                               widthMeasureMode,
+                                               heightMeasureMode,
+                                               skipsMeasurement,
+                                               marginAxisRow,
+                                               marginAxisColumn)) {
+          cachedResults = &layout->cachedMeasurements[i];
+          break;
+        }
+      }
+    }
+  } else if (performLayout) {
+    if (YGNodeCanReuseLayout(&layout->cachedLayout,
+                             availableWidth,
+                             availableHeight,
+                             widthMeasureMode,
+                             heightMeasureMode)) {
+      cachedResults = &layout->cachedLayout;
+    } else if (!needToVisitNode && node->extras->virtualized == NULL) {
+      *cachedLayoutEntry = YGLayoutCacheFind(
+          node, availableWidth, availableHeight, widthMeasureMode, heightMeasureMode);
+    }
+  } else {
+    for (uint32_t i = 0; i < layout->nextCachedMeasurementsIndex; i++) {
+      if (YGNodeCanReuseLayout(&layout->cachedMeasurements[i],
+                               availableWidth,
+                               availableHeight,
+                               widthMeasureMode,
+                               heightMeasureMode)) {
+        cachedResults = &layout->cachedMeasurements[i];
+        break;
+      }
+    }
+  }
+
+  return cachedResults;
+}
+
+// Whether the subtrees of the node and of instance match node for node. Baseline functions below
+// the root would align on the contexts of their own nodes.
+static bool YGNodeIsInstanceOf(const YGNodeRef node, const YGNodeRef instance) {
+  if (!YGNodeMatchesInstance(node, instance)) {
+    return false;
+  }
+
+  const uint32_t childCount = YGNodeListCount(node->children);
+  for (uint32_t i = 0; i < childCount; i++) {
+    const YGNodeRef child = YGNodeListGet(node->children, i);
+    const YGNodeRef instanceChild = YGNodeListGet(instance->children, i);
+    if (child->baseline != NULL || instanceChild->baseline != NULL ||
+        !YGNodeIsInstanceOf(child, instanceChild)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Copies the layout state of the subtree of instance onto the one of the node. What
+// YGNodeEmitFrameDelta last reported and pending batched measurements stay with each node.
+static void YGNodeCopyInstanceLayout(const YGNodeRef node, const YGNodeRef instance) {
+  YGLayout *const layout = &node->layout;
+  // Of the measurements only those in use, most of the ring is usually empty.
+  const size_t measurementsStart = offsetof(YGLayout, cachedMeasurements);
+  const size_t measurementsEnd = offsetof(YGLayout, measuredDimensions);
+  memcpy(layout, &instance->layout, measurementsStart);
+  memcpy(layout->cachedMeasurements,
+         instance->layout.cachedMeasurements,
+         sizeof(YGCachedMeasurement) * instance->layout.nextCachedMeasurementsIndex);
+  memcpy((char *) layout + measurementsEnd,
+         (const char *) &instance->layout + measurementsEnd,
+         sizeof(YGLayout) - measurementsEnd);
+  YGNodeSetUnroundedPosition(
+      node, YGNodeGetUnroundedPosition(instance, 0), YGNodeGetUnroundedPosition(instance, 1));
+  YGNodeInvalidateBounds(node);
+
+  const YGLayoutCacheRef cache = instance->layoutCache;
+  YGLayoutCacheAssign(node,
+                      cache != NULL ? cache->entries : NULL,
+                      cache != NULL ? cache->count : 0,
+                      cache != NULL ? cache->next : 0);
+
+  node->isDirty = instance->isDirty;
+  node->hasDirtyDescendant = instance->hasDirtyDescendant;
+  node->cachesWarm = instance->cachesWarm;
+  YGNodeSetNewLayout(node);
+
+  const uint32_t childCount = YGNodeListCount(node->children);
+  for (uint32_t i = 0; i < childCount; i++) {
+    const YGNodeRef child = YGNodeListGet(node->children, i);
+    const YGNodeRef instanceChild = YGNodeListGet(instance->children, i);
+    child->lineIndex = instanceChild->lineIndex;
+    YGNodeCopyInstanceLayout(child, instanceChild);
+  }
+}
+
+// Takes over the layout state of the sibling the parent matched the node with, once that one
+// was visited by this pass: its caches then hold for the node too. A measurement only looks at
+// the measurements of the node itself, the frames below it are left alone until it is laid out.
+static bool YGNodeAdoptInstanceLayout(const YGNodeRef node,
+                                      const YGDirection parentDirection,
+                                      const bool performLayout) {
+  const YGNodeRef parent = node->parent;
+  if (parent == NULL || parent->extras->virtualized != NULL || gMeasureBatch.collecting ||
+      node->extras->instanceIndex >= YGNodeListCount(parent->children)) {
+    return false;
+  }
+
+  const YGNodeRef instance = YGNodeListGet(parent->children, node->extras->instanceIndex);
+  if (instance == node || instance->layout.generationCount != gCurrentGenerationCount ||
+      instance->layout.lastParentDirection != parentDirection ||
+      !YGNodeIsInstanceOf(node, instance)) {
+    return false;
+  }
+
+  if (performLayout) {
+    // The parent places the node itself.
+    YGFloat position[4];
+    memcpy(position, node->layout.position, sizeof(position));
+    YGNodeCopyInstanceLayout(node, instance);
+    memcpy(node->layout.position, position, sizeof(position));
+  } else {
+    YGLayout *const layout = &node->layout;
+    memcpy(layout->cachedMeasurements,
+           instance->layout.cachedMeasurements,
+           sizeof(YGCachedMeasurement) * instance->layout.nextCachedMeasurementsIndex);
+    layout->nextCachedMeasurementsIndex = instance->layout.nextCachedMeasurementsIndex;
+    layout->lastParentDirection = parentDirection;
+  }
+  return true;
+}
+
+//
+// This is a wrapper around the YGNodelayoutImpl function. It determines
+// whether the layout request is redundant and can be skipped.
+//
+// Parameters:
+//  Input parameters are the same as YGNodelayoutImpl (see above)
+//  Return parameter is true if layout was performed, false if skipped
+//
+bool YGLayoutNodeInternal(const YGNodeRef node,
+                          const YGFloat availableWidth,
+                          const YGFloat availableHeight,
+                          const YGDirection parentDirection,
+                          const YGMeasureMode widthMeasureMode,
+                          const YGMeasureMode heightMeasureMode,
+                          const YGFloat parentWidth,
+                          const YGFloat parentHeight,
+                          const bool performLayout,
+                          const char *reason) {
+  YGLayout *layout = &node->layout;
+
+  // A frozen node reports the size of its last layout whatever it is asked to fit in, without
+  // looking at its caches or its subtree. Its generation is left alone, so the walks that
+  // follow a layout pass know nothing below it changed.
+  if (YGNodeKeepsFrozenLayout(node)) {
+    layout->measuredDimensions[YGDimensionWidth] = layout->laidOutDimensions[YGDimensionWidth];
+    layout->measuredDimensions[YGDimensionHeight] = layout->laidOutDimensions[YGDimensionHeight];
+    YGAvailableRangeOpenAxis(&layout->availableRange, YGDimensionWidth);
+    YGAvailableRangeOpenAxis(&layout->availableRange, YGDimensionHeight);
+    if (performLayout) {
+      // The parent may still have moved it.
+      YGNodeSetNewLayout(node);
+    }
+    return false;
+  }
+
+  if (performLayout && gDeferredLayoutRoot != NULL && YGNodeCanDeferLayout(node,
+                                                                           widthMeasureMode,
+                                                                           heightMeasureMode)) {
+    return YGNodeDeferLayout(node,
+                             availableWidth,
+                             availableHeight,
+                             parentDirection,
+                             widthMeasureMode,
+                             heightMeasureMode,
+                             parentWidth,
+                             parentHeight,
+                             reason);
+  }
+
+  gDepth++;
+
+  bool needToVisitNode =
+  (node->isDirty && !node->cachesWarm && layout->generationCount != gCurrentGenerationCount) ||
+  layout->lastParentDirection != parentDirection;
+
+  if (needToVisitNode) {
+    // Invalidate the cached results.
+    layout->nextCachedMeasurementsIndex = 0;
+    layout->cachedLayout.widthMeasureMode = (YGMeasureMode) -1;
+    layout->cachedLayout.heightMeasureMode = (YGMeasureMode) -1;
+    layout->cachedLayout.computedWidth = -1;
+    layout->cachedLayout.computedHeight = -1;
+    if (node->layoutCache) {
+      node->layoutCache->count = 0;
+      node->layoutCache->next = 0;
+    }
+  }
+
+  YGCachedLayoutEntry *cachedLayoutEntry = NULL;
+  YGCachedMeasurement *cachedResults = YGNodeFindCachedResults(node,
+                                          availableWidth,
+                                          availableHeight,
+                                          widthMeasureMode,
+                                          heightMeasureMode,
+                                          parentWidth,
+                                          performLayout,
+                                          needToVisitNode,
+                                          &cachedLayoutEntry);
+
+  // Instead of being laid out, a node can take over the state of an identical sibling this pass
+  // already visited, whose caches then hold for the node as they are. A clean node keeps
+  // measuring on its own caches, those of the sibling may come from a different parent size.
+  const bool instanced =
+      (needToVisitNode || (performLayout && cachedResults == NULL && cachedLayoutEntry == NULL)) &&
+      YGNodeAdoptInstanceLayout(node, parentDirection, performLayout);
+  if (instanced) {
+    needToVisitNode = false;
+    cachedResults = YGNodeFindCachedResults(node,
+                                            availableWidth,
+                                            availableHeight,
+                                            widthMeasureMode,
+                                            heightMeasureMode,
+                                            parentWidth,
+                                            performLayout,
+                                            needToVisitNode,
+                                            &cachedLayoutEntry);
+  }
+
+  bool laidOutBoundaries = false;
+  const uint32_t pendingBatchedMeasurements = gMeasureBatch.count;
+
+  if (!needToVisitNode && cachedResults != NULL) {
+    layout->measuredDimensions[YGDimensionWidth] = cachedResults->computedWidth;
+    layout->measuredDimensions[YGDimensionHeight] = cachedResults->computedHeight;
+    if (node->measure) {
+      YGNodeSetLeafAvailableRange(node,
+                                  availableWidth,
+                                  availableHeight,
+                                  widthMeasureMode,
+                                  heightMeasureMode,
+                                  parentWidth);
+    } else {
+      layout->availableRange = cachedResults->range;
+    }
+
+    if (gPrintChanges && gPrintSkips) {
+      printf("%s%d.{[skipped] ", YGSpacer(gDepth), gDepth);
+      if (node->print) {
+        node->print(node);
+      }
+      printf("wm: %s, hm: %s, aw: %f ah: %f => d: (%f, %f) %s\n",
+             YGMeasureModeName(widthMeasureMode, performLayout),
+             YGMeasureModeName(heightMeasureMode, performLayout),
+             availableWidth,
+             availableHeight,
+             cachedResults->computedWidth,
+             cachedResults->computedHeight,
+             reason);
+    }
+
+    if (performLayout && node->hasDirtyDescendant) {
+      laidOutBoundaries = YGNodeLayoutDirtyBoundaries(node);
+    }
+  } else if (cachedLayoutEntry != NULL) {
+    if (gPrintChanges && gPrintSkips) {
+      printf("%s%d.{[restored] ", YGSpacer(gDepth), gDepth);
+      if (node->print) {
+        node->print(node);
+      }
+      printf("wm: %s, hm: %s, aw: %f ah: %f %s\n",
+             YGMeasureModeName(widthMeasureMode, performLayout),
+             YGMeasureModeName(heightMeasureMode, performLayout),
+             availableWidth,
+             availableHeight,
+             reason);
+    }
+
+    YGLayoutCacheRestore(node, cachedLayoutEntry);
+    layout->cachedLayout = cachedLayoutEntry->measurement;
+    layout->availableRange = cachedLayoutEntry->measurement.range;
+  } else {
+    if (gPrintChanges) {
+      printf("%s%d.{%s", YGSpacer(gDepth), gDepth, needToVisitNode ? "*" : "");
+      if (node->print) {
+        node->print(node);
+      }
+      printf("wm: %s, hm: %s, aw: %f ah: %f %s\n",
+             YGMeasureModeName(widthMeasureMode, performLayout),
+             YGMeasureModeName(heightMeasureMode, performLayout),
+             availableWidth,
+             availableHeight,
+             reason);
+    }
+
+    YGNodelayoutImpl(node,
+                     availableWidth,
+                     availableHeight,
+                     parentDirection,
+                     widthMeasureMode,
+                     heightMeasureMode,
+                     parentWidth,
+                     parentHeight,
+                     performLayout);
+
+    if (gPrintChanges) {
+      printf("%s%d.}%s", YGSpacer(gDepth), gDepth, needToVisitNode ? "*" : "");
+      if (node->print) {
+        node->print(node);
+      }
+      printf("wm: %s, hm: %s, d: (%f, %f) %s\n",
+             YGMeasureModeName(widthMeasureMode, performLayout),
+             YGMeasureModeName(heightMeasureMode, performLayout),
+             layout->measuredDimensions[YGDimensionWidth],
+             layout->measuredDimensions[YGDimensionHeight],
+             reason);
+    }
+
+    layout->lastParentDirection = parentDirection;
+
+    // A measurement deferred to the parent's batch only produced a placeholder size.
+    const bool measurementDeferred = gMeasureBatch.count != pendingBatchedMeasurements;
+
+    if (cachedResults == NULL && !measurementDeferred) {
+      if (layout->nextCachedMeasurementsIndex == YG_MAX_CACHED_RESULT_COUNT) {
+        if (gPrintChanges) {
+          printf("Out of cache entries!\n");
+        }
+        layout->nextCachedMeasurementsIndex = 0;
+      }
+
+      YGCachedMeasurement *newCacheEntry;
+      if (performLayout) {
+        // Use the single layout cache entry.
+        newCacheEntry = &layout->cachedLayout;
+      } else {
+        // Allocate a new measurement cache entry.
+        newCacheEntry = &layout->cachedMeasurements[layout->nextCachedMeasurementsIndex];
+        layout->nextCachedMeasurementsIndex++;
+      }
+
+      newCacheEntry->availableWidth = availableWidth;
+      newCacheEntry->availableHeight = availableHeight;
+      newCacheEntry->widthMeasureMode = widthMeasureMode;
+      newCacheEntry->heightMeasureMode = heightMeasureMode;
+      newCacheEntry->computedWidth = layout->measuredDimensions[YGDimensionWidth];
+      newCacheEntry->computedHeight = layout->measuredDimensions[YGDimensionHeight];
+      newCacheEntry->range = layout->availableRange;
+    }
+
+    if (performLayout && node->measure == NULL && node->extras->virtualized == NULL &&
+        !measurementDeferred) {
+      YGLayoutCacheStore(
+          node, availableWidth, availableHeight, widthMeasureMode, heightMeasureMode);
+    }
+  }
+
+  if (performLayout) {
+    layout->lastLayoutRequest = (YGLayoutRequest){
+        .availableWidth = availableWidth,
+        .availableHeight = availableHeight,
+        .widthMeasureMode = widthMeasureMode,
+        .heightMeasureMode = heightMeasureMode,
+        .parentWidth = parentWidth,
+        .parentHeight = parentHeight,
+        .parentDirection = parentDirection,
+        .generationCount = gCurrentGenerationCount,
+    };
+    node->layout.dimensions[YGDimensionWidth] = node->layout.measuredDimensions[YGDimensionWidth];
+    node->layout.dimensions[YGDimensionHeight] = node->layout.measuredDimensions[YGDimensionHeight];
+    node->layout.laidOutDimensions[YGDimensionWidth] =
+        node->layout.measuredDimensions[YGDimensionWidth];
+    node->layout.laidOutDimensions[YGDimensionHeight] =
+        node->layout.measuredDimensions[YGDimensionHeight];
+    YGNodeSetNewLayout(node);
+    node->isDirty = false;
+    if (cachedResults == NULL) {
+      // All children were visited, which lays out any dirty boundary below.
+      node->hasDirtyDescendant = false;
+    }
+    if (node->extras->layoutDeferred) {
+      node->extras->layoutDeferred = false;
+      gDeferredLayoutCount--;
+    }
+  }
+
+  if (gAvailableRangeScope != NULL && gAvailableRangeScope->node == node->parent) {
+    YGAvailableRangeScopeNarrow(gAvailableRangeScope,
+                                &layout->availableRange,
+                                availableWidth,
+                                availableHeight,
+                                widthMeasureMode,
+                                heightMeasureMode);
+  }
+
+  gDepth--;
+  layout->generationCount = gCurrentGenerationCount;
+  return (needToVisitNode || cachedResults == NULL || laidOutBoundaries || instanced);
+}
+
+static void YGRoundToPixelGridRecursive(const YGNodeRef node) {
+  YGRoundFrameToPixelGrid(node);
+
+  // The children of a deferred node are rounded once they are positioned, those of a frozen
+  // node skipped by this pass were rounded when it was last laid out.
+  if (node->extras->layoutDeferred ||
+      (node->extras->frozen && node->layout.generationCount != gCurrentGenerationCount)) {
+    return;
+  }
+
+  // Children of a virtualized container outside the last window were not laid out.
+  uint32_t firstChild = 0;
+  uint32_t endChild = YGNodeListCount(node->children);
+  if (node->extras->virtualized != NULL) {
+    firstChild = node->extras->virtualized->firstVisible;
+    if (node->extras->virtualized->endVisible < endChild) {
+      endChild = node->extras->virtualized->endVisible;
+    }
+  }
+  for (uint32_t i = firstChild; i < endChild; i++) {
+    YGRoundToPixelGridRecursive(YGNodeGetChild(node, i));
+  }
+}
+
+// Rounds the frames of a subtree just laid out to whole points, when rounding is enabled.
+static void YGRoundToPixelGrid(const YGNodeRef node) {
+  if (YGIsExperimentalFeatureEnabled(YGExperimentalFeatureRounding)) {
+    YGRoundToPixelGridRecursive(node);
+  }
+}
+
+// Determines the size and mode a root is laid out with on an axis. Without an available size
+// the root's own dimension, or failing that its max dimension, is used.
+static void YGNodeResolveRootConstraint(const YGNodeRef node,
+                                        const YGFlexDirection axis,
+                                        const YGFloat availableSize,
+                                        const YGFloat availableWidth,
+                                        YGFloat *size,
+                                        YGMeasureMode *measureMode) {
+  *size = availableSize;
+  *measureMode = YGMeasureModeUndefined;
+  if (!YGFloatIsUndefined(availableSize)) {
+    *measureMode = YGMeasureModeExactly;
+  } else if (YGNodeIsStyleDimDefined(node, axis, availableSize)) {
+    *size = YGValueResolve(node->resolvedDimensions[dim[axis]], availableSize) +
+    YGNodeMarginForAxis(node, axis, availableWidth);
+    *measureMode = YGMeasureModeExactly;
+  } else if (YGValueResolve(&node->style.maxDimensions[dim[axis]], availableSize) >= 0.0f) {
+    *size = YGValueResolve(&node->style.maxDimensions[dim[axis]], availableSize);
+    *measureMode = YGMeasureModeAtMost;
+  }
+}
+
+// Lays a root out with resolved constraints and finishes the pass: positions the root within its
+// parent size, rounds to the pixel grid and prints the tree when asked to. The pass is finished
+// even if the layout was cached when an earlier pass of the same call did some work.
+static void YGNodeLayoutRoot(const YGNodeRef node,
+                             const YGFloat width,
+                             const YGFloat height,
+                             const YGMeasureMode widthMeasureMode,
+                             const YGMeasureMode heightMeasureMode,
+                             const YGFloat parentWidth,
+                             const YGFloat parentHeight,
+                             const YGDirection parentDirection,
+                             const bool finish,
+                             const char *reason) {
+  if (YGLayoutNodeInternal(node,
+                           width,
+                           height,
+                           parentDirection,
+                           widthMeasureMode,
+                           heightMeasureMode,
+                           parentWidth,
+                           parentHeight,
+                           true,
+                           reason) ||
+      finish) {
+    YGNodeSetPosition(node, node->layout.direction, parentWidth, parentHeight, parentWidth);
+
+    YGRoundToPixelGrid(node);
+
+    if (gPrintTree) {
+      YGNodePrint(node, YGPrintOptionsLayout | YGPrintOptionsChildren | YGPrintOptionsStyle);
+    }
+  } else if (YGIsExperimentalFeatureEnabled(YGExperimentalFeatureRounding)) {
+    // A cached layout sets the size again from the measured one, which is rounded like the last
+    // pass rounded it.
+    node->layout.position[YGEdgeLeft] = YGNodeGetUnroundedPosition(node, 0);
+    node->layout.position[YGEdgeTop] = YGNodeGetUnroundedPosition(node, 1);
+    YGRoundFrameToPixelGrid(node);
+  }
+}
+
+// Lays the tree out in the current generation.
+static void YGNodeLayoutTree(const YGNodeRef node,
+                             const float availableWidth,
+                             const float availableHeight,
+                             const YGDirection parentDirection) {
+  YGFloat width;
+  YGFloat height;
+  YGMeasureMode widthMeasureMode;
+  YGMeasureMode heightMeasureMode;
+
+  YGResolveDimensions(node);
+
+  YGNodeResolveRootConstraint(
+      node, YGFlexDirectionRow, availableWidth, availableWidth, &width, &widthMeasureMode);
+  YGNodeResolveRootConstraint(
+      node, YGFlexDirectionColumn, availableHeight, availableWidth, &height, &heightMeasureMode);
+
+  YGNodeLayoutRoot(node,
+                   width,
+                   height,
+                   widthMeasureMode,
+                   heightMeasureMode,
+                   availableWidth,
+                   availableHeight,
+                   parentDirection,
+                   false,
+                   "initial");
+}
+
+void YGNodeCalculateLayout(const YGNodeRef node,
+                           const float availableWidth,
+                           const float availableHeight,
+                           const YGDirection parentDirection) {
+  // Increment the generation count. This will force the recursive routine to
+  // visit
+  // all dirty nodes at least once. Subsequent visits will be skipped if the
+  // input
+  // parameters don't change.
+  YGNextGeneration();
+  YGNodeLayoutTree(node, availableWidth, availableHeight, parentDirection);
+}
+
+void YGNodeCalculateLayoutSubtree(const YGNodeRef node) {
+  if (node->layout.lastLayoutRequest.generationCount == 0) {
+    return;
+  }
+
+  YGNextGeneration();
+
+  if (YGNodeLayoutAgain(node, "subtree")) {
+    YGRoundToPixelGrid(node);
+
+    // The ancestors were not visited, so what they derived from their subtrees is stale.
+    for (YGNodeRef ancestor = node->parent; ancestor != NULL; ancestor = ancestor->parent) {
+      YGNodeInvalidateBounds(ancestor);
+    }
+    YGNodeInvalidateCommittedSubtree(node->parent);
+  }
+}
+
+// Positions the children of a deferred node with the request its parent made. With
+// deferChildren the containers among them are in turn only sized.
+static void YGNodeLayoutDeferred(const YGNodeRef node, const bool deferChildren) {
+  const YGNodeRef previousRoot = gDeferredLayoutRoot;
+  gDeferredLayoutRoot = deferChildren ? node : NULL;
+  const bool laidOut = YGNodeLayoutAgain(node, "deferred");
+  gDeferredLayoutRoot = previousRoot;
+
+  if (laidOut) {
+    YGRoundToPixelGrid(node);
+  }
+}
+
+// Lays out the deferred nodes from the root down to node, outermost first. A deferred node only
+// has its measured size, which a layout pass may still change, so the node itself is included.
+static void YGNodeResolveDeferredPath(const YGNodeRef node) {
+  if (node->parent != NULL) {
+    YGNodeResolveDeferredPath(node->parent);
+  }
+  if (node->extras->layoutDeferred) {
+    YGNodeLayoutDeferred(node, true);
+  }
+}
+
+// Positions the deferred nodes whose frames intersect the region. left and top are the node's
+// origin relative to the root.
+static void YGNodeLayoutRegion(const YGNodeRef node,
+                               const YGFloat left,
+                               const YGFloat top,
+                               const YGRect region) {
+  if (node->extras->layoutDeferred) {
+    YGNodeLayoutDeferred(node, true);
+  }
+
+  uint32_t firstChild = 0;
+  uint32_t endChild = YGNodeListCount(node->children);
+  if (node->extras->virtualized != NULL) {
+    firstChild = node->extras->virtualized->firstVisible;
+    if (node->extras->virtualized->endVisible < endChild) {
+      endChild = node->extras->virtualized->endVisible;
+    }
+  }
+
+  for (uint32_t i = firstChild; i < endChild; i++) {
+    const YGNodeRef child = YGNodeListGet(node->children, i);
+    if (child->style.display == YGDisplayNone) {
+      continue;
+    }
+
+    const YGFloat childLeft = left + child->layout.position[YGEdgeLeft];
+    const YGFloat childTop = top + child->layout.position[YGEdgeTop];
+    if (childLeft < region.x + region.width &&
+        childLeft + child->layout.dimensions[YGDimensionWidth] > region.x &&
+        childTop < region.y + region.height &&
+        childTop + child->layout.dimensions[YGDimensionHeight] > region.y) {
+      YGNodeLayoutRegion(child, childLeft, childTop, region);
+    }
+  }
+}
+
+void YGNodeCalculateLayoutDeferred(const YGNodeRef node,
+                                   const float availableWidth,
+                                   const float availableHeight,
+                                   const YGDirection parentDirection,
+                                   const YGRect region) {
+  gDeferredLayoutRoot = node;
+  YGNodeCalculateLayout(node, availableWidth, availableHeight, parentDirection);
+  gDeferredLayoutRoot = NULL;
+
+  YGNodeLayoutRegion(node, 0, 0, region);
+}
+
+static void YGNodeEnsureLayoutRecursive(const YGNodeRef node) {
+  if (gDeferredLayoutCount == 0) {
+    return;
+  }
+
+  if (node->extras->layoutDeferred) {
+    YGNodeLayoutDeferred(node, false);
+  }
+
+  const uint32_t childCount = YGNodeListCount(node->children);
+  for (uint32_t i = 0; i < childCount; i++) {
+    YGNodeEnsureLayoutRecursive(YGNodeListGet(node->children, i));
+  }
+}
+
+void YGNodeEnsureLayout(const YGNodeRef node) {
+  if (gDeferredLayoutCount > 0) {
+    YGNodeResolveDeferredPath(node);
+    YGNodeEnsureLayoutRecursive(node);
+  }
+}
+
+static uint64_t YGMonotonicMicros(void) {
+  struct timespec now;
+#ifdef _MSC_VER
+  timespec_get(&now, TIME_UTC);
+#else
+  clock_gettime(CLOCK_MONOTONIC, &now);
+#endif
+  return (uint64_t) now.tv_sec * 1000000 + (uint64_t) now.tv_nsec / 1000;
+}
+
+// A node a session measures ahead of the pass that sizes the tree, with the constraints its
+// parent is expected to measure its flex basis with.
+typedef struct YGSessionMeasurement {
+  YGNodeRef node;
+  YGFloat availableWidth;
+  YGFloat availableHeight;
+  YGMeasureMode widthMeasureMode;
+  YGMeasureMode heightMeasureMode;
+  YGFloat parentWidth;
+  YGFloat parentHeight;
+  YGDirection parentDirection;
+  // Whether its children were queued.
+  bool expanded;
+} YGSessionMeasurement;
+
+// A time-sliced layout. The tree is first measured bottom up, one node per unit of work, then
+// sized the way YGNodeCalculateLayoutDeferred does, which finds those measurements cached and
+// leaves the children of containers sized exactly by their parent pending. Each later unit of
+// work positions the children of one such container, again deferring the containers among them,
+// so the pending work is found by walking the tree with an explicit stack rather than recursing.
+// All steps run in the generation of the first, so what one step measured holds for the next.
+struct YGLayoutSession {
+  YGNodeRef root;
+  float availableWidth;
+  float availableHeight;
+  YGDirection parentDirection;
+  uint32_t generation;
+  bool sized;
+  YGSessionMeasurement *measurements;
+  uint32_t measurementCount;
+  uint32_t measurementCapacity;
+  YGNodeListRef stack;
+};
+
+YGLayoutSessionRef YGLayoutBegin(const YGNodeRef root,
+                                 const float availableWidth,
+                                 const float availableHeight,
+                                 const YGDirection parentDirection) {
+  const YGLayoutSessionRef session = gYGCalloc(1, sizeof(struct YGLayoutSession));
+  YG_ASSERT(session, "Could not allocate memory for layout session");
+  session->root = root;
+  session->availableWidth = availableWidth;
+  session->availableHeight = availableHeight;
+  session->parentDirection = parentDirection;
+  return session;
+}
+
+static void YGLayoutSessionQueue(const YGLayoutSessionRef session,
+                                 const YGSessionMeasurement *const measurement) {
+  if (session->measurementCount == session->measurementCapacity) {
+    session->measurementCapacity =
+        session->measurementCapacity == 0 ? 16 : session->measurementCapacity * 2;
+    session->measurements = gYGRealloc(session->measurements,
+                                       sizeof(YGSessionMeasurement) *
+                                           session->measurementCapacity);
+    YG_ASSERT(session->measurements, "Could not extend allocation for layout session");
+  }
+  session->measurements[session->measurementCount++] = *measurement;
+}
+
+// The size left for the content of a node on an axis, as YGNodelayoutImpl determines it.
+static YGFloat YGNodeAvailableInnerSize(const YGNodeRef node,
+                                        const YGFlexDirection axis,
+                                        const YGFloat availableSize,
+                                        const YGFloat parentSize,
+                                        const YGFloat parentWidth) {
+  const YGFloat margin = YGNodeMarginForAxis(node, axis, parentWidth);
+  const YGFloat paddingAndBorder = YGNodePaddingAndBorderForAxis(node, axis, parentWidth);
+  YGFloat innerSize = availableSize - margin - paddingAndBorder;
+  if (!YGFloatIsUndefined(innerSize)) {
+    const YGFloat minInnerSize =
+        YGValueResolve(&node->style.minDimensions[dim[axis]], parentSize) - margin -
+        paddingAndBorder;
+    const YGFloat maxInnerSize =
+        YGValueResolve(&node->style.maxDimensions[dim[axis]], parentSize) - margin -
+        paddingAndBorder;
+    innerSize = YGFloatMax(YGFloatMin(innerSize, maxInnerSize), minInnerSize);
+  }
+  return innerSize;
+}
+
+// Queues the children of a node with the constraints their flex basis is measured with, which
+// for children of definite size are those they are measured with once the basis is known. The
+// only flexible child of a container of exact size is sized by its siblings, it is measured along
+// with the node, as are leaves handed to a batch measure function so they stay in one batch.
+// Virtualized containers pick their children during the pass.
+static void YGLayoutSessionQueueChildren(const YGLayoutSessionRef session,
+                                         const YGSessionMeasurement *const parent) {
+  const YGNodeRef node = parent->node;
+  if (node->measure != NULL || node->extras->virtualized != NULL || YGNodeKeepsFrozenLayout(node)) {
+    return;
+  }
+
+  const YGDirection direction = YGNodeResolveDirection(node, parent->parentDirection);
+  const YGFlexDirection mainAxis = YGFlexDirectionResolve(node->style.flexDirection, direction);
+  const bool isMainAxisRow = YGFlexDirectionIsRow(mainAxis);
+  const YGFloat innerWidth = YGNodeAvailableInnerSize(node,
+                                                      YGFlexDirectionRow,
+                                                      parent->availableWidth,
+                                                      parent->parentWidth,
+                                                      parent->parentWidth);
+  const YGFloat innerHeight = YGNodeAvailableInnerSize(node,
+                                                       YGFlexDirectionColumn,
+                                                       parent->availableHeight,
+                                                       parent->parentHeight,
+                                                       parent->parentWidth);
+  const uint32_t childCount = YGNodeListCount(node->children);
+  const YGNodeRef singleFlexChild =
+      (isMainAxisRow ? parent->widthMeasureMode : parent->heightMeasureMode) ==
+              YGMeasureModeExactly
+          ? YGNodeFindSingleFlexChild(node, childCount)
+          : NULL;
+
+  // Queued in reverse so children are measured in document order.
+  for (uint32_t i = childCount; i > 0; i--) {
+    const YGNodeRef child = YGNodeListGet(node->children, i - 1);
+    if (child == singleFlexChild || child->style.display == YGDisplayNone ||
+        child->style.positionType == YGPositionTypeAbsolute || YGNodeKeepsFrozenLayout(child) ||
+        (child->measure != NULL && node->batchMeasure != NULL)) {
+      continue;
+    }
+    YGResolveDimensions(child);
+    YGSessionMeasurement measurement = {
+        .node = child,
+        .parentWidth = innerWidth,
+        .parentHeight = innerHeight,
+        .parentDirection = direction,
+    };
+    if (YGNodeFlexBasisMeasureConstraints(node,
+                                          child,
+                                          innerWidth,
+                                          parent->widthMeasureMode,
+                                          innerHeight,
+                                          innerWidth,
+                                          innerHeight,
+                                          parent->heightMeasureMode,
+                                          direction,
+                                          &measurement.availableWidth,
+                                          &measurement.availableHeight,
+                                          &measurement.widthMeasureMode,
+                                          &measurement.heightMeasureMode)) {
+      YGLayoutSessionQueue(session, &measurement);
+    }
+  }
+}
+
+// Measures the queued nodes, each after its children, until the deadline. Returns whether all
+// were measured in time. The root is left to the pass that sizes the tree.
+static bool YGLayoutSessionMeasure(const YGLayoutSessionRef session, const uint64_t deadline) {
+  while (session->measurementCount > 0) {
+    const YGSessionMeasurement measurement = session->measurements[session->measurementCount - 1];
+    if (!measurement.expanded) {
+      session->measurements[session->measurementCount - 1].expanded = true;
+      YGLayoutSessionQueueChildren(session, &measurement);
+      continue;
+    }
+
+    session->measurementCount--;
+    if (measurement.node == session->root) {
+      continue;
+    }
+    YGLayoutNodeInternal(measurement.node,
+                         measurement.availableWidth,
+                         measurement.availableHeight,
+                         measurement.parentDirection,
+                         measurement.widthMeasureMode,
+                         measurement.heightMeasureMode,
+                         measurement.parentWidth,
+                         measurement.parentHeight,
+                         false,
+                         "measure");
+    if (YGMonotonicMicros() >= deadline) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool YGLayoutStep(const YGLayoutSessionRef session, const uint32_t budgetMicros) {
+  const uint64_t deadline = YGMonotonicMicros() + budgetMicros;
+  if (session->generation == 0) {
+    YGNextGeneration();
+    session->generation = gCurrentGenerationCount;
+
+    const YGNodeRef root = session->root;
+    YGResolveDimensions(root);
+    YGSessionMeasurement measurement = {
+        .node = root,
+        .parentWidth = session->availableWidth,
+        .parentHeight = session->availableHeight,
+        .parentDirection = session->parentDirection,
+    };
+    YGNodeResolveRootConstraint(root,
+                                YGFlexDirectionRow,
+                                session->availableWidth,
+                                session->availableWidth,
+                                &measurement.availableWidth,
+                                &measurement.widthMeasureMode);
+    YGNodeResolveRootConstraint(root,
+                                YGFlexDirectionColumn,
+                                session->availableHeight,
+                                session->availableWidth,
+                                &measurement.availableHeight,
+                                &measurement.heightMeasureMode);
+    YGLayoutSessionQueue(session, &measurement);
+  }
+  gCurrentGenerationCount = session->generation;
+
+  // Every step makes progress, however small its budget.
+  if (!session->sized) {
+    if (!YGLayoutSessionMeasure(session, deadline)) {
+      return false;
+    }
+    session->sized = true;
+    gDeferredLayoutRoot = session->root;
+    YGNodeLayoutTree(session->root,
+                     session->availableWidth,
+                     session->availableHeight,
+                     session->parentDirection);
+    gDeferredLayoutRoot = NULL;
+    YGNodeListAdd(&session->stack, session->root);
+    if (gDeferredLayoutCount > 0 && YGMonotonicMicros() >= deadline) {
+      return false;
+    }
+  }
+
+  while (YGNodeListCount(session->stack) > 0) {
+    if (gDeferredLayoutCount == 0) {
+      // Nothing is pending anywhere, not even below the nodes still on the stack.
+      YGNodeListFree(session->stack);
+      session->stack = NULL;
+      break;
+    }
+
+    const YGNodeRef node =
+        YGNodeListRemove(session->stack, YGNodeListCount(session->stack) - 1);
+    const bool laidOut = node->extras->layoutDeferred;
+    if (laidOut) {
+      YGNodeLayoutDeferred(node, true);
+    }
+    // Pushed in reverse so children are visited in document order.
+    for (uint32_t i = YGNodeListCount(node->children); i > 0; i--) {
+      const YGNodeRef child = YGNodeListGet(node->children, i - 1);
+      if (YGNodeListCount(child->children) > 0) {
+        YGNodeListAdd(&session->stack, child);
+      }
+    }
+
+    if (laidOut && YGNodeListCount(session->stack) > 0 && YGMonotonicMicros() >= deadline) {
+      return false;
+    }
+  }
+  return true;
+}
+
+static void YGLayoutSessionFree(const YGLayoutSessionRef session) {
+  gYGFree(session->measurements);
+  YGNodeListFree(session->stack);
+  gYGFree(session);
+}
+
+void YGLayoutCommit(const YGLayoutSessionRef session) {
+  while (!YGLayoutStep(session, UINT32_MAX)) {
+  }
+  YGLayoutSessionFree(session);
+}
+
+typedef struct YGScheduledLayout {
+  YGNodeRef root;
+  float availableWidth;
+  float availableHeight;
+  YGDirection parentDirection;
+  int32_t priority;
+  uint64_t deadline;
+  uint64_t enqueueTime;
+  uint64_t sequence;
+  // Layout in progress, NULL until the root is first picked.
+  YGLayoutSessionRef session;
+} YGScheduledLayout;
+
+// The queue is expected to hold dozens of roots, so it is kept unordered and scanned.
+struct YGLayoutScheduler {
+  YGScheduledLayout *entries;
+  uint32_t count;
+  uint32_t capacity;
+  uint64_t sequence;
+  YGLayoutSchedulerStats stats;
+};
+
+YGLayoutSchedulerRef YGLayoutSchedulerNew(void) {
+  const YGLayoutSchedulerRef scheduler = gYGCalloc(1, sizeof(struct YGLayoutScheduler));
+  YG_ASSERT(scheduler, "Could not allocate memory for layout scheduler");
+  return scheduler;
+}
+
+void YGLayoutSchedulerFree(const YGLayoutSchedulerRef scheduler) {
+  for (uint32_t i = 0; i < scheduler->count; i++) {
+    if (scheduler->entries[i].session != NULL) {
+      YGLayoutSessionFree(scheduler->entries[i].session);
+    }
+  }
+  gYGFree(scheduler->entries);
+  gYGFree(scheduler);
+}
+
+static YGScheduledLayout *YGLayoutSchedulerFind(const YGLayoutSchedulerRef scheduler,
+                                                const YGNodeRef root) {
+  for (uint32_t i = 0; i < scheduler->count; i++) {
+    if (scheduler->entries[i].root == root) {
+      return &scheduler->entries[i];
+    }
+  }
+  return NULL;
+}
+
+// Swaps the last entry into the removed one's place, order is restored by the scan.
+static void YGLayoutSchedulerRemove(const YGLayoutSchedulerRef scheduler,
+                                    YGScheduledLayout *const entry) {
+  if (entry->session != NULL) {
+    YGLayoutSessionFree(entry->session);
+  }
+  *entry = scheduler->entries[--scheduler->count];
+}
+
+void YGLayoutSchedulerEnqueue(const YGLayoutSchedulerRef scheduler,
+                              const YGNodeRef root,
+                              const float availableWidth,
+                              const float availableHeight,
+                              const YGDirection parentDirection,
+                              const int32_t priority,
+                              const uint32_t deadlineMicros) {
+  const uint64_t now = YGMonotonicMicros();
+  YGScheduledLayout *entry = YGLayoutSchedulerFind(scheduler, root);
+  if (entry != NULL) {
+    scheduler->stats.coalescedCount++;
+    if (entry->session != NULL) {
+      // Whatever the session has done may be stale now; what it left pending stays valid and
+      // is picked up by the next one.
+      YGLayoutSessionFree(entry->session);
+      entry->session = NULL;
+    }
+    if (priority > entry->priority) {
+      entry->priority = priority;
+    }
+    if (now + deadlineMicros < entry->deadline) {
+      entry->deadline = now + deadlineMicros;
+    }
+  } else {
+    if (scheduler->count == scheduler->capacity) {
+      scheduler->capacity = scheduler->capacity == 0 ? 8 : scheduler->capacity * 2;
+      scheduler->entries =
+          gYGRealloc(scheduler->entries, sizeof(YGScheduledLayout) * scheduler->capacity);
+      YG_ASSERT(scheduler->entries, "Could not extend allocation for layout scheduler");
+    }
+    entry = &scheduler->entries[scheduler->count++];
+    entry->root = root;
+    entry->priority = priority;
+    entry->deadline = now + deadlineMicros;
+    entry->enqueueTime = now;
+    entry->sequence = scheduler->sequence++;
+    entry->session = NULL;
+  }
+  entry->availableWidth = availableWidth;
+  entry->availableHeight = availableHeight;
+  entry->parentDirection = parentDirection;
+}
+
+void YGLayoutSchedulerCancel(const YGLayoutSchedulerRef scheduler, const YGNodeRef root) {
+  YGScheduledLayout *const entry = YGLayoutSchedulerFind(scheduler, root);
+  if (entry != NULL) {
+    YGLayoutSchedulerRemove(scheduler, entry);
+  }
+}
+
+static YGScheduledLayout *YGLayoutSchedulerNext(const YGLayoutSchedulerRef scheduler) {
+  YGScheduledLayout *next = NULL;
+  for (uint32_t i = 0; i < scheduler->count; i++) {
+    YGScheduledLayout *const entry = &scheduler->entries[i];
+    if (next == NULL || entry->priority > next->priority ||
+        (entry->priority == next->priority &&
+         (entry->deadline < next->deadline ||
+          (entry->deadline == next->deadline && entry->sequence < next->sequence)))) {
+      next = entry;
+    }
+  }
+  return next;
+}
+
+uint32_t YGLayoutSchedulerRun(const YGLayoutSchedulerRef scheduler, const uint32_t budgetMicros) {
+  const uint64_t end = YGMonotonicMicros() + budgetMicros;
+  uint32_t completed = 0;
+  uint64_t now;
+  do {
+    YGScheduledLayout *const entry = YGLayoutSchedulerNext(scheduler);
+    if (entry == NULL) {
+      break;
+    }
+    if (entry->session == NULL) {
+      entry->session = YGLayoutBegin(
+          entry->root, entry->availableWidth, entry->availableHeight, entry->parentDirection);
+    }
+
+    now = YGMonotonicMicros();
+    const bool done = YGLayoutStep(entry->session, now < end ? (uint32_t)(end - now) : 0);
+    now = YGMonotonicMicros();
+    if (done) {
+      YGLayoutSchedulerStats *const stats = &scheduler->stats;
+      const uint64_t latency = now - entry->enqueueTime;
+      stats->completedCount++;
+      stats->totalQueueMicros += latency;
+      if (latency > stats->maxQueueMicros) {
+        stats->maxQueueMicros = latency;
+      }
+      if (now > entry->deadline) {
+        stats->deadlineMissCount++;
+      }
+      YGLayoutSchedulerRemove(scheduler, entry);
+      completed++;
+    }
+  } while (now < end);
+  return completed;
+}
+
+uint32_t YGLayoutSchedulerGetQueueLength(const YGLayoutSchedulerRef scheduler) {
+  return scheduler->count;
+}
+
+YGLayoutSchedulerStats YGLayoutSchedulerGetStats(const YGLayoutSchedulerRef scheduler) {
+  return scheduler->stats;
+}
+
+// Size constraint on an axis of a root fitted to its content: its own dimension when it has
+// one, otherwise whatever is smaller of the given maximum and its max dimension.
+static void YGNodeResolveFittingConstraint(const YGNodeRef node,
+                                           const YGFlexDirection axis,
+                                           const YGFloat maxSize,
+                                           const YGFloat maxWidth,
+                                           YGFloat *size,
+                                           YGMeasureMode *measureMode) {
+  if (YGNodeIsStyleDimDefined(node, axis, maxSize)) {
+    *size = YGValueResolve(node->resolvedDimensions[dim[axis]], maxSize) +
+    YGNodeMarginForAxis(node, axis, maxWidth);
+    *measureMode = YGMeasureModeExactly;
+    return;
+  }
+
+  *size = maxSize;
+  const YGFloat maxDimension = YGValueResolve(&node->style.maxDimensions[dim[axis]], maxSize);
+  if (maxDimension >= 0.0f && (YGFloatIsUndefined(maxSize) || maxDimension < maxSize)) {
+    *size = maxDimension;
+  }
+  *measureMode = YGFloatIsUndefined(*size) ? YGMeasureModeUndefined : YGMeasureModeAtMost;
+}
+
+void YGNodeCalculateLayoutFitting(const YGNodeRef node,
+                                  const float maxWidth,
+                                  const float maxHeight,
+                                  const YGDirection parentDirection) {
+  YGNextGeneration();
+
+  YGFloat width;
+  YGFloat height;
+  YGMeasureMode widthMeasureMode;
+  YGMeasureMode heightMeasureMode;
+
+  YGResolveDimensions(node);
+
+  YGNodeResolveFittingConstraint(
+      node, YGFlexDirectionRow, maxWidth, maxWidth, &width, &widthMeasureMode);
+  YGNodeResolveFittingConstraint(
+      node, YGFlexDirectionColumn, maxHeight, maxWidth, &height, &heightMeasureMode);
+
+  // Fit first: a measure pass leaves the children's measurements cached for the layout pass,
+  // which then runs at the fitted size so percentages and free space resolve against it exactly
+  // as they would for a root given that size.
+  const bool measured = YGLayoutNodeInternal(node,
+                                             width,
+                                             height,
+                                             parentDirection,
+                                             widthMeasureMode,
+                                             heightMeasureMode,
+                                             maxWidth,
+                                             maxHeight,
+                                             false,
+                                             "fit");
+
+  YGNodeLayoutRoot(node,
+                   node->layout.measuredDimensions[YGDimensionWidth] +
+                       YGNodeMarginForAxis(node, YGFlexDirectionRow, maxWidth),
+                   node->layout.measuredDimensions[YGDimensionHeight] +
+                       YGNodeMarginForAxis(node, YGFlexDirectionColumn, maxWidth),
+                   YGMeasureModeExactly,
+                   YGMeasureModeExactly,
+                   maxWidth,
+                   maxHeight,
+                   parentDirection,
+                   measured,
+                   "fitting");
+}
+
+// A node whose layout was not visited since its bounds were computed cannot have a descendant
+// that was, so only the parts of the tree touched by layout passes are walked again.
+static void YGNodeUpdateBounds(const YGNodeRef node) {
+  if (node->extras->boundsGeneration == node->layout.generationCount) {
+    return;
+  }
+
+  YGFloat *const bounds = YGNodeGetExtras(node)->bounds;
+  bounds[YGEdgeLeft] = 0;
+  bounds[YGEdgeTop] = 0;
+  bounds[YGEdgeRight] = node->layout.dimensions[YGDimensionWidth];
+  bounds[YGEdgeBottom] = node->layout.dimensions[YGDimensionHeight];
+
+  // Children of a virtualized container outside the last window were not laid out.
+  uint32_t firstChild = 0;
+  uint32_t endChild = YGNodeListCount(node->children);
+  if (node->extras->virtualized != NULL) {
+    firstChild = node->extras->virtualized->firstVisible;
+    if (node->extras->virtualized->endVisible < endChild) {
+      endChild = node->extras->virtualized->endVisible;
+    }
+  }
+  for (uint32_t i = firstChild; i < endChild; i++) {
+    const YGNodeRef child = YGNodeListGet(node->children, i);
+    if (child->style.display == YGDisplayNone) {
+      continue;
+    }
+    YGNodeUpdateBounds(child);
+    const YGFloat left = child->layout.position[YGEdgeLeft];
+    const YGFloat top = child->layout.position[YGEdgeTop];
+    const YGFloat *const childBounds = child->extras->bounds;
+    bounds[YGEdgeLeft] = YGFloatMin(bounds[YGEdgeLeft], left + childBounds[YGEdgeLeft]);
+    bounds[YGEdgeTop] = YGFloatMin(bounds[YGEdgeTop], top + childBounds[YGEdgeTop]);
+    bounds[YGEdgeRight] = YGFloatMax(bounds[YGEdgeRight], left + childBounds[YGEdgeRight]);
+    bounds[YGEdgeBottom] = YGFloatMax(bounds[YGEdgeBottom], top + childBounds[YGEdgeBottom]);
+  }
+
+  node->extras->boundsGeneration = node->layout.generationCount;
+}
+
+// x and y are relative to the node's origin. Later siblings are on top of earlier ones.
+static YGNodeRef YGNodeHitTestInternal(const YGNodeRef node, const YGFloat x, const YGFloat y) {
+  const YGFloat *const bounds = node->extras->bounds;
+  if (x < bounds[YGEdgeLeft] || x >= bounds[YGEdgeRight] || y < bounds[YGEdgeTop] ||
+      y >= bounds[YGEdgeBottom]) {
+    return NULL;
+  }
+
+  uint32_t firstChild = 0;
+  uint32_t endChild = YGNodeListCount(node->children);
+  if (node->extras->virtualized != NULL) {
+    firstChild = node->extras->virtualized->firstVisible;
+    if (node->extras->virtualized->endVisible < endChild) {
+      endChild = node->extras->virtualized->endVisible;
+    }
+  }
+  for (uint32_t i = endChild; i > firstChild; i--) {
+    const YGNodeRef child = YGNodeListGet(node->children, i - 1);
+    if (child->style.display == YGDisplayNone) {
+      continue;
+    }
+    const YGNodeRef hit = YGNodeHitTestInternal(child,
+                                                x - child->layout.position[YGEdgeLeft],
+                                                y - child->layout.position[YGEdgeTop]);
+    if (hit != NULL) {
+      return hit;
+    }
+  }
+
+  if (x >= 0 && x < node->layout.dimensions[YGDimensionWidth] && y >= 0 &&
+      y < node->layout.dimensions[YGDimensionHeight]) {
+    return node;
+  }
+  return NULL;
+}
+
+YGNodeRef YGNodeHitTest(const YGNodeRef root, const float x, const float y) {
+  YGNodeEnsureLayout(root);
+  YGNodeUpdateBounds(root);
+  return YGNodeHitTestInternal(root, x, y);
+}
+
+// left and top are the node's origin in the coordinate space of the query.
+static void YGNodeQueryRectInternal(const YGNodeRef node,
+                                    const YGFloat left,
+                                    const YGFloat top,
+                                    const YGRect rect,
+                                    YGQueryRectFunc callback,
+                                    void *data) {
+  const YGFloat *const bounds = node->extras->bounds;
+  if (left + bounds[YGEdgeLeft] >= rect.x + rect.width || rect.x >= left + bounds[YGEdgeRight] ||
+      top + bounds[YGEdgeTop] >= rect.y + rect.height || rect.y >= top + bounds[YGEdgeBottom]) {
+    return;
+  }
+
+  const YGRect frame = {
+    .x = left,
+    .y = top,
+    .width = node->layout.dimensions[YGDimensionWidth],
+    .height = node->layout.dimensions[YGDimensionHeight],
+  };
+  if (frame.x < rect.x + rect.width && rect.x < frame.x + frame.width &&
+      frame.y < rect.y + rect.height && rect.y < frame.y + frame.height) {
+    callback(node, frame, data);
+  }
+
+  uint32_t firstChild = 0;
+  uint32_t endChild = YGNodeListCount(node->children);
+  if (node->extras->virtualized != NULL) {
+    firstChild = node->extras->virtualized->firstVisible;
+    if (node->extras->virtualized->endVisible < endChild) {
+      endChild = node->extras->virtualized->endVisible;
+    }
+  }
+  for (uint32_t i = firstChild; i < endChild; i++) {
+    const YGNodeRef child = YGNodeListGet(node->children, i);
+    if (child->style.display == YGDisplayNone) {
+      continue;
+    }
+    YGNodeQueryRectInternal(child,
+                            left + child->layout.position[YGEdgeLeft],
+                            top + child->layout.position[YGEdgeTop],
+                            rect,
+                            callback,
+                            data);
+  }
+}
+
+void YGNodeQueryRect(const YGNodeRef root,
+                     const YGRect rect,
+                     YGQueryRectFunc callback,
+                     void *data) {
+  YGNodeEnsureLayout(root);
+  YGNodeUpdateBounds(root);
+  YGNodeQueryRectInternal(root, 0, 0, rect, callback, data);
+}
+
+static void YGNodeExportFramesInternal(const YGNodeRef node,
+                                       const YGFloat left,
+                                       const YGFloat top,
+                                       YGFrameRecord *const out,
+                                       const uint32_t capacity,
+                                       uint32_t *const count) {
+  if (*count < capacity) {
+    YGFrameRecord *const record = &out[*count];
+    record->context = node->context;
+    record->x = left;
+    record->y = top;
+    record->width = node->layout.dimensions[YGDimensionWidth];
+    record->height = node->layout.dimensions[YGDimensionHeight];
+  }
+  (*count)++;
+
+  // Children of a virtualized container outside the last window were not laid out.
+  uint32_t firstChild = 0;
+  uint32_t endChild = YGNodeListCount(node->children);
+  if (node->extras->virtualized != NULL) {
+    firstChild = node->extras->virtualized->firstVisible;
+    if (node->extras->virtualized->endVisible < endChild) {
+      endChild = node->extras->virtualized->endVisible;
+    }
+  }
+  for (uint32_t i = firstChild; i < endChild; i++) {
+    const YGNodeRef child = YGNodeListGet(node->children, i);
+    YGNodeExportFramesInternal(child,
+                               left + child->layout.position[YGEdgeLeft],
+                               top + child->layout.position[YGEdgeTop],
+                               out,
+                               capacity,
+                               count);
+  }
+}
+
+uint32_t YGNodeExportFrames(const YGNodeRef root, YGFrameRecord *out, const uint32_t capacity) {
+  YGNodeEnsureLayout(root);
+
+  uint32_t count = 0;
+  YGNodeExportFramesInternal(root,
+                             root->layout.position[YGEdgeLeft],
+                             root->layout.position[YGEdgeTop],
+                             out,
+                             capacity,
+                             &count);
+  return count;
+}
+
+// Growing buffer holding the delta stream produced by the last YGNodeEmitFrameDelta call.
+typedef struct YGFrameDeltaBuffer {
+  size_t capacity;
+  size_t length;
+  uint8_t *bytes;
+} YGFrameDeltaBuffer;
+
+static YG_THREAD_LOCAL YGFrameDeltaBuffer gFrameDelta = {
+  .capacity = 0, .length = 0, .bytes = NULL,
+};
+
+// The buffers above stay allocated for the next layout or delta on their thread and are freed
+// once it exits. Threads ending without pthread keys running, like the main one, keep them.
+#ifndef _MSC_VER
+static pthread_key_t gThreadBuffersKey;
+static pthread_once_t gThreadBuffersOnce = PTHREAD_ONCE_INIT;
+static YG_THREAD_LOCAL bool gThreadBuffersRegistered = false;
+
+static void YGThreadBuffersFree(void *unused) {
+  (void) unused;
+  gYGFree(gMeasureBatch.requests);
+  gYGFree(gMeasureBatch.sizes);
+  gMeasureBatch.requests = NULL;
+  gMeasureBatch.sizes = NULL;
+  gMeasureBatch.capacity = 0;
+  gYGFree(gFrameDelta.bytes);
+  gFrameDelta.bytes = NULL;
+  gFrameDelta.capacity = 0;
+  gThreadBuffersRegistered = false;
+}
+
+static void YGThreadBuffersCreateKey(void) {
+  const int error = pthread_key_create(&gThreadBuffersKey, YGThreadBuffersFree);
+  YG_ASSERT(error == 0, "Could not create the key freeing thread buffers");
+}
+#endif
+
+static void YGThreadBuffersRegister(void) {
+#ifndef _MSC_VER
+  if (!gThreadBuffersRegistered) {
+    gThreadBuffersRegistered = true;
+    pthread_once(&gThreadBuffersOnce, YGThreadBuffersCreateKey);
+    // Destructors only run for keys holding a value.
+    pthread_setspecific(gThreadBuffersKey, &gThreadBuffersRegistered);
+  }
+#endif
+}
+
+static void YGFrameDeltaWrite(const void *bytes, const size_t size) {
+  if (gFrameDelta.length + size > gFrameDelta.capacity) {
+    size_t capacity = gFrameDelta.capacity == 0 ? 256 : gFrameDelta.capacity;
+    while (gFrameDelta.length + size > capacity) {
+      capacity *= 2;
+    }
+    YGThreadBuffersRegister();
+    gFrameDelta.bytes = gYGRealloc(gFrameDelta.bytes, capacity);
+    YG_ASSERT(gFrameDelta.bytes != NULL, "Could not extend allocation for frame delta");
+    gFrameDelta.capacity = capacity;
+  }
+  memcpy(gFrameDelta.bytes + gFrameDelta.length, bytes, size);
+  gFrameDelta.length += size;
+}
+
+static void YGNodeEmitFrameDeltaInternal(const YGNodeRef node,
+                                         const YGFloat left,
+                                         const YGFloat top,
+                                         uint32_t *const index) {
+  YGNodeExtras *const extras = YGNodeGetExtras(node);
+  const uint32_t nodeIndex = (*index)++;
+  const bool moved = extras->committedIndex != nodeIndex;
+
+  // Layout only writes to nodes it visits and it always visits them top-down, so a node that
+  // was not laid out since and kept its place and origin has an unchanged subtree.
+  if (!moved && !extras->frameChanged && !node->isDirty && extras->committedSubtreeCount != 0 &&
+      YGFloatsEqual(extras->committedFrame[0], left) &&
+      YGFloatsEqual(extras->committedFrame[1], top)) {
+    *index = nodeIndex + extras->committedSubtreeCount;
+    return;
+  }
+
+  const YGFloat *const dimensions = node->layout.dimensions;
+  const YGFloat frame[4] = {
+    left, top, dimensions[YGDimensionWidth], dimensions[YGDimensionHeight],
+  };
+  uint8_t fields = moved ? YGFrameDeltaFieldContext : 0;
+  for (uint32_t i = 0; i < 4; i++) {
+    if (moved || !YGFloatsEqual(extras->committedFrame[i], frame[i])) {
+      fields |= YGFrameDeltaFieldX << i;
+      extras->committedFrame[i] = frame[i];
+    }
+  }
+
+  if (fields != 0) {
+    YGFrameDeltaWrite(&nodeIndex, sizeof(uint32_t));
+    YGFrameDeltaWrite(&fields, sizeof(uint8_t));
+    if (fields & YGFrameDeltaFieldContext) {
+      YGFrameDeltaWrite(&node->context, sizeof(void *));
+    }
+    for (uint32_t i = 0; i < 4; i++) {
+      if (fields & (YGFrameDeltaFieldX << i)) {
+        const float value = frame[i];
+        YGFrameDeltaWrite(&value, sizeof(float));
+      }
+    }
+  }
+  extras->committedIndex = nodeIndex;
+  extras->frameChanged = false;
+
+  // Below a node that kept its place and origin and none of whose children was laid out since,
+  // such as a container served from its cache, the frames are unchanged too.
+  if (!moved && !extras->childFrameChanged && extras->committedSubtreeCount != 0 &&
+      extras->virtualized == NULL && (fields & (YGFrameDeltaFieldX | YGFrameDeltaFieldY)) == 0) {
+    *index = nodeIndex + extras->committedSubtreeCount;
+    return;
+  }
+  extras->childFrameChanged = false;
+
+  // Children of a virtualized container outside the last window were not laid out.
+  uint32_t firstChild = 0;
+  uint32_t endChild = YGNodeListCount(node->children);
+  if (node->extras->virtualized != NULL) {
+    firstChild = node->extras->virtualized->firstVisible;
+    if (node->extras->virtualized->endVisible < endChild) {
+      endChild = node->extras->virtualized->endVisible;
+    }
+  }
+  for (uint32_t i = firstChild; i < endChild; i++) {
+    const YGNodeRef child = YGNodeListGet(node->children, i);
+    YGNodeEmitFrameDeltaInternal(child,
+                                 left + child->layout.position[YGEdgeLeft],
+                                 top + child->layout.position[YGEdgeTop],
+                                 index);
+  }
+  extras->committedSubtreeCount = *index - nodeIndex;
+}
+
+const uint8_t *YGNodeEmitFrameDelta(const YGNodeRef root, size_t *length) {
+  YGNodeEnsureLayout(root);
+
+  // Reserve the header, the node count is only known after the walk.
+  uint32_t count = 0;
+  gFrameDelta.length = 0;
+  YGFrameDeltaWrite(&count, sizeof(uint32_t));
+
+  YGNodeEmitFrameDeltaInternal(root,
+                               root->layout.position[YGEdgeLeft],
+                               root->layout.position[YGEdgeTop],
+                               &count);
+  memcpy(gFrameDelta.bytes, &count, sizeof(uint32_t));
+
+  *length = gFrameDelta.length;
+  return gFrameDelta.bytes;
+}
+
+uint32_t YGFrameDeltaApply(const uint8_t *delta,
+                           const size_t length,
+                           YGFrameRecord *mirror,
+                           const uint32_t capacity) {
+  const uint8_t *const end = delta + length;
+  uint32_t count;
+  memcpy(&count, delta, sizeof(uint32_t));
+  delta += sizeof(uint32_t);
+
+  while (delta < end) {
+    uint32_t index;
+    uint8_t fields;
+    memcpy(&index, delta, sizeof(uint32_t));
+    memcpy(&fields, delta + sizeof(uint32_t), sizeof(uint8_t));
+    delta += sizeof(uint32_t) + sizeof(uint8_t);
+
+    YGFrameRecord *const record = index < capacity ? &mirror[index] : NULL;
+    if (fields & YGFrameDeltaFieldContext) {
+      if (record) {
+        memcpy(&record->context, delta, sizeof(void *));
+      }
+      delta += sizeof(void *);
+    }
+    float *const values[4] = {
+      record ? &record->x : NULL,
+      record ? &record->y : NULL,
+      record ? &record->width : NULL,
+      record ? &record->height : NULL,
+    };
+    for (uint32_t i = 0; i < 4; i++) {
+      if (fields & (YGFrameDeltaFieldX << i)) {
+        if (record) {
+          memcpy(values[i], delta, sizeof(float));
+        }
+        delta += sizeof(float);
       }
     }
+  }
+  return count;
+}
 
-    float remainingFreeSpace = 0;
-    if (!YGFloatIsUndefined(availableInnerMainDim)) {
-      remainingFreeSpace = availableInnerMainDim - sizeConsumedOnCurrentLine;
-    } else if (sizeConsumedOnCurrentLine < 0) {
-      // availableInnerMainDim is indefinite which means the node is being sized
-      // based on its
-      // content.
-      // sizeConsumedOnCurrentLine is negative which means the node will
-      // allocate 0 points for
-      // its content. Consequently, remainingFreeSpace is 0 -
-      // sizeConsumedOnCurrentLine.
-      remainingFreeSpace = -sizeConsumedOnCurrentLine;
+// Solves a CSS cubic-bezier timing function with end points (0, 0) and (1, 1) for progress x.
+static float YGCubicBezier(const float x1, const float y1, const float x2, const float y2, const float x) {
+  const float cx = 3 * x1;
+  const float bx = 3 * (x2 - x1) - cx;
+  const float ax = 1 - cx - bx;
+  const float cy = 3 * y1;
+  const float by = 3 * (y2 - y1) - cy;
+  const float ay = 1 - cy - by;
+
+  // Newton's method on x(t) = x, falling back to bisection where the slope vanishes.
+  float t = x;
+  for (uint32_t i = 0; i < 8; i++) {
+    const float error = ((ax * t + bx) * t + cx) * t - x;
+    if (fabsf(error) < 1e-6f) {
+      return ((ay * t + by) * t + cy) * t;
+    }
+    const float slope = (3 * ax * t + 2 * bx) * t + cx;
+    if (fabsf(slope) < 1e-6f) {
+      break;
     }
+    t -= error / slope;
+  }
 
-    const float originalRemainingFreeSpace = remainingFreeSpace;
-    float deltaFreeSpace = 0;
+  float low = 0;
+  float high = 1;
+  t = x;
+  for (uint32_t i = 0; i < 32 && high - low > 1e-6f; i++) {
+    const float value = ((ax * t + bx) * t + cx) * t;
+    if (value < x) {
+      low = t;
+    } else {
+      high = t;
+    }
+    t = (low + high) / 2;
+  }
+  return ((ay * t + by) * t + cy) * t;
+}
 
-    if (!canSkipFlex) {
-      float childFlexBasis;
-      float flexShrinkScaledFactor;
-      float flexGrowFactor;
-      float baseMainSize;
-      float boundMainSize;
+static float YGEasingApply(const YGEasing easing, const float progress) {
+  switch (easing) {
+    case YGEasingLinear:
+      return progress;
+    case YGEasingEase:
+      return YGCubicBezier(0.25f, 0.1f, 0.25f, 1.0f, progress);
+    case YGEasingEaseIn:
+      return YGCubicBezier(0.42f, 0.0f, 1.0f, 1.0f, progress);
+    case YGEasingEaseOut:
+      return YGCubicBezier(0.0f, 0.0f, 0.58f, 1.0f, progress);
+    case YGEasingEaseInOut:
+      return YGCubicBezier(0.42f, 0.0f, 0.58f, 1.0f, progress);
+  }
+  return progress;
+}
 
-      // Do two passes over the flex items to figure out how to distribute the
-      // remaining space.
-      // The first pass finds the items whose min/max constraints trigger,
-      // freezes them at those
-      // sizes, and excludes those sizes from the remaining space. The second
-      // pass sets the size
-      // of each flexible item. It distributes the remaining space amongst the
-      // items whose min/max
-      // constraints didn't trigger in pass 1. For the other items, it sets
-      // their sizes by forcing
-      // their min/max constraints to trigger again.
-      //
-      // This two pass approach for resolving min/max constraints deviates from
-      // the spec. The
-      // spec (https://www.w3.org/TR/YG-flexbox-1/#resolve-flexible-lengths)
-      // describes a process
-      // that needs to be repeated a variable number of times. The algorithm
-      // implemented here
-      // won't handle all cases but it was simpler to implement and it mitigates
-      // performance
-      // concerns because we know exactly how many passes it'll do.
+void YGFrameInterpolate(const YGFrameRecord *from,
+                        const YGFrameRecord *to,
+                        const uint32_t count,
+                        const YGEasing easing,
+                        const uint32_t frameCount,
+                        YGFrameRecord *out) {
+  for (uint32_t frame = 0; frame < frameCount; frame++) {
+    // The easing curve is evaluated once per frame, the per-node kernel is a branch-free
+    // multiply-add over the four contiguous floats of each record, which compilers vectorize.
+    const float t = YGEasingApply(easing, (float) (frame + 1) / (float) (frameCount + 1));
+    YGFrameRecord *const records = out + (size_t) frame * count;
+    for (uint32_t i = 0; i < count; i++) {
+      records[i].context = to[i].context;
+      records[i].x = from[i].x + (to[i].x - from[i].x) * t;
+      records[i].y = from[i].y + (to[i].y - from[i].y) * t;
+      records[i].width = from[i].width + (to[i].width - from[i].width) * t;
+      records[i].height = from[i].height + (to[i].height - from[i].height) * t;
+    }
+  }
+}
 
-      // First pass: detect the flex items whose min/max constraints trigger
-      float deltaFlexShrinkScaledFactors = 0;
-      float deltaFlexGrowFactors = 0;
-      currentRelativeChild = firstRelativeChild;
-      while (currentRelativeChild != NULL) {
-        childFlexBasis = currentRelativeChild->layout.computedFlexBasis;
+// Everything a layout pass writes to a node, so YGNodeCalculateLayoutMulti can put the primary
+// layout back.
+typedef struct YGLayoutSnapshot {
+  YGLayout layout;
+  YGFloat unroundedPosition[2];
+  bool isDirty;
+  bool hasDirtyDescendant;
+  bool hasNewLayout;
+  bool layoutDeferred;
+  uint32_t firstVisible;
+  uint32_t endVisible;
+} YGLayoutSnapshot;
 
-        if (remainingFreeSpace < 0) {
-          flexShrinkScaledFactor = -YGNodeStyleGetFlexShrink(currentRelativeChild) * childFlexBasis;
+static uint32_t YGNodeCountRecursive(const YGNodeRef node) {
+  uint32_t count = 1;
+  const uint32_t childCount = YGNodeListCount(node->children);
+  for (uint32_t i = 0; i < childCount; i++) {
+    count += YGNodeCountRecursive(YGNodeListGet(node->children, i));
+  }
+  return count;
+}
 
-          // Is this child able to shrink?
-          if (flexShrinkScaledFactor != 0) {
-            baseMainSize =
-            childFlexBasis +
-            remainingFreeSpace / totalFlexShrinkScaledFactors * flexShrinkScaledFactor;
-            boundMainSize = YGNodeBoundAxis(currentRelativeChild,
-                                            mainAxis,
-                                            baseMainSize,
-                                            availableInnerMainDim,
-                                            availableInnerWidth);
-            if (baseMainSize != boundMainSize) {
-              // By excluding this item's size and flex factor from remaining,
-              // this item's
-              // min/max constraints should also trigger in the second pass
-              // resulting in the
-              // item's size calculation being identical in the first and second
-              // passes.
-              deltaFreeSpace -= boundMainSize - childFlexBasis;
-              deltaFlexShrinkScaledFactors -= flexShrinkScaledFactor;
-            }
-          }
-        } else if (remainingFreeSpace > 0) {
-          flexGrowFactor = YGNodeStyleGetFlexGrow(currentRelativeChild);
+static void YGNodeSaveLayout(const YGNodeRef node, YGLayoutSnapshot *const snapshot) {
+  snapshot->layout = node->layout;
+  snapshot->unroundedPosition[0] = YGNodeGetUnroundedPosition(node, 0);
+  snapshot->unroundedPosition[1] = YGNodeGetUnroundedPosition(node, 1);
+  snapshot->isDirty = node->isDirty;
+  snapshot->hasDirtyDescendant = node->hasDirtyDescendant;
+  snapshot->hasNewLayout = node->hasNewLayout;
+  snapshot->layoutDeferred = node->extras->layoutDeferred;
+  if (node->extras->virtualized != NULL) {
+    snapshot->firstVisible = node->extras->virtualized->firstVisible;
+    snapshot->endVisible = node->extras->virtualized->endVisible;
+  }
+}
 
-          // Is this child able to grow?
-          if (flexGrowFactor != 0) {
-            baseMainSize =
-            childFlexBasis + remainingFreeSpace / totalFlexGrowFactors * flexGrowFactor;
-            boundMainSize = YGNodeBoundAxis(currentRelativeChild,
-                                            mainAxis,
-                                            baseMainSize,
-                                            availableInnerMainDim,
-                                            availableInnerWidth);
-            if (baseMainSize != boundMainSize) {
-              // By excluding this item's size and flex factor from remaining,
-              // this item's
-              // min/max constraints should also trigger in the second pass
-              // resulting in the
-              // item's size calculation being identical in the first and second
-              // passes.
-              deltaFreeSpace -= boundMainSize - childFlexBasis;
-              deltaFlexGrowFactors -= flexGrowFactor;
-            }
-          }
-        }
+static void YGNodeSaveLayoutRecursive(const YGNodeRef node,
+                                      YGLayoutSnapshot *const snapshots,
+                                      uint32_t *const index) {
+  YGNodeSaveLayout(node, &snapshots[(*index)++]);
 
-        currentRelativeChild = currentRelativeChild->nextChild;
-      }
+  const uint32_t childCount = YGNodeListCount(node->children);
+  for (uint32_t i = 0; i < childCount; i++) {
+    YGNodeSaveLayoutRecursive(YGNodeListGet(node->children, i), snapshots, index);
+  }
+}
 
-      totalFlexShrinkScaledFactors += deltaFlexShrinkScaledFactors;
-      totalFlexGrowFactors += deltaFlexGrowFactors;
-      remainingFreeSpace += deltaFreeSpace;
+// With keepCaches the measurements taken since the snapshot stay. Nodes that were dirty also keep
+// what the passes laid them out with, their frames alone are put back: the next layout finds
+// their caches warm instead of clearing them.
+static void YGNodeRestoreLayout(const YGNodeRef node,
+                                const YGLayoutSnapshot *const snapshot,
+                                const bool keepCaches) {
+  if (keepCaches) {
+    YGLayout *const layout = &node->layout;
+    const YGCachedMeasurement cachedLayout = layout->cachedLayout;
+    const YGDirection lastParentDirection = layout->lastParentDirection;
+    YGCachedMeasurement cachedMeasurements[YG_MAX_CACHED_RESULT_COUNT];
+    memcpy(cachedMeasurements, layout->cachedMeasurements, sizeof(cachedMeasurements));
+    const uint32_t nextCachedMeasurementsIndex = layout->nextCachedMeasurementsIndex;
+
+    *layout = snapshot->layout;
+    memcpy(layout->cachedMeasurements, cachedMeasurements, sizeof(cachedMeasurements));
+    layout->nextCachedMeasurementsIndex = nextCachedMeasurementsIndex;
+    // The cached layout vouches for the frames, which are put back, so the one of the last pass
+    // is kept as a measurement.
+    if (cachedLayout.widthMeasureMode != (YGMeasureMode) -1 &&
+        layout->nextCachedMeasurementsIndex < YG_MAX_CACHED_RESULT_COUNT) {
+      layout->cachedMeasurements[layout->nextCachedMeasurementsIndex++] = cachedLayout;
+    }
+    if (snapshot->isDirty) {
+      node->cachesWarm = true;
+      layout->lastParentDirection = lastParentDirection;
+      layout->cachedLayout.widthMeasureMode = (YGMeasureMode) -1;
+      layout->cachedLayout.heightMeasureMode = (YGMeasureMode) -1;
+    }
+  } else {
+    node->layout = snapshot->layout;
+  }
+  YGNodeSetUnroundedPosition(node, snapshot->unroundedPosition[0], snapshot->unroundedPosition[1]);
+  YGNodeInvalidateBounds(node);
+  // What YGNodeEmitFrameDelta last reported stays, the frames put back are reported again.
+  YGNodeMarkFrameChanged(node);
+  node->isDirty = snapshot->isDirty;
+  node->hasDirtyDescendant = snapshot->hasDirtyDescendant;
+  node->hasNewLayout = snapshot->hasNewLayout;
+  if (node->extras->layoutDeferred != snapshot->layoutDeferred) {
+    YGNodeGetExtras(node)->layoutDeferred = snapshot->layoutDeferred;
+    if (snapshot->layoutDeferred) {
+      gDeferredLayoutCount++;
+    } else {
+      gDeferredLayoutCount--;
+    }
+  }
+  if (node->extras->virtualized != NULL) {
+    node->extras->virtualized->firstVisible = snapshot->firstVisible;
+    node->extras->virtualized->endVisible = snapshot->endVisible;
+    // Streaming containers were last laid out with other constraints.
+    node->extras->virtualized->needsRebuild |= node->extras->virtualized->streaming;
+  }
+}
 
-      // Second pass: resolve the sizes of the flexible items
-      deltaFreeSpace = 0;
-      currentRelativeChild = firstRelativeChild;
-      while (currentRelativeChild != NULL) {
-        childFlexBasis = currentRelativeChild->layout.computedFlexBasis;
-        float updatedMainSize = childFlexBasis;
+static void YGNodeRestoreLayoutRecursive(const YGNodeRef node,
+                                         const YGLayoutSnapshot *const snapshots,
+                                         uint32_t *const index,
+                                         const bool keepCaches) {
+  YGNodeRestoreLayout(node, &snapshots[(*index)++], keepCaches);
 
-        if (remainingFreeSpace < 0) {
-          flexShrinkScaledFactor = -YGNodeStyleGetFlexShrink(currentRelativeChild) * childFlexBasis;
-          // Is this child able to shrink?
-          if (flexShrinkScaledFactor != 0) {
-            float childSize;
+  const uint32_t childCount = YGNodeListCount(node->children);
+  for (uint32_t i = 0; i < childCount; i++) {
+    YGNodeRestoreLayoutRecursive(YGNodeListGet(node->children, i), snapshots, index, keepCaches);
+  }
+}
 
-            if (totalFlexShrinkScaledFactors == 0) {
-              childSize = childFlexBasis + flexShrinkScaledFactor;
-            } else {
-              childSize =
-              childFlexBasis +
-              (remainingFreeSpace / totalFlexShrinkScaledFactors) * flexShrinkScaledFactor;
-            }
+// Exchanges the layout caches of the subtree with those in the array, in depth-first order.
+static void YGNodeSwapLayoutCachesRecursive(const YGNodeRef node,
+                                            YGLayoutCacheRef *const caches,
+                                            uint32_t *const index) {
+  const YGLayoutCacheRef cache = node->layoutCache;
+  node->layoutCache = caches[*index];
+  caches[(*index)++] = cache;
 
-            updatedMainSize = YGNodeBoundAxis(currentRelativeChild,
-                                              mainAxis,
-                                              childSize,
-                                              availableInnerMainDim,
-                                              availableInnerWidth);
-          }
-        } else if (remainingFreeSpace > 0) {
-          flexGrowFactor = YGNodeStyleGetFlexGrow(currentRelativeChild);
+  const uint32_t childCount = YGNodeListCount(node->children);
+  for (uint32_t i = 0; i < childCount; i++) {
+    YGNodeSwapLayoutCachesRecursive(YGNodeListGet(node->children, i), caches, index);
+  }
+}
 
-          // Is this child able to grow?
-          if (flexGrowFactor != 0) {
-            updatedMainSize =
-            YGNodeBoundAxis(currentRelativeChild,
-                            mainAxis,
-                            childFlexBasis +
-                            remainingFreeSpace / totalFlexGrowFactors * flexGrowFactor,
-                            availableInnerMainDim,
-                            availableInnerWidth);
-          }
-        }
+void YGNodeCalculateLayoutMulti(const YGNodeRef root,
+                                const YGSize *sizes,
+                                const uint32_t count,
+                                const YGDirection parentDirection,
+                                YGLayoutResultBuffer *outs) {
+  const uint32_t nodeCount = YGNodeCountRecursive(root);
+  YGLayoutSnapshot *const snapshots = gYGMalloc(sizeof(YGLayoutSnapshot) * nodeCount);
+  YG_ASSERT(snapshots, "Could not allocate memory for layout snapshots");
+
+  // The containers' layout caches are set aside for the passes. Entries the passes would add
+  // replay children with the constraints of one of the sizes, while the children get the layout
+  // of the snapshot back, so they cannot stay.
+  YGLayoutCacheRef *const layoutCaches = gYGCalloc(nodeCount, sizeof(YGLayoutCacheRef));
+  YG_ASSERT(layoutCaches, "Could not allocate memory for layout caches");
+
+  uint32_t index = 0;
+  YGNodeSaveLayoutRecursive(root, snapshots, &index);
+  index = 0;
+  YGNodeSwapLayoutCachesRecursive(root, layoutCaches, &index);
+
+  // The passes run back to back on the same nodes so the measurement caches filled by one size
+  // serve the next ones. Windows of virtual children are pinned so the snapshots keep covering
+  // the same nodes.
+  gVirtualWindowsPinned = true;
+  for (uint32_t i = 0; i < count; i++) {
+    YGNodeCalculateLayout(root, sizes[i].width, sizes[i].height, parentDirection);
+    outs[i].count = YGNodeExportFrames(root, outs[i].frames, outs[i].capacity);
+  }
+  gVirtualWindowsPinned = false;
+
+  index = 0;
+  YGNodeRestoreLayoutRecursive(root, snapshots, &index, false);
+  index = 0;
+  YGNodeSwapLayoutCachesRecursive(root, layoutCaches, &index);
+  for (uint32_t i = 0; i < nodeCount; i++) {
+    YGLayoutCacheFree(layoutCaches[i]);
+  }
+  gYGFree(layoutCaches);
+  gYGFree(snapshots);
+}
 
-        deltaFreeSpace -= updatedMainSize - childFlexBasis;
-
-        const float marginMain =
-        YGNodeMarginForAxis(currentRelativeChild, mainAxis, availableInnerWidth);
-        const float marginCross =
-        YGNodeMarginForAxis(currentRelativeChild, crossAxis, availableInnerWidth);
-
-        float childCrossSize;
-        float childMainSize = updatedMainSize + marginMain;
-        YGMeasureMode childCrossMeasureMode;
-        YGMeasureMode childMainMeasureMode = YGMeasureModeExactly;
-
-        if (!YGFloatIsUndefined(availableInnerCrossDim) &&
-            !YGNodeIsStyleDimDefined(currentRelativeChild, crossAxis, availableInnerCrossDim) &&
-            measureModeCrossDim == YGMeasureModeExactly &&
-            !(isNodeFlexWrap && flexBasisOverflows) &&
-            YGNodeAlignItem(node, currentRelativeChild) == YGAlignStretch) {
-          childCrossSize = availableInnerCrossDim;
-          childCrossMeasureMode = YGMeasureModeExactly;
-        } else if (!YGNodeIsStyleDimDefined(currentRelativeChild,
-                                            crossAxis,
-                                            availableInnerCrossDim)) {
-          childCrossSize = availableInnerCrossDim;
-          childCrossMeasureMode =
-          YGFloatIsUndefined(childCrossSize) ? YGMeasureModeUndefined : YGMeasureModeAtMost;
-        } else {
-          childCrossSize = YGValueResolve(currentRelativeChild->resolvedDimensions[dim[crossAxis]],
-                                          availableInnerCrossDim) +
-          marginCross;
-          childCrossMeasureMode =
-          YGFloatIsUndefined(childCrossSize) ? YGMeasureModeUndefined : YGMeasureModeExactly;
-        }
+uint32_t YGNodeWarmup(const YGNodeRef root,
+                      const YGSize *anticipatedSizes,
+                      const uint32_t count,
+                      const uint32_t budgetMicros) {
+  if (count == 0) {
+    return 0;
+  }
 
-        if (!YGFloatIsUndefined(currentRelativeChild->style.aspectRatio)) {
-          childCrossSize = fmaxf(
-                                 isMainAxisRow
-                                 ? (childMainSize - marginMain) / currentRelativeChild->style.aspectRatio
-                                 : (childMainSize - marginMain) * currentRelativeChild->style.aspectRatio,
-                                 YGNodePaddingAndBorderForAxis(currentRelativeChild, crossAxis, availableInnerWidth));
-          childCrossMeasureMode = YGMeasureModeExactly;
-
-          // Parent size constraint should have higher priority than flex
-          if (YGNodeIsFlex(currentRelativeChild)) {
-            childCrossSize = fminf(childCrossSize - marginCross, availableInnerCrossDim);
-            childMainSize =
-            marginMain + (isMainAxisRow
-                          ? childCrossSize * currentRelativeChild->style.aspectRatio
-                          : childCrossSize / currentRelativeChild->style.aspectRatio);
-          }
+  const uint64_t deadline = YGMonotonicMicros() + budgetMicros;
+  const uint32_t nodeCount = YGNodeCountRecursive(root);
+  YGLayoutSnapshot *const snapshots = gYGMalloc(sizeof(YGLayoutSnapshot) * nodeCount);
+  YG_ASSERT(snapshots, "Could not allocate memory for layout snapshots");
+
+  uint32_t index = 0;
+  YGNodeSaveLayoutRecursive(root, snapshots, &index);
+
+  // Full passes rather than measurements, as only those fill the containers' layout caches. The
+  // direction of the last layout is kept so the caches stay valid for the next one.
+  const YGDirection parentDirection = root->layout.lastParentDirection == (YGDirection) -1
+                                          ? root->style.direction
+                                          : root->layout.lastParentDirection;
+  uint32_t warmed = 0;
+  gVirtualWindowsPinned = true;
+  do {
+    YGNodeCalculateLayout(root,
+                          anticipatedSizes[warmed].width,
+                          anticipatedSizes[warmed].height,
+                          parentDirection);
+    warmed++;
+  } while (warmed < count && YGMonotonicMicros() < deadline);
+  gVirtualWindowsPinned = false;
+
+  index = 0;
+  YGNodeRestoreLayoutRecursive(root, snapshots, &index, true);
+  gYGFree(snapshots);
+  // A root served from its caches would not be positioned, so a dirty one is laid out again.
+  root->cachesWarm = false;
+  return warmed;
+}
 
-          childCrossSize += marginCross;
-        }
+typedef struct YGSpeculativeLayout {
+  YGNodeRef root;
+  YGNodeRef clone;
+  // The live nodes in depth-first order with their clones, and their revisions and child counts
+  // when cloned.
+  uint32_t nodeCount;
+  YGNodeRef *nodes;
+  YGNodeRef *clones;
+  uint32_t *revisions;
+  uint32_t *childCounts;
+} YGSpeculativeLayout;
+
+static bool YGNodeCanSpeculate(const YGNodeRef node) {
+  if (node->extras->virtualized != NULL || node->extras->layoutDeferred) {
+    return false;
+  }
+  const uint32_t childCount = YGNodeListCount(node->children);
+  for (uint32_t i = 0; i < childCount; i++) {
+    if (!YGNodeCanSpeculate(YGNodeListGet(node->children, i))) {
+      return false;
+    }
+  }
+  return true;
+}
 
-        YGConstrainMaxSizeForMode(
-                                  YGValueResolve(&currentRelativeChild->style.maxDimensions[dim[mainAxis]],
-                                                 availableInnerWidth),
-                                  &childMainMeasureMode,
-                                  &childMainSize);
-        YGConstrainMaxSizeForMode(
-                                  YGValueResolve(&currentRelativeChild->style.maxDimensions[dim[crossAxis]],
-                                                 availableInnerHeight),
-                                  &childCrossMeasureMode,
-                                  &childCrossSize);
-
-        const bool requiresStretchLayout =
-        !YGNodeIsStyleDimDefined(currentRelativeChild, crossAxis, availableInnerCrossDim) &&
-        YGNodeAlignItem(node, currentRelativeChild) == YGAlignStretch;
-
-        const float childWidth = isMainAxisRow ? childMainSize : childCrossSize;
-        const float childHeight = !isMainAxisRow ? childMainSize : childCrossSize;
-
-        const YGMeasureMode childWidthMeasureMode =
-        isMainAxisRow ? childMainMeasureMode : childCrossMeasureMode;
-        const YGMeasureMode childHeightMeasureMode =
-        !isMainAxisRow ? childMainMeasureMode : childCrossMeasureMode;
-
-        // Recursively call the layout algorithm for this child with the updated
-        // main size.
-        YGLayoutNodeInternal(currentRelativeChild,
-                             childWidth,
-                             childHeight,
-                             direction,
-                             childWidthMeasureMode,
-                             childHeightMeasureMode,
-                             availableInnerWidth,
-                             availableInnerHeight,
-                             performLayout && !requiresStretchLayout,
-                             "flex");
+// Copies the node with its style, layout and measurement caches. Contexts and functions are
+// shared with the original, the layout caches of containers and the extras are not.
+static YGNodeRef YGNodeCloneRecursive(const YGNodeRef node,
+                                      YGSpeculativeLayout *const speculation,
+                                      uint32_t *const index) {
+  const YGNodeRef clone = YGNodeNew();
+  speculation->nodes[*index] = node;
+  speculation->clones[*index] = clone;
+  speculation->revisions[*index] = node->revision;
+  speculation->childCounts[*index] = YGNodeListCount(node->children);
+  (*index)++;
+
+  memcpy(clone, node, sizeof(YGNode));
+  clone->extras = (YGNodeExtras *) &gYGNodeExtrasDefaults;
+  if (YGNodeHasExtras(node)) {
+    *YGNodeGetExtras(clone) = *node->extras;
+  }
+  clone->parent = NULL;
+  clone->children = NULL;
+  clone->layoutCache = NULL;
+  clone->layoutProgram = NULL;
+  clone->nextChild = NULL;
+  YGResolveDimensions(clone);
 
-        currentRelativeChild = currentRelativeChild->nextChild;
-      }
-    }
+  const uint32_t childCount = YGNodeListCount(node->children);
+  for (uint32_t i = 0; i < childCount; i++) {
+    const YGNodeRef child = YGNodeCloneRecursive(YGNodeListGet(node->children, i), speculation, index);
+    YGNodeListAdd(&clone->children, child);
+    child->parent = clone;
+  }
+  return clone;
+}
 
-    remainingFreeSpace = originalRemainingFreeSpace + deltaFreeSpace;
+YGSpeculativeLayoutRef YGSpeculativeLayoutBegin(const YGNodeRef root) {
+  if (!YGNodeCanSpeculate(root)) {
+    return NULL;
+  }
 
-    // STEP 6: MAIN-AXIS JUSTIFICATION & CROSS-AXIS SIZE DETERMINATION
+  YGSpeculativeLayout *const speculation = gYGMalloc(sizeof(YGSpeculativeLayout));
+  YG_ASSERT(speculation, "Could not allocate memory for speculative layout");
+  speculation->root = root;
+  speculation->nodeCount = YGNodeCountRecursive(root);
+  speculation->nodes = gYGMalloc(sizeof(YGNodeRef) * speculation->nodeCount);
+  speculation->clones = gYGMalloc(sizeof(YGNodeRef) * speculation->nodeCount);
+  speculation->revisions = gYGMalloc(sizeof(uint32_t) * speculation->nodeCount);
+  speculation->childCounts = gYGMalloc(sizeof(uint32_t) * speculation->nodeCount);
+  YG_ASSERT(speculation->nodes && speculation->clones && speculation->revisions &&
+                speculation->childCounts,
+            "Could not allocate memory for speculative layout");
+
+  uint32_t index = 0;
+  speculation->clone = YGNodeCloneRecursive(root, speculation, &index);
+  return speculation;
+}
 
-    // At this point, all the children have their dimensions set in the main
-    // axis.
-    // Their dimensions are also set in the cross axis with the exception of
-    // items
-    // that are aligned "stretch". We need to compute these stretch values and
-    // set the final positions.
+YGNodeRef YGSpeculativeLayoutGetNode(const YGSpeculativeLayoutRef speculation,
+                                     const YGNodeRef node) {
+  for (uint32_t i = 0; i < speculation->nodeCount; i++) {
+    if (speculation->nodes[i] == node) {
+      return speculation->clones[i];
+    }
+  }
+  return NULL;
+}
 
-    // If we are using "at most" rules in the main axis. Calculate the remaining space when
-    // constraint by the min size defined for the main axis.
+void YGSpeculativeLayoutCalculate(const YGSpeculativeLayoutRef speculation,
+                                  const float availableWidth,
+                                  const float availableHeight,
+                                  const YGDirection parentDirection) {
+  YGNodeCalculateLayout(speculation->clone, availableWidth, availableHeight, parentDirection);
+}
 
-    if (measureModeMainDim == YGMeasureModeAtMost && remainingFreeSpace > 0) {
-      if (node->style.minDimensions[dim[mainAxis]].unit != YGUnitUndefined &&
-          YGValueResolve(&node->style.minDimensions[dim[mainAxis]], mainAxisParentSize) >= 0) {
-        remainingFreeSpace =
-        fmaxf(0,
-              YGValueResolve(&node->style.minDimensions[dim[mainAxis]], mainAxisParentSize) -
-              (availableInnerMainDim - remainingFreeSpace));
-      } else {
-        remainingFreeSpace = 0;
-      }
+static bool YGSpeculativeLayoutIsCurrent(const YGSpeculativeLayout *const speculation,
+                                         const YGNodeRef node,
+                                         const YGNodeRef clone,
+                                         uint32_t *const index) {
+  const uint32_t childCount = YGNodeListCount(node->children);
+  if (speculation->nodes[*index] != node || speculation->revisions[*index] != node->revision ||
+      speculation->childCounts[*index] != childCount ||
+      YGNodeListCount(clone->children) != childCount) {
+    return false;
+  }
+  (*index)++;
+
+  for (uint32_t i = 0; i < childCount; i++) {
+    if (!YGSpeculativeLayoutIsCurrent(speculation,
+                                      YGNodeListGet(node->children, i),
+                                      YGNodeListGet(clone->children, i),
+                                      index)) {
+      return false;
     }
+  }
+  return true;
+}
 
-    int numberOfAutoMarginsOnCurrentLine = 0;
-    for (uint32_t i = startOfLineIndex; i < endOfLineIndex; i++) {
-      const YGNodeRef child = YGNodeListGet(node->children, i);
-      if (child->style.positionType == YGPositionTypeRelative) {
-        if (child->style.margin[leading[mainAxis]].unit == YGUnitAuto) {
-          numberOfAutoMarginsOnCurrentLine++;
-        }
-        if (child->style.margin[trailing[mainAxis]].unit == YGUnitAuto) {
-          numberOfAutoMarginsOnCurrentLine++;
-        }
+// Moves the style, layout and caches of the clone onto the live node. What YGNodeEmitFrameDelta
+// last reported stays with the live node.
+static void YGSpeculativeLayoutApply(const YGNodeRef node, const YGNodeRef clone) {
+  if (memcmp(&node->style, &clone->style, sizeof(YGStyle)) != 0) {
+    node->style = clone->style;
+    node->hasPercentStyle = clone->hasPercentStyle;
+    YGNodeInvalidateLayoutProgram(node);
+  }
+  YGResolveDimensions(node);
+
+  node->layout = clone->layout;
+  YGNodeSetUnroundedPosition(
+      node, YGNodeGetUnroundedPosition(clone, 0), YGNodeGetUnroundedPosition(clone, 1));
+  if (YGNodeHasExtras(node) || YGNodeHasExtras(clone)) {
+    YGNodeGetExtras(node)->batchedMeasurement = clone->extras->batchedMeasurement;
+  }
+  YGNodeInvalidateBounds(node);
+  YGNodeMarkFrameChanged(node);
+
+  const YGLayoutCacheRef layoutCache = node->layoutCache;
+  node->layoutCache = clone->layoutCache;
+  clone->layoutCache = layoutCache;
+
+  node->lineIndex = clone->lineIndex;
+  node->isDirty = clone->isDirty;
+  node->hasDirtyDescendant = clone->hasDirtyDescendant;
+  node->hasNewLayout |= clone->hasNewLayout;
+  node->cachesWarm = clone->cachesWarm;
+
+  const uint32_t childCount = YGNodeListCount(node->children);
+  for (uint32_t i = 0; i < childCount; i++) {
+    YGSpeculativeLayoutApply(YGNodeListGet(node->children, i), YGNodeListGet(clone->children, i));
+  }
+}
+
+static void YGSpeculativeLayoutFree(const YGSpeculativeLayoutRef speculation) {
+  YGNodeFreeRecursive(speculation->clone);
+  gYGFree(speculation->nodes);
+  gYGFree(speculation->clones);
+  gYGFree(speculation->revisions);
+  gYGFree(speculation->childCounts);
+  gYGFree(speculation);
+}
+
+bool YGSpeculativeLayoutCommit(const YGSpeculativeLayoutRef speculation) {
+  const YGNodeRef root = speculation->root;
+  uint32_t index = 0;
+  const bool current = YGSpeculativeLayoutIsCurrent(speculation, root, speculation->clone, &index);
+  if (current) {
+    const YGNodeRef parent = root->parent;
+    YGFloat position[4];
+    YGFloat dimensions[2];
+    memcpy(position, root->layout.position, sizeof(position));
+    memcpy(dimensions, root->layout.dimensions, sizeof(dimensions));
+
+    YGSpeculativeLayoutApply(root, speculation->clone);
+
+    if (parent != NULL) {
+      // The parent places the root, and has to again if its size changed.
+      memcpy(root->layout.position, position, sizeof(position));
+      if (!YGFloatsEqual(dimensions[YGDimensionWidth], root->layout.dimensions[YGDimensionWidth]) ||
+          !YGFloatsEqual(dimensions[YGDimensionHeight],
+                         root->layout.dimensions[YGDimensionHeight])) {
+        YGNodeMarkDirtyInternal(parent);
+      }
+      for (YGNodeRef ancestor = parent; ancestor != NULL; ancestor = ancestor->parent) {
+        YGNodeInvalidateBounds(ancestor);
       }
     }
+    YGNodeInvalidateCommittedSubtree(parent);
+  }
 
-    if (numberOfAutoMarginsOnCurrentLine == 0) {
-      switch (justifyContent) {
-        case YGJustifyCenter:
-          leadingMainDim = remainingFreeSpace / 2;
-          break;
-        case YGJustifyFlexEnd:
-          leadingMainDim = remainingFreeSpace;
-          break;
-        case YGJustifySpaceBetween:
-          if (itemsOnLine > 1) {
-            betweenMainDim = fmaxf(remainingFreeSpace, 0) / (itemsOnLine - 1);
-          } else {
-            betweenMainDim = 0;
-          }
-          break;
-        case YGJustifySpaceAround:
-          // Space on the edges is half of the space between elements
-          betweenMainDim = remainingFreeSpace / itemsOnLine;
-          leadingMainDim = betweenMainDim / 2;
-          break;
-        case YGJustifyFlexStart:
-          break;
-      }
+  YGSpeculativeLayoutFree(speculation);
+  return current;
+}
+
+void YGSpeculativeLayoutAbort(const YGSpeculativeLayoutRef speculation) {
+  YGSpeculativeLayoutFree(speculation);
+}
+
+// Style and layout state of one node kept by a checkpoint. The entries of its layout cache and
+// their children are stored further down the same allocation.
+typedef struct YGCheckpointRecord {
+  YGNodeRef node;
+  uint32_t childCount;
+  YGStyle style;
+  bool hasPercentStyle;
+  bool cachesWarm;
+  YGLayoutSnapshot snapshot;
+  uint32_t firstCachedLayout;
+  uint32_t cachedLayoutCount;
+  uint32_t cachedLayoutNext;
+} YGCheckpointRecord;
+
+// Dirty flags of an ancestor of the root, set by the changes of a trial on their way up.
+typedef struct YGCheckpointAncestor {
+  YGNodeRef node;
+  bool isDirty;
+  bool hasDirtyDescendant;
+  bool cachesWarm;
+} YGCheckpointAncestor;
+
+struct YGLayoutCheckpoint {
+  YGNodeRef root;
+  uint32_t nodeCount;
+  uint32_t ancestorCount;
+  YGCheckpointRecord *records;
+  YGCheckpointAncestor *ancestors;
+  YGCachedLayoutEntry *cachedLayouts;
+  YGCachedChildLayout *cachedChildren;
+};
+
+static bool YGNodeCanCheckpoint(const YGNodeRef node,
+                                uint32_t *const nodeCount,
+                                uint32_t *const cachedLayoutCount,
+                                uint32_t *const cachedChildCount) {
+  if (node->extras->virtualized != NULL) {
+    return false;
+  }
+  (*nodeCount)++;
+  if (node->layoutCache != NULL) {
+    *cachedLayoutCount += node->layoutCache->count;
+    for (uint32_t i = 0; i < node->layoutCache->count; i++) {
+      *cachedChildCount += node->layoutCache->entries[i].childCount;
     }
+  }
 
-    float mainDim = leadingPaddingAndBorderMain + leadingMainDim;
-    float crossDim = 0;
+  const uint32_t childCount = YGNodeListCount(node->children);
+  for (uint32_t i = 0; i < childCount; i++) {
+    if (!YGNodeCanCheckpoint(
+            YGNodeListGet(node->children, i), nodeCount, cachedLayoutCount, cachedChildCount)) {
+      return false;
+    }
+  }
+  return true;
+}
 
-    for (uint32_t i = startOfLineIndex; i < endOfLineIndex; i++) {
-      const YGNodeRef child = YGNodeListGet(node->children, i);
-      if (child->style.display == YGDisplayNone) {
-        continue;
-      }
-      if (child->style.positionType == YGPositionTypeAbsolute &&
-          YGNodeIsLeadingPosDefined(child, mainAxis)) {
-        if (performLayout) {
-          // In case the child is position absolute and has left/top being
-          // defined, we override the position to whatever the user said
-          // (and margin/border).
-          child->layout.position[pos[mainAxis]] =
-          YGNodeLeadingPosition(child, mainAxis, availableInnerMainDim) +
-          YGNodeLeadingBorder(node, mainAxis) +
-          YGNodeLeadingMargin(child, mainAxis, availableInnerWidth);
-        }
-      } else {
-        // Now that we placed the element, we need to update the variables.
-        // We need to do that only for relative elements. Absolute elements
-        // do not take part in that phase.
-        if (child->style.positionType == YGPositionTypeRelative) {
-          if (child->style.margin[leading[mainAxis]].unit == YGUnitAuto) {
-            mainDim += remainingFreeSpace / numberOfAutoMarginsOnCurrentLine;
-          }
+static void YGNodeCheckpointRecursive(const YGNodeRef node,
+                                      const YGLayoutCheckpointRef checkpoint,
+                                      uint32_t *const index,
+                                      uint32_t *const cachedLayoutIndex,
+                                      uint32_t *const cachedChildIndex) {
+  YGCheckpointRecord *const record = &checkpoint->records[(*index)++];
+  record->node = node;
+  record->childCount = YGNodeListCount(node->children);
+  record->style = node->style;
+  record->hasPercentStyle = node->hasPercentStyle;
+  record->cachesWarm = node->cachesWarm;
+  YGNodeSaveLayout(node, &record->snapshot);
+
+  record->firstCachedLayout = *cachedLayoutIndex;
+  record->cachedLayoutCount = 0;
+  record->cachedLayoutNext = 0;
+  if (node->layoutCache != NULL) {
+    record->cachedLayoutCount = node->layoutCache->count;
+    record->cachedLayoutNext = node->layoutCache->next;
+    for (uint32_t i = 0; i < node->layoutCache->count; i++) {
+      const YGCachedLayoutEntry *const entry = &node->layoutCache->entries[i];
+      YGCachedLayoutEntry *const saved = &checkpoint->cachedLayouts[(*cachedLayoutIndex)++];
+      *saved = *entry;
+      saved->childCapacity = entry->childCount;
+      saved->children = &checkpoint->cachedChildren[*cachedChildIndex];
+      memcpy(saved->children, entry->children, sizeof(YGCachedChildLayout) * entry->childCount);
+      *cachedChildIndex += entry->childCount;
+    }
+  }
 
-          if (performLayout) {
-            child->layout.position[pos[mainAxis]] += mainDim;
-          }
+  for (uint32_t i = 0; i < record->childCount; i++) {
+    YGNodeCheckpointRecursive(YGNodeListGet(node->children, i),
+                              checkpoint,
+                              index,
+                              cachedLayoutIndex,
+                              cachedChildIndex);
+  }
+}
 
-          if (child->style.margin[trailing[mainAxis]].unit == YGUnitAuto) {
-            mainDim += remainingFreeSpace / numberOfAutoMarginsOnCurrentLine;
-          }
+YGLayoutCheckpointRef YGLayoutCheckpoint(const YGNodeRef root) {
+  uint32_t nodeCount = 0;
+  uint32_t cachedLayoutCount = 0;
+  uint32_t cachedChildCount = 0;
+  if (!YGNodeCanCheckpoint(root, &nodeCount, &cachedLayoutCount, &cachedChildCount)) {
+    return NULL;
+  }
+  uint32_t ancestorCount = 0;
+  for (YGNodeRef ancestor = root->parent; ancestor != NULL; ancestor = ancestor->parent) {
+    ancestorCount++;
+  }
 
-          if (canSkipFlex) {
-            // If we skipped the flex step, then we can't rely on the
-            // measuredDims because
-            // they weren't computed. This means we can't call YGNodeDimWithMargin.
-            mainDim += betweenMainDim + YGNodeMarginForAxis(child, mainAxis, availableInnerWidth) +
-            child->layout.computedFlexBasis;
-            crossDim = availableInnerCrossDim;
-          } else {
-            // The main dimension is the sum of all the elements dimension plus the spacing.
-            mainDim += betweenMainDim + YGNodeDimWithMargin(child, mainAxis, availableInnerWidth);
+  // One allocation, with the arrays laid out from the most to the least aligned.
+  const size_t size = sizeof(struct YGLayoutCheckpoint) +
+                      sizeof(YGCheckpointRecord) * nodeCount +
+                      sizeof(YGCheckpointAncestor) * ancestorCount +
+                      sizeof(YGCachedLayoutEntry) * cachedLayoutCount +
+                      sizeof(YGCachedChildLayout) * cachedChildCount;
+  const YGLayoutCheckpointRef checkpoint = gYGMalloc(size);
+  YG_ASSERT(checkpoint, "Could not allocate memory for layout checkpoint");
+  checkpoint->root = root;
+  checkpoint->nodeCount = nodeCount;
+  checkpoint->ancestorCount = ancestorCount;
+  checkpoint->records = (YGCheckpointRecord *) (checkpoint + 1);
+  checkpoint->ancestors = (YGCheckpointAncestor *) (checkpoint->records + nodeCount);
+  checkpoint->cachedLayouts = (YGCachedLayoutEntry *) (checkpoint->ancestors + ancestorCount);
+  checkpoint->cachedChildren =
+      (YGCachedChildLayout *) (checkpoint->cachedLayouts + cachedLayoutCount);
+
+  uint32_t index = 0;
+  uint32_t cachedLayoutIndex = 0;
+  uint32_t cachedChildIndex = 0;
+  YGNodeCheckpointRecursive(root, checkpoint, &index, &cachedLayoutIndex, &cachedChildIndex);
+
+  index = 0;
+  for (YGNodeRef ancestor = root->parent; ancestor != NULL; ancestor = ancestor->parent) {
+    YGCheckpointAncestor *const saved = &checkpoint->ancestors[index++];
+    saved->node = ancestor;
+    saved->isDirty = ancestor->isDirty;
+    saved->hasDirtyDescendant = ancestor->hasDirtyDescendant;
+    saved->cachesWarm = ancestor->cachesWarm;
+  }
+  return checkpoint;
+}
 
-            // The cross dimension is the max of the elements dimension since
-            // there can only be one element in that cross dimension.
-            crossDim = fmaxf(crossDim, YGNodeDimWithMargin(child, crossAxis, availableInnerWidth));
-          }
-        } else if (performLayout) {
-          child->layout.position[pos[mainAxis]] +=
-          YGNodeLeadingBorder(node, mainAxis) + leadingMainDim;
-        }
-      }
-    }
+static void YGNodeRestoreCheckpointRecursive(const YGNodeRef node,
+                                             const struct YGLayoutCheckpoint *const checkpoint,
+                                             uint32_t *const index) {
+  const YGCheckpointRecord *const record = &checkpoint->records[(*index)++];
+  YG_ASSERT(record->node == node && record->childCount == YGNodeListCount(node->children),
+            "Cannot restore a checkpoint of a tree whose structure changed");
 
-    mainDim += trailingPaddingAndBorderMain;
+  if (memcmp(&node->style, &record->style, sizeof(YGStyle)) != 0) {
+    node->style = record->style;
+    YGNodeInvalidateLayoutProgram(node);
+  }
+  node->hasPercentStyle = record->hasPercentStyle;
+  YGResolveDimensions(node);
+  YGNodeRestoreLayout(node, &record->snapshot, false);
+  node->cachesWarm = record->cachesWarm;
+  YGLayoutCacheAssign(node,
+                      &checkpoint->cachedLayouts[record->firstCachedLayout],
+                      record->cachedLayoutCount,
+                      record->cachedLayoutNext);
+
+  for (uint32_t i = 0; i < record->childCount; i++) {
+    YGNodeRestoreCheckpointRecursive(YGNodeListGet(node->children, i), checkpoint, index);
+  }
+}
 
-    float containerCrossAxis = availableInnerCrossDim;
-    if (measureModeCrossDim == YGMeasureModeUndefined ||
-        measureModeCrossDim == YGMeasureModeAtMost) {
-      // Compute the cross axis from the max cross dimension of the children.
-      containerCrossAxis = YGNodeBoundAxis(node,
-                                           crossAxis,
-                                           crossDim + paddingAndBorderAxisCross,
-                                           crossAxisParentSize,
-                                           parentWidth) -
-      paddingAndBorderAxisCross;
+void YGLayoutRestore(const YGLayoutCheckpointRef checkpoint) {
+  uint32_t index = 0;
+  YGNodeRestoreCheckpointRecursive(checkpoint->root, checkpoint, &index);
 
-      if (measureModeCrossDim == YGMeasureModeAtMost) {
-        containerCrossAxis = fminf(containerCrossAxis, availableInnerCrossDim);
-      }
+  for (uint32_t i = 0; i < checkpoint->ancestorCount; i++) {
+    const YGCheckpointAncestor *const saved = &checkpoint->ancestors[i];
+    saved->node->isDirty = saved->isDirty;
+    saved->node->hasDirtyDescendant = saved->hasDirtyDescendant;
+    saved->node->cachesWarm = saved->cachesWarm;
+  }
+}
+
+void YGLayoutCheckpointFree(const YGLayoutCheckpointRef checkpoint) {
+  gYGFree(checkpoint);
+}
+
+YGSize YGNodeMeasure(const YGNodeRef node,
+                     const float width,
+                     const YGMeasureMode widthMode,
+                     const float height,
+                     const YGMeasureMode heightMode) {
+  YGNextGeneration();
+
+  YGFloat availableWidth = width;
+  YGFloat availableHeight = height;
+  YGMeasureMode widthMeasureMode = widthMode;
+  YGMeasureMode heightMeasureMode = heightMode;
+
+  YGResolveDimensions(node);
+
+  if (widthMode == YGMeasureModeUndefined) {
+    YGNodeResolveRootConstraint(
+        node, YGFlexDirectionRow, YGUndefined, YGUndefined, &availableWidth, &widthMeasureMode);
+  }
+  if (heightMode == YGMeasureModeUndefined) {
+    YGNodeResolveRootConstraint(
+        node, YGFlexDirectionColumn, YGUndefined, YGUndefined, &availableHeight, &heightMeasureMode);
+  }
+
+  // Measure with the direction of the last layout so its caches stay valid.
+  const YGDirection parentDirection = node->layout.lastParentDirection == (YGDirection) -1
+                                          ? node->style.direction
+                                          : node->layout.lastParentDirection;
+
+  YGLayoutNodeInternal(node,
+                       availableWidth,
+                       availableHeight,
+                       parentDirection,
+                       widthMeasureMode,
+                       heightMeasureMode,
+                       widthMode == YGMeasureModeUndefined ? YGUndefined : width,
+                       heightMode == YGMeasureModeUndefined ? YGUndefined : height,
+                       false,
+                       "measure");
+
+  return (YGSize){
+      .width = node->layout.measuredDimensions[YGDimensionWidth],
+      .height = node->layout.measuredDimensions[YGDimensionHeight],
+  };
+}
+
+// One node of a compiled layout program, with everything the flex algorithm reads from its style
+// resolved ahead of time. Values indexed by flex direction are for the node's own resolved axes.
+typedef struct YGLayoutInstruction {
+  YGNodeRef node;
+  uint32_t firstChild;
+  uint32_t childCount;
+  YGDirection direction;
+  YGFlexDirection mainAxis;
+  YGFlexDirection crossAxis;
+  YGJustify justifyContent;
+  // How the parent aligns the node on its cross axis.
+  YGAlign align;
+  YGFloat flexGrow;
+  // Style dimensions in points, undefined when sized by the content.
+  YGFloat dimensions[2];
+  YGFloat leadingMargin[4];
+  YGFloat trailingMargin[4];
+  YGFloat marginForAxis[4];
+  YGFloat paddingAndBorderForAxis[4];
+  YGFloat leadingPaddingAndBorder[4];
+  YGFloat trailingPaddingAndBorder[4];
+  // Position the parent starts from before adding the offsets of the flex algorithm.
+  YGFloat position[4];
+  YGFloat margin[6];
+  YGFloat border[6];
+  YGFloat padding[6];
+} YGLayoutInstruction;
+
+typedef struct YGLayoutProgram {
+  // NULL once a change to the tree made the program stale.
+  YGNodeRef root;
+  YGDirection direction;
+  uint32_t count;
+  // Breadth-first, so the children of every node are next to each other.
+  YGLayoutInstruction *instructions;
+} YGLayoutProgram;
+
+static void YGLayoutProgramDetach(const YGLayoutProgramRef program) {
+  if (program->root != NULL) {
+    program->root->layoutProgram = NULL;
+    program->root = NULL;
+    YG_ATOMIC_ADD(gLayoutProgramCount, -1);
+  }
+}
+
+static void YGLayoutProgramInvalidatePath(YGNodeRef node) {
+  for (; node != NULL; node = node->parent) {
+    if (node->layoutProgram != NULL) {
+      YGLayoutProgramDetach(node->layoutProgram);
     }
+  }
+}
 
-    // If there's no flex wrap, the cross dimension is defined by the container.
-    if (!isNodeFlexWrap && measureModeCrossDim == YGMeasureModeExactly) {
-      crossDim = availableInnerCrossDim;
+static bool YGLayoutProgramSupportsEdges(const YGValue edges[YGEdgeCount]) {
+  for (YGEdge edge = YGEdgeLeft; edge < YGEdgeCount; edge++) {
+    if (edges[edge].unit != YGUnitUndefined && edges[edge].unit != YGUnitPoint) {
+      return false;
     }
+  }
+  return true;
+}
 
-    // Clamp to the min/max size specified on the container.
-    crossDim = YGNodeBoundAxis(node,
-                               crossAxis,
-                               crossDim + paddingAndBorderAxisCross,
-                               crossAxisParentSize,
-                               parentWidth) -
-    paddingAndBorderAxisCross;
+// Whether the part of the algorithm a program runs lays the node out as the engine would.
+static bool YGLayoutProgramSupportsNode(const YGNodeRef node) {
+  const YGStyle *const style = &node->style;
+  if (node->extras->virtualized != NULL || node->extras->frozen ||
+      style->positionType != YGPositionTypeRelative || style->display != YGDisplayFlex ||
+      YGNodeStyleGetFlexShrink(node) != 0.0f || YGNodeStyleGetFlexGrow(node) < 0.0f ||
+      YGNodeStyleGetFlexBasisPtr(node)->unit != YGUnitAuto ||
+      !YGFloatIsUndefined(style->aspectRatio)) {
+    return false;
+  }
 
-    // STEP 7: CROSS-AXIS ALIGNMENT
-    // We can skip child alignment if we're just measuring the container.
-    if (performLayout) {
-      for (uint32_t i = startOfLineIndex; i < endOfLineIndex; i++) {
-        const YGNodeRef child = YGNodeListGet(node->children, i);
-        if (child->style.display == YGDisplayNone) {
-          continue;
-        }
-        if (child->style.positionType == YGPositionTypeAbsolute) {
-          // If the child is absolutely positioned and has a
-          // top/left/bottom/right
-          // set, override all the previously computed positions to set it
-          // correctly.
-          if (YGNodeIsLeadingPosDefined(child, crossAxis)) {
-            child->layout.position[pos[crossAxis]] =
-            YGNodeLeadingPosition(child, crossAxis, availableInnerCrossDim) +
-            YGNodeLeadingBorder(node, crossAxis) +
-            YGNodeLeadingMargin(child, crossAxis, availableInnerWidth);
-          } else {
-            child->layout.position[pos[crossAxis]] =
-            YGNodeLeadingBorder(node, crossAxis) +
-            YGNodeLeadingMargin(child, crossAxis, availableInnerWidth);
-          }
-        } else {
-          float leadingCrossDim = leadingPaddingAndBorderCross;
+  for (YGDimension dimension = YGDimensionWidth; dimension <= YGDimensionHeight; dimension++) {
+    if ((style->dimensions[dimension].unit == YGUnitPercent) ||
+        style->minDimensions[dimension].unit != YGUnitUndefined ||
+        style->maxDimensions[dimension].unit != YGUnitUndefined) {
+      return false;
+    }
+  }
 
-          // For a relative children, we're either using alignItems (parent) or
-          // alignSelf (child) in order to determine the position in the cross
-          // axis
-          const YGAlign alignItem = YGNodeAlignItem(node, child);
+  for (YGEdge edge = YGEdgeLeft; edge < YGEdgeCount; edge++) {
+    if (style->position[edge].unit != YGUnitUndefined) {
+      return false;
+    }
+  }
+  if (!YGLayoutProgramSupportsEdges(style->margin) ||
+      !YGLayoutProgramSupportsEdges(style->padding) ||
+      !YGLayoutProgramSupportsEdges(style->border)) {
+    return false;
+  }
 
-          // If the child uses align stretch, we need to lay it out one more
-          // time, this time
-          // forcing the cross-axis size to be the computed cross size for the
-          // current line.
-          if (alignItem == YGAlignStretch &&
-              child->style.margin[leading[crossAxis]].unit != YGUnitAuto &&
-              child->style.margin[trailing[crossAxis]].unit != YGUnitAuto) {
-            // If the child defines a definite size for its cross axis, there's
-            // no need to stretch.
-            if (!YGNodeIsStyleDimDefined(child, crossAxis, availableInnerCrossDim)) {
-              float childMainSize = child->layout.measuredDimensions[dim[mainAxis]];
-              float childCrossSize =
-              !YGFloatIsUndefined(child->style.aspectRatio)
-              ? ((YGNodeMarginForAxis(child, crossAxis, availableInnerWidth) +
-                  (isMainAxisRow ? childMainSize / child->style.aspectRatio
-                   : childMainSize * child->style.aspectRatio)))
-              : crossDim;
+  const uint32_t childCount = YGNodeListCount(node->children);
+  if (childCount == 0) {
+    return true;
+  }
+  if (style->flexWrap != YGWrapNoWrap || style->overflow == YGOverflowScroll ||
+      style->alignContent == YGAlignStretch || YGIsBaselineLayout(node)) {
+    return false;
+  }
+  for (uint32_t i = 0; i < childCount; i++) {
+    if (YGNodeAlignItem(node, YGNodeListGet(node->children, i)) == YGAlignBaseline) {
+      return false;
+    }
+  }
+  return true;
+}
 
-              childMainSize += YGNodeMarginForAxis(child, mainAxis, availableInnerWidth);
+static uint32_t YGLayoutProgramCountNodes(const YGNodeRef node) {
+  if (!YGLayoutProgramSupportsNode(node)) {
+    return 0;
+  }
+  uint32_t count = 1;
+  const uint32_t childCount = YGNodeListCount(node->children);
+  for (uint32_t i = 0; i < childCount; i++) {
+    const uint32_t childNodes = YGLayoutProgramCountNodes(YGNodeListGet(node->children, i));
+    if (childNodes == 0) {
+      return 0;
+    }
+    count += childNodes;
+  }
+  return count;
+}
 
-              YGMeasureMode childMainMeasureMode = YGMeasureModeExactly;
-              YGMeasureMode childCrossMeasureMode = YGMeasureModeExactly;
-              YGConstrainMaxSizeForMode(YGValueResolve(&child->style.maxDimensions[dim[mainAxis]],
-                                                       availableInnerMainDim),
-                                        &childMainMeasureMode,
-                                        &childMainSize);
-              YGConstrainMaxSizeForMode(YGValueResolve(&child->style.maxDimensions[dim[crossAxis]],
-                                                       availableInnerCrossDim),
-                                        &childCrossMeasureMode,
-                                        &childCrossSize);
+static void YGLayoutInstructionCompile(YGLayoutInstruction *const instruction,
+                                       const YGNodeRef node,
+                                       const YGDirection parentDirection,
+                                       const YGAlign align) {
+  YGResolveDimensions(node);
 
-              const float childWidth = isMainAxisRow ? childMainSize : childCrossSize;
-              const float childHeight = !isMainAxisRow ? childMainSize : childCrossSize;
+  const YGDirection direction = YGNodeResolveDirection(node, parentDirection);
+  instruction->node = node;
+  instruction->childCount = YGNodeListCount(node->children);
+  instruction->direction = direction;
+  instruction->mainAxis = YGFlexDirectionResolve(node->style.flexDirection, direction);
+  instruction->crossAxis = YGFlexDirectionCross(instruction->mainAxis, direction);
+  instruction->justifyContent = node->style.justifyContent;
+  instruction->align = align;
+  instruction->flexGrow = YGNodeStyleGetFlexGrow(node);
+
+  instruction->dimensions[YGDimensionWidth] =
+      YGNodeIsStyleDimDefined(node, YGFlexDirectionRow, YGUndefined)
+          ? node->resolvedDimensions[YGDimensionWidth]->value
+          : YGUndefined;
+  instruction->dimensions[YGDimensionHeight] =
+      YGNodeIsStyleDimDefined(node, YGFlexDirectionColumn, YGUndefined)
+          ? node->resolvedDimensions[YGDimensionHeight]->value
+          : YGUndefined;
+
+  for (YGFlexDirection axis = YGFlexDirectionColumn; axis <= YGFlexDirectionRowReverse; axis++) {
+    instruction->leadingMargin[axis] = YGNodeLeadingMargin(node, axis, YGUndefined);
+    instruction->trailingMargin[axis] = YGNodeTrailingMargin(node, axis, YGUndefined);
+    instruction->marginForAxis[axis] = YGNodeMarginForAxis(node, axis, YGUndefined);
+    instruction->paddingAndBorderForAxis[axis] =
+        YGNodePaddingAndBorderForAxis(node, axis, YGUndefined);
+    instruction->leadingPaddingAndBorder[axis] =
+        YGNodeLeadingPaddingAndBorder(node, axis, YGUndefined);
+    instruction->trailingPaddingAndBorder[axis] =
+        YGNodeTrailingPaddingAndBorder(node, axis, YGUndefined);
+  }
 
-              const YGMeasureMode childWidthMeasureMode =
-              YGFloatIsUndefined(childWidth) ? YGMeasureModeUndefined : YGMeasureModeExactly;
-              const YGMeasureMode childHeightMeasureMode =
-              YGFloatIsUndefined(childHeight) ? YGMeasureModeUndefined : YGMeasureModeExactly;
+  // Without position offsets the start position only depends on the margins.
+  const YGLayout layout = node->layout;
+  YGNodeSetPosition(node, direction, YGUndefined, YGUndefined, YGUndefined);
+  memcpy(instruction->position, node->layout.position, sizeof(instruction->position));
+  node->layout.position[YGEdgeLeft] = layout.position[YGEdgeLeft];
+  node->layout.position[YGEdgeTop] = layout.position[YGEdgeTop];
+  node->layout.position[YGEdgeRight] = layout.position[YGEdgeRight];
+  node->layout.position[YGEdgeBottom] = layout.position[YGEdgeBottom];
 
-              YGLayoutNodeInternal(child,
-                                   childWidth,
-                                   childHeight,
-                                   direction,
-                                   childWidthMeasureMode,
-                                   childHeightMeasureMode,
-                                   availableInnerWidth,
-                                   availableInnerHeight,
-                                   true,
-                                   "stretch");
-            }
-          } else {
-            const float remainingCrossDim =
-            containerCrossAxis - YGNodeDimWithMargin(child, crossAxis, availableInnerWidth);
+  const YGFlexDirection flexRowDirection = YGFlexDirectionResolve(YGFlexDirectionRow, direction);
+  const YGFlexDirection flexColumnDirection =
+      YGFlexDirectionResolve(YGFlexDirectionColumn, direction);
+
+  memcpy(instruction->margin, layout.margin, sizeof(instruction->margin));
+  instruction->margin[YGEdgeStart] = YGNodeLeadingMargin(node, flexRowDirection, YGUndefined);
+  instruction->margin[YGEdgeEnd] = YGNodeTrailingMargin(node, flexRowDirection, YGUndefined);
+  instruction->margin[YGEdgeTop] = YGNodeLeadingMargin(node, flexColumnDirection, YGUndefined);
+  instruction->margin[YGEdgeBottom] = YGNodeTrailingMargin(node, flexColumnDirection, YGUndefined);
+
+  memcpy(instruction->border, layout.border, sizeof(instruction->border));
+  instruction->border[YGEdgeStart] = YGNodeLeadingBorder(node, flexRowDirection);
+  instruction->border[YGEdgeEnd] = YGNodeTrailingBorder(node, flexRowDirection);
+  instruction->border[YGEdgeTop] = YGNodeLeadingBorder(node, flexColumnDirection);
+  instruction->border[YGEdgeBottom] = YGNodeTrailingBorder(node, flexColumnDirection);
+
+  memcpy(instruction->padding, layout.padding, sizeof(instruction->padding));
+  instruction->padding[YGEdgeStart] = YGNodeLeadingPadding(node, flexRowDirection, YGUndefined);
+  instruction->padding[YGEdgeEnd] = YGNodeTrailingPadding(node, flexRowDirection, YGUndefined);
+  instruction->padding[YGEdgeTop] = YGNodeLeadingPadding(node, flexColumnDirection, YGUndefined);
+  instruction->padding[YGEdgeBottom] =
+      YGNodeTrailingPadding(node, flexColumnDirection, YGUndefined);
+}
 
-            if (child->style.margin[leading[crossAxis]].unit == YGUnitAuto &&
-                child->style.margin[trailing[crossAxis]].unit == YGUnitAuto) {
-              leadingCrossDim += remainingCrossDim / 2;
-            } else if (child->style.margin[trailing[crossAxis]].unit == YGUnitAuto) {
-              // No-Op
-            } else if (child->style.margin[leading[crossAxis]].unit == YGUnitAuto) {
-              leadingCrossDim += remainingCrossDim;
-            } else if (alignItem == YGAlignFlexStart) {
-              // No-Op
-            } else if (alignItem == YGAlignCenter) {
-              leadingCrossDim += remainingCrossDim / 2;
-            } else {
-              leadingCrossDim += remainingCrossDim;
-            }
-          }
-          // And we apply the position
-          child->layout.position[pos[crossAxis]] += totalLineCrossDim + leadingCrossDim;
-        }
-      }
+YGLayoutProgramRef YGLayoutProgramNew(const YGNodeRef root, const YGDirection direction) {
+  if (YGNodeListCount(root->children) == 0) {
+    return NULL;
+  }
+  const uint32_t count = YGLayoutProgramCountNodes(root);
+  if (count == 0) {
+    return NULL;
+  }
+
+  const YGLayoutProgramRef program = gYGMalloc(sizeof(YGLayoutProgram));
+  YG_ASSERT(program, "Could not allocate memory for layout program");
+  program->instructions = gYGMalloc(count * sizeof(YGLayoutInstruction));
+  YG_ASSERT(program->instructions, "Could not allocate memory for layout program");
+  program->count = count;
+  program->direction = direction;
+
+  YGLayoutInstructionCompile(&program->instructions[0], root, direction, YGAlignAuto);
+  uint32_t end = 1;
+  for (uint32_t i = 0; i < count; i++) {
+    YGLayoutInstruction *const instruction = &program->instructions[i];
+    const YGNodeRef node = instruction->node;
+    instruction->firstChild = end;
+    for (uint32_t j = 0; j < instruction->childCount; j++) {
+      const YGNodeRef child = YGNodeListGet(node->children, j);
+      YGLayoutInstructionCompile(&program->instructions[end++],
+                                 child,
+                                 instruction->direction,
+                                 YGNodeAlignItem(node, child));
     }
+  }
 
-    totalLineCrossDim += crossDim;
-    maxLineMainDim = fmaxf(maxLineMainDim, mainDim);
+  if (root->layoutProgram != NULL) {
+    YGLayoutProgramDetach(root->layoutProgram);
   }
+  program->root = root;
+  root->layoutProgram = program;
+  YG_ATOMIC_ADD(gLayoutProgramCount, 1);
+  return program;
+}
 
-  // STEP 8: MULTI-LINE CONTENT ALIGNMENT
-  if (performLayout &&
-      (lineCount > 1 || node->style.alignContent == YGAlignStretch || YGIsBaselineLayout(node)) &&
-      !YGFloatIsUndefined(availableInnerCrossDim)) {
-    const float remainingAlignContentDim = availableInnerCrossDim - totalLineCrossDim;
+void YGLayoutProgramFree(const YGLayoutProgramRef program) {
+  YGLayoutProgramDetach(program);
+  gYGFree(program->instructions);
+  gYGFree(program);
+}
+
+static inline bool YGCachedMeasurementMatches(const YGCachedMeasurement *const entry,
+                                              const YGFloat availableWidth,
+                                              const YGFloat availableHeight,
+                                              const YGMeasureMode widthMeasureMode,
+                                              const YGMeasureMode heightMeasureMode) {
+  return YGFloatsEqual(entry->availableWidth, availableWidth) &&
+         YGFloatsEqual(entry->availableHeight, availableHeight) &&
+         entry->widthMeasureMode == widthMeasureMode &&
+         entry->heightMeasureMode == heightMeasureMode;
+}
+
+static void YGLayoutProgramLayoutNode(const YGLayoutProgramRef program,
+                                      const uint32_t index,
+                                      const YGFloat availableWidth,
+                                      const YGFloat availableHeight,
+                                      const YGDirection parentDirection,
+                                      const YGMeasureMode widthMeasureMode,
+                                      const YGMeasureMode heightMeasureMode,
+                                      const YGFloat parentWidth,
+                                      const YGFloat parentHeight,
+                                      const bool performLayout,
+                                      const char *reason);
+
+static inline YGFloat YGLayoutInstructionDimWithMargin(const YGLayoutInstruction *const instruction,
+                                                       const YGFlexDirection axis) {
+  return instruction->node->layout.measuredDimensions[dim[axis]] +
+         instruction->leadingMargin[axis] + instruction->trailingMargin[axis];
+}
+
+// YGNodelayoutImpl for a compiled container: a single line of relative children without
+// min/max sizes, shrinking or auto margins, so only the steps and branches reachable with
+// those are left.
+static void YGLayoutProgramLayoutImpl(const YGLayoutProgramRef program,
+                                      const YGLayoutInstruction *const instruction,
+                                      const YGFloat availableWidth,
+                                      const YGFloat availableHeight,
+                                      const YGMeasureMode widthMeasureMode,
+                                      const YGMeasureMode heightMeasureMode,
+                                      const bool performLayout) {
+  const YGNodeRef node = instruction->node;
+  YGLayout *const layout = &node->layout;
+  const YGDirection direction = instruction->direction;
+
+  layout->direction = direction;
+  memcpy(layout->margin, instruction->margin, sizeof(layout->margin));
+  memcpy(layout->border, instruction->border, sizeof(layout->border));
+  memcpy(layout->padding, instruction->padding, sizeof(layout->padding));
+
+  const YGFloat marginAxisRow = instruction->marginForAxis[YGFlexDirectionRow];
+  const YGFloat marginAxisColumn = instruction->marginForAxis[YGFlexDirectionColumn];
+
+  if (!performLayout &&
+      ((widthMeasureMode == YGMeasureModeAtMost && availableWidth <= 0.0f) ||
+       (heightMeasureMode == YGMeasureModeAtMost && availableHeight <= 0.0f) ||
+       (widthMeasureMode == YGMeasureModeExactly && heightMeasureMode == YGMeasureModeExactly))) {
+    layout->measuredDimensions[YGDimensionWidth] =
+        YGFloatMax(YGFloatIsUndefined(availableWidth) ||
+                           (widthMeasureMode == YGMeasureModeAtMost && availableWidth < 0.0f)
+                       ? 0.0f
+                       : availableWidth - marginAxisRow,
+                   instruction->paddingAndBorderForAxis[YGFlexDirectionRow]);
+    layout->measuredDimensions[YGDimensionHeight] =
+        YGFloatMax(YGFloatIsUndefined(availableHeight) ||
+                           (heightMeasureMode == YGMeasureModeAtMost && availableHeight < 0.0f)
+                       ? 0.0f
+                       : availableHeight - marginAxisColumn,
+                   instruction->paddingAndBorderForAxis[YGFlexDirectionColumn]);
+    return;
+  }
 
-    float crossDimLead = 0;
-    float currentLead = leadingPaddingAndBorderCross;
+  // STEP 1: CALCULATE VALUES FOR REMAINDER OF ALGORITHM
+  const YGFlexDirection mainAxis = instruction->mainAxis;
+  const YGFlexDirection crossAxis = instruction->crossAxis;
+  const bool isMainAxisRow = YGFlexDirectionIsRow(mainAxis);
+  const YGDimension mainDimension = dim[mainAxis];
+  const YGDimension crossDimension = dim[crossAxis];
 
-    switch (node->style.alignContent) {
-      case YGAlignFlexEnd:
-        currentLead += remainingAlignContentDim;
-        break;
-      case YGAlignCenter:
-        currentLead += remainingAlignContentDim / 2;
-        break;
-      case YGAlignStretch:
-        if (availableInnerCrossDim > totalLineCrossDim) {
-          crossDimLead = remainingAlignContentDim / lineCount;
-        }
-        break;
-      case YGAlignSpaceAround:
-        if (availableInnerCrossDim > totalLineCrossDim) {
-          currentLead += remainingAlignContentDim / (2 * lineCount);
-          if (lineCount > 1) {
-            crossDimLead = remainingAlignContentDim / lineCount;
-          }
-        } else {
-          currentLead += remainingAlignContentDim / 2;
-        }
-        break;
-      case YGAlignSpaceBetween:
-        if (availableInnerCrossDim > totalLineCrossDim && lineCount > 1) {
-          crossDimLead = remainingAlignContentDim / (lineCount - 1);
-        }
-        break;
-      case YGAlignAuto:
-      case YGAlignFlexStart:
-      case YGAlignBaseline:
-        break;
-    }
+  const YGFloat leadingPaddingAndBorderMain = instruction->leadingPaddingAndBorder[mainAxis];
+  const YGFloat trailingPaddingAndBorderMain = instruction->trailingPaddingAndBorder[mainAxis];
+  const YGFloat leadingPaddingAndBorderCross = instruction->leadingPaddingAndBorder[crossAxis];
+  const YGFloat paddingAndBorderAxisMain = instruction->paddingAndBorderForAxis[mainAxis];
+  const YGFloat paddingAndBorderAxisCross = instruction->paddingAndBorderForAxis[crossAxis];
 
-    uint32_t endIndex = 0;
-    for (uint32_t i = 0; i < lineCount; i++) {
-      const uint32_t startIndex = endIndex;
-      uint32_t ii;
+  const YGMeasureMode measureModeMainDim = isMainAxisRow ? widthMeasureMode : heightMeasureMode;
+  const YGMeasureMode measureModeCrossDim = isMainAxisRow ? heightMeasureMode : widthMeasureMode;
 
-      // compute the line's height and find the endIndex
-      float lineHeight = 0;
-      float maxAscentForCurrentLine = 0;
-      float maxDescentForCurrentLine = 0;
-      for (ii = startIndex; ii < childCount; ii++) {
-        const YGNodeRef child = YGNodeListGet(node->children, ii);
-        if (child->style.display == YGDisplayNone) {
-          continue;
-        }
-        if (child->style.positionType == YGPositionTypeRelative) {
-          if (child->lineIndex != i) {
-            break;
-          }
-          if (YGNodeIsLayoutDimDefined(child, crossAxis)) {
-            lineHeight = fmaxf(lineHeight,
-                               child->layout.measuredDimensions[dim[crossAxis]] +
-                               YGNodeMarginForAxis(child, crossAxis, availableInnerWidth));
-          }
-          if (YGNodeAlignItem(node, child) == YGAlignBaseline) {
-            const float ascent =
-            YGBaseline(child) +
-            YGNodeLeadingMargin(child, YGFlexDirectionColumn, availableInnerWidth);
-            const float descent =
-            child->layout.measuredDimensions[YGDimensionHeight] +
-            YGNodeMarginForAxis(child, YGFlexDirectionColumn, availableInnerWidth) - ascent;
-            maxAscentForCurrentLine = fmaxf(maxAscentForCurrentLine, ascent);
-            maxDescentForCurrentLine = fmaxf(maxDescentForCurrentLine, descent);
-            lineHeight = fmaxf(lineHeight, maxAscentForCurrentLine + maxDescentForCurrentLine);
-          }
-        }
-      }
-      endIndex = ii;
-      lineHeight += crossDimLead;
+  const YGFloat paddingAndBorderAxisRow =
+      isMainAxisRow ? paddingAndBorderAxisMain : paddingAndBorderAxisCross;
+  const YGFloat paddingAndBorderAxisColumn =
+      isMainAxisRow ? paddingAndBorderAxisCross : paddingAndBorderAxisMain;
 
-      if (performLayout) {
-        for (ii = startIndex; ii < endIndex; ii++) {
-          const YGNodeRef child = YGNodeListGet(node->children, ii);
-          if (child->style.display == YGDisplayNone) {
-            continue;
-          }
-          if (child->style.positionType == YGPositionTypeRelative) {
-            switch (YGNodeAlignItem(node, child)) {
-              case YGAlignFlexStart: {
-                child->layout.position[pos[crossAxis]] =
-                currentLead + YGNodeLeadingMargin(child, crossAxis, availableInnerWidth);
-                break;
-              }
-              case YGAlignFlexEnd: {
-                child->layout.position[pos[crossAxis]] =
-                currentLead + lineHeight -
-                YGNodeTrailingMargin(child, crossAxis, availableInnerWidth) -
-                child->layout.measuredDimensions[dim[crossAxis]];
-                break;
-              }
-              case YGAlignCenter: {
-                float childHeight = child->layout.measuredDimensions[dim[crossAxis]];
-                child->layout.position[pos[crossAxis]] =
-                currentLead + (lineHeight - childHeight) / 2;
-                break;
-              }
-              case YGAlignStretch: {
-                child->layout.position[pos[crossAxis]] =
-                currentLead + YGNodeLeadingMargin(child, crossAxis, availableInnerWidth);
+  // STEP 2: DETERMINE AVAILABLE SIZE IN MAIN AND CROSS DIRECTIONS
+  const YGFloat availableInnerWidth = availableWidth - marginAxisRow - paddingAndBorderAxisRow;
+  const YGFloat availableInnerHeight =
+      availableHeight - marginAxisColumn - paddingAndBorderAxisColumn;
+  const YGFloat availableInnerMainDim = isMainAxisRow ? availableInnerWidth : availableInnerHeight;
+  const YGFloat availableInnerCrossDim = isMainAxisRow ? availableInnerHeight : availableInnerWidth;
 
-                // Remeasure child with the line height as it as been only measured with the
-                // parents height yet.
-                if (!YGNodeIsStyleDimDefined(child, crossAxis, availableInnerCrossDim)) {
-                  const float childWidth =
-                  isMainAxisRow ? (child->layout.measuredDimensions[YGDimensionWidth] +
-                                   YGNodeMarginForAxis(child, crossAxis, availableInnerWidth))
-                  : lineHeight;
+  const uint32_t childCount = instruction->childCount;
+  const uint32_t firstChild = instruction->firstChild;
+  const YGLayoutInstruction *const children = &program->instructions[firstChild];
 
-                  const float childHeight =
-                  !isMainAxisRow ? (child->layout.measuredDimensions[YGDimensionHeight] +
-                                    YGNodeMarginForAxis(child, crossAxis, availableInnerWidth))
-                  : lineHeight;
+  // STEP 3: DETERMINE FLEX BASIS FOR EACH ITEM
+  for (uint32_t i = 0; i < childCount; i++) {
+    const YGLayoutInstruction *const child = &children[i];
+    YGLayout *const childLayout = &child->node->layout;
+    if (performLayout) {
+      memcpy(childLayout->position, child->position, sizeof(childLayout->position));
+    }
 
-                  if (!(YGFloatsEqual(childWidth,
-                                      child->layout.measuredDimensions[YGDimensionWidth]) &&
-                        YGFloatsEqual(childHeight,
-                                      child->layout.measuredDimensions[YGDimensionHeight]))) {
-                          YGLayoutNodeInternal(child,
-                                               childWidth,
-                                               childHeight,
-                                               direction,
-                                               YGMeasureModeExactly,
-                                               YGMeasureModeExactly,
-                                               availableInnerWidth,
-                                               availableInnerHeight,
-                                               true,
-                                               "stretch");
-                        }
-                }
-                break;
-              }
-              case YGAlignBaseline: {
-                child->layout.position[YGEdgeTop] =
-                currentLead + maxAscentForCurrentLine - YGBaseline(child) +
-                YGNodeLeadingPosition(child, YGFlexDirectionColumn, availableInnerCrossDim);
-                break;
-              }
-              case YGAlignAuto:
-              case YGAlignSpaceBetween:
-              case YGAlignSpaceAround:
-                break;
-            }
-          }
-        }
+    if (!YGFloatIsUndefined(child->dimensions[mainDimension])) {
+      childLayout->computedFlexBasis =
+          YGFloatMax(child->dimensions[mainDimension],
+                     child->paddingAndBorderForAxis[isMainAxisRow ? YGFlexDirectionRow
+                                                                  : YGFlexDirectionColumn]);
+    } else {
+      YGFloat childWidth = child->dimensions[YGDimensionWidth];
+      YGFloat childHeight = child->dimensions[YGDimensionHeight];
+      YGMeasureMode childWidthMeasureMode = YGMeasureModeUndefined;
+      YGMeasureMode childHeightMeasureMode = YGMeasureModeUndefined;
+
+      if (!YGFloatIsUndefined(childWidth)) {
+        childWidth += child->marginForAxis[YGFlexDirectionRow];
+        childWidthMeasureMode = YGMeasureModeExactly;
+      } else if (!YGFloatIsUndefined(availableInnerWidth)) {
+        childWidth = availableInnerWidth;
+        childWidthMeasureMode =
+            !isMainAxisRow && widthMeasureMode == YGMeasureModeExactly &&
+                    child->align == YGAlignStretch
+                ? YGMeasureModeExactly
+                : YGMeasureModeAtMost;
+      }
+      if (!YGFloatIsUndefined(childHeight)) {
+        childHeight += child->marginForAxis[YGFlexDirectionColumn];
+        childHeightMeasureMode = YGMeasureModeExactly;
+      } else if (!YGFloatIsUndefined(availableInnerHeight)) {
+        childHeight = availableInnerHeight;
+        childHeightMeasureMode =
+            isMainAxisRow && heightMeasureMode == YGMeasureModeExactly &&
+                    child->align == YGAlignStretch
+                ? YGMeasureModeExactly
+                : YGMeasureModeAtMost;
       }
 
-      currentLead += lineHeight;
+      YGLayoutProgramLayoutNode(program,
+                                firstChild + i,
+                                childWidth,
+                                childHeight,
+                                direction,
+                                childWidthMeasureMode,
+                                childHeightMeasureMode,
+                                availableInnerWidth,
+                                availableInnerHeight,
+                                false,
+                                "measure");
+
+      childLayout->computedFlexBasis = YGFloatMax(childLayout->measuredDimensions[mainDimension],
+                                                  child->paddingAndBorderForAxis[mainAxis]);
     }
+    childLayout->computedFlexBasisGeneration = gCurrentGenerationCount;
   }
 
-  // STEP 9: COMPUTING FINAL DIMENSIONS
-  node->layout.measuredDimensions[YGDimensionWidth] = YGNodeBoundAxis(
-                                                                      node, YGFlexDirectionRow, availableWidth - marginAxisRow, parentWidth, parentWidth);
-  node->layout.measuredDimensions[YGDimensionHeight] = YGNodeBoundAxis(
-                                                                       node, YGFlexDirectionColumn, availableHeight - marginAxisColumn, parentHeight, parentWidth);
-
-  // If the user didn't specify a width or height for the node, set the
-  // dimensions based on the children.
-  if (measureModeMainDim == YGMeasureModeUndefined ||
-      (node->style.overflow != YGOverflowScroll && measureModeMainDim == YGMeasureModeAtMost)) {
-    // Clamp the size to the min/max size, if specified, and make sure it
-    // doesn't go below the padding and border amount.
-    node->layout.measuredDimensions[dim[mainAxis]] =
-    YGNodeBoundAxis(node, mainAxis, maxLineMainDim, mainAxisParentSize, parentWidth);
-  } else if (measureModeMainDim == YGMeasureModeAtMost &&
-             node->style.overflow == YGOverflowScroll) {
-    node->layout.measuredDimensions[dim[mainAxis]] = fmaxf(
-                                                           fminf(availableInnerMainDim + paddingAndBorderAxisMain,
-                                                                 YGNodeBoundAxisWithinMinAndMax(node, mainAxis, maxLineMainDim, mainAxisParentSize)),
-                                                           paddingAndBorderAxisMain);
+  // STEP 4: COLLECT FLEX ITEMS INTO FLEX LINES
+  YGFloat sizeConsumedOnCurrentLine = 0;
+  YGFloat totalFlexGrowFactors = 0;
+  for (uint32_t i = 0; i < childCount; i++) {
+    const YGLayoutInstruction *const child = &children[i];
+    child->node->lineIndex = 0;
+    sizeConsumedOnCurrentLine +=
+        child->node->layout.computedFlexBasis + child->marginForAxis[mainAxis];
+    totalFlexGrowFactors += child->flexGrow;
   }
 
-  if (measureModeCrossDim == YGMeasureModeUndefined ||
-      (node->style.overflow != YGOverflowScroll && measureModeCrossDim == YGMeasureModeAtMost)) {
-    // Clamp the size to the min/max size, if specified, and make sure it
-    // doesn't go below the padding and border amount.
-    node->layout.measuredDimensions[dim[crossAxis]] =
-    YGNodeBoundAxis(node,
-                    crossAxis,
-                    totalLineCrossDim + paddingAndBorderAxisCross,
-                    crossAxisParentSize,
-                    parentWidth);
-  } else if (measureModeCrossDim == YGMeasureModeAtMost &&
-             node->style.overflow == YGOverflowScroll) {
-    node->layout.measuredDimensions[dim[crossAxis]] =
-    fmaxf(fminf(availableInnerCrossDim + paddingAndBorderAxisCross,
-                YGNodeBoundAxisWithinMinAndMax(node,
-                                               crossAxis,
-                                               totalLineCrossDim + paddingAndBorderAxisCross,
-                                               crossAxisParentSize)),
-          paddingAndBorderAxisCross);
+  // If we don't need to measure the cross axis, we can skip the entire flex step.
+  const bool canSkipFlex = !performLayout && measureModeCrossDim == YGMeasureModeExactly;
+
+  YGFloat leadingMainDim = 0;
+  YGFloat betweenMainDim = 0;
+
+  // STEP 5: RESOLVING FLEXIBLE LENGTHS ON MAIN AXIS
+  YGFloat remainingFreeSpace = 0;
+  if (!YGFloatIsUndefined(availableInnerMainDim)) {
+    remainingFreeSpace = availableInnerMainDim - sizeConsumedOnCurrentLine;
+  } else if (sizeConsumedOnCurrentLine < 0) {
+    remainingFreeSpace = -sizeConsumedOnCurrentLine;
   }
 
-  // As we only wrapped in normal direction yet, we need to reverse the positions on wrap-reverse.
-  if (performLayout && node->style.flexWrap == YGWrapWrapReverse) {
-    for (uint32_t i = 0; i < childCount; i++) {
-      const YGNodeRef child = YGNodeGetChild(node, i);
-      if (child->style.positionType == YGPositionTypeRelative) {
-        child->layout.position[pos[crossAxis]] = node->layout.measuredDimensions[dim[crossAxis]] -
-        child->layout.position[pos[crossAxis]] -
-        child->layout.measuredDimensions[dim[crossAxis]];
+  const YGFloat originalRemainingFreeSpace = remainingFreeSpace;
+  YGFloat deltaFreeSpace = 0;
+
+  if (!canSkipFlex) {
+    // First pass: freeze the growing items that end up below their padding and border.
+    if (remainingFreeSpace > 0) {
+      YGFloat deltaFlexGrowFactors = 0;
+      for (uint32_t i = 0; i < childCount; i++) {
+        const YGLayoutInstruction *const child = &children[i];
+        if (child->flexGrow != 0) {
+          const YGFloat childFlexBasis = child->node->layout.computedFlexBasis;
+          const YGFloat baseMainSize =
+              childFlexBasis + remainingFreeSpace / totalFlexGrowFactors * child->flexGrow;
+          const YGFloat boundMainSize =
+              YGFloatMax(baseMainSize, child->paddingAndBorderForAxis[mainAxis]);
+          if (baseMainSize != boundMainSize) {
+            deltaFreeSpace -= boundMainSize - childFlexBasis;
+            deltaFlexGrowFactors -= child->flexGrow;
+          }
+        }
       }
+      totalFlexGrowFactors += deltaFlexGrowFactors;
+      remainingFreeSpace += deltaFreeSpace;
     }
-  }
 
-  if (performLayout) {
-    // STEP 10: SIZING AND POSITIONING ABSOLUTE CHILDREN
-    for (currentAbsoluteChild = firstAbsoluteChild; currentAbsoluteChild != NULL;
-         currentAbsoluteChild = currentAbsoluteChild->nextChild) {
-      YGNodeAbsoluteLayoutChild(node,
-                                currentAbsoluteChild,
+    // Second pass: resolve the sizes of the flexible items.
+    deltaFreeSpace = 0;
+    for (uint32_t i = 0; i < childCount; i++) {
+      const YGLayoutInstruction *const child = &children[i];
+      const YGFloat childFlexBasis = child->node->layout.computedFlexBasis;
+      YGFloat updatedMainSize = childFlexBasis;
+      if (remainingFreeSpace > 0 && child->flexGrow != 0) {
+        updatedMainSize =
+            YGFloatMax(childFlexBasis + remainingFreeSpace / totalFlexGrowFactors * child->flexGrow,
+                       child->paddingAndBorderForAxis[mainAxis]);
+      }
+      deltaFreeSpace -= updatedMainSize - childFlexBasis;
+
+      const YGFloat childMainSize = updatedMainSize + child->marginForAxis[mainAxis];
+      const bool isCrossDimDefined = !YGFloatIsUndefined(child->dimensions[crossDimension]);
+      YGFloat childCrossSize;
+      YGMeasureMode childCrossMeasureMode;
+      if (!YGFloatIsUndefined(availableInnerCrossDim) && !isCrossDimDefined &&
+          measureModeCrossDim == YGMeasureModeExactly && child->align == YGAlignStretch) {
+        childCrossSize = availableInnerCrossDim;
+        childCrossMeasureMode = YGMeasureModeExactly;
+      } else if (!isCrossDimDefined) {
+        childCrossSize = availableInnerCrossDim;
+        childCrossMeasureMode =
+            YGFloatIsUndefined(childCrossSize) ? YGMeasureModeUndefined : YGMeasureModeAtMost;
+      } else {
+        childCrossSize = child->dimensions[crossDimension] + child->marginForAxis[crossAxis];
+        childCrossMeasureMode = YGMeasureModeExactly;
+      }
+
+      const bool requiresStretchLayout = !isCrossDimDefined && child->align == YGAlignStretch;
+
+      YGLayoutProgramLayoutNode(program,
+                                firstChild + i,
+                                isMainAxisRow ? childMainSize : childCrossSize,
+                                isMainAxisRow ? childCrossSize : childMainSize,
+                                direction,
+                                isMainAxisRow ? YGMeasureModeExactly : childCrossMeasureMode,
+                                isMainAxisRow ? childCrossMeasureMode : YGMeasureModeExactly,
                                 availableInnerWidth,
-                                widthMeasureMode,
                                 availableInnerHeight,
-                                direction);
+                                performLayout && !requiresStretchLayout,
+                                "flex");
     }
+  }
 
-    // STEP 11: SETTING TRAILING POSITIONS FOR CHILDREN
-    const bool needsMainTrailingPos =
-    mainAxis == YGFlexDirectionRowReverse || mainAxis == YGFlexDirectionColumnReverse;
-    const bool needsCrossTrailingPos =
-    crossAxis == YGFlexDirectionRowReverse || crossAxis == YGFlexDirectionColumnReverse;
+  remainingFreeSpace = originalRemainingFreeSpace + deltaFreeSpace;
 
-    // Set trailing position if necessary.
-    if (needsMainTrailingPos || needsCrossTrailingPos) {
-      for (uint32_t i = 0; i < childCount; i++) {
-        const YGNodeRef child = YGNodeListGet(node->children, i);
-        if (child->style.display == YGDisplayNone) {
-          continue;
-        }
-        if (needsMainTrailingPos) {
-          YGNodeSetChildTrailingPosition(node, child, mainAxis);
-        }
+  // STEP 6: MAIN-AXIS JUSTIFICATION & CROSS-AXIS SIZE DETERMINATION
+  if (measureModeMainDim == YGMeasureModeAtMost && remainingFreeSpace > 0) {
+    remainingFreeSpace = 0;
+  }
 
-        if (needsCrossTrailingPos) {
-          YGNodeSetChildTrailingPosition(node, child, crossAxis);
-        }
+  switch (instruction->justifyContent) {
+    case YGJustifyCenter:
+      leadingMainDim = remainingFreeSpace / 2;
+      break;
+    case YGJustifyFlexEnd:
+      leadingMainDim = remainingFreeSpace;
+      break;
+    case YGJustifySpaceBetween:
+      if (childCount > 1) {
+        betweenMainDim = YGFloatMax(remainingFreeSpace, 0) / (childCount - 1);
       }
-    }
+      break;
+    case YGJustifySpaceAround:
+      betweenMainDim = remainingFreeSpace / childCount;
+      leadingMainDim = betweenMainDim / 2;
+      break;
+    case YGJustifyFlexStart:
+      break;
   }
-}
 
-uint32_t gDepth = 0;
-bool gPrintTree = false;
-bool gPrintChanges = false;
-bool gPrintSkips = false;
+  YGFloat mainDim = leadingPaddingAndBorderMain + leadingMainDim;
+  YGFloat crossDim = 0;
 
-static const char *spacer = "                                                            ";
+  for (uint32_t i = 0; i < childCount; i++) {
+    const YGLayoutInstruction *const child = &children[i];
+    YGLayout *const childLayout = &child->node->layout;
+    if (performLayout) {
+      childLayout->position[pos[mainAxis]] += mainDim;
+    }
 
-static const char *YGSpacer(const unsigned long level) {
-  const size_t spacerLen = strlen(spacer);
-  if (level > spacerLen) {
-    return &spacer[0];
-  } else {
-    return &spacer[spacerLen - level];
+    if (canSkipFlex) {
+      mainDim +=
+          betweenMainDim + child->marginForAxis[mainAxis] + childLayout->computedFlexBasis;
+      crossDim = availableInnerCrossDim;
+    } else {
+      mainDim += betweenMainDim + YGLayoutInstructionDimWithMargin(child, mainAxis);
+      crossDim = YGFloatMax(crossDim, YGLayoutInstructionDimWithMargin(child, crossAxis));
+    }
   }
-}
 
-static const char *YGMeasureModeName(const YGMeasureMode mode, const bool performLayout) {
-  const char *kMeasureModeNames[YGMeasureModeCount] = {"UNDEFINED", "EXACTLY", "AT_MOST"};
-  const char *kLayoutModeNames[YGMeasureModeCount] = {"LAY_UNDEFINED",
-    "LAY_EXACTLY",
-    "LAY_AT_"
-    "MOST"};
+  mainDim += trailingPaddingAndBorderMain;
 
-  if (mode >= YGMeasureModeCount) {
-    return "";
-  }
+  YGFloat containerCrossAxis = availableInnerCrossDim;
+  if (measureModeCrossDim == YGMeasureModeUndefined ||
+      measureModeCrossDim == YGMeasureModeAtMost) {
+    containerCrossAxis =
+        YGFloatMax(crossDim + paddingAndBorderAxisCross, paddingAndBorderAxisCross) -
+        paddingAndBorderAxisCross;
 
-  return performLayout ? kLayoutModeNames[mode] : kMeasureModeNames[mode];
-}
+    if (measureModeCrossDim == YGMeasureModeAtMost) {
+      containerCrossAxis = YGFloatMin(containerCrossAxis, availableInnerCrossDim);
+    }
+  }
 
-static inline bool YGMeasureModeSizeIsExactAndMatchesOldMeasuredSize(YGMeasureMode sizeMode,
-                                                                     float size,
-                                                                     float lastComputedSize) {
-  return sizeMode == YGMeasureModeExactly && YGFloatsEqual(size, lastComputedSize);
-}
+  if (measureModeCrossDim == YGMeasureModeExactly) {
+    crossDim = availableInnerCrossDim;
+  }
 
-static inline bool YGMeasureModeOldSizeIsUnspecifiedAndStillFits(YGMeasureMode sizeMode,
-                                                                 float size,
-                                                                 YGMeasureMode lastSizeMode,
-                                                                 float lastComputedSize) {
-  return sizeMode == YGMeasureModeAtMost && lastSizeMode == YGMeasureModeUndefined &&
-  (size >= lastComputedSize || YGFloatsEqual(size, lastComputedSize));
-}
+  crossDim = YGFloatMax(crossDim + paddingAndBorderAxisCross, paddingAndBorderAxisCross) -
+             paddingAndBorderAxisCross;
 
-static inline bool YGMeasureModeNewMeasureSizeIsStricterAndStillValid(YGMeasureMode sizeMode,
-                                                                      float size,
-                                                                      YGMeasureMode lastSizeMode,
-                                                                      float lastSize,
-                                                                      float lastComputedSize) {
-  return lastSizeMode == YGMeasureModeAtMost && sizeMode == YGMeasureModeAtMost &&
-  lastSize > size && (lastComputedSize <= size || YGFloatsEqual(size, lastComputedSize));
-}
+  // STEP 7: CROSS-AXIS ALIGNMENT
+  if (performLayout) {
+    for (uint32_t i = 0; i < childCount; i++) {
+      const YGLayoutInstruction *const child = &children[i];
+      YGLayout *const childLayout = &child->node->layout;
+      YGFloat leadingCrossDim = leadingPaddingAndBorderCross;
+
+      if (child->align == YGAlignStretch) {
+        if (YGFloatIsUndefined(child->dimensions[crossDimension])) {
+          const YGFloat childMainSize =
+              childLayout->measuredDimensions[mainDimension] + child->marginForAxis[mainAxis];
+          const YGFloat childWidth = isMainAxisRow ? childMainSize : crossDim;
+          const YGFloat childHeight = !isMainAxisRow ? childMainSize : crossDim;
+
+          YGLayoutProgramLayoutNode(program,
+                                    firstChild + i,
+                                    childWidth,
+                                    childHeight,
+                                    direction,
+                                    YGFloatIsUndefined(childWidth) ? YGMeasureModeUndefined
+                                                                   : YGMeasureModeExactly,
+                                    YGFloatIsUndefined(childHeight) ? YGMeasureModeUndefined
+                                                                    : YGMeasureModeExactly,
+                                    availableInnerWidth,
+                                    availableInnerHeight,
+                                    true,
+                                    "stretch");
+        }
+      } else {
+        const YGFloat remainingCrossDim =
+            containerCrossAxis - YGLayoutInstructionDimWithMargin(child, crossAxis);
 
-bool YGNodeCanUseCachedMeasurement(const YGMeasureMode widthMode,
-                                   const float width,
-                                   const YGMeasureMode heightMode,
-                                   const float height,
-                                   const YGMeasureMode lastWidthMode,
-                                   const float lastWidth,
-                                   const YGMeasureMode lastHeightMode,
-                                   const float lastHeight,
-                                   const float lastComputedWidth,
-                                   const float lastComputedHeight,
-                                   const float marginRow,
-                                   const float marginColumn) {
-  if (lastComputedHeight < 0 || lastComputedWidth < 0) {
-    return false;
+        if (child->align == YGAlignFlexStart) {
+          // No-Op
+        } else if (child->align == YGAlignCenter) {
+          leadingCrossDim += remainingCrossDim / 2;
+        } else {
+          leadingCrossDim += remainingCrossDim;
+        }
+      }
+      childLayout->position[pos[crossAxis]] += leadingCrossDim;
+    }
   }
 
-  const bool hasSameWidthSpec = lastWidthMode == widthMode && YGFloatsEqual(lastWidth, width);
-  const bool hasSameHeightSpec = lastHeightMode == heightMode && YGFloatsEqual(lastHeight, height);
+  // STEP 9: COMPUTING FINAL DIMENSIONS
+  layout->measuredDimensions[YGDimensionWidth] =
+      YGFloatMax(availableWidth - marginAxisRow,
+                 instruction->paddingAndBorderForAxis[YGFlexDirectionRow]);
+  layout->measuredDimensions[YGDimensionHeight] =
+      YGFloatMax(availableHeight - marginAxisColumn,
+                 instruction->paddingAndBorderForAxis[YGFlexDirectionColumn]);
+
+  if (measureModeMainDim == YGMeasureModeUndefined || measureModeMainDim == YGMeasureModeAtMost) {
+    layout->measuredDimensions[mainDimension] =
+        YGFloatMax(YGFloatMax(0, mainDim), paddingAndBorderAxisMain);
+  }
 
-  const bool widthIsCompatible =
-  hasSameWidthSpec || YGMeasureModeSizeIsExactAndMatchesOldMeasuredSize(widthMode,
-                                                                        width - marginRow,
-                                                                        lastComputedWidth) ||
-  YGMeasureModeOldSizeIsUnspecifiedAndStillFits(widthMode,
-                                                width - marginRow,
-                                                lastWidthMode,
-                                                lastComputedWidth) ||
-  YGMeasureModeNewMeasureSizeIsStricterAndStillValid(
-                                                     widthMode, width - marginRow, lastWidthMode, lastWidth, lastComputedWidth);
+  if (measureModeCrossDim == YGMeasureModeUndefined ||
+      measureModeCrossDim == YGMeasureModeAtMost) {
+    layout->measuredDimensions[crossDimension] =
+        YGFloatMax(crossDim + paddingAndBorderAxisCross, paddingAndBorderAxisCross);
+  }
 
-  const bool heightIsCompatible =
-  hasSameHeightSpec || YGMeasureModeSizeIsExactAndMatchesOldMeasuredSize(heightMode,
-                                                                         height - marginColumn,
-                                                                         lastComputedHeight) ||
-  YGMeasureModeOldSizeIsUnspecifiedAndStillFits(heightMode,
-                                                height - marginColumn,
-                                                lastHeightMode,
-                                                lastComputedHeight) ||
-  YGMeasureModeNewMeasureSizeIsStricterAndStillValid(
-                                                     heightMode, height - marginColumn, lastHeightMode, lastHeight, lastComputedHeight);
+  // STEP 11: SETTING TRAILING POSITIONS FOR CHILDREN
+  if (performLayout) {
+    const bool needsMainTrailingPos =
+        mainAxis == YGFlexDirectionRowReverse || mainAxis == YGFlexDirectionColumnReverse;
+    const bool needsCrossTrailingPos =
+        crossAxis == YGFlexDirectionRowReverse || crossAxis == YGFlexDirectionColumnReverse;
 
-  return widthIsCompatible && heightIsCompatible;
+    if (needsMainTrailingPos || needsCrossTrailingPos) {
+      for (uint32_t i = 0; i < childCount; i++) {
+        const YGNodeRef child = children[i].node;
+        if (needsMainTrailingPos) {
+          YGNodeSetChildTrailingPosition(node, child, mainAxis);
+        }
+        if (needsCrossTrailingPos) {
+          YGNodeSetChildTrailingPosition(node, child, crossAxis);
+        }
+      }
+    }
+  }
 }
 
-//
-// This is a wrapper around the YGNodelayoutImpl function. It determines
-// whether the layout request is redundant and can be skipped.
-//
-// Parameters:
-//  Input parameters are the same as YGNodelayoutImpl (see above)
-//  Return parameter is true if layout was performed, false if skipped
-//
-bool YGLayoutNodeInternal(const YGNodeRef node,
-                          const float availableWidth,
-                          const float availableHeight,
-                          const YGDirection parentDirection,
-                          const YGMeasureMode widthMeasureMode,
-                          const YGMeasureMode heightMeasureMode,
-                          const float parentWidth,
-                          const float parentHeight,
-                          const bool performLayout,
-                          const char *reason) {
-  YGLayout *layout = &node->layout;
-
-  gDepth++;
+// YGLayoutNodeInternal for compiled nodes. Containers share the caches of the engine, so a
+// program and YGNodeCalculateLayout can take turns on the same tree; leaves go through the
+// engine itself.
+static void YGLayoutProgramLayoutNode(const YGLayoutProgramRef program,
+                                      const uint32_t index,
+                                      const YGFloat availableWidth,
+                                      const YGFloat availableHeight,
+                                      const YGDirection parentDirection,
+                                      const YGMeasureMode widthMeasureMode,
+                                      const YGMeasureMode heightMeasureMode,
+                                      const YGFloat parentWidth,
+                                      const YGFloat parentHeight,
+                                      const bool performLayout,
+                                      const char *reason) {
+  const YGLayoutInstruction *const instruction = &program->instructions[index];
+  const YGNodeRef node = instruction->node;
+  if (instruction->childCount == 0) {
+    YGLayoutNodeInternal(node,
+                         availableWidth,
+                         availableHeight,
+                         parentDirection,
+                         widthMeasureMode,
+                         heightMeasureMode,
+                         parentWidth,
+                         parentHeight,
+                         performLayout,
+                         reason);
+    return;
+  }
 
+  YGLayout *const layout = &node->layout;
   const bool needToVisitNode =
-  (node->isDirty && layout->generationCount != gCurrentGenerationCount) ||
-  layout->lastParentDirection != parentDirection;
+      (node->isDirty && !node->cachesWarm &&
+       layout->generationCount != gCurrentGenerationCount) ||
+      layout->lastParentDirection != parentDirection;
 
   if (needToVisitNode) {
     // Invalidate the cached results.
@@ -3037,73 +8623,35 @@ bool YGLayoutNodeInternal(const YGNodeRef node,
     layout->cachedLayout.heightMeasureMode = (YGMeasureMode) -1;
     layout->cachedLayout.computedWidth = -1;
     layout->cachedLayout.computedHeight = -1;
+    if (node->layoutCache) {
+      node->layoutCache->count = 0;
+      node->layoutCache->next = 0;
+    }
   }
 
+  // A layout that still has to reach a dirty boundary or position deferred children is done
+  // again, which gets there through the caches of everything else.
   YGCachedMeasurement *cachedResults = NULL;
-
-  // Determine whether the results are already cached. We maintain a separate
-  // cache for layouts and measurements. A layout operation modifies the
-  // positions
-  // and dimensions for nodes in the subtree. The algorithm assumes that each
-  // node
-  // gets layed out a maximum of one time per tree layout, but multiple
-  // measurements
-  // may be required to resolve all of the flex dimensions.
-  // We handle nodes with measure functions specially here because they are the
-  // most
-  // expensive to measure, so it's worth avoiding redundant measurements if at
-  // all possible.
-  if (node->measure) {
-    const float marginAxisRow = YGNodeMarginForAxis(node, YGFlexDirectionRow, parentWidth);
-    const float marginAxisColumn = YGNodeMarginForAxis(node, YGFlexDirectionColumn, parentWidth);
-
-    // First, try to use the layout cache.
-    if (YGNodeCanUseCachedMeasurement(widthMeasureMode,
-                                      availableWidth,
-                                      heightMeasureMode,
-                                      availableHeight,
-                                      layout->cachedLayout.widthMeasureMode,
-                                      layout->cachedLayout.availableWidth,
-                                      layout->cachedLayout.heightMeasureMode,
-                                      layout->cachedLayout.availableHeight,
-                                      layout->cachedLayout.computedWidth,
-                                      layout->cachedLayout.computedHeight,
-                                      marginAxisRow,
-                                      marginAxisColumn)) {
-      cachedResults = &layout->cachedLayout;
-    } else {
-      // Try to use the measurement cache.
-      for (uint32_t i = 0; i < layout->nextCachedMeasurementsIndex; i++) {
-        if (YGNodeCanUseCachedMeasurement(widthMeasureMode,
-                                          availableWidth,
-                                          heightMeasureMode,
-                                          availableHeight,
-                                          layout->cachedMeasurements[i].widthMeasureMode,
-                                          layout->cachedMeasurements[i].availableWidth,
-                                          layout->cachedMeasurements[i].heightMeasureMode,
-                                          layout->cachedMeasurements[i].availableHeight,
-                                          layout->cachedMeasurements[i].computedWidth,
-                                          layout->cachedMeasurements[i].computedHeight,
-                                          marginAxisRow,
-                                          marginAxisColumn)) {
-          cachedResults = &layout->cachedMeasurements[i];
-          break;
-        }
-      }
-    }
-  } else if (performLayout) {
-    if (YGFloatsEqual(layout->cachedLayout.availableWidth, availableWidth) &&
-        YGFloatsEqual(layout->cachedLayout.availableHeight, availableHeight) &&
-        layout->cachedLayout.widthMeasureMode == widthMeasureMode &&
-        layout->cachedLayout.heightMeasureMode == heightMeasureMode) {
+  YGCachedLayoutEntry *cachedLayoutEntry = NULL;
+  if (performLayout) {
+    if (!node->hasDirtyDescendant && !node->extras->layoutDeferred &&
+        YGCachedMeasurementMatches(&layout->cachedLayout,
+                                   availableWidth,
+                                   availableHeight,
+                                   widthMeasureMode,
+                                   heightMeasureMode)) {
       cachedResults = &layout->cachedLayout;
+    } else if (!needToVisitNode) {
+      cachedLayoutEntry = YGLayoutCacheFind(
+          node, availableWidth, availableHeight, widthMeasureMode, heightMeasureMode);
     }
   } else {
     for (uint32_t i = 0; i < layout->nextCachedMeasurementsIndex; i++) {
-      if (YGFloatsEqual(layout->cachedMeasurements[i].availableWidth, availableWidth) &&
-          YGFloatsEqual(layout->cachedMeasurements[i].availableHeight, availableHeight) &&
-          layout->cachedMeasurements[i].widthMeasureMode == widthMeasureMode &&
-          layout->cachedMeasurements[i].heightMeasureMode == heightMeasureMode) {
+      if (YGCachedMeasurementMatches(&layout->cachedMeasurements[i],
+                                     availableWidth,
+                                     availableHeight,
+                                     widthMeasureMode,
+                                     heightMeasureMode)) {
         cachedResults = &layout->cachedMeasurements[i];
         break;
       }
@@ -3113,180 +8661,117 @@ bool YGLayoutNodeInternal(const YGNodeRef node,
   if (!needToVisitNode && cachedResults != NULL) {
     layout->measuredDimensions[YGDimensionWidth] = cachedResults->computedWidth;
     layout->measuredDimensions[YGDimensionHeight] = cachedResults->computedHeight;
-
-    if (gPrintChanges && gPrintSkips) {
-      printf("%s%d.{[skipped] ", YGSpacer(gDepth), gDepth);
-      if (node->print) {
-        node->print(node);
-      }
-      printf("wm: %s, hm: %s, aw: %f ah: %f => d: (%f, %f) %s\n",
-             YGMeasureModeName(widthMeasureMode, performLayout),
-             YGMeasureModeName(heightMeasureMode, performLayout),
-             availableWidth,
-             availableHeight,
-             cachedResults->computedWidth,
-             cachedResults->computedHeight,
-             reason);
-    }
+    layout->availableRange = cachedResults->range;
+  } else if (cachedLayoutEntry != NULL) {
+    YGLayoutCacheRestore(node, cachedLayoutEntry);
+    layout->cachedLayout = cachedLayoutEntry->measurement;
+    layout->availableRange = cachedLayoutEntry->measurement.range;
   } else {
-    if (gPrintChanges) {
-      printf("%s%d.{%s", YGSpacer(gDepth), gDepth, needToVisitNode ? "*" : "");
-      if (node->print) {
-        node->print(node);
-      }
-      printf("wm: %s, hm: %s, aw: %f ah: %f %s\n",
-             YGMeasureModeName(widthMeasureMode, performLayout),
-             YGMeasureModeName(heightMeasureMode, performLayout),
-             availableWidth,
-             availableHeight,
-             reason);
-    }
-
-    YGNodelayoutImpl(node,
-                     availableWidth,
-                     availableHeight,
-                     parentDirection,
-                     widthMeasureMode,
-                     heightMeasureMode,
-                     parentWidth,
-                     parentHeight,
-                     performLayout);
-
-    if (gPrintChanges) {
-      printf("%s%d.}%s", YGSpacer(gDepth), gDepth, needToVisitNode ? "*" : "");
-      if (node->print) {
-        node->print(node);
-      }
-      printf("wm: %s, hm: %s, d: (%f, %f) %s\n",
-             YGMeasureModeName(widthMeasureMode, performLayout),
-             YGMeasureModeName(heightMeasureMode, performLayout),
-             layout->measuredDimensions[YGDimensionWidth],
-             layout->measuredDimensions[YGDimensionHeight],
-             reason);
-    }
+    YGLayoutProgramLayoutImpl(program,
+                              instruction,
+                              availableWidth,
+                              availableHeight,
+                              widthMeasureMode,
+                              heightMeasureMode,
+                              performLayout);
 
     layout->lastParentDirection = parentDirection;
+    // Programs do not track what their layouts depend on.
+    layout->availableRange = YGAvailableRangePoint(availableWidth, availableHeight);
 
-    if (cachedResults == NULL) {
-      if (layout->nextCachedMeasurementsIndex == YG_MAX_CACHED_RESULT_COUNT) {
-        if (gPrintChanges) {
-          printf("Out of cache entries!\n");
-        }
-        layout->nextCachedMeasurementsIndex = 0;
-      }
-
-      YGCachedMeasurement *newCacheEntry;
-      if (performLayout) {
-        // Use the single layout cache entry.
-        newCacheEntry = &layout->cachedLayout;
-      } else {
-        // Allocate a new measurement cache entry.
-        newCacheEntry = &layout->cachedMeasurements[layout->nextCachedMeasurementsIndex];
-        layout->nextCachedMeasurementsIndex++;
-      }
+    if (layout->nextCachedMeasurementsIndex == YG_MAX_CACHED_RESULT_COUNT) {
+      layout->nextCachedMeasurementsIndex = 0;
+    }
+    YGCachedMeasurement *const newCacheEntry =
+        performLayout ? &layout->cachedLayout
+                      : &layout->cachedMeasurements[layout->nextCachedMeasurementsIndex++];
+    newCacheEntry->availableWidth = availableWidth;
+    newCacheEntry->availableHeight = availableHeight;
+    newCacheEntry->widthMeasureMode = widthMeasureMode;
+    newCacheEntry->heightMeasureMode = heightMeasureMode;
+    newCacheEntry->computedWidth = layout->measuredDimensions[YGDimensionWidth];
+    newCacheEntry->computedHeight = layout->measuredDimensions[YGDimensionHeight];
+    newCacheEntry->range = layout->availableRange;
 
-      newCacheEntry->availableWidth = availableWidth;
-      newCacheEntry->availableHeight = availableHeight;
-      newCacheEntry->widthMeasureMode = widthMeasureMode;
-      newCacheEntry->heightMeasureMode = heightMeasureMode;
-      newCacheEntry->computedWidth = layout->measuredDimensions[YGDimensionWidth];
-      newCacheEntry->computedHeight = layout->measuredDimensions[YGDimensionHeight];
+    if (performLayout) {
+      YGLayoutCacheStore(
+          node, availableWidth, availableHeight, widthMeasureMode, heightMeasureMode);
     }
   }
 
   if (performLayout) {
-    node->layout.dimensions[YGDimensionWidth] = node->layout.measuredDimensions[YGDimensionWidth];
-    node->layout.dimensions[YGDimensionHeight] = node->layout.measuredDimensions[YGDimensionHeight];
-    node->hasNewLayout = true;
+    layout->lastLayoutRequest = (YGLayoutRequest){
+        .availableWidth = availableWidth,
+        .availableHeight = availableHeight,
+        .widthMeasureMode = widthMeasureMode,
+        .heightMeasureMode = heightMeasureMode,
+        .parentWidth = parentWidth,
+        .parentHeight = parentHeight,
+        .parentDirection = parentDirection,
+        .generationCount = gCurrentGenerationCount,
+    };
+    layout->dimensions[YGDimensionWidth] = layout->measuredDimensions[YGDimensionWidth];
+    layout->dimensions[YGDimensionHeight] = layout->measuredDimensions[YGDimensionHeight];
+    YGNodeSetNewLayout(node);
     node->isDirty = false;
+    node->hasDirtyDescendant = false;
+    if (node->extras->layoutDeferred) {
+      node->extras->layoutDeferred = false;
+      gDeferredLayoutCount--;
+    }
   }
 
-  gDepth--;
   layout->generationCount = gCurrentGenerationCount;
-  return (needToVisitNode || cachedResults == NULL);
 }
 
-static void YGRoundToPixelGrid(const YGNodeRef node) {
-  const float fractialLeft =
-  node->layout.position[YGEdgeLeft] - floorf(node->layout.position[YGEdgeLeft]);
-  const float fractialTop =
-  node->layout.position[YGEdgeTop] - floorf(node->layout.position[YGEdgeTop]);
-  node->layout.dimensions[YGDimensionWidth] =
-  roundf(fractialLeft + node->layout.dimensions[YGDimensionWidth]) - roundf(fractialLeft);
-  node->layout.dimensions[YGDimensionHeight] =
-  roundf(fractialTop + node->layout.dimensions[YGDimensionHeight]) - roundf(fractialTop);
-
-  node->layout.position[YGEdgeLeft] = roundf(node->layout.position[YGEdgeLeft]);
-  node->layout.position[YGEdgeTop] = roundf(node->layout.position[YGEdgeTop]);
-
-  const uint32_t childCount = YGNodeListCount(node->children);
-  for (uint32_t i = 0; i < childCount; i++) {
-    YGRoundToPixelGrid(YGNodeGetChild(node, i));
+bool YGLayoutProgramRun(const YGLayoutProgramRef program,
+                        const float availableWidth,
+                        const float availableHeight) {
+  const YGNodeRef root = program->root;
+  if (root == NULL) {
+    return false;
   }
-}
-
-void YGNodeCalculateLayout(const YGNodeRef node,
-                           const float availableWidth,
-                           const float availableHeight,
-                           const YGDirection parentDirection) {
-  // Increment the generation count. This will force the recursive routine to
-  // visit
-  // all dirty nodes at least once. Subsequent visits will be skipped if the
-  // input
-  // parameters don't change.
-  gCurrentGenerationCount++;
 
-  float width = availableWidth;
-  float height = availableHeight;
-  YGMeasureMode widthMeasureMode = YGMeasureModeUndefined;
-  YGMeasureMode heightMeasureMode = YGMeasureModeUndefined;
-
-  YGResolveDimensions(node);
-
-  if (!YGFloatIsUndefined(width)) {
-    widthMeasureMode = YGMeasureModeExactly;
-  } else if (YGNodeIsStyleDimDefined(node, YGFlexDirectionRow, availableWidth)) {
-    width = YGValueResolve(node->resolvedDimensions[dim[YGFlexDirectionRow]], availableWidth) +
-    YGNodeMarginForAxis(node, YGFlexDirectionRow, availableWidth);
-    widthMeasureMode = YGMeasureModeExactly;
-  } else if (YGValueResolve(&node->style.maxDimensions[YGDimensionWidth], availableWidth) >= 0.0f) {
-    width = YGValueResolve(&node->style.maxDimensions[YGDimensionWidth], availableWidth);
-    widthMeasureMode = YGMeasureModeAtMost;
-  }
-
-  if (!YGFloatIsUndefined(height)) {
-    heightMeasureMode = YGMeasureModeExactly;
-  } else if (YGNodeIsStyleDimDefined(node, YGFlexDirectionColumn, availableHeight)) {
-    height = YGValueResolve(node->resolvedDimensions[dim[YGFlexDirectionColumn]], availableHeight) +
-    YGNodeMarginForAxis(node, YGFlexDirectionColumn, availableWidth);
-    heightMeasureMode = YGMeasureModeExactly;
-  } else if (YGValueResolve(&node->style.maxDimensions[YGDimensionHeight], availableHeight) >=
-             0.0f) {
-    height = YGValueResolve(&node->style.maxDimensions[YGDimensionHeight], availableHeight);
-    heightMeasureMode = YGMeasureModeAtMost;
+  YGNextGeneration();
+
+  const YGLayoutInstruction *const instruction = &program->instructions[0];
+  YGFloat width = availableWidth;
+  YGFloat height = availableHeight;
+  YGMeasureMode widthMeasureMode = YGMeasureModeExactly;
+  YGMeasureMode heightMeasureMode = YGMeasureModeExactly;
+  if (YGFloatIsUndefined(width)) {
+    width = instruction->dimensions[YGDimensionWidth] +
+            instruction->marginForAxis[YGFlexDirectionRow];
+    widthMeasureMode =
+        YGFloatIsUndefined(width) ? YGMeasureModeUndefined : YGMeasureModeExactly;
+  }
+  if (YGFloatIsUndefined(height)) {
+    height = instruction->dimensions[YGDimensionHeight] +
+             instruction->marginForAxis[YGFlexDirectionColumn];
+    heightMeasureMode =
+        YGFloatIsUndefined(height) ? YGMeasureModeUndefined : YGMeasureModeExactly;
   }
 
-  if (YGLayoutNodeInternal(node,
-                           width,
-                           height,
-                           parentDirection,
-                           widthMeasureMode,
-                           heightMeasureMode,
-                           availableWidth,
-                           availableHeight,
-                           true,
-                           "initia"
-                           "l")) {
-    YGNodeSetPosition(node, node->layout.direction, availableWidth, availableHeight, availableWidth);
+  YGLayoutProgramLayoutNode(program,
+                            0,
+                            width,
+                            height,
+                            program->direction,
+                            widthMeasureMode,
+                            heightMeasureMode,
+                            availableWidth,
+                            availableHeight,
+                            true,
+                            "initial");
 
-    if (YGIsExperimentalFeatureEnabled(YGExperimentalFeatureRounding)) {
-      YGRoundToPixelGrid(node);
-    }
+  memcpy(root->layout.position, instruction->position, sizeof(root->layout.position));
 
-    if (gPrintTree) {
-      YGNodePrint(node, YGPrintOptionsLayout | YGPrintOptionsChildren | YGPrintOptionsStyle);
-    }
+  YGRoundToPixelGrid(root);
+
+  if (gPrintTree) {
+    YGNodePrint(root, YGPrintOptionsLayout | YGPrintOptionsChildren | YGPrintOptionsStyle);
   }
+  return true;
 }
 
 void YGSetLogger(YGLogger logger) {
@@ -3311,7 +8796,7 @@ inline bool YGIsExperimentalFeatureEnabled(YGExperimentalFeature feature) {
 }
 
 void YGSetMemoryFuncs(YGMalloc ygmalloc, YGCalloc yccalloc, YGRealloc ygrealloc, YGFree ygfree) {
-  YG_ASSERT(gNodeInstanceCount == 0, "Cannot set memory functions: all node must be freed first");
+  YG_ASSERT(YG_ATOMIC_LOAD(gNodeInstanceCount) == 0, "Cannot set memory functions: all node must be freed first");
   YG_ASSERT((ygmalloc == NULL && yccalloc == NULL && ygrealloc == NULL && ygfree == NULL) ||
             (ygmalloc != NULL && yccalloc != NULL && ygrealloc != NULL && ygfree != NULL),
             "Cannot set memory functions: functions must be all NULL or Non-NULL");
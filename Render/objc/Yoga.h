@@ -32,6 +32,58 @@ typedef struct YGSize {
   float height;
 } YGSize;
 
+typedef struct YGRect {
+  float x;
+  float y;
+  float width;
+  float height;
+} YGRect;
+
+// Absolute frame of a node, as written by YGNodeExportFrames.
+typedef struct YGFrameRecord {
+  void *context;
+  float x;
+  float y;
+  float width;
+  float height;
+} YGFrameRecord;
+
+// Fields present in an entry of a frame delta stream, see YGNodeEmitFrameDelta.
+typedef enum YGFrameDeltaField {
+  YGFrameDeltaFieldContext = 1 << 0,
+  YGFrameDeltaFieldX = 1 << 1,
+  YGFrameDeltaFieldY = 1 << 2,
+  YGFrameDeltaFieldWidth = 1 << 3,
+  YGFrameDeltaFieldHeight = 1 << 4,
+} YGFrameDeltaField;
+
+// Timing functions for YGFrameInterpolate, matching the CSS keywords of the same names.
+typedef enum YGEasing {
+  YGEasingLinear,
+  YGEasingEase,
+  YGEasingEaseIn,
+  YGEasingEaseOut,
+  YGEasingEaseInOut,
+} YGEasing;
+
+// Counters of a YGLayoutScheduler. Queueing latency runs from the first request for a root to
+// the completion of its layout.
+typedef struct YGLayoutSchedulerStats {
+  uint32_t completedCount;
+  uint32_t coalescedCount;
+  uint32_t deadlineMissCount;
+  uint64_t totalQueueMicros;
+  uint64_t maxQueueMicros;
+} YGLayoutSchedulerStats;
+
+// Destination of one result of YGNodeCalculateLayoutMulti. count receives the number of records
+// the tree needs; only the first capacity of them are written to frames.
+typedef struct YGLayoutResultBuffer {
+  YGFrameRecord *frames;
+  uint32_t capacity;
+  uint32_t count;
+} YGLayoutResultBuffer;
+
 typedef struct YGValue {
   float value;
   YGUnit unit;
@@ -41,13 +93,40 @@ static const YGValue YGValueUndefined = {YGUndefined, YGUnitUndefined};
 static const YGValue YGValueAuto = {YGUndefined, YGUnitAuto};
 
 typedef struct YGNode *YGNodeRef;
+typedef struct YGLayoutProgram *YGLayoutProgramRef;
+typedef struct YGLayoutSession *YGLayoutSessionRef;
+typedef struct YGLayoutScheduler *YGLayoutSchedulerRef;
+typedef struct YGSpeculativeLayout *YGSpeculativeLayoutRef;
+typedef struct YGLayoutCheckpoint *YGLayoutCheckpointRef;
+typedef struct YGMeasureCache *YGMeasureCacheRef;
 typedef YGSize (*YGMeasureFunc)(YGNodeRef node,
 float width,
 YGMeasureMode widthMode,
 float height,
 YGMeasureMode heightMode);
+
+// A single pending leaf measurement, as it would have been passed to the leaf's YGMeasureFunc.
+typedef struct YGMeasureRequest {
+  YGNodeRef node;
+  float width;
+  YGMeasureMode widthMode;
+  float height;
+  YGMeasureMode heightMode;
+} YGMeasureRequest;
+
+// Measures all the pending leaf children of a container in one call. The function must write
+// one result into sizes for every entry of requests.
+typedef void (*YGBatchMeasureFunc)(YGNodeRef node,
+const YGMeasureRequest *requests,
+YGSize *sizes,
+const uint32_t count);
 typedef float (*YGBaselineFunc)(YGNodeRef node, const float width, const float height);
 typedef void (*YGPrintFunc)(YGNodeRef node);
+typedef void (*YGQueryRectFunc)(YGNodeRef node, const YGRect frame, void *data);
+// Data source of a container with virtual children, see YGNodeSetVirtualChildren.
+typedef uint32_t (*YGChildCountFunc)(YGNodeRef node);
+typedef YGNodeRef (*YGChildFunc)(YGNodeRef node, const uint32_t index);
+typedef void (*YGRecycleChildFunc)(YGNodeRef node, YGNodeRef child);
 typedef int (*YGLogger)(YGLogLevel level, const char *format, va_list args);
 
 typedef void *(*YGMalloc)(size_t size);
@@ -70,11 +149,203 @@ WIN_EXPORT YGNodeRef YGNodeGetChild(const YGNodeRef node, const uint32_t index);
 WIN_EXPORT YGNodeRef YGNodeGetParent(const YGNodeRef node);
 WIN_EXPORT uint32_t YGNodeGetChildCount(const YGNodeRef node);
 
+// Lays out only the children of a single-line column or row container that fall within the given
+// viewport, plus half a viewport of overscan on either side. The viewport is measured along the
+// main axis in the container's own coordinates, e.g. its scroll offset and visible length. Children
+// outside of it keep their last layout and count with the main-axis size they last had, or the
+// average size of the children laid out so far; before any was, the first children are measured to
+// get that average. Children are sized by their flex basis only; flex grow and shrink,
+// justification and align-content are not applied. Containers that wrap or have a reverse main axis
+// are laid out in full. Pass YGUndefined as the viewport length to turn virtualization off.
+WIN_EXPORT void YGNodeSetVirtualized(const YGNodeRef node,
+                                     const float viewportStart,
+                                     const float viewportLength);
+
+// Supplies the children of a virtualized container through callbacks instead of YGNodeInsertChild.
+// Layout asks childFunc for the children of the window it lays out, which must be nodes without a
+// parent, and hands the ones leaving the window to recycleFunc when given, so only the window
+// exists as nodes. YGNodeGetChild and the other tree walks see just those, in order. A node handed
+// out is laid out again; below it style setters mark what changed dirty, and only measured leaves
+// whose content changed need YGNodeMarkDirty. Call again when the data changes: the window is
+// recycled and asked for again, the sizes known for the other children keep serving as estimates.
+// Containers that wrap or have a reverse main axis ask for all of their children,
+// YGNodeCalculateLayoutMulti keeps the windows of the last layout. Pass NULL callbacks, or turn
+// virtualization off, to recycle the window and stop.
+WIN_EXPORT void YGNodeSetVirtualChildren(const YGNodeRef node,
+                                         YGChildCountFunc countFunc,
+                                         YGChildFunc childFunc,
+                                         YGRecycleChildFunc recycleFunc);
+
+// Lays out a single-line column or row container incrementally, for feeds that grow at the tail
+// and drop children at the head. While its cross size is exact and its constraints and the
+// children it laid out stay the same, a layout only visits the children appended since the last
+// one and places them after those. Children are sized by their flex basis like in virtualized
+// containers. Containers that wrap or have a reverse main axis are laid out in full.
+WIN_EXPORT void YGNodeSetStreaming(const YGNodeRef node, const bool streaming);
+
+// Detaches the first count children of a streaming container, all of which must have been laid
+// out. The remaining children keep their positions: the extent of the retired ones stays in front
+// of them. The detached nodes belong to the caller.
+WIN_EXPORT void YGNodeRetireChildren(const YGNodeRef node, const uint32_t count);
+
 WIN_EXPORT void YGNodeCalculateLayout(const YGNodeRef node,
                                       const float availableWidth,
                                       const float availableHeight,
                                       const YGDirection parentDirection);
 
+// Lays out a subtree again with the constraints its parent last gave it, without visiting the
+// ancestors. Meant for layout boundaries, nodes with both dimensions in points whose content
+// changes do not dirty their ancestors; for any other node the ancestors stay dirty and the next
+// YGNodeCalculateLayout still reconciles them. Does nothing for a node never laid out.
+WIN_EXPORT void YGNodeCalculateLayoutSubtree(const YGNodeRef node);
+
+// Lays the tree out like YGNodeCalculateLayout but only positions the parts of it whose frames
+// intersect region, given relative to the root. Elsewhere containers sized exactly by their
+// parent are sized but their children wait; they are positioned on first read through the
+// YGNodeLayoutGet* functions or by YGNodeEnsureLayout, which must happen on the same thread.
+WIN_EXPORT void YGNodeCalculateLayoutDeferred(const YGNodeRef node,
+                                              const float availableWidth,
+                                              const float availableHeight,
+                                              const YGDirection parentDirection,
+                                              const YGRect region);
+
+// Positions whatever a deferred layout left pending in the subtree of node.
+WIN_EXPORT void YGNodeEnsureLayout(const YGNodeRef node);
+
+// Lays a tree out in slices so a host can spread a large layout over several frames.
+// YGLayoutBegin only records the request. Each YGLayoutStep works until the budget is spent and
+// returns whether the layout is complete. Steps first measure the tree bottom up, one node at a
+// time, then size it in one pass that finds those measurements, then position the content of
+// containers sized exactly by their parent, one container at a time. A step stops after the first
+// of these units of work that ends past its budget. A unit takes time in proportion to the children
+// of one container, except the sizing pass, which visits the children of every container down to
+// those sized exactly by their parent, and the measurement of a container of exact size with a
+// single flexible child, which measures the content of that child too. A container with thousands
+// of children overruns a small budget. Frames read in between are complete where they are read,
+// pending parts being positioned on first read like with YGNodeCalculateLayoutDeferred.
+// YGLayoutCommit finishes whatever is left and frees the session. The tree must not change until
+// then.
+WIN_EXPORT YGLayoutSessionRef YGLayoutBegin(const YGNodeRef root,
+                                            const float availableWidth,
+                                            const float availableHeight,
+                                            const YGDirection parentDirection);
+WIN_EXPORT bool YGLayoutStep(const YGLayoutSessionRef session, const uint32_t budgetMicros);
+WIN_EXPORT void YGLayoutCommit(const YGLayoutSessionRef session);
+
+// Queue of roots waiting for layout, run a little at a time. Roots with a higher priority go first,
+// then those with the earlier deadline, then the ones requested first. Requesting a root already
+// queued updates its request, keeping the higher priority and the earlier deadline; a layout of it
+// in progress starts over. Roots are laid out in slices (see YGLayoutBegin), so a large one may
+// take several runs. A tree that changes while its layout is in progress must be requested again,
+// and a root must be cancelled before it is freed.
+WIN_EXPORT YGLayoutSchedulerRef YGLayoutSchedulerNew(void);
+WIN_EXPORT void YGLayoutSchedulerFree(const YGLayoutSchedulerRef scheduler);
+WIN_EXPORT void YGLayoutSchedulerEnqueue(const YGLayoutSchedulerRef scheduler,
+                                         const YGNodeRef root,
+                                         const float availableWidth,
+                                         const float availableHeight,
+                                         const YGDirection parentDirection,
+                                         const int32_t priority,
+                                         const uint32_t deadlineMicros);
+WIN_EXPORT void YGLayoutSchedulerCancel(const YGLayoutSchedulerRef scheduler, const YGNodeRef root);
+
+// Lays out queued roots until budgetMicros are spent or the queue is empty, and returns how many
+// roots it completed. At least one slice of work is done per call, and a run ends after the first
+// that ends past the budget, so it overruns the budget by as much as the slices of YGLayoutStep do.
+WIN_EXPORT uint32_t YGLayoutSchedulerRun(const YGLayoutSchedulerRef scheduler,
+                                         const uint32_t budgetMicros);
+WIN_EXPORT uint32_t YGLayoutSchedulerGetQueueLength(const YGLayoutSchedulerRef scheduler);
+WIN_EXPORT YGLayoutSchedulerStats YGLayoutSchedulerGetStats(const YGLayoutSchedulerRef scheduler);
+
+// Lays the tree out with the root sized to its content, no larger than maxWidth and maxHeight
+// (YGUndefined for no limit) unless its own dimensions say otherwise, in one call that reuses the
+// measurements for the layout. For a root without dimensions, max dimensions, margins or
+// percentages in its own style, the frames are those of YGNodeMeasure at most maxWidth and
+// maxHeight followed by YGNodeCalculateLayout at the measured size. Otherwise the root's style
+// resolves against maxWidth and maxHeight in both passes, and a measured root is measured at its
+// max dimensions where YGNodeMeasure measures it at maxWidth and maxHeight and clamps the result.
+WIN_EXPORT void YGNodeCalculateLayoutFitting(const YGNodeRef node,
+                                             const float maxWidth,
+                                             const float maxHeight,
+                                             const YGDirection parentDirection);
+
+// Returns the size the node would have when laid out with the given constraints, without
+// laying it out. Only the measurement caches are filled; positions and the current layout of
+// the tree are left untouched. With YGMeasureModeUndefined the node's own dimension or max
+// dimension is used, as YGNodeCalculateLayout does for an undefined available size.
+WIN_EXPORT YGSize YGNodeMeasure(const YGNodeRef node,
+                                const float width,
+                                const YGMeasureMode widthMode,
+                                const float height,
+                                const YGMeasureMode heightMode);
+
+// Lays the tree out for each of count available sizes and writes the frames of each result, as
+// YGNodeExportFrames would, into the matching entry of outs. Measurements are shared between
+// the sizes. The layout the tree had before the call, including its dirty state, is restored
+// afterwards.
+WIN_EXPORT void YGNodeCalculateLayoutMulti(const YGNodeRef root,
+                                           const YGSize *sizes,
+                                           const uint32_t count,
+                                           const YGDirection parentDirection,
+                                           YGLayoutResultBuffer *outs);
+
+// Lays the tree out ahead of time for sizes it is expected to get, so the layout at one of them
+// is served from the caches, then puts the current layout back, as YGNodeCalculateLayoutMulti
+// does. Meant for idle time: sizes are tried in order until budgetMicros is spent, at least one,
+// and the number warmed is returned. Dirty nodes stay dirty but keep the measurements taken,
+// until they change again. The direction of the last layout is used.
+WIN_EXPORT uint32_t YGNodeWarmup(const YGNodeRef root,
+                                 const YGSize *anticipatedSizes,
+                                 const uint32_t count,
+                                 const uint32_t budgetMicros);
+
+// Lays out the next state of a tree on another thread while the current one stays live.
+// YGSpeculativeLayoutBegin clones the tree under root, or returns NULL when it holds virtualized
+// containers or pending deferred layouts. Apply the pending changes to the clones, found with
+// YGSpeculativeLayoutGetNode, then call YGSpeculativeLayoutCalculate from any one thread: separate
+// trees can be laid out concurrently, measure functions then run on that thread too. Back on the
+// thread owning the live tree, YGSpeculativeLayoutCommit moves the styles and layouts of the
+// clones onto it at once, unless the live tree or the structure of the clone changed meanwhile,
+// and returns whether it did; YGSpeculativeLayoutAbort discards them. Both free the speculation.
+// A root with a parent keeps its position, and its parent is marked dirty if its size changed.
+WIN_EXPORT YGSpeculativeLayoutRef YGSpeculativeLayoutBegin(const YGNodeRef root);
+WIN_EXPORT YGNodeRef YGSpeculativeLayoutGetNode(const YGSpeculativeLayoutRef speculation,
+                                                const YGNodeRef node);
+WIN_EXPORT void YGSpeculativeLayoutCalculate(const YGSpeculativeLayoutRef speculation,
+                                             const float availableWidth,
+                                             const float availableHeight,
+                                             const YGDirection parentDirection);
+WIN_EXPORT bool YGSpeculativeLayoutCommit(const YGSpeculativeLayoutRef speculation);
+WIN_EXPORT void YGSpeculativeLayoutAbort(const YGSpeculativeLayoutRef speculation);
+
+// Saves the styles, dirty flags, layouts and caches of the tree under root, and the dirty flags
+// of its ancestors, in one buffer, or returns NULL when it holds virtualized containers. Trial
+// layouts can then change styles and lay the tree out, and YGLayoutRestore puts back exactly what
+// was saved, so the next trial or the final layout finds the caches as they were. The structure
+// of the tree must not change in between. A checkpoint can be restored any number of times
+// until it is freed.
+WIN_EXPORT YGLayoutCheckpointRef YGLayoutCheckpoint(const YGNodeRef root);
+WIN_EXPORT void YGLayoutRestore(const YGLayoutCheckpointRef checkpoint);
+WIN_EXPORT void YGLayoutCheckpointFree(const YGLayoutCheckpointRef checkpoint);
+
+// Compiles the tree under root into a layout program: its nodes in a flat list with their
+// styles, flex directions and alignments resolved for the given direction. Running the program
+// lays the tree out like YGNodeCalculateLayout but without the generic parts of the algorithm,
+// for screens whose structure and styles stay the same while the available size changes.
+// Returns NULL for trees the program does not cover: anything but point (or content) sizes,
+// grow-only flexing on a single line, relative positioning and flex/stretch/start/center/end
+// alignment. Leaves are measured by the regular engine. Containers only reuse their layouts at
+// the same size, so the engine can be faster for trees of measured text resized often.
+WIN_EXPORT YGLayoutProgramRef YGLayoutProgramNew(const YGNodeRef root, const YGDirection direction);
+WIN_EXPORT void YGLayoutProgramFree(const YGLayoutProgramRef program);
+
+// Lays the compiled tree out for the given available size. Returns false without touching the
+// tree when a style or child of the tree changed after it was compiled; the program then has to
+// be compiled again. Leaf content changes (YGNodeMarkDirty) do not invalidate a program.
+WIN_EXPORT bool YGLayoutProgramRun(const YGLayoutProgramRef program,
+                                   const float availableWidth,
+                                   const float availableHeight);
+
 // Mark a node as dirty. Only valid for nodes with a custom measure function
 // set.
 // YG knows when to mark all other nodes as dirty but because nodes with
@@ -82,10 +353,95 @@ WIN_EXPORT void YGNodeCalculateLayout(const YGNodeRef node,
 // depends on information not known to YG they must perform this dirty
 // marking manually.
 WIN_EXPORT void YGNodeMarkDirty(const YGNodeRef node);
+// Whether the node needs to be laid out again, because it or a node below it changed.
 WIN_EXPORT bool YGNodeIsDirty(const YGNodeRef node);
 
+// Freezes a node that is not going to change, such as a prebuilt embed. Once laid out, a frozen
+// node keeps the size of that layout whatever its parent asks it to fit in, and layout passes
+// neither look into its subtree nor round it again; only its own position follows the parent.
+// Dirtying it or anything inside it lays it out once more, unfreezing lays it out normally.
+// Layout programs do not cover trees with frozen nodes.
+WIN_EXPORT void YGNodeSetFrozen(const YGNodeRef node, const bool frozen);
+WIN_EXPORT bool YGNodeIsFrozen(const YGNodeRef node);
+
+// Leaves with the same measure function and the same non-zero measure key promise to measure
+// the same for the same constraints, whatever their contexts; changing the key marks the leaf
+// dirty. Siblings whose subtrees match in styles, structure and measure keys then share their
+// layouts: once one of them is laid out for some constraints, the others given the same take its
+// layout instead of being laid out, so a grid of identical tiles costs about one tile. Nodes with
+// a baseline function below such a sibling, and children of virtualized containers, are always
+// laid out on their own.
+WIN_EXPORT void YGNodeSetMeasureKey(const YGNodeRef node, const uintptr_t measureKey);
+WIN_EXPORT uintptr_t YGNodeGetMeasureKey(const YGNodeRef node);
+
+// Keeps the measurements of keyed leaves in a memory-mapped file, so the next launch finds them
+// without calling the measure functions. Keys must then identify what is measured across launches,
+// such as a hash of the text and its font. Entries are found by key and constraints alone, not by
+// measure function, whose address changes between launches: leaves measured by different
+// functions must not share keys. The file grows by appending up to maxEntries; when full, it is
+// compacted to half, keeping the entries used since it was opened first. YGMeasureCacheCompact
+// drops all others and syncs the file to disk, for instance before the app goes to the
+// background; closing syncs it too. YGMeasureCacheOpen returns NULL when the file cannot be mapped
+// or another process has it open. YGSetMeasureCache installs a cache, or none, for layouts on the
+// calling thread. A cache serves one thread of one process at a time.
+WIN_EXPORT YGMeasureCacheRef YGMeasureCacheOpen(const char *path, const uint32_t maxEntries);
+WIN_EXPORT void YGMeasureCacheClose(const YGMeasureCacheRef cache);
+WIN_EXPORT void YGMeasureCacheCompact(const YGMeasureCacheRef cache);
+WIN_EXPORT uint32_t YGMeasureCacheGetCount(const YGMeasureCacheRef cache);
+WIN_EXPORT void YGSetMeasureCache(const YGMeasureCacheRef cache);
+
 WIN_EXPORT void YGNodePrint(const YGNodeRef node, const YGPrintOptions options);
 
+// Spatial queries over the last computed layout of a tree. Points and rects are in the root's
+// own coordinate space, i.e. relative to its top-left corner. Every node keeps the bounds of
+// its subtree, refreshed on query for the parts of the tree visited by layout since the last
+// query, so subtrees away from the point or rect are skipped.
+//
+// Returns the deepest node containing the point, preferring later siblings, or NULL.
+WIN_EXPORT YGNodeRef YGNodeHitTest(const YGNodeRef root, const float x, const float y);
+// Calls callback with the frame of every node intersecting rect, in depth-first order.
+WIN_EXPORT void YGNodeQueryRect(const YGNodeRef root,
+                                const YGRect rect,
+                                YGQueryRectFunc callback,
+                                void *data);
+
+// Writes the frame of every node of a laid-out tree into out, in depth-first order. Frames are
+// in the coordinate space of the root's parent, so the root's record holds its own position.
+// Children of a virtualized container are only written for its last window. Returns the number
+// of records the tree needs; only the first capacity of them are written.
+WIN_EXPORT uint32_t YGNodeExportFrames(const YGNodeRef root,
+                                       YGFrameRecord *out,
+                                       const uint32_t capacity);
+
+// Returns the frames of a laid-out tree that changed since the last call for the same root, as
+// a stream a mirror of the YGNodeExportFrames records can be updated with. Nodes are identified
+// by their index in that depth-first order, nodes whose index changed are sent in full,
+// including their context. Subtrees not laid out since the last call are skipped; the
+// hasNewLayout flags are left to the host. The returned bytes are owned by Yoga and stay valid
+// until the next call.
+//
+// The stream is the node count as a uint32_t followed by one entry per changed node: its index
+// as a uint32_t, a uint8_t mask of YGFrameDeltaField, then the context pointer and the x, y,
+// width and height floats present in the mask, in that order and unaligned.
+WIN_EXPORT const uint8_t *YGNodeEmitFrameDelta(const YGNodeRef root, size_t *length);
+// Applies a stream produced by YGNodeEmitFrameDelta to mirror and returns the new node count.
+// Entries past capacity are skipped.
+WIN_EXPORT uint32_t YGFrameDeltaApply(const uint8_t *delta,
+                                      const size_t length,
+                                      YGFrameRecord *mirror,
+                                      const uint32_t capacity);
+
+// Interpolates between two YGNodeExportFrames snapshots of the same tree, writing frameCount
+// intermediate frames of count records each into out, one frame after the other. Frame k is at
+// progress (k + 1) / (frameCount + 1) along the easing curve, so neither snapshot is repeated.
+// Contexts are taken from the to snapshot.
+WIN_EXPORT void YGFrameInterpolate(const YGFrameRecord *from,
+                                   const YGFrameRecord *to,
+                                   const uint32_t count,
+                                   const YGEasing easing,
+                                   const uint32_t frameCount,
+                                   YGFrameRecord *out);
+
 WIN_EXPORT bool YGFloatIsUndefined(const float value);
 
 WIN_EXPORT bool YGNodeCanUseCachedMeasurement(const YGMeasureMode widthMode,
@@ -146,6 +502,11 @@ WIN_EXPORT type YGNodeLayoutGet##name(const YGNodeRef node, const YGEdge edge);
 
 YG_NODE_PROPERTY(void *, Context, context);
 YG_NODE_PROPERTY(YGMeasureFunc, MeasureFunc, measureFunc);
+// Optional, set on a container. When present the leaf children that need measuring while
+// resolving their flex basis or flexible lengths are handed to it together instead of one
+// by one. The leaves keep their own measure functions, which are still used for any
+// measurement outside of those two steps.
+YG_NODE_PROPERTY(YGBatchMeasureFunc, BatchMeasureFunc, batchMeasureFunc);
 YG_NODE_PROPERTY(YGBaselineFunc, BaselineFunc, baselineFunc)
 YG_NODE_PROPERTY(YGPrintFunc, PrintFunc, printFunc);
 YG_NODE_PROPERTY(bool, HasNewLayout, hasNewLayout);
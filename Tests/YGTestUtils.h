@@ -0,0 +1,200 @@
+/** Copyright (c) 2014-present, Facebook, Inc. */
+
+// Helpers shared by the layout core tests: a seeded generator of random trees, a counting
+// measure function and layout comparison.
+
+#ifndef YG_TEST_UTILS_H
+#define YG_TEST_UTILS_H
+
+#if !defined(_MSC_VER) && !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "Yoga.h"
+
+#define YG_TEST_CHECK(condition)                                                      \
+  do {                                                                                \
+    if (!(condition)) {                                                               \
+      fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #condition);   \
+      exit(1);                                                                        \
+    }                                                                                 \
+  } while (0)
+
+static unsigned gYGTestSeed = 12345;
+static int gYGTestMeasureCalls = 0;
+static int gYGTestContext = 0;
+
+static inline unsigned YGTestRandom(void) {
+  gYGTestSeed = gYGTestSeed * 1103515245u + 12345u;
+  return (gYGTestSeed >> 16) & 0x7fff;
+}
+
+// Measures a leaf like wrapping text whose natural size comes from its context.
+static YGSize YGTestMeasure(YGNodeRef node,
+                            float width,
+                            YGMeasureMode widthMode,
+                            float height,
+                            YGMeasureMode heightMode) {
+  (void) height;
+  (void) heightMode;
+  gYGTestMeasureCalls++;
+  const int context = (int) (long) YGNodeGetContext(node);
+  float measuredWidth = 10 + (context % 7) * 13;
+  float measuredHeight = 8 + (context % 5) * 3;
+  if (widthMode != YGMeasureModeUndefined && measuredWidth > width) {
+    measuredHeight *= measuredWidth / (width > 1 ? width : 1);
+    measuredWidth = width;
+  }
+  return (YGSize){.width = measuredWidth, .height = measuredHeight};
+}
+
+// The same seed and context counter build the same tree.
+static YGNodeRef YGTestBuildTree(const int depth) {
+  const YGNodeRef node = YGNodeNew();
+  YGNodeSetContext(node, (void *) (long) (++gYGTestContext));
+  const unsigned r = YGTestRandom();
+  YGNodeStyleSetFlexDirection(node, (YGFlexDirection)(r % 4));
+  YGNodeStyleSetJustifyContent(node, (YGJustify)((r >> 2) % 5));
+  YGNodeStyleSetAlignItems(node, (YGAlign)(1 + (r >> 4) % 5));
+  if ((r >> 7) % 4 == 0) {
+    YGNodeStyleSetFlexWrap(node, YGWrapWrap);
+  }
+  if ((r >> 9) % 3 == 0) {
+    YGNodeStyleSetWidth(node, 20 + YGTestRandom() % 200);
+  }
+  if ((r >> 11) % 3 == 0) {
+    YGNodeStyleSetHeightPercent(node, 10 + YGTestRandom() % 80);
+  }
+  if (YGTestRandom() % 3 == 0) {
+    YGNodeStyleSetFlexGrow(node, 1 + YGTestRandom() % 3);
+  }
+  if (YGTestRandom() % 4 == 0) {
+    YGNodeStyleSetFlexShrink(node, 1);
+  }
+  if (YGTestRandom() % 4 == 0) {
+    YGNodeStyleSetMargin(node, YGEdgeAll, YGTestRandom() % 10);
+  }
+  if (YGTestRandom() % 4 == 0) {
+    YGNodeStyleSetPadding(node, YGEdgeLeft, YGTestRandom() % 10);
+  }
+  if (YGTestRandom() % 9 == 0) {
+    YGNodeStyleSetPositionType(node, YGPositionTypeAbsolute);
+    YGNodeStyleSetPosition(node, YGEdgeTop, YGTestRandom() % 30);
+  }
+  if (YGTestRandom() % 12 == 0) {
+    YGNodeStyleSetDisplay(node, YGDisplayNone);
+  }
+  if (YGTestRandom() % 10 == 0) {
+    YGNodeStyleSetAspectRatio(node, 0.5f + (YGTestRandom() % 4) * 0.5f);
+  }
+  if (YGTestRandom() % 8 == 0) {
+    YGNodeStyleSetMaxWidth(node, 50 + YGTestRandom() % 100);
+  }
+
+  const unsigned childCount = depth > 0 ? YGTestRandom() % 6 : 0;
+  if (childCount == 0) {
+    YGNodeSetMeasureFunc(node, YGTestMeasure);
+    return node;
+  }
+  for (unsigned i = 0; i < childCount; i++) {
+    YGNodeInsertChild(node, YGTestBuildTree(depth - 1), i);
+  }
+  return node;
+}
+
+// Builds count identical trees from the current seed.
+static void YGTestBuildTrees(const int depth, YGNodeRef *const trees, const uint32_t count) {
+  const unsigned seed = gYGTestSeed;
+  const int context = gYGTestContext;
+  for (uint32_t i = 0; i < count; i++) {
+    gYGTestSeed = seed;
+    gYGTestContext = context;
+    trees[i] = YGTestBuildTree(depth);
+  }
+}
+
+// Builds two identical trees from the current seed.
+static void YGTestBuildTreePair(const int depth, YGNodeRef *first, YGNodeRef *second) {
+  const unsigned seed = gYGTestSeed;
+  const int context = gYGTestContext;
+  *first = YGTestBuildTree(depth);
+  const unsigned nextSeed = gYGTestSeed;
+  const int nextContext = gYGTestContext;
+  gYGTestSeed = seed;
+  gYGTestContext = context;
+  *second = YGTestBuildTree(depth);
+  gYGTestSeed = nextSeed;
+  gYGTestContext = nextContext;
+}
+
+static uint32_t YGTestNodeCount(const YGNodeRef node) {
+  uint32_t count = 1;
+  for (uint32_t i = 0; i < YGNodeGetChildCount(node); i++) {
+    count += YGTestNodeCount(YGNodeGetChild(node, i));
+  }
+  return count;
+}
+
+static void YGTestCollectLayout(const YGNodeRef node, float *const out, uint32_t *const count) {
+  out[(*count)++] = YGNodeLayoutGetLeft(node);
+  out[(*count)++] = YGNodeLayoutGetTop(node);
+  out[(*count)++] = YGNodeLayoutGetWidth(node);
+  out[(*count)++] = YGNodeLayoutGetHeight(node);
+  for (uint32_t i = 0; i < YGNodeGetChildCount(node); i++) {
+    YGTestCollectLayout(YGNodeGetChild(node, i), out, count);
+  }
+}
+
+// Whether both trees hold the same frames up to tolerance, reporting the first difference.
+static bool YGTestSameLayoutWithin(const YGNodeRef a, const YGNodeRef b, const float tolerance) {
+  const uint32_t nodeCount = YGTestNodeCount(a);
+  if (nodeCount != YGTestNodeCount(b)) {
+    fprintf(stderr, "node counts differ: %u vs %u\n", nodeCount, YGTestNodeCount(b));
+    return false;
+  }
+  float *const frames = malloc(sizeof(float) * 8 * nodeCount);
+  uint32_t countA = 0, countB = 0;
+  YGTestCollectLayout(a, frames, &countA);
+  YGTestCollectLayout(b, frames + countA, &countB);
+  bool same = true;
+  for (uint32_t i = 0; i < countA && same; i++) {
+    const float x = frames[i], y = frames[countA + i];
+    if (!(x == y || fabsf(x - y) <= tolerance || (isnan(x) && isnan(y)))) {
+      fprintf(stderr, "node %u %s differs: %f vs %f\n",
+              i / 4, (const char *[]){"left", "top", "width", "height"}[i % 4], x, y);
+      same = false;
+    }
+  }
+  free(frames);
+  return same;
+}
+
+// The largest difference between the frames of two trees of the same shape, 0 when they are
+// the same.
+static float YGTestLayoutDifference(const YGNodeRef a, const YGNodeRef b) {
+  const uint32_t nodeCount = YGTestNodeCount(a);
+  float *const frames = malloc(sizeof(float) * 8 * nodeCount);
+  uint32_t countA = 0, countB = 0;
+  YGTestCollectLayout(a, frames, &countA);
+  YGTestCollectLayout(b, frames + countA, &countB);
+  float difference = 0;
+  for (uint32_t i = 0; i < countA; i++) {
+    const float x = frames[i], y = frames[countA + i];
+    if (!(x == y || (isnan(x) && isnan(y)))) {
+      difference = isnan(x) || isnan(y) ? INFINITY : fmaxf(difference, fabsf(x - y));
+    }
+  }
+  free(frames);
+  return difference;
+}
+
+static inline bool YGTestSameLayout(const YGNodeRef a, const YGNodeRef b) {
+  return YGTestSameLayoutWithin(a, b, 0);
+}
+
+#endif
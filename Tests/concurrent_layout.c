@@ -0,0 +1,212 @@
+/** Copyright (c) 2014-present, Facebook, Inc. */
+
+// Separate trees laid out on separate threads: speculative layouts next to the live tree,
+// deferred layouts resolved by the thread owning their tree, and the buffers of exiting threads.
+// Also built against a ThreadSanitizer library where the compiler has one.
+
+#include <pthread.h>
+
+#include "YGTestUtils.h"
+
+#define THREAD_COUNT 4
+#define ROUNDS 20
+
+static long gLiveAllocations = 0;
+
+static void *countingMalloc(size_t size) {
+  __atomic_add_fetch(&gLiveAllocations, 1, __ATOMIC_RELAXED);
+  return malloc(size);
+}
+
+static void *countingCalloc(size_t count, size_t size) {
+  __atomic_add_fetch(&gLiveAllocations, 1, __ATOMIC_RELAXED);
+  return calloc(count, size);
+}
+
+static void *countingRealloc(void *pointer, size_t size) {
+  if (pointer == NULL) {
+    __atomic_add_fetch(&gLiveAllocations, 1, __ATOMIC_RELAXED);
+  }
+  return realloc(pointer, size);
+}
+
+static void countingFree(void *pointer) {
+  if (pointer != NULL) {
+    __atomic_sub_fetch(&gLiveAllocations, 1, __ATOMIC_RELAXED);
+  }
+  free(pointer);
+}
+
+// Like YGTestMeasure without its call counter, which is not meant to be shared by threads.
+static YGSize measureText(const YGNodeRef node, const float width, const YGMeasureMode widthMode) {
+  const int context = (int) (long) YGNodeGetContext(node);
+  const float naturalWidth = 10 + (context % 7) * 13;
+  const float lineHeight = 8 + (context % 5) * 3;
+  if (widthMode != YGMeasureModeUndefined && naturalWidth > width) {
+    return (YGSize){.width = width, .height = lineHeight * ceilf(naturalWidth / width)};
+  }
+  return (YGSize){.width = naturalWidth, .height = lineHeight};
+}
+
+static YGSize measureLeaf(YGNodeRef node,
+                          float width,
+                          YGMeasureMode widthMode,
+                          float height,
+                          YGMeasureMode heightMode) {
+  (void) height;
+  (void) heightMode;
+  return measureText(node, width, widthMode);
+}
+
+static void measureRows(YGNodeRef node,
+                        const YGMeasureRequest *requests,
+                        YGSize *sizes,
+                        const uint32_t count) {
+  (void) node;
+  for (uint32_t i = 0; i < count; i++) {
+    sizes[i] = measureText(requests[i].node, requests[i].width, requests[i].widthMode);
+  }
+}
+
+// A column of rows, each a batch-measured container of text leaves.
+static YGNodeRef buildFeed(const uint32_t rows) {
+  const YGNodeRef root = YGNodeNew();
+  YGNodeStyleSetWidth(root, 320);
+  YGNodeStyleSetHeight(root, 600);
+  for (uint32_t i = 0; i < rows; i++) {
+    const YGNodeRef row = YGNodeNew();
+    YGNodeStyleSetFlexDirection(row, YGFlexDirectionRow);
+    YGNodeStyleSetHeight(row, 40);
+    YGNodeSetBatchMeasureFunc(row, measureRows);
+    for (uint32_t j = 0; j < 3; j++) {
+      const YGNodeRef text = YGNodeNew();
+      YGNodeSetContext(text, (void *) (long) (i * 3 + j + 1));
+      YGNodeSetMeasureFunc(text, measureLeaf);
+      YGNodeInsertChild(row, text, j);
+    }
+    YGNodeInsertChild(root, row, i);
+  }
+  return root;
+}
+
+static void collectFrames(const YGNodeRef node, float *const frames, uint32_t *const count) {
+  frames[(*count)++] = YGNodeLayoutGetLeft(node);
+  frames[(*count)++] = YGNodeLayoutGetTop(node);
+  frames[(*count)++] = YGNodeLayoutGetWidth(node);
+  frames[(*count)++] = YGNodeLayoutGetHeight(node);
+  for (uint32_t i = 0; i < YGNodeGetChildCount(node); i++) {
+    collectFrames(YGNodeGetChild(node, i), frames, count);
+  }
+}
+
+static bool sameFrames(const YGNodeRef a, const YGNodeRef b) {
+  float framesA[4096];
+  float framesB[4096];
+  uint32_t countA = 0;
+  uint32_t countB = 0;
+  collectFrames(a, framesA, &countA);
+  collectFrames(b, framesB, &countB);
+  return countA == countB && memcmp(framesA, framesB, sizeof(float) * countA) == 0;
+}
+
+// Lays out a tree deferred and one eagerly and reads both, emitting frame deltas meanwhile.
+static void *deferredWorker(void *unused) {
+  (void) unused;
+  for (uint32_t round = 0; round < ROUNDS; round++) {
+    const YGNodeRef deferred = buildFeed(40);
+    const YGNodeRef eager = buildFeed(40);
+    const YGRect region = {0, 0, 320, 120};
+    YGNodeCalculateLayoutDeferred(deferred, YGUndefined, YGUndefined, YGDirectionLTR, region);
+    YGNodeCalculateLayout(eager, YGUndefined, YGUndefined, YGDirectionLTR);
+    size_t length;
+    YG_TEST_CHECK(YGNodeEmitFrameDelta(deferred, &length) != NULL && length > 0);
+    YG_TEST_CHECK(sameFrames(deferred, eager));
+    YGNodeFreeRecursive(deferred);
+    YGNodeFreeRecursive(eager);
+  }
+  return NULL;
+}
+
+typedef struct SpeculativeJob {
+  YGSpeculativeLayoutRef speculation;
+  float width;
+} SpeculativeJob;
+
+static void *speculativeWorker(void *data) {
+  const SpeculativeJob *const job = data;
+  YGSpeculativeLayoutCalculate(job->speculation, job->width, YGUndefined, YGDirectionLTR);
+  return NULL;
+}
+
+static void testSpeculativeLayouts(void) {
+  YGNodeRef live[THREAD_COUNT];
+  YGNodeRef expected[THREAD_COUNT];
+  SpeculativeJob jobs[THREAD_COUNT];
+  pthread_t threads[THREAD_COUNT];
+  for (uint32_t i = 0; i < THREAD_COUNT; i++) {
+    live[i] = buildFeed(20);
+    expected[i] = buildFeed(20);
+    YGNodeCalculateLayout(live[i], YGUndefined, YGUndefined, YGDirectionLTR);
+    jobs[i].speculation = YGSpeculativeLayoutBegin(live[i]);
+    YG_TEST_CHECK(jobs[i].speculation != NULL);
+    const YGNodeRef row = YGNodeGetChild(live[i], i);
+    YGNodeStyleSetHeight(YGSpeculativeLayoutGetNode(jobs[i].speculation, row), 70);
+    YGNodeStyleSetHeight(YGNodeGetChild(expected[i], i), 70);
+    jobs[i].width = 280 + 10 * i;
+    YG_TEST_CHECK(pthread_create(&threads[i], NULL, speculativeWorker, &jobs[i]) == 0);
+  }
+
+  // The owning thread keeps laying out and reading its trees meanwhile.
+  for (uint32_t round = 0; round < ROUNDS; round++) {
+    const YGNodeRef other = buildFeed(20);
+    const YGRect region = {0, 0, 320, 80};
+    YGNodeCalculateLayoutDeferred(other, YGUndefined, YGUndefined, YGDirectionLTR, region);
+    YGNodeEnsureLayout(other);
+    YGNodeFreeRecursive(other);
+    for (uint32_t i = 0; i < THREAD_COUNT; i++) {
+      YGNodeCalculateLayout(live[i], YGUndefined, YGUndefined, YGDirectionLTR);
+    }
+  }
+
+  for (uint32_t i = 0; i < THREAD_COUNT; i++) {
+    YG_TEST_CHECK(pthread_join(threads[i], NULL) == 0);
+    YG_TEST_CHECK(YGSpeculativeLayoutCommit(jobs[i].speculation));
+    YGNodeCalculateLayout(expected[i], jobs[i].width, YGUndefined, YGDirectionLTR);
+    YG_TEST_CHECK(sameFrames(live[i], expected[i]));
+    YGNodeFreeRecursive(live[i]);
+    YGNodeFreeRecursive(expected[i]);
+  }
+}
+
+static void testDeferredLayouts(void) {
+  pthread_t threads[THREAD_COUNT];
+  for (uint32_t i = 0; i < THREAD_COUNT; i++) {
+    YG_TEST_CHECK(pthread_create(&threads[i], NULL, deferredWorker, NULL) == 0);
+  }
+  deferredWorker(NULL);
+  for (uint32_t i = 0; i < THREAD_COUNT; i++) {
+    YG_TEST_CHECK(pthread_join(threads[i], NULL) == 0);
+  }
+}
+
+// Threads that batched measurements and emitted frame deltas leave no buffers behind.
+static void testThreadBuffers(void) {
+  const long liveAllocations = __atomic_load_n(&gLiveAllocations, __ATOMIC_RELAXED);
+  pthread_t threads[THREAD_COUNT];
+  for (uint32_t i = 0; i < THREAD_COUNT; i++) {
+    YG_TEST_CHECK(pthread_create(&threads[i], NULL, deferredWorker, NULL) == 0);
+  }
+  for (uint32_t i = 0; i < THREAD_COUNT; i++) {
+    YG_TEST_CHECK(pthread_join(threads[i], NULL) == 0);
+  }
+  YG_TEST_CHECK(__atomic_load_n(&gLiveAllocations, __ATOMIC_RELAXED) == liveAllocations);
+}
+
+int main(void) {
+  YGSetMemoryFuncs(countingMalloc, countingCalloc, countingRealloc, countingFree);
+  testThreadBuffers();
+  testSpeculativeLayouts();
+  testDeferredLayouts();
+  YG_TEST_CHECK(YGNodeGetInstanceCount() == 0);
+  return 0;
+}
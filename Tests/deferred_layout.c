@@ -0,0 +1,112 @@
+/** Copyright (c) 2014-present, Facebook, Inc. */
+
+// A deferred layout comes out as the eager one once everything pending is positioned.
+
+#include "YGTestUtils.h"
+
+// Turns some containers into rows aligned by their baselines, which read the positions inside
+// the children.
+static void addBaselines(const YGNodeRef node) {
+  const int context = (int) (long) YGNodeGetContext(node);
+  if (YGNodeGetChildCount(node) > 0 && context % 3 == 1) {
+    YGNodeStyleSetFlexDirection(node, context % 2 ? YGFlexDirectionRow : YGFlexDirectionRowReverse);
+    YGNodeStyleSetAlignItems(node, YGAlignBaseline);
+  }
+  for (uint32_t i = 0; i < YGNodeGetChildCount(node); i++) {
+    addBaselines(YGNodeGetChild(node, i));
+  }
+}
+
+static void checkMatchesEagerLayout(const int depth,
+                                    const float width,
+                                    const float height,
+                                    const YGRect region) {
+  YGNodeRef eager, deferred;
+  YGTestBuildTreePair(depth, &eager, &deferred);
+  YGNodeCalculateLayout(eager, width, height, YGDirectionLTR);
+  YGNodeCalculateLayoutDeferred(deferred, width, height, YGDirectionLTR, region);
+  YGNodeEnsureLayout(deferred);
+  YG_TEST_CHECK(YGTestSameLayoutWithin(eager, deferred, 0.001f));
+  YGNodeFreeRecursive(eager);
+  YGNodeFreeRecursive(deferred);
+}
+
+// Trees the deferred layout used to get wrong, built from the seeds that produced them.
+typedef struct PinnedTree {
+  unsigned seed;
+  int context;
+  float width;
+  float height;
+  YGRect region;
+} PinnedTree;
+
+static const PinnedTree kPinnedTrees[] = {
+  // The eager pass measured a container again after laying it out, then reused that layout,
+  // under a row aligned by baseline. The baseline came out of the newer measurement of the first
+  // leaf while its position was the one of the earlier layout.
+  {3946361978u, 410709, 569, 310, {.x = 97, .y = 82, .width = 65, .height = 220}},
+  {451781387u, 1237207, 537, 327, {.x = 171, .y = 112, .width = 231, .height = 148}},
+  // A container laid out with a height of 0 and again with float noise above it: the cached
+  // layout squeezed the leaves to nothing, a fresh one measured them.
+  {595333078u, 63709, 437, 480, {.x = 0, .y = 0, .width = 0, .height = 0}},
+  // A leaf with margins measured at an at-most width, then at a larger one: the cache took the
+  // second constraint for a stricter one and kept the narrower result.
+  {3218949891u, 2005458, 409, 348, {.x = 0, .y = 0, .width = 0, .height = 0}},
+};
+
+static void testPinnedTrees(void) {
+  for (size_t i = 0; i < sizeof(kPinnedTrees) / sizeof(kPinnedTrees[0]); i++) {
+    const PinnedTree *const pinned = &kPinnedTrees[i];
+    gYGTestSeed = pinned->seed;
+    gYGTestContext = pinned->context;
+    checkMatchesEagerLayout(5, pinned->width, pinned->height, pinned->region);
+  }
+  gYGTestSeed = 12345;
+  gYGTestContext = 0;
+}
+
+// Random trees, positioned either by reading them, which resolves the pending parts on the way
+// down, or by YGNodeEnsureLayout.
+static void testRandomTreesMatchEagerLayout(const bool rounding) {
+  YGSetExperimentalFeatureEnabled(YGExperimentalFeatureRounding, rounding);
+  // Up to float noise, which rounding can turn into a point: a deferred container is laid out
+  // from its own request rather than within its parent's pass. Few trees differ at all.
+  const float tolerance = rounding ? 1 : 0.001f;
+  int inexact = 0;
+  for (int t = 0; t < 3000; t++) {
+    YGNodeRef eager, deferred;
+    YGTestBuildTreePair(5, &eager, &deferred);
+    addBaselines(eager);
+    addBaselines(deferred);
+    const float width = 200 + YGTestRandom() % 400;
+    const float height = t % 3 == 0 ? YGUndefined : 300 + YGTestRandom() % 400;
+    const YGRect region = {
+      .x = YGTestRandom() % 200,
+      .y = YGTestRandom() % 200,
+      .width = t % 4 == 0 ? 0 : YGTestRandom() % 300,
+      .height = YGTestRandom() % 300,
+    };
+
+    YGNodeCalculateLayout(eager, width, height, YGDirectionLTR);
+    YGNodeCalculateLayoutDeferred(deferred, width, height, YGDirectionLTR, region);
+    if (t % 2 == 0) {
+      YGNodeEnsureLayout(deferred);
+    }
+    if (!YGTestSameLayoutWithin(eager, deferred, tolerance)) {
+      fprintf(stderr, "tree %d\n", t);
+      exit(1);
+    }
+    inexact += YGTestLayoutDifference(eager, deferred) > 0;
+    YGNodeFreeRecursive(eager);
+    YGNodeFreeRecursive(deferred);
+  }
+  YG_TEST_CHECK(inexact < 3000 / 100);
+  YGSetExperimentalFeatureEnabled(YGExperimentalFeatureRounding, false);
+}
+
+int main(void) {
+  testPinnedTrees();
+  testRandomTreesMatchEagerLayout(false);
+  testRandomTreesMatchEagerLayout(true);
+  return 0;
+}
@@ -0,0 +1,152 @@
+/** Copyright (c) 2014-present, Facebook, Inc. */
+
+// Frame deltas keep a mirror equal to the exported frames, whatever the host does with
+// hasNewLayout.
+
+#include "YGTestUtils.h"
+
+#define CAPACITY 20000
+
+static YGFrameRecord gMirror[CAPACITY];
+static YGFrameRecord gExpected[CAPACITY];
+
+static void clearNewLayout(const YGNodeRef node) {
+  YGNodeSetHasNewLayout(node, false);
+  for (uint32_t i = 0; i < YGNodeGetChildCount(node); i++) {
+    clearNewLayout(YGNodeGetChild(node, i));
+  }
+}
+
+// The stream leaves out changes smaller than the layout epsilon.
+static bool sameFloat(const float a, const float b) {
+  return a == b || fabsf(a - b) <= 0.001f || (isnan(a) && isnan(b));
+}
+
+static void checkMirror(const YGNodeRef root, const uint32_t count) {
+  YG_TEST_CHECK(YGNodeExportFrames(root, gExpected, CAPACITY) == count);
+  for (uint32_t i = 0; i < count; i++) {
+    YG_TEST_CHECK(gMirror[i].context == gExpected[i].context);
+    YG_TEST_CHECK(sameFloat(gMirror[i].x, gExpected[i].x));
+    YG_TEST_CHECK(sameFloat(gMirror[i].y, gExpected[i].y));
+    YG_TEST_CHECK(sameFloat(gMirror[i].width, gExpected[i].width));
+    YG_TEST_CHECK(sameFloat(gMirror[i].height, gExpected[i].height));
+  }
+}
+
+static uint32_t emitAndApply(const YGNodeRef root, size_t *const length) {
+  const uint8_t *const delta = YGNodeEmitFrameDelta(root, length);
+  return YGFrameDeltaApply(delta, *length, gMirror, CAPACITY);
+}
+
+// A host consuming hasNewLayout between two emits must not hide the change.
+static void testHostClearsNewLayout(void) {
+  const YGNodeRef root = YGNodeNew();
+  const YGNodeRef child = YGNodeNew();
+  const YGNodeRef grandchild = YGNodeNew();
+  YGNodeStyleSetHeight(grandchild, 10);
+  YGNodeInsertChild(child, grandchild, 0);
+  YGNodeInsertChild(root, child, 0);
+  YGNodeCalculateLayout(root, 100, 100, YGDirectionLTR);
+
+  size_t length;
+  uint32_t count = emitAndApply(root, &length);
+  checkMirror(root, count);
+  YG_TEST_CHECK(YGNodeGetHasNewLayout(grandchild));
+
+  YGNodeStyleSetHeight(grandchild, 30);
+  YGNodeCalculateLayout(root, 100, 100, YGDirectionLTR);
+  clearNewLayout(root);
+  count = emitAndApply(root, &length);
+  YG_TEST_CHECK(length > sizeof(uint32_t));
+  YG_TEST_CHECK(gMirror[2].height == 30);
+  checkMirror(root, count);
+
+  // Nothing changed since: only the node count is sent.
+  count = emitAndApply(root, &length);
+  YG_TEST_CHECK(length == sizeof(uint32_t));
+  YGNodeFreeRecursive(root);
+}
+
+// Containers served from their caches are only walked into when they moved or a child of theirs
+// was laid out since the last emit, even by a pass before the last one.
+static void testCachedContainers(void) {
+  const YGNodeRef root = YGNodeNew();
+  YGNodeRef leaves[2];
+  for (uint32_t i = 0; i < 2; i++) {
+    const YGNodeRef container = YGNodeNew();
+    YGNodeStyleSetFlexDirection(container, YGFlexDirectionRow);
+    leaves[i] = YGNodeNew();
+    YGNodeStyleSetWidth(leaves[i], 20);
+    YGNodeStyleSetHeight(leaves[i], 10);
+    YGNodeInsertChild(container, leaves[i], 0);
+    YGNodeInsertChild(root, container, i);
+  }
+  YGNodeCalculateLayout(root, 100, YGUndefined, YGDirectionLTR);
+  size_t length;
+  checkMirror(root, emitAndApply(root, &length));
+
+  YGNodeStyleSetWidth(leaves[0], 30);
+  YGNodeCalculateLayout(root, 100, YGUndefined, YGDirectionLTR);
+  YGNodeCalculateLayout(root, 100, YGUndefined, YGDirectionLTR);
+  checkMirror(root, emitAndApply(root, &length));
+  YG_TEST_CHECK(gMirror[2].width == 30);
+
+  YGNodeStyleSetHeight(leaves[0], 25);
+  YGNodeCalculateLayout(root, 100, YGUndefined, YGDirectionLTR);
+  checkMirror(root, emitAndApply(root, &length));
+  YG_TEST_CHECK(gMirror[4].y == 25);
+
+  YGNodeCalculateLayout(root, 100, YGUndefined, YGDirectionLTR);
+  YG_TEST_CHECK(emitAndApply(root, &length) == 5 && length == sizeof(uint32_t));
+  YGNodeFreeRecursive(root);
+}
+
+static YGNodeRef anyNode(YGNodeRef node) {
+  while (YGNodeGetChildCount(node) > 0 && YGTestRandom() % 3 != 0) {
+    node = YGNodeGetChild(node, YGTestRandom() % YGNodeGetChildCount(node));
+  }
+  return node;
+}
+
+// Random style and structure changes, with the host clearing hasNewLayout now and then.
+static void testRandomChanges(void) {
+  for (int t = 0; t < 100; t++) {
+    const YGNodeRef root = YGTestBuildTree(4);
+    const float width = 200 + YGTestRandom() % 300;
+    YGNodeCalculateLayout(root, width, YGUndefined, YGDirectionLTR);
+    size_t length;
+    checkMirror(root, emitAndApply(root, &length));
+
+    for (int step = 0; step < 8; step++) {
+      const YGNodeRef node = anyNode(root);
+      switch (YGTestRandom() % 3) {
+        case 0:
+          YGNodeStyleSetMargin(node, YGEdgeTop, YGTestRandom() % 20);
+          break;
+        case 1:
+          if (YGNodeGetChildCount(node) == 0 && YGNodeGetParent(node) != NULL) {
+            const YGNodeRef parent = YGNodeGetParent(node);
+            YGNodeRemoveChild(parent, node);
+            YGNodeFree(node);
+          }
+          break;
+        default:
+          YGNodeStyleSetWidth(node, 10 + YGTestRandom() % 100);
+          break;
+      }
+      YGNodeCalculateLayout(root, width, YGUndefined, YGDirectionLTR);
+      if (YGTestRandom() % 2 == 0) {
+        clearNewLayout(root);
+      }
+      checkMirror(root, emitAndApply(root, &length));
+    }
+    YGNodeFreeRecursive(root);
+  }
+}
+
+int main(void) {
+  testHostClearsNewLayout();
+  testCachedContainers();
+  testRandomChanges();
+  return 0;
+}
@@ -0,0 +1,174 @@
+/** Copyright (c) 2014-present, Facebook, Inc. */
+
+// A frozen node lays out like a box of the size it was frozen at, its subtree keeps its frames,
+// and once unfrozen the tree lays out as if it had never been frozen.
+
+#include "YGTestUtils.h"
+
+#define CAPACITY 20000
+
+static float gBefore[CAPACITY];
+static float gAfter[CAPACITY];
+
+// A node below the root, not absolute, hidden or without a size, or NULL.
+static YGNodeRef pickNode(const YGNodeRef root) {
+  YGNodeRef node = root;
+  for (int depth = 1 + YGTestRandom() % 2; depth > 0 && YGNodeGetChildCount(node) > 0; depth--) {
+    node = YGNodeGetChild(node, YGTestRandom() % YGNodeGetChildCount(node));
+  }
+  if (node == root || YGNodeStyleGetPositionType(node) == YGPositionTypeAbsolute ||
+      YGNodeStyleGetDisplay(node) == YGDisplayNone || isnan(YGNodeLayoutGetWidth(node)) ||
+      isnan(YGNodeLayoutGetHeight(node))) {
+    return NULL;
+  }
+  return node;
+}
+
+// The node at the same place in another copy of the tree.
+static YGNodeRef sameNodeIn(const YGNodeRef root, const YGNodeRef node, const YGNodeRef copy) {
+  if (node == root) {
+    return copy;
+  }
+  const YGNodeRef parent = YGNodeGetParent(node);
+  uint32_t index = 0;
+  while (YGNodeGetChild(parent, index) != node) {
+    index++;
+  }
+  return YGNodeGetChild(sameNodeIn(root, parent, copy), index);
+}
+
+// Turns the node into a leaf of a fixed size that does not flex.
+static void makeBox(const YGNodeRef node, const float width, const float height) {
+  while (YGNodeGetChildCount(node) > 0) {
+    const YGNodeRef child = YGNodeGetChild(node, 0);
+    YGNodeRemoveChild(node, child);
+    YGNodeFreeRecursive(child);
+  }
+  YGNodeSetMeasureFunc(node, NULL);
+  YGNodeStyleSetWidth(node, width);
+  YGNodeStyleSetHeight(node, height);
+  YGNodeStyleSetMinWidth(node, YGUndefined);
+  YGNodeStyleSetMinHeight(node, YGUndefined);
+  YGNodeStyleSetMaxWidth(node, YGUndefined);
+  YGNodeStyleSetMaxHeight(node, YGUndefined);
+  YGNodeStyleSetFlexGrow(node, 0);
+  YGNodeStyleSetFlexShrink(node, 0);
+  YGNodeStyleSetFlexBasisAuto(node);
+  YGNodeStyleSetAspectRatio(node, YGUndefined);
+}
+
+// The box takes other paths through the algorithm, which can change the last bits of a float.
+static bool sameFloat(const float a, const float b) {
+  return a == b || fabsf(a - b) <= 0.001f || (isnan(a) && isnan(b));
+}
+
+// Whether both trees hold the same frames, except below the given node of the first one.
+static bool sameLayoutAround(const YGNodeRef a, const YGNodeRef b, const YGNodeRef skipped) {
+  if (!sameFloat(YGNodeLayoutGetLeft(a), YGNodeLayoutGetLeft(b)) ||
+      !sameFloat(YGNodeLayoutGetTop(a), YGNodeLayoutGetTop(b)) ||
+      !sameFloat(YGNodeLayoutGetWidth(a), YGNodeLayoutGetWidth(b)) ||
+      !sameFloat(YGNodeLayoutGetHeight(a), YGNodeLayoutGetHeight(b))) {
+    fprintf(stderr, "node %ld differs\n", (long) YGNodeGetContext(a));
+    return false;
+  }
+  if (a == skipped) {
+    return true;
+  }
+  for (uint32_t i = 0; i < YGNodeGetChildCount(a); i++) {
+    if (!sameLayoutAround(YGNodeGetChild(a, i), YGNodeGetChild(b, i), skipped)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+static void testRandomTrees(const bool rounding) {
+  YGSetExperimentalFeatureEnabled(YGExperimentalFeatureRounding, rounding);
+  for (int t = 0; t < 300; t++) {
+    // The tree to freeze a node of, the same tree with a box in its place, and one never frozen.
+    YGNodeRef trees[3];
+    YGTestBuildTrees(4, trees, 3);
+    const YGNodeRef root = trees[0], boxed = trees[1], plain = trees[2];
+    YGNodeCalculateLayout(root, 300, 400, YGDirectionLTR);
+    YGNodeCalculateLayout(plain, 300, 400, YGDirectionLTR);
+
+    const YGNodeRef frozen = pickNode(root);
+    if (frozen == NULL) {
+      for (uint32_t i = 0; i < 3; i++) {
+        YGNodeFreeRecursive(trees[i]);
+      }
+      continue;
+    }
+    const float width = YGNodeLayoutGetWidth(frozen);
+    const float height = YGNodeLayoutGetHeight(frozen);
+    uint32_t count = 0;
+    YGTestCollectLayout(frozen, gBefore, &count);
+
+    YGNodeSetFrozen(frozen, true);
+    YG_TEST_CHECK(YGNodeIsFrozen(frozen));
+    const float availableWidth = 150 + YGTestRandom() % 300;
+    const float availableHeight = 150 + YGTestRandom() % 300;
+    YGNodeCalculateLayout(root, availableWidth, availableHeight, YGDirectionLTR);
+
+    // Only the position of the frozen node itself follows the parent.
+    uint32_t countAfter = 0;
+    YGTestCollectLayout(frozen, gAfter, &countAfter);
+    YG_TEST_CHECK(countAfter == count);
+    YG_TEST_CHECK(memcmp(gBefore + 2, gAfter + 2, sizeof(float) * (count - 2)) == 0);
+
+    // The box reference needs the unrounded size, and a box has no baseline of its own.
+    if (!rounding && YGNodeStyleGetAlignItems(YGNodeGetParent(frozen)) != YGAlignBaseline) {
+      makeBox(sameNodeIn(root, frozen, boxed), width, height);
+      YGNodeCalculateLayout(boxed, availableWidth, availableHeight, YGDirectionLTR);
+      YG_TEST_CHECK(sameLayoutAround(root, boxed, frozen));
+    }
+
+    // The frozen pass leaves other measurements in the caches, which can change the last bits of
+    // a float, and a point once rounded.
+    YGNodeSetFrozen(frozen, false);
+    YGNodeCalculateLayout(root, availableWidth, availableHeight, YGDirectionLTR);
+    YGNodeCalculateLayout(plain, availableWidth, availableHeight, YGDirectionLTR);
+    YG_TEST_CHECK(YGTestSameLayoutWithin(root, plain, rounding ? 1 : 0.001f));
+    for (uint32_t i = 0; i < 3; i++) {
+      YGNodeFreeRecursive(trees[i]);
+    }
+  }
+  YGSetExperimentalFeatureEnabled(YGExperimentalFeatureRounding, false);
+}
+
+// Dirtying a frozen node or a node inside it lays it out once more, then it holds again.
+static void testDirtyingRelayouts(void) {
+  const YGNodeRef root = YGNodeNew();
+  const YGNodeRef box = YGNodeNew();
+  const YGNodeRef leaf = YGNodeNew();
+  YGNodeSetContext(leaf, (void *) 3L);
+  YGNodeSetMeasureFunc(leaf, YGTestMeasure);
+  YGNodeInsertChild(box, leaf, 0);
+  YGNodeInsertChild(root, box, 0);
+  YGNodeCalculateLayout(root, 300, 300, YGDirectionLTR);
+
+  YGNodeSetFrozen(box, true);
+  YGNodeCalculateLayout(root, 200, 200, YGDirectionLTR);
+  YG_TEST_CHECK(YGNodeLayoutGetWidth(box) == 300);
+  gYGTestMeasureCalls = 0;
+  YGNodeCalculateLayout(root, 250, 250, YGDirectionLTR);
+  YG_TEST_CHECK(gYGTestMeasureCalls == 0);
+
+  YGNodeStyleSetPadding(box, YGEdgeLeft, 10);
+  YGNodeCalculateLayout(root, 250, 250, YGDirectionLTR);
+  YG_TEST_CHECK(YGNodeLayoutGetWidth(box) == 250 && YGNodeLayoutGetLeft(leaf) == 10);
+  YGNodeCalculateLayout(root, 400, 400, YGDirectionLTR);
+  YG_TEST_CHECK(YGNodeLayoutGetWidth(box) == 250);
+
+  YGNodeMarkDirty(leaf);
+  YGNodeCalculateLayout(root, 400, 400, YGDirectionLTR);
+  YG_TEST_CHECK(YGNodeLayoutGetWidth(box) == 400);
+  YGNodeFreeRecursive(root);
+}
+
+int main(void) {
+  testRandomTrees(false);
+  testRandomTrees(true);
+  testDirtyingRelayouts();
+  return 0;
+}
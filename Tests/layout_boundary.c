@@ -0,0 +1,173 @@
+/** Copyright (c) 2014-present, Facebook, Inc. */
+
+// Layout boundaries stop dirty propagation only where nothing outside can change.
+
+#include "YGTestUtils.h"
+
+static float gLeafHeight = 10;
+
+static YGSize measureLeaf(YGNodeRef node,
+                          float width,
+                          YGMeasureMode widthMode,
+                          float height,
+                          YGMeasureMode heightMode) {
+  (void) node;
+  (void) width;
+  (void) widthMode;
+  (void) height;
+  (void) heightMode;
+  return (YGSize){.width = 20, .height = gLeafHeight};
+}
+
+// row G aligned by baseline > P > fixed size B > measured L, next to Q: the baseline of B, and
+// so the position of P, follows L.
+static YGNodeRef buildBaselineTree(YGNodeRef *leaf, YGNodeRef *wrapper) {
+  const YGNodeRef root = YGNodeNew();
+  YGNodeStyleSetFlexDirection(root, YGFlexDirectionRow);
+  YGNodeStyleSetAlignItems(root, YGAlignBaseline);
+  YGNodeStyleSetWidth(root, 300);
+  YGNodeStyleSetHeight(root, 200);
+
+  *wrapper = YGNodeNew();
+  const YGNodeRef box = YGNodeNew();
+  YGNodeStyleSetWidth(box, 50);
+  YGNodeStyleSetHeight(box, 50);
+  *leaf = YGNodeNew();
+  YGNodeSetMeasureFunc(*leaf, measureLeaf);
+  YGNodeInsertChild(box, *leaf, 0);
+  YGNodeInsertChild(*wrapper, box, 0);
+  YGNodeInsertChild(root, *wrapper, 0);
+
+  const YGNodeRef sibling = YGNodeNew();
+  YGNodeStyleSetWidth(sibling, 50);
+  YGNodeStyleSetHeight(sibling, 80);
+  YGNodeInsertChild(root, sibling, 1);
+  return root;
+}
+
+static void testBaselineThroughFirstChildren(void) {
+  YGNodeRef leaf, wrapper;
+  gLeafHeight = 10;
+  const YGNodeRef root = buildBaselineTree(&leaf, &wrapper);
+  YGNodeCalculateLayout(root, YGUndefined, YGUndefined, YGDirectionLTR);
+  YG_TEST_CHECK(YGNodeLayoutGetTop(wrapper) == 70);
+
+  gLeafHeight = 40;
+  YGNodeMarkDirty(leaf);
+  YG_TEST_CHECK(YGNodeIsDirty(wrapper));
+  YG_TEST_CHECK(YGNodeIsDirty(root));
+  YGNodeCalculateLayout(root, YGUndefined, YGUndefined, YGDirectionLTR);
+  YG_TEST_CHECK(YGNodeLayoutGetTop(wrapper) == 40);
+  YG_TEST_CHECK(!YGNodeIsDirty(root));
+  YGNodeFreeRecursive(root);
+}
+
+// Above a boundary the ancestors report the pending layout too.
+static void testDirtyAboveBoundary(void) {
+  const YGNodeRef root = YGNodeNew();
+  const YGNodeRef panel = YGNodeNew();
+  YGNodeStyleSetWidth(panel, 100);
+  YGNodeStyleSetHeight(panel, 100);
+  const YGNodeRef leaf = YGNodeNew();
+  YGNodeSetMeasureFunc(leaf, YGTestMeasure);
+  YGNodeInsertChild(panel, leaf, 0);
+  YGNodeInsertChild(root, panel, 0);
+  YGNodeCalculateLayout(root, 375, 667, YGDirectionLTR);
+  YG_TEST_CHECK(!YGNodeIsDirty(root));
+
+  YGNodeMarkDirty(leaf);
+  YG_TEST_CHECK(YGNodeIsDirty(leaf));
+  YG_TEST_CHECK(YGNodeIsDirty(panel));
+  YG_TEST_CHECK(YGNodeIsDirty(root));
+  YGNodeCalculateLayout(root, 375, 667, YGDirectionLTR);
+  YG_TEST_CHECK(!YGNodeIsDirty(root) && !YGNodeIsDirty(panel) && !YGNodeIsDirty(leaf));
+  YGNodeFreeRecursive(root);
+}
+
+// Gives some containers a fixed size, so the trees hold boundaries, and aligns some rows by their
+// baselines.
+static void addBoundaries(const YGNodeRef node) {
+  const int context = (int) (long) YGNodeGetContext(node);
+  if (YGNodeGetChildCount(node) > 0 && context % 3 == 0) {
+    YGNodeStyleSetWidth(node, 40 + context % 150);
+    YGNodeStyleSetHeight(node, 30 + context % 100);
+  }
+  if (context % 4 == 1) {
+    YGNodeStyleSetFlexDirection(node, YGFlexDirectionRow);
+    YGNodeStyleSetAlignItems(node, YGAlignBaseline);
+  }
+  for (uint32_t i = 0; i < YGNodeGetChildCount(node); i++) {
+    addBoundaries(YGNodeGetChild(node, i));
+  }
+}
+
+static YGNodeRef nodeAtPath(YGNodeRef node, const uint32_t *path, const uint32_t length) {
+  for (uint32_t i = 0; i < length; i++) {
+    node = YGNodeGetChild(node, path[i]);
+  }
+  return node;
+}
+
+// Randomly changed leaves relaid out through boundaries come out as when every ancestor is
+// marked dirty, which is what happened before boundaries existed. Up to float noise, which
+// rounding can turn into a point: a boundary is laid out again with its last request rather than
+// the one its parent would compute now. Few layouts differ at all.
+static void testRandomTreesMatchFullPropagation(const bool rounding) {
+  YGSetExperimentalFeatureEnabled(YGExperimentalFeatureRounding, rounding);
+  const float tolerance = rounding ? 1 : 0.001f;
+  int inexact = 0;
+  for (int t = 0; t < 400; t++) {
+    YGNodeRef tree, reference;
+    YGTestBuildTreePair(5, &tree, &reference);
+    addBoundaries(tree);
+    addBoundaries(reference);
+    const float width = 200 + YGTestRandom() % 300;
+    YGNodeCalculateLayout(tree, width, YGUndefined, YGDirectionLTR);
+    YGNodeCalculateLayout(reference, width, YGUndefined, YGDirectionLTR);
+
+    for (int step = 0; step < 4; step++) {
+      uint32_t path[16];
+      uint32_t length = 0;
+      YGNodeRef leaf = tree;
+      while (YGNodeGetChildCount(leaf) > 0 && length < 16) {
+        path[length] = YGTestRandom() % YGNodeGetChildCount(leaf);
+        leaf = YGNodeGetChild(leaf, path[length++]);
+      }
+      if (YGNodeGetChildCount(leaf) > 0) {
+        continue;
+      }
+      const YGNodeRef referenceLeaf = nodeAtPath(reference, path, length);
+      const long context = (long) YGNodeGetContext(leaf) + 1 + YGTestRandom() % 5;
+      YGNodeSetContext(leaf, (void *) context);
+      YGNodeSetContext(referenceLeaf, (void *) context);
+      YGNodeMarkDirty(leaf);
+      YGNodeMarkDirty(referenceLeaf);
+      for (YGNodeRef ancestor = YGNodeGetParent(referenceLeaf); ancestor != NULL;
+           ancestor = YGNodeGetParent(ancestor)) {
+        const float grow = YGNodeStyleGetFlexGrow(ancestor);
+        YGNodeStyleSetFlexGrow(ancestor, grow + 1);
+        YGNodeStyleSetFlexGrow(ancestor, grow);
+      }
+
+      YGNodeCalculateLayout(tree, width, YGUndefined, YGDirectionLTR);
+      YGNodeCalculateLayout(reference, width, YGUndefined, YGDirectionLTR);
+      if (!YGTestSameLayoutWithin(tree, reference, tolerance)) {
+        fprintf(stderr, "tree %d step %d\n", t, step);
+        exit(1);
+      }
+      inexact += YGTestLayoutDifference(tree, reference) > 0;
+    }
+    YGNodeFreeRecursive(tree);
+    YGNodeFreeRecursive(reference);
+  }
+  YG_TEST_CHECK(inexact < 400 * 4 / 100);
+  YGSetExperimentalFeatureEnabled(YGExperimentalFeatureRounding, false);
+}
+
+int main(void) {
+  testBaselineThroughFirstChildren();
+  testDirtyAboveBoundary();
+  testRandomTreesMatchFullPropagation(false);
+  testRandomTreesMatchFullPropagation(true);
+  return 0;
+}
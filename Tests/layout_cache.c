@@ -0,0 +1,164 @@
+/** Copyright (c) 2014-present, Facebook, Inc. */
+
+// Layouts served from the caches, including the containers' layout caches, come out as a fresh
+// layout at the same size.
+
+#include "YGTestUtils.h"
+
+#define LAYOUT_COUNT 6
+
+// The pattern of a render: the bounds, the intrinsic size, the content size, the bounds again,
+// then sizes seen before. Each layout is compared with a copy of the tree laid out only once.
+static void testRenderPattern(const bool rounding) {
+  YGSetExperimentalFeatureEnabled(YGExperimentalFeatureRounding, rounding);
+  // Reused measurements can differ from new ones in the last bits of a float, which rounding can
+  // turn into a point.
+  const float tolerance = rounding ? 1 : 0.001f;
+  for (int t = 0; t < 200; t++) {
+    YGNodeRef trees[1 + LAYOUT_COUNT];
+    YGTestBuildTrees(4, trees, 1 + LAYOUT_COUNT);
+    const YGNodeRef root = trees[0];
+
+    const float width = 200 + t % 200;
+    const float height = 300 + t % 300;
+    YGNodeCalculateLayout(root, width, height, YGDirectionLTR);
+    const YGSize intrinsic = YGNodeMeasure(
+        root, YGUndefined, YGMeasureModeUndefined, YGUndefined, YGMeasureModeUndefined);
+
+    const float sizes[LAYOUT_COUNT][2] = {
+        {width, height},
+        {intrinsic.width, intrinsic.height},
+        {width, height},
+        {width, YGUndefined},
+        {intrinsic.width, intrinsic.height},
+        {width, height},
+    };
+    for (uint32_t i = 0; i < LAYOUT_COUNT; i++) {
+      YGNodeCalculateLayout(root, sizes[i][0], sizes[i][1], YGDirectionLTR);
+      YGNodeCalculateLayout(trees[1 + i], sizes[i][0], sizes[i][1], YGDirectionLTR);
+      YG_TEST_CHECK(YGTestSameLayoutWithin(root, trees[1 + i], tolerance));
+    }
+    for (uint32_t i = 0; i < 1 + LAYOUT_COUNT; i++) {
+      YGNodeFreeRecursive(trees[i]);
+    }
+  }
+  YGSetExperimentalFeatureEnabled(YGExperimentalFeatureRounding, false);
+}
+
+// A leaf without room for its content is not measured. Its size for those constraints must not be
+// reused for constraints that leave room, here the size it gets once its parent's height is known.
+static void testPercentOfParentAfterEmptyMeasurement(void) {
+  const YGNodeRef root = YGNodeNew();
+  YGNodeStyleSetAlignItems(root, YGAlignCenter);
+  const YGNodeRef row = YGNodeNew();
+  YGNodeStyleSetFlexDirection(row, YGFlexDirectionRow);
+  YGNodeStyleSetAspectRatio(row, 0.5f);
+  YGNodeInsertChild(root, row, 0);
+  const YGNodeRef first = YGNodeNew();
+  YGNodeSetContext(first, (void *) 18L);
+  YGNodeSetMeasureFunc(first, YGTestMeasure);
+  YGNodeInsertChild(row, first, 0);
+  const YGNodeRef second = YGNodeNew();
+  YGNodeSetContext(second, (void *) 19L);
+  YGNodeSetMeasureFunc(second, YGTestMeasure);
+  YGNodeStyleSetMargin(second, YGEdgeAll, 7);
+  YGNodeStyleSetPadding(second, YGEdgeLeft, 4);
+  YGNodeStyleSetHeightPercent(second, 68);
+  YGNodeInsertChild(row, second, 1);
+  YGNodeCalculateLayout(root, 319, YGUndefined, YGDirectionLTR);
+
+  YG_TEST_CHECK(YGNodeLayoutGetWidth(row) == 17 && YGNodeLayoutGetHeight(row) == 34);
+  YG_TEST_CHECK(YGNodeLayoutGetWidth(second) == 4);
+  YG_TEST_CHECK(fabsf(YGNodeLayoutGetHeight(second) - 34 * 0.68f) < 0.001f);
+  YGNodeFreeRecursive(root);
+}
+
+// Containers whose sizes differ by less than the caches tell apart break their lines alike.
+static void testWrapWithinCacheTolerance(void) {
+  YGNodeRef roots[2];
+  for (uint32_t i = 0; i < 2; i++) {
+    roots[i] = YGNodeNew();
+    YGNodeStyleSetFlexWrap(roots[i], YGWrapWrap);
+    YGNodeStyleSetWidth(roots[i], 100);
+    for (uint32_t j = 0; j < 2; j++) {
+      const YGNodeRef child = YGNodeNew();
+      YGNodeStyleSetWidth(child, 40);
+      YGNodeStyleSetHeightPercent(child, 100);
+      YGNodeInsertChild(roots[i], child, j);
+    }
+  }
+  YGNodeCalculateLayout(roots[0], YGUndefined, 0, YGDirectionLTR);
+  YGNodeCalculateLayout(roots[0], YGUndefined, 0.00001f, YGDirectionLTR);
+  YGNodeCalculateLayout(roots[1], YGUndefined, 0.00001f, YGDirectionLTR);
+  YG_TEST_CHECK(YGTestSameLayoutWithin(roots[0], roots[1], 0.001f));
+  YG_TEST_CHECK(YGNodeLayoutGetLeft(YGNodeGetChild(roots[1], 1)) == 0);
+  for (uint32_t i = 0; i < 2; i++) {
+    YGNodeFreeRecursive(roots[i]);
+  }
+}
+
+// With rounding, a layout served whole from the cache keeps the frame the last pass rounded.
+static void testRoundedCachedRoot(void) {
+  YGSetExperimentalFeatureEnabled(YGExperimentalFeatureRounding, true);
+  const YGNodeRef root = YGNodeNew();
+  YGNodeStyleSetFlexDirection(root, YGFlexDirectionRow);
+  for (uint32_t i = 0; i < 3; i++) {
+    const YGNodeRef child = YGNodeNew();
+    YGNodeStyleSetWidth(child, 10.4f);
+    YGNodeStyleSetHeight(child, 10.4f);
+    YGNodeInsertChild(root, child, i);
+  }
+  YGNodeCalculateLayout(root, YGUndefined, YGUndefined, YGDirectionLTR);
+  YGNodeCalculateLayout(root, YGUndefined, YGUndefined, YGDirectionLTR);
+  YG_TEST_CHECK(YGNodeLayoutGetWidth(root) == 31 && YGNodeLayoutGetHeight(root) == 10);
+  YGNodeFreeRecursive(root);
+  YGSetExperimentalFeatureEnabled(YGExperimentalFeatureRounding, false);
+}
+
+// With rounding, a row aligned by baselines finds the baseline of a child served from the caches
+// where a fresh layout finds it, not from the rounded positions deeper in the child.
+static void testRoundedBaselineOfCachedChild(void) {
+  YGSetExperimentalFeatureEnabled(YGExperimentalFeatureRounding, true);
+  YGNodeRef roots[2];
+  for (uint32_t i = 0; i < 2; i++) {
+    roots[i] = YGNodeNew();
+    YGNodeStyleSetFlexDirection(roots[i], YGFlexDirectionRow);
+    YGNodeStyleSetAlignItems(roots[i], YGAlignBaseline);
+    YGNodeStyleSetWidth(roots[i], 300);
+    YGNodeStyleSetHeight(roots[i], 100);
+    const YGNodeRef column = YGNodeNew();
+    const YGNodeRef paragraph = YGNodeNew();
+    YGNodeStyleSetPadding(paragraph, YGEdgeTop, 0.4f);
+    const YGNodeRef text = YGNodeNew();
+    YGNodeStyleSetHeight(text, 10);
+    YGNodeInsertChild(paragraph, text, 0);
+    YGNodeInsertChild(column, paragraph, 0);
+    YGNodeInsertChild(roots[i], column, 0);
+    const YGNodeRef box = YGNodeNew();
+    YGNodeStyleSetWidth(box, 50);
+    YGNodeStyleSetHeight(box, 30);
+    YGNodeInsertChild(roots[i], box, 1);
+  }
+  YGNodeCalculateLayout(roots[0], YGUndefined, YGUndefined, YGDirectionLTR);
+  for (uint32_t i = 0; i < 2; i++) {
+    YGNodeStyleSetHeight(YGNodeGetChild(roots[i], 1), 30.7f);
+  }
+  YGNodeCalculateLayout(roots[0], YGUndefined, YGUndefined, YGDirectionLTR);
+  YGNodeCalculateLayout(roots[1], YGUndefined, YGUndefined, YGDirectionLTR);
+  YG_TEST_CHECK(YGNodeLayoutGetTop(YGNodeGetChild(roots[1], 0)) == 20);
+  YG_TEST_CHECK(YGTestSameLayout(roots[0], roots[1]));
+  for (uint32_t i = 0; i < 2; i++) {
+    YGNodeFreeRecursive(roots[i]);
+  }
+  YGSetExperimentalFeatureEnabled(YGExperimentalFeatureRounding, false);
+}
+
+int main(void) {
+  testRenderPattern(false);
+  testRenderPattern(true);
+  testPercentOfParentAfterEmptyMeasurement();
+  testWrapWithinCacheTolerance();
+  testRoundedCachedRoot();
+  testRoundedBaselineOfCachedChild();
+  return 0;
+}
@@ -0,0 +1,129 @@
+/** Copyright (c) 2014-present, Facebook, Inc. */
+
+// Trial layouts between a checkpoint and its restore leave no trace: the tree goes on exactly like
+// a copy laid out with plain YGNodeCalculateLayout that never saw the trials.
+
+#include "YGTestUtils.h"
+
+static YGNodeRef nodeAt(const YGNodeRef node, uint32_t *const index) {
+  if ((*index)-- == 0) {
+    return node;
+  }
+  for (uint32_t i = 0; i < YGNodeGetChildCount(node); i++) {
+    const YGNodeRef found = nodeAt(YGNodeGetChild(node, i), index);
+    if (found != NULL) {
+      return found;
+    }
+  }
+  return NULL;
+}
+
+// The node at the given depth-first index.
+static YGNodeRef nthNode(const YGNodeRef root, uint32_t index) {
+  return nodeAt(root, &index);
+}
+
+static void change(const YGNodeRef node, const unsigned value) {
+  switch (value % 4) {
+    case 0:
+      YGNodeStyleSetMargin(node, YGEdgeLeft, value % 13);
+      break;
+    case 1:
+      YGNodeStyleSetWidthPercent(node, 20 + value % 60);
+      break;
+    case 2:
+      YGNodeStyleSetFlexDirection(node, (YGFlexDirection)(value % 4));
+      break;
+    default:
+      YGNodeStyleSetPadding(node, YGEdgeAll, value % 9);
+      break;
+  }
+}
+
+static void testRandomTrees(const bool rounding) {
+  YGSetExperimentalFeatureEnabled(YGExperimentalFeatureRounding, rounding);
+  for (int t = 0; t < 150; t++) {
+    YGNodeRef tried, plain;
+    YGTestBuildTreePair(4, &tried, &plain);
+    const uint32_t nodeCount = YGTestNodeCount(tried);
+    YGNodeCalculateLayout(tried, 300, 400, YGDirectionLTR);
+    YGNodeCalculateLayout(plain, 300, 400, YGDirectionLTR);
+
+    // A pending change is part of what gets saved.
+    if (t % 3 == 0) {
+      const uint32_t index = YGTestRandom() % nodeCount;
+      const unsigned value = YGTestRandom();
+      change(nthNode(tried, index), value);
+      change(nthNode(plain, index), value);
+    }
+    const YGLayoutCheckpointRef checkpoint = YGLayoutCheckpoint(tried);
+    YG_TEST_CHECK(checkpoint != NULL);
+    for (int trial = 0; trial < 3; trial++) {
+      for (int i = 0; i < 3; i++) {
+        change(nthNode(tried, YGTestRandom() % nodeCount), YGTestRandom());
+      }
+      YGNodeCalculateLayout(tried,
+                            200 + YGTestRandom() % 200,
+                            trial == 0 ? 500 : YGUndefined,
+                            trial == 2 ? YGDirectionRTL : YGDirectionLTR);
+      YGLayoutRestore(checkpoint);
+      YG_TEST_CHECK(YGNodeIsDirty(tried) == YGNodeIsDirty(plain));
+      YG_TEST_CHECK(YGTestSameLayout(tried, plain));
+    }
+    YGLayoutCheckpointFree(checkpoint);
+
+    // The next layouts measure what the copy measures and come out the same.
+    for (int step = 0; step < 4; step++) {
+      float width = 300;
+      float height = 400;
+      if (step > 0) {
+        const uint32_t index = YGTestRandom() % nodeCount;
+        const unsigned value = YGTestRandom();
+        change(nthNode(tried, index), value);
+        change(nthNode(plain, index), value);
+        width = 150 + YGTestRandom() % 300;
+        height = YGUndefined;
+      }
+      gYGTestMeasureCalls = 0;
+      YGNodeCalculateLayout(tried, width, height, YGDirectionLTR);
+      const int triedCalls = gYGTestMeasureCalls;
+      gYGTestMeasureCalls = 0;
+      YGNodeCalculateLayout(plain, width, height, YGDirectionLTR);
+      YG_TEST_CHECK(triedCalls == gYGTestMeasureCalls);
+      YG_TEST_CHECK(YGTestSameLayout(tried, plain));
+    }
+    YGNodeFreeRecursive(tried);
+    YGNodeFreeRecursive(plain);
+  }
+  YGSetExperimentalFeatureEnabled(YGExperimentalFeatureRounding, false);
+}
+
+// The checkpoint of a subtree puts the dirty flags of its ancestors back too.
+static void testSubtree(void) {
+  const YGNodeRef root = YGNodeNew();
+  YGNodeStyleSetWidth(root, 200);
+  for (uint32_t i = 0; i < 3; i++) {
+    const YGNodeRef child = YGNodeNew();
+    YGNodeStyleSetHeight(child, 30);
+    YGNodeInsertChild(root, child, i);
+  }
+  YGNodeCalculateLayout(root, YGUndefined, YGUndefined, YGDirectionLTR);
+
+  const YGNodeRef middle = YGNodeGetChild(root, 1);
+  const YGLayoutCheckpointRef checkpoint = YGLayoutCheckpoint(middle);
+  YGNodeStyleSetHeight(middle, 80);
+  YG_TEST_CHECK(YGNodeIsDirty(root));
+  YGLayoutRestore(checkpoint);
+  YGLayoutCheckpointFree(checkpoint);
+  YG_TEST_CHECK(!YGNodeIsDirty(root) && !YGNodeIsDirty(middle));
+  YG_TEST_CHECK(YGNodeStyleGetHeight(middle).value == 30);
+  YGNodeFreeRecursive(root);
+}
+
+int main(void) {
+  testRandomTrees(false);
+  testRandomTrees(true);
+  testSubtree();
+  YG_TEST_CHECK(YGNodeGetInstanceCount() == 0);
+  return 0;
+}
@@ -0,0 +1,104 @@
+/** Copyright (c) 2014-present, Facebook, Inc. */
+
+// YGNodeCalculateLayoutFitting lays out a root without dimensions of its own like YGNodeMeasure
+// followed by YGNodeCalculateLayout at the measured size. Percentages in the root's style and the
+// max dimensions of a measured root resolve against the limits the root fits in instead.
+
+#include "YGTestUtils.h"
+
+// Leaves the root without dimensions, max dimensions, margins and percentages of its own.
+static void plainRoot(const YGNodeRef root) {
+  YGNodeStyleSetWidth(root, YGUndefined);
+  YGNodeStyleSetHeight(root, YGUndefined);
+  YGNodeStyleSetMaxWidth(root, YGUndefined);
+  YGNodeStyleSetMargin(root, YGEdgeAll, 0);
+}
+
+// Reused measurements can differ from new ones in the last bits of a float, which rounding can
+// turn into a point.
+static void testMatchesMeasureThenLayout(const bool rounding) {
+  YGSetExperimentalFeatureEnabled(YGExperimentalFeatureRounding, rounding);
+  const float tolerance = rounding ? 1 : 0.001f;
+  int inexact = 0;
+  for (int t = 0; t < 400; t++) {
+    YGNodeRef fitted, measured;
+    YGTestBuildTreePair(4, &fitted, &measured);
+    plainRoot(fitted);
+    plainRoot(measured);
+    const float maxWidth = 200 + YGTestRandom() % 200;
+    const float maxHeight = t % 3 == 0 ? YGUndefined : 100 + YGTestRandom() % 400;
+    const YGDirection direction = t % 5 == 0 ? YGDirectionRTL : YGDirectionLTR;
+
+    YGNodeCalculateLayoutFitting(fitted, maxWidth, maxHeight, direction);
+    YGNodeStyleSetDirection(measured, direction);
+    const YGSize size = YGNodeMeasure(measured,
+                                      maxWidth,
+                                      YGMeasureModeAtMost,
+                                      maxHeight,
+                                      YGFloatIsUndefined(maxHeight) ? YGMeasureModeUndefined
+                                                                     : YGMeasureModeAtMost);
+    YGNodeCalculateLayout(measured, size.width, size.height, direction);
+    if (!YGTestSameLayoutWithin(fitted, measured, tolerance)) {
+      fprintf(stderr, "tree %d\n", t);
+      exit(1);
+    }
+    inexact += YGTestLayoutDifference(fitted, measured) > 0;
+    YGNodeFreeRecursive(fitted);
+    YGNodeFreeRecursive(measured);
+  }
+  YG_TEST_CHECK(inexact < 20);
+  YGSetExperimentalFeatureEnabled(YGExperimentalFeatureRounding, false);
+}
+
+// A max width in percent is a share of the limit the root fits in, for the root and so for the
+// percentages of its children; laid out at the measured size it would be a share of that size.
+static void testRootMaxWidthPercent(void) {
+  YGNodeRef roots[2];
+  for (uint32_t i = 0; i < 2; i++) {
+    roots[i] = YGNodeNew();
+    YGNodeStyleSetMaxWidthPercent(roots[i], 20);
+    const YGNodeRef text = YGNodeNew();
+    YGNodeSetContext(text, (void *) 6L);
+    YGNodeSetMeasureFunc(text, YGTestMeasure);
+    YGNodeInsertChild(roots[i], text, 0);
+    const YGNodeRef half = YGNodeNew();
+    YGNodeStyleSetWidthPercent(half, 50);
+    YGNodeStyleSetHeight(half, 10);
+    YGNodeInsertChild(roots[i], half, 1);
+  }
+
+  YGNodeCalculateLayoutFitting(roots[0], 300, YGUndefined, YGDirectionLTR);
+  const YGNodeRef text = YGNodeGetChild(roots[0], 0);
+  YG_TEST_CHECK(YGNodeLayoutGetWidth(roots[0]) == 60 && YGNodeLayoutGetWidth(text) == 60);
+  YG_TEST_CHECK(fabsf(YGNodeLayoutGetHeight(text) - 11 * 88 / 60.0f) < 0.001f);
+  YG_TEST_CHECK(YGNodeLayoutGetWidth(YGNodeGetChild(roots[0], 1)) == 30);
+
+  const YGSize size =
+      YGNodeMeasure(roots[1], 300, YGMeasureModeAtMost, YGUndefined, YGMeasureModeUndefined);
+  YGNodeCalculateLayout(roots[1], size.width, size.height, YGDirectionLTR);
+  YG_TEST_CHECK(size.width == 60 && YGNodeLayoutGetWidth(roots[1]) == 12);
+  YG_TEST_CHECK(YGNodeLayoutGetWidth(YGNodeGetChild(roots[1], 1)) == 6);
+  for (uint32_t i = 0; i < 2; i++) {
+    YGNodeFreeRecursive(roots[i]);
+  }
+}
+
+// A measured root with a max width is measured at it, so its text wraps to the width it gets.
+static void testMeasuredRootMaxWidth(void) {
+  const YGNodeRef root = YGNodeNew();
+  YGNodeStyleSetMaxWidth(root, 60);
+  YGNodeSetContext(root, (void *) 6L);
+  YGNodeSetMeasureFunc(root, YGTestMeasure);
+  YGNodeCalculateLayoutFitting(root, 300, YGUndefined, YGDirectionLTR);
+  YG_TEST_CHECK(YGNodeLayoutGetWidth(root) == 60);
+  YG_TEST_CHECK(fabsf(YGNodeLayoutGetHeight(root) - 11 * 88 / 60.0f) < 0.001f);
+  YGNodeFreeRecursive(root);
+}
+
+int main(void) {
+  testMatchesMeasureThenLayout(false);
+  testMatchesMeasureThenLayout(true);
+  testRootMaxWidthPercent();
+  testMeasuredRootMaxWidth();
+  return 0;
+}
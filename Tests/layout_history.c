@@ -0,0 +1,101 @@
+/** Copyright (c) 2014-present, Facebook, Inc. */
+
+// Laying a tree out at one size and then at another gives the frames of a tree laid out only at
+// the second, in the cases where a cached result used to carry the first layout over.
+
+#include "YGTestUtils.h"
+
+// 200 points wide on one line of 20, wrapping to a narrower width it is given.
+static YGSize measureText(YGNodeRef node,
+                          float width,
+                          YGMeasureMode widthMode,
+                          float height,
+                          YGMeasureMode heightMode) {
+  (void) node;
+  (void) height;
+  (void) heightMode;
+  if (widthMode != YGMeasureModeUndefined && width < 200) {
+    return (YGSize){.width = width, .height = 20 * 200 / fmaxf(width, 1)};
+  }
+  return (YGSize){.width = 200, .height = 20};
+}
+
+// A column that leaves one text its own width, after a margin.
+static YGNodeRef buildColumn(const float margin) {
+  const YGNodeRef root = YGNodeNew();
+  YGNodeStyleSetAlignItems(root, YGAlignFlexStart);
+  const YGNodeRef text = YGNodeNew();
+  YGNodeStyleSetMargin(text, YGEdgeLeft, margin);
+  YGNodeSetMeasureFunc(text, measureText);
+  YGNodeInsertChild(root, text, 0);
+  return root;
+}
+
+static void checkTextAfterResize(const float margin,
+                                 const float firstWidth,
+                                 const float secondWidth,
+                                 const float expectedWidth,
+                                 const float expectedHeight) {
+  const YGNodeRef resized = buildColumn(margin);
+  const YGNodeRef fresh = buildColumn(margin);
+  YGNodeCalculateLayout(resized, firstWidth, YGUndefined, YGDirectionLTR);
+  YGNodeCalculateLayout(resized, secondWidth, YGUndefined, YGDirectionLTR);
+  YGNodeCalculateLayout(fresh, secondWidth, YGUndefined, YGDirectionLTR);
+  YG_TEST_CHECK(YGTestSameLayoutWithin(resized, fresh, 0.001f));
+  const YGNodeRef text = YGNodeGetChild(resized, 0);
+  YG_TEST_CHECK(fabsf(YGNodeLayoutGetWidth(text) - expectedWidth) < 0.001f);
+  YG_TEST_CHECK(fabsf(YGNodeLayoutGetHeight(text) - expectedHeight) < 0.001f);
+  YGNodeFreeRecursive(resized);
+  YGNodeFreeRecursive(fresh);
+}
+
+// The text was measured at most 90 wide after its margin, then gets 95: the cache used to take
+// 95 for a stricter constraint than 100 with the margin and keep the narrower result.
+static void testMarginNotInStricterSize(void) {
+  checkTextAfterResize(10, 100, 105, 95, 20 * 200 / 95.0f);
+}
+
+// A width of 3e-5 is 0 to the caches, so it leaves no room for the text as 0 does, whether the
+// node was laid out at 0 before or not.
+static void testNoiseAboveZeroIsEmpty(void) {
+  checkTextAfterResize(0, 0, 3e-5f, 0, 0);
+}
+
+// Turns some containers into rows aligned by their baselines.
+static void addBaselines(const YGNodeRef node) {
+  const int context = (int) (long) YGNodeGetContext(node);
+  if (YGNodeGetChildCount(node) > 0 && context % 3 == 1) {
+    YGNodeStyleSetFlexDirection(node, context % 2 ? YGFlexDirectionRow : YGFlexDirectionRowReverse);
+    YGNodeStyleSetAlignItems(node, YGAlignBaseline);
+  }
+  for (uint32_t i = 0; i < YGNodeGetChildCount(node); i++) {
+    addBaselines(YGNodeGetChild(node, i));
+  }
+}
+
+// A tree whose second layout measures a child of a baseline-aligned row again after laying it out
+// and then reuses that layout: the baseline used to come from the newer measurement while the
+// content kept the positions of the layout.
+static void testBaselineReadsLaidOutSize(void) {
+  gYGTestSeed = 526140945u;
+  gYGTestContext = 3451;
+  YGNodeRef resized, fresh;
+  YGTestBuildTreePair(5, &resized, &fresh);
+  addBaselines(resized);
+  addBaselines(fresh);
+  YGNodeCalculateLayout(resized, 313, 692, YGDirectionLTR);
+  YGNodeCalculateLayout(resized, 318, 465, YGDirectionLTR);
+  YGNodeCalculateLayout(fresh, 318, 465, YGDirectionLTR);
+  YG_TEST_CHECK(YGTestSameLayoutWithin(resized, fresh, 0.001f));
+  YGNodeFreeRecursive(resized);
+  YGNodeFreeRecursive(fresh);
+  gYGTestSeed = 12345;
+  gYGTestContext = 0;
+}
+
+int main(void) {
+  testMarginNotInStricterSize();
+  testNoiseAboveZeroIsEmpty();
+  testBaselineReadsLaidOutSize();
+  return 0;
+}
@@ -0,0 +1,142 @@
+/** Copyright (c) 2014-present, Facebook, Inc. */
+
+// A layout program lays out the trees it compiles exactly like plain YGNodeCalculateLayout lays
+// out a copy, at any size, after leaf content changes and alternating with the engine.
+
+#include "YGTestUtils.h"
+
+// A random tree within what programs cover: point sizes, grow-only flexing on a single line and
+// flex, stretch, start, center and end alignment.
+static YGNodeRef buildTree(const int depth) {
+  const YGNodeRef node = YGNodeNew();
+  YGNodeSetContext(node, (void *) (long) (++gYGTestContext));
+  const unsigned r = YGTestRandom();
+  YGNodeStyleSetFlexDirection(node, (YGFlexDirection)(r % 4));
+  YGNodeStyleSetJustifyContent(node, (YGJustify)((r >> 2) % 5));
+  YGNodeStyleSetAlignItems(node, (YGAlign)(YGAlignFlexStart + (r >> 5) % 4));
+  if ((r >> 7) % 5 == 0) {
+    YGNodeStyleSetAlignSelf(node, (YGAlign)(YGAlignFlexStart + (r >> 9) % 4));
+  }
+  if (YGTestRandom() % 3 == 0) {
+    YGNodeStyleSetWidth(node, 20 + YGTestRandom() % 200);
+  }
+  if (YGTestRandom() % 4 == 0) {
+    YGNodeStyleSetHeight(node, 10 + YGTestRandom() % 150);
+  }
+  if (YGTestRandom() % 3 == 0) {
+    YGNodeStyleSetFlexGrow(node, 1 + YGTestRandom() % 3);
+  }
+  if (YGTestRandom() % 4 == 0) {
+    YGNodeStyleSetMargin(node, (YGEdge)(YGTestRandom() % YGEdgeCount), YGTestRandom() % 10);
+  }
+  if (YGTestRandom() % 4 == 0) {
+    YGNodeStyleSetPadding(node, (YGEdge)(YGTestRandom() % YGEdgeCount), YGTestRandom() % 10);
+  }
+  if (YGTestRandom() % 6 == 0) {
+    YGNodeStyleSetBorder(node, YGEdgeAll, 1 + YGTestRandom() % 3);
+  }
+
+  const unsigned childCount = depth > 0 ? YGTestRandom() % 6 : 0;
+  if (childCount == 0) {
+    YGNodeSetMeasureFunc(node, YGTestMeasure);
+    return node;
+  }
+  for (unsigned i = 0; i < childCount; i++) {
+    YGNodeInsertChild(node, buildTree(depth - 1), i);
+  }
+  return node;
+}
+
+static void buildTreePair(const int depth, YGNodeRef *first, YGNodeRef *second) {
+  const unsigned seed = gYGTestSeed;
+  const int context = gYGTestContext;
+  *first = buildTree(depth);
+  gYGTestSeed = seed;
+  gYGTestContext = context;
+  *second = buildTree(depth);
+}
+
+// Gives a random leaf of both copies of a tree other content.
+static void changeAnyLeaf(YGNodeRef node, YGNodeRef copy) {
+  while (YGNodeGetChildCount(node) > 0) {
+    const uint32_t index = YGTestRandom() % YGNodeGetChildCount(node);
+    node = YGNodeGetChild(node, index);
+    copy = YGNodeGetChild(copy, index);
+  }
+  const long context = (long) YGNodeGetContext(node) + 1;
+  YGNodeSetContext(node, (void *) context);
+  YGNodeSetContext(copy, (void *) context);
+  YGNodeMarkDirty(node);
+  YGNodeMarkDirty(copy);
+}
+
+static void testRandomTreesMatchEngine(const bool rounding) {
+  YGSetExperimentalFeatureEnabled(YGExperimentalFeatureRounding, rounding);
+  int compiled = 0;
+  for (int t = 0; t < 400; t++) {
+    YGNodeRef run, plain;
+    buildTreePair(4, &run, &plain);
+    const YGDirection direction = t % 4 == 0 ? YGDirectionRTL : YGDirectionLTR;
+    const YGLayoutProgramRef program = YGLayoutProgramNew(run, direction);
+    if (program == NULL) {
+      YG_TEST_CHECK(YGNodeGetChildCount(run) == 0);
+      YGNodeFreeRecursive(run);
+      YGNodeFreeRecursive(plain);
+      continue;
+    }
+    compiled++;
+
+    for (int step = 0; step < 6; step++) {
+      const float width = 150 + YGTestRandom() % 400;
+      const float height = step % 3 == 0 ? YGUndefined : 200 + YGTestRandom() % 400;
+      // Leaf content changes keep the program, and the engine can lay the same tree out too.
+      if (step % 2 == 1) {
+        changeAnyLeaf(run, plain);
+      }
+      if (step == 4) {
+        YGNodeCalculateLayout(run, width, height, direction);
+      } else {
+        YG_TEST_CHECK(YGLayoutProgramRun(program, width, height));
+      }
+      YGNodeCalculateLayout(plain, width, height, direction);
+      if (!YGTestSameLayout(run, plain)) {
+        fprintf(stderr, "tree %d step %d\n", t, step);
+        exit(1);
+      }
+    }
+
+    // A style change makes the program stale.
+    YGNodeStyleSetMargin(YGNodeGetChild(run, 0), YGEdgeLeft, 11);
+    YG_TEST_CHECK(!YGLayoutProgramRun(program, 300, 400));
+    YGLayoutProgramFree(program);
+    YGNodeFreeRecursive(run);
+    YGNodeFreeRecursive(plain);
+  }
+  YG_TEST_CHECK(compiled > 300);
+  YGSetExperimentalFeatureEnabled(YGExperimentalFeatureRounding, false);
+}
+
+// Trees outside what programs cover are not compiled.
+static void testUnsupportedTrees(void) {
+  const YGNodeRef root = YGNodeNew();
+  const YGNodeRef child = YGNodeNew();
+  YGNodeInsertChild(root, child, 0);
+  YGNodeStyleSetWidthPercent(child, 50);
+  YG_TEST_CHECK(YGLayoutProgramNew(root, YGDirectionLTR) == NULL);
+  YGNodeStyleSetWidth(child, 50);
+  YGNodeStyleSetFlexWrap(root, YGWrapWrap);
+  YG_TEST_CHECK(YGLayoutProgramNew(root, YGDirectionLTR) == NULL);
+  YGNodeStyleSetFlexWrap(root, YGWrapNoWrap);
+  YGNodeStyleSetFlexDirection(root, YGFlexDirectionRow);
+  YGNodeStyleSetAlignItems(root, YGAlignBaseline);
+  YG_TEST_CHECK(YGLayoutProgramNew(root, YGDirectionLTR) == NULL);
+  YGNodeFreeRecursive(root);
+}
+
+int main(void) {
+  testRandomTreesMatchEngine(false);
+  testRandomTreesMatchEngine(true);
+  testUnsupportedTrees();
+  YG_TEST_CHECK(YGNodeGetInstanceCount() == 0);
+  return 0;
+}
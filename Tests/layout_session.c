@@ -0,0 +1,238 @@
+/** Copyright (c) 2014-present, Facebook, Inc. */
+
+// Sliced layouts, through sessions or the scheduler, come out as a layout done in one go.
+
+#include "YGTestUtils.h"
+
+#include <time.h>
+
+#define ROOT_COUNT 600
+#define SECTION_COUNT 100
+#define CARD_COUNT 20
+#define STEP_BUDGET_MICROS 5000
+
+static YGNodeRef anyNode(YGNodeRef node) {
+  while (YGNodeGetChildCount(node) > 0 && YGTestRandom() % 3 != 0) {
+    node = YGNodeGetChild(node, YGTestRandom() % YGNodeGetChildCount(node));
+  }
+  return node;
+}
+
+// Steps with no budget, so every step does the least it can, and reads a frame now and then,
+// which positions its pending ancestors before the session gets to them.
+static void layOutInSlices(const YGNodeRef root, const float width, const float height) {
+  const YGLayoutSessionRef session = YGLayoutBegin(root, width, height, YGDirectionLTR);
+  while (!YGLayoutStep(session, 0)) {
+    if (YGTestRandom() % 4 == 0) {
+      YGNodeLayoutGetTop(anyNode(root));
+    }
+  }
+  YGLayoutCommit(session);
+}
+
+// A tree the session used to get wrong along with YGNodeCalculateLayoutDeferred, see
+// Tests/deferred_layout.c.
+static void testPinnedTree(void) {
+  gYGTestSeed = 595333078u;
+  gYGTestContext = 63709;
+  YGNodeRef eager, sliced;
+  YGTestBuildTreePair(5, &eager, &sliced);
+  YGNodeCalculateLayout(eager, 437, 480, YGDirectionLTR);
+  layOutInSlices(sliced, 437, 480);
+  YG_TEST_CHECK(YGTestSameLayoutWithin(eager, sliced, 0.001f));
+  YGNodeFreeRecursive(eager);
+  YGNodeFreeRecursive(sliced);
+  gYGTestSeed = 12345;
+  gYGTestContext = 0;
+}
+
+// Up to float noise, which rounding can turn into a point: sliced layouts lay out containers from
+// their own requests rather than within their parents' passes. Few trees differ at all.
+static void testRandomSessionsMatchEagerLayout(const bool rounding) {
+  YGSetExperimentalFeatureEnabled(YGExperimentalFeatureRounding, rounding);
+  const float tolerance = rounding ? 1 : 0.001f;
+  int inexact = 0;
+  for (int t = 0; t < 2000; t++) {
+    YGNodeRef eager, sliced;
+    YGTestBuildTreePair(5, &eager, &sliced);
+    const float width = 200 + YGTestRandom() % 400;
+    const float height = t % 3 == 0 ? YGUndefined : 300 + YGTestRandom() % 400;
+    YGNodeCalculateLayout(eager, width, height, YGDirectionLTR);
+    layOutInSlices(sliced, width, height);
+    if (!YGTestSameLayoutWithin(eager, sliced, tolerance)) {
+      fprintf(stderr, "tree %d\n", t);
+      exit(1);
+    }
+    inexact += YGTestLayoutDifference(eager, sliced) > 0;
+    YGNodeFreeRecursive(eager);
+    YGNodeFreeRecursive(sliced);
+  }
+  YG_TEST_CHECK(inexact < 2000 / 25);
+  YGSetExperimentalFeatureEnabled(YGExperimentalFeatureRounding, false);
+}
+
+// Roots queued with mixed priorities and deadlines and run a little at a time. Some are requested
+// again while their layout is in progress, which starts it over. Compared like the sessions above.
+static void testSchedulerMatchesEagerLayout(const bool rounding) {
+  YGSetExperimentalFeatureEnabled(YGExperimentalFeatureRounding, rounding);
+  const float tolerance = rounding ? 1 : 0.001f;
+  int inexact = 0;
+  static YGNodeRef eager[ROOT_COUNT];
+  static YGNodeRef scheduled[ROOT_COUNT];
+  static float widths[ROOT_COUNT];
+  static float heights[ROOT_COUNT];
+  const YGLayoutSchedulerRef scheduler = YGLayoutSchedulerNew();
+  for (int i = 0; i < ROOT_COUNT; i++) {
+    YGTestBuildTreePair(4, &eager[i], &scheduled[i]);
+    widths[i] = 200 + YGTestRandom() % 400;
+    heights[i] = i % 3 == 0 ? YGUndefined : 300 + YGTestRandom() % 400;
+    YGNodeCalculateLayout(eager[i], widths[i], heights[i], YGDirectionLTR);
+    YGLayoutSchedulerEnqueue(
+        scheduler, scheduled[i], widths[i], heights[i], YGDirectionLTR, i % 3, 1000 + i % 50);
+    if (i % 7 == 6) {
+      YGLayoutSchedulerRun(scheduler, 0);
+      const int again = i - YGTestRandom() % 7;
+      YGLayoutSchedulerEnqueue(
+          scheduler, scheduled[again], widths[again], heights[again], YGDirectionLTR, 0, 0);
+    }
+  }
+  while (YGLayoutSchedulerGetQueueLength(scheduler) > 0) {
+    YGLayoutSchedulerRun(scheduler, 50);
+  }
+  YGLayoutSchedulerFree(scheduler);
+
+  for (int i = 0; i < ROOT_COUNT; i++) {
+    if (!YGTestSameLayoutWithin(eager[i], scheduled[i], tolerance)) {
+      fprintf(stderr, "root %d\n", i);
+      exit(1);
+    }
+    inexact += YGTestLayoutDifference(eager[i], scheduled[i]) > 0;
+    YGNodeFreeRecursive(eager[i]);
+    YGNodeFreeRecursive(scheduled[i]);
+  }
+  YG_TEST_CHECK(inexact < ROOT_COUNT / 25);
+  YGSetExperimentalFeatureEnabled(YGExperimentalFeatureRounding, false);
+}
+
+static YGNodeRef buildText(const bool shrinks) {
+  const YGNodeRef text = YGNodeNew();
+  YGNodeSetContext(text, (void *) (long) ++gYGTestContext);
+  YGNodeSetMeasureFunc(text, YGTestMeasure);
+  YGNodeStyleSetFlexShrink(text, shrinks ? 1 : 0);
+  return text;
+}
+
+// Sections of cards, each a row of three texts over three more, in a root of fixed width: every
+// height comes from the texts.
+static YGNodeRef buildFeed(void) {
+  gYGTestContext = 0;
+  const YGNodeRef root = YGNodeNew();
+  YGNodeStyleSetWidth(root, 375);
+  for (uint32_t i = 0; i < SECTION_COUNT; i++) {
+    const YGNodeRef section = YGNodeNew();
+    YGNodeStyleSetPadding(section, YGEdgeAll, 4);
+    for (uint32_t j = 0; j < CARD_COUNT; j++) {
+      const YGNodeRef card = YGNodeNew();
+      YGNodeStyleSetPadding(card, YGEdgeAll, 8);
+      const YGNodeRef row = YGNodeNew();
+      YGNodeStyleSetFlexDirection(row, YGFlexDirectionRow);
+      for (uint32_t k = 0; k < 3; k++) {
+        YGNodeInsertChild(row, buildText(true), k);
+      }
+      YGNodeInsertChild(card, row, 0);
+      for (uint32_t k = 0; k < 3; k++) {
+        YGNodeInsertChild(card, buildText(false), k + 1);
+      }
+      YGNodeInsertChild(section, card, j);
+    }
+    YGNodeInsertChild(root, section, i);
+  }
+  return root;
+}
+
+static double nowMicros(void) {
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return now.tv_sec * 1e6 + now.tv_nsec / 1e3;
+}
+
+// A tree sized by its content is measured a node at a time before it is sized, so a step without
+// budget measures no more than a row of texts, and a step with one overruns it by no more than a
+// unit of work, which for this tree takes a fraction of the budget.
+static void testContentSizedStepsKeepToBudget(void) {
+  const YGNodeRef eager = buildFeed();
+  const YGNodeRef sliced = buildFeed();
+  YGNodeCalculateLayout(eager, YGUndefined, YGUndefined, YGDirectionLTR);
+  YGLayoutSessionRef session = YGLayoutBegin(sliced, YGUndefined, YGUndefined, YGDirectionLTR);
+  int maxCalls = 0;
+  bool done;
+  do {
+    gYGTestMeasureCalls = 0;
+    done = YGLayoutStep(session, 0);
+    if (gYGTestMeasureCalls > maxCalls) {
+      maxCalls = gYGTestMeasureCalls;
+    }
+  } while (!done);
+  YGLayoutCommit(session);
+  YG_TEST_CHECK(maxCalls > 0 && maxCalls <= 3);
+  YG_TEST_CHECK(YGTestSameLayoutWithin(eager, sliced, 0.001f));
+
+  // Narrower, so every text is measured again.
+  YGNodeCalculateLayout(eager, 300, YGUndefined, YGDirectionLTR);
+  session = YGLayoutBegin(sliced, 300, YGUndefined, YGDirectionLTR);
+  double worstStep = 0;
+  do {
+    const double start = nowMicros();
+    done = YGLayoutStep(session, STEP_BUDGET_MICROS);
+    worstStep = fmax(worstStep, nowMicros() - start);
+  } while (!done);
+  YGLayoutCommit(session);
+  YG_TEST_CHECK(worstStep < 2 * STEP_BUDGET_MICROS);
+  YG_TEST_CHECK(YGTestSameLayoutWithin(eager, sliced, 0.001f));
+
+  YGNodeFreeRecursive(eager);
+  YGNodeFreeRecursive(sliced);
+}
+
+// The scheduler runs sessions, so its runs keep to the budget like their steps, here over two
+// feeds sized by their content, one of them requested again halfway.
+static void testContentSizedRunsKeepToBudget(void) {
+  const YGNodeRef eager = buildFeed();
+  YGNodeCalculateLayout(eager, YGUndefined, YGUndefined, YGDirectionLTR);
+  YGNodeRef scheduled[2];
+  const YGLayoutSchedulerRef scheduler = YGLayoutSchedulerNew();
+  for (uint32_t i = 0; i < 2; i++) {
+    scheduled[i] = buildFeed();
+    YGLayoutSchedulerEnqueue(
+        scheduler, scheduled[i], YGUndefined, YGUndefined, YGDirectionLTR, i, 16000);
+  }
+  double worstRun = 0;
+  int runs = 0;
+  while (YGLayoutSchedulerGetQueueLength(scheduler) > 0) {
+    const double start = nowMicros();
+    YGLayoutSchedulerRun(scheduler, STEP_BUDGET_MICROS);
+    worstRun = fmax(worstRun, nowMicros() - start);
+    if (++runs == 3) {
+      YGLayoutSchedulerEnqueue(
+          scheduler, scheduled[0], YGUndefined, YGUndefined, YGDirectionLTR, 0, 16000);
+    }
+  }
+  YGLayoutSchedulerFree(scheduler);
+  YG_TEST_CHECK(worstRun < 2 * STEP_BUDGET_MICROS);
+  for (uint32_t i = 0; i < 2; i++) {
+    YG_TEST_CHECK(YGTestSameLayoutWithin(eager, scheduled[i], 0.001f));
+    YGNodeFreeRecursive(scheduled[i]);
+  }
+  YGNodeFreeRecursive(eager);
+}
+
+int main(void) {
+  testPinnedTree();
+  testRandomSessionsMatchEagerLayout(false);
+  testRandomSessionsMatchEagerLayout(true);
+  testContentSizedStepsKeepToBudget();
+  testSchedulerMatchesEagerLayout(false);
+  testSchedulerMatchesEagerLayout(true);
+  testContentSizedRunsKeepToBudget();
+  return 0;
+}
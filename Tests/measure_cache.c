@@ -0,0 +1,138 @@
+/** Copyright (c) 2014-present, Facebook, Inc. */
+
+// Layouts through a measurement cache come out as without one, on the launch that fills the file
+// and on the next ones reading it back, and the file is kept to one process.
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "YGTestUtils.h"
+
+#define TREE_COUNT 60
+
+static char gCachePath[256];
+
+// YGTestMeasure only looks at the context modulo 7 and 5.
+static void setMeasureKeys(const YGNodeRef node) {
+  if (YGNodeGetChildCount(node) == 0) {
+    YGNodeSetMeasureKey(node, 1 + (long) YGNodeGetContext(node) % 35);
+  }
+  for (uint32_t i = 0; i < YGNodeGetChildCount(node); i++) {
+    setMeasureKeys(YGNodeGetChild(node, i));
+  }
+}
+
+// Lays out the same random trees with and without the cache, at two widths each, reopening the
+// file for every tree like a new launch would, and compacting it now and then when asked to.
+// Returns the measure calls made with the cache.
+static int launch(const uint32_t capacity, const bool compact) {
+  gYGTestSeed = 12345;
+  gYGTestContext = 0;
+  int measureCalls = 0;
+  for (int t = 0; t < TREE_COUNT; t++) {
+    YGNodeRef cached, plain;
+    YGTestBuildTreePair(4, &cached, &plain);
+    setMeasureKeys(cached);
+    const float width = 100 + YGTestRandom() % 300;
+    const float height = t % 3 == 0 ? YGUndefined : 200 + YGTestRandom() % 300;
+
+    const YGMeasureCacheRef cache = YGMeasureCacheOpen(gCachePath, capacity);
+    YG_TEST_CHECK(cache != NULL);
+    YGSetMeasureCache(cache);
+    gYGTestMeasureCalls = 0;
+    YGNodeCalculateLayout(cached, width, height, YGDirectionLTR);
+    YGNodeCalculateLayout(cached, width * 0.8f, height, YGDirectionLTR);
+    measureCalls += gYGTestMeasureCalls;
+    YGSetMeasureCache(NULL);
+    YG_TEST_CHECK(YGMeasureCacheGetCount(cache) <= capacity);
+    if (compact && t % 7 == 3) {
+      YGMeasureCacheCompact(cache);
+    }
+    YGMeasureCacheClose(cache);
+
+    YGNodeCalculateLayout(plain, width, height, YGDirectionLTR);
+    YGNodeCalculateLayout(plain, width * 0.8f, height, YGDirectionLTR);
+    YG_TEST_CHECK(YGTestSameLayout(cached, plain));
+    YGNodeFreeRecursive(cached);
+    YGNodeFreeRecursive(plain);
+  }
+  return measureCalls;
+}
+
+static void testMatchesUncachedLayout(void) {
+  YG_TEST_CHECK(launch(100000, false) > 0);
+  YG_TEST_CHECK(launch(100000, false) == 0);
+
+  // A file too small for the trees compacts as it goes.
+  unlink(gCachePath);
+  YG_TEST_CHECK(launch(64, true) > 0);
+}
+
+// A second process cannot open the file while the first one has it.
+static void testOneProcessAtATime(void) {
+  const YGMeasureCacheRef cache = YGMeasureCacheOpen(gCachePath, 1000);
+  YG_TEST_CHECK(cache != NULL);
+  const pid_t child = fork();
+  if (child == 0) {
+    _exit(YGMeasureCacheOpen(gCachePath, 1000) == NULL ? 0 : 1);
+  }
+  int status;
+  YG_TEST_CHECK(waitpid(child, &status, 0) == child);
+  YG_TEST_CHECK(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+  YGMeasureCacheClose(cache);
+
+  const pid_t next = fork();
+  if (next == 0) {
+    const YGMeasureCacheRef reopened = YGMeasureCacheOpen(gCachePath, 1000);
+    _exit(reopened != NULL ? 0 : 1);
+  }
+  YG_TEST_CHECK(waitpid(next, &status, 0) == next);
+  YG_TEST_CHECK(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+}
+
+// A damaged entry is dropped along with those after it, and a foreign file starts empty.
+static void testDamagedFile(void) {
+  unlink(gCachePath);
+  launch(100000, false);
+  YGMeasureCacheRef cache = YGMeasureCacheOpen(gCachePath, 100000);
+  const uint32_t count = YGMeasureCacheGetCount(cache);
+  YGMeasureCacheClose(cache);
+  YG_TEST_CHECK(count > 10);
+
+  FILE *file = fopen(gCachePath, "r+b");
+  YG_TEST_CHECK(file != NULL);
+  fseek(file, 0, SEEK_END);
+  const long size = ftell(file);
+  const long entrySize = (size - 16) / 100000;
+  fseek(file, 16 + entrySize * 5 + 9, SEEK_SET);
+  const int byte = fgetc(file);
+  fseek(file, 16 + entrySize * 5 + 9, SEEK_SET);
+  fputc(byte ^ 0x40, file);
+  fclose(file);
+
+  cache = YGMeasureCacheOpen(gCachePath, 100000);
+  YG_TEST_CHECK(YGMeasureCacheGetCount(cache) == 5);
+  YGMeasureCacheClose(cache);
+
+  file = fopen(gCachePath, "wb");
+  fputs("not a measurement cache, but long enough to hold a header", file);
+  fclose(file);
+  cache = YGMeasureCacheOpen(gCachePath, 100000);
+  YG_TEST_CHECK(cache != NULL && YGMeasureCacheGetCount(cache) == 0);
+  YGMeasureCacheClose(cache);
+}
+
+int main(void) {
+  const char *const directory = getenv("TMPDIR");
+  snprintf(gCachePath, sizeof(gCachePath), "%s/yoga_measure_cache_XXXXXX",
+           directory != NULL ? directory : "/tmp");
+  const int fd = mkstemp(gCachePath);
+  YG_TEST_CHECK(fd >= 0);
+  close(fd);
+
+  testMatchesUncachedLayout();
+  testOneProcessAtATime();
+  testDamagedFile();
+  unlink(gCachePath);
+  return 0;
+}
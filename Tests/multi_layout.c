@@ -0,0 +1,109 @@
+/** Copyright (c) 2014-present, Facebook, Inc. */
+
+// Every result of YGNodeCalculateLayoutMulti matches YGNodeCalculateLayout at that size, and the
+// tree keeps the layout it had before the call.
+
+#include "YGTestUtils.h"
+
+#define CAPACITY 20000
+#define SIZE_COUNT 3
+
+static YGFrameRecord gResults[SIZE_COUNT][CAPACITY];
+static YGFrameRecord gExpected[CAPACITY];
+static YGFrameRecord gBefore[CAPACITY];
+
+static bool sameFloat(const float a, const float b) {
+  return a == b || (isnan(a) && isnan(b));
+}
+
+static bool sameFrames(const YGFrameRecord *a, const YGFrameRecord *b, const uint32_t count) {
+  for (uint32_t i = 0; i < count; i++) {
+    if (a[i].context != b[i].context || !sameFloat(a[i].x, b[i].x) ||
+        !sameFloat(a[i].y, b[i].y) || !sameFloat(a[i].width, b[i].width) ||
+        !sameFloat(a[i].height, b[i].height)) {
+      fprintf(stderr, "record %u differs\n", i);
+      return false;
+    }
+  }
+  return true;
+}
+
+static YGNodeRef anyNode(YGNodeRef node) {
+  while (YGNodeGetChildCount(node) > 0 && YGTestRandom() % 3 != 0) {
+    node = YGNodeGetChild(node, YGTestRandom() % YGNodeGetChildCount(node));
+  }
+  return node;
+}
+
+// The node at the same place in another copy of the tree.
+static YGNodeRef sameNodeIn(const YGNodeRef root, const YGNodeRef node, const YGNodeRef copy) {
+  if (node == root) {
+    return copy;
+  }
+  const YGNodeRef parent = YGNodeGetParent(node);
+  uint32_t index = 0;
+  while (YGNodeGetChild(parent, index) != node) {
+    index++;
+  }
+  return YGNodeGetChild(sameNodeIn(root, parent, copy), index);
+}
+
+// Layouts depend on the caches earlier ones left, so each result is checked against a copy of the
+// tree given the same layouts before: single takes the sizes one after the other like the call
+// does, plain only the next layout of the tree.
+static void testRandomTrees(const bool rounding) {
+  YGSetExperimentalFeatureEnabled(YGExperimentalFeatureRounding, rounding);
+  for (int t = 0; t < 200; t++) {
+    YGNodeRef trees[3];
+    YGTestBuildTrees(4, trees, 3);
+    const YGNodeRef multi = trees[0], single = trees[1], plain = trees[2];
+    for (uint32_t i = 0; i < 3; i++) {
+      YGNodeCalculateLayout(trees[i], 300, 400, YGDirectionLTR);
+    }
+
+    // Now and then the tree is dirty when the results are asked for.
+    if (t % 3 == 0) {
+      const YGNodeRef node = anyNode(multi);
+      for (uint32_t i = 0; i < 3; i++) {
+        YGNodeStyleSetMargin(sameNodeIn(multi, node, trees[i]), YGEdgeTop, 7);
+      }
+    }
+    const uint32_t count = YGNodeExportFrames(multi, gBefore, CAPACITY);
+    const bool dirty = YGNodeIsDirty(multi);
+
+    const YGSize sizes[SIZE_COUNT] = {
+        {320, 480}, {480, 320}, {200 + YGTestRandom() % 300, YGUndefined},
+    };
+    YGLayoutResultBuffer outs[SIZE_COUNT];
+    for (uint32_t i = 0; i < SIZE_COUNT; i++) {
+      outs[i].frames = gResults[i];
+      outs[i].capacity = CAPACITY;
+    }
+    YGNodeCalculateLayoutMulti(multi, sizes, SIZE_COUNT, YGDirectionLTR, outs);
+
+    YG_TEST_CHECK(YGNodeIsDirty(multi) == dirty);
+    YG_TEST_CHECK(YGNodeExportFrames(multi, gExpected, CAPACITY) == count);
+    YG_TEST_CHECK(sameFrames(gExpected, gBefore, count));
+
+    for (uint32_t i = 0; i < SIZE_COUNT; i++) {
+      YGNodeCalculateLayout(single, sizes[i].width, sizes[i].height, YGDirectionLTR);
+      YG_TEST_CHECK(outs[i].count == YGNodeExportFrames(single, gExpected, CAPACITY));
+      YG_TEST_CHECK(sameFrames(outs[i].frames, gExpected, outs[i].count));
+    }
+
+    // The next layout of the tree itself is the one it would have had without the call.
+    YGNodeCalculateLayout(multi, sizes[1].width, sizes[1].height, YGDirectionLTR);
+    YGNodeCalculateLayout(plain, sizes[1].width, sizes[1].height, YGDirectionLTR);
+    YG_TEST_CHECK(YGTestSameLayout(multi, plain));
+    for (uint32_t i = 0; i < 3; i++) {
+      YGNodeFreeRecursive(trees[i]);
+    }
+  }
+  YGSetExperimentalFeatureEnabled(YGExperimentalFeatureRounding, false);
+}
+
+int main(void) {
+  testRandomTrees(false);
+  testRandomTrees(true);
+  return 0;
+}
@@ -0,0 +1,73 @@
+/** Copyright (c) 2014-present, Facebook, Inc. */
+
+// Built once per numeric policy, see YGMacros.h.
+
+#include "YGTestUtils.h"
+
+// Rows of a tenth of a point far down a long column, where float loses the fractions.
+static void testLargeOffsets(void) {
+  const YGNodeRef root = YGNodeNew();
+  YGNodeStyleSetWidth(root, 100);
+  const YGNodeRef spacer = YGNodeNew();
+  YGNodeStyleSetHeight(spacer, 1000000);
+  YGNodeInsertChild(root, spacer, 0);
+  for (uint32_t i = 1; i <= 1000; i++) {
+    const YGNodeRef row = YGNodeNew();
+    YGNodeStyleSetHeight(row, 0.1f);
+    YGNodeInsertChild(root, row, i);
+  }
+  YGNodeCalculateLayout(root, YGUndefined, YGUndefined, YGDirectionLTR);
+
+  const float top = YGNodeLayoutGetTop(YGNodeGetChild(root, 1000));
+#if YG_DOUBLE_PRECISION
+  YG_TEST_CHECK(fabsf(top - 1000099.9f) < 0.1f);
+#else
+  YG_TEST_CHECK(fabsf(top - 1000099.9f) < 50);
+#endif
+  YGNodeFreeRecursive(root);
+}
+
+// Thirds of an odd width keep their fractions.
+static void testFractionalSplit(void) {
+  const YGNodeRef root = YGNodeNew();
+  YGNodeStyleSetFlexDirection(root, YGFlexDirectionRow);
+  YGNodeStyleSetPadding(root, YGEdgeLeft, 0.3f);
+  for (uint32_t i = 0; i < 3; i++) {
+    const YGNodeRef child = YGNodeNew();
+    YGNodeStyleSetFlexGrow(child, 1);
+    YGNodeInsertChild(root, child, i);
+  }
+  YGNodeCalculateLayout(root, 301, 50, YGDirectionLTR);
+
+  for (uint32_t i = 0; i < 3; i++) {
+    const YGNodeRef child = YGNodeGetChild(root, i);
+    YG_TEST_CHECK(fabsf(YGNodeLayoutGetWidth(child) - 300.7f / 3) < 0.001f);
+    YG_TEST_CHECK(fabsf(YGNodeLayoutGetLeft(child) - (0.3f + i * 300.7f / 3)) < 0.001f);
+  }
+  YGNodeFreeRecursive(root);
+}
+
+// Random trees lay out the same as a copy of themselves, also after a resize.
+static void testRandomTrees(void) {
+  for (int t = 0; t < 100; t++) {
+    YGNodeRef a, b;
+    YGTestBuildTreePair(4, &a, &b);
+    const float width = 100 + YGTestRandom() % 400;
+    YGNodeCalculateLayout(a, width, YGUndefined, YGDirectionLTR);
+    YGNodeCalculateLayout(b, width, YGUndefined, YGDirectionLTR);
+    YG_TEST_CHECK(YGTestSameLayout(a, b));
+
+    YGNodeCalculateLayout(a, width * 0.7f, YGUndefined, YGDirectionLTR);
+    YGNodeCalculateLayout(b, width * 0.7f, YGUndefined, YGDirectionLTR);
+    YG_TEST_CHECK(YGTestSameLayout(a, b));
+    YGNodeFreeRecursive(a);
+    YGNodeFreeRecursive(b);
+  }
+}
+
+int main(void) {
+  testLargeOffsets();
+  testFractionalSplit();
+  testRandomTrees();
+  return 0;
+}
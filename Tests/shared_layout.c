@@ -0,0 +1,220 @@
+/** Copyright (c) 2014-present, Facebook, Inc. */
+
+// Identical tiles with keyed leaves share their layouts and come out like a copy whose leaves have
+// no keys, which lays out every tile on its own. Tiles given other constraints, tiles with a
+// baseline function inside and tiles in virtualized containers are laid out on their own.
+
+#include "YGTestUtils.h"
+
+#define TILE_COUNT 12
+
+static void setKeys(const YGNodeRef node, const bool keyed) {
+  if (YGNodeGetChildCount(node) == 0) {
+    YGNodeSetMeasureKey(node, keyed ? (uintptr_t) YGNodeGetContext(node) : 0);
+  }
+  for (uint32_t i = 0; i < YGNodeGetChildCount(node); i++) {
+    setKeys(YGNodeGetChild(node, i), keyed);
+  }
+}
+
+// A wrapping row of tiles built from the same seed and contexts; with keys, the leaves at the
+// same place in two tiles share theirs.
+static YGNodeRef buildGrid(const unsigned seed, const bool keyed) {
+  const YGNodeRef root = YGNodeNew();
+  YGNodeStyleSetFlexDirection(root, YGFlexDirectionRow);
+  YGNodeStyleSetFlexWrap(root, YGWrapWrap);
+  for (uint32_t i = 0; i < TILE_COUNT; i++) {
+    gYGTestSeed = seed;
+    gYGTestContext = 0;
+    const YGNodeRef tile = YGTestBuildTree(3);
+    YGNodeStyleSetPositionType(tile, YGPositionTypeRelative);
+    YGNodeStyleSetDisplay(tile, YGDisplayFlex);
+    YGNodeStyleSetWidth(tile, 90);
+    setKeys(tile, keyed);
+    YGNodeInsertChild(root, tile, i);
+  }
+  return root;
+}
+
+// Gives the same leaf of a tile in both grids other content.
+static void changeLeaf(const YGNodeRef shared, const YGNodeRef plain, const uint32_t tile) {
+  YGNodeRef node = YGNodeGetChild(shared, tile);
+  YGNodeRef copy = YGNodeGetChild(plain, tile);
+  while (YGNodeGetChildCount(node) > 0) {
+    const uint32_t index = YGTestRandom() % YGNodeGetChildCount(node);
+    node = YGNodeGetChild(node, index);
+    copy = YGNodeGetChild(copy, index);
+  }
+  const long context = (long) YGNodeGetContext(node) + 100;
+  YGNodeSetContext(node, (void *) context);
+  YGNodeSetContext(copy, (void *) context);
+  YGNodeSetMeasureKey(node, (uintptr_t) context);
+  YGNodeMarkDirty(copy);
+}
+
+static void testSharedMatchesUnshared(const bool rounding) {
+  YGSetExperimentalFeatureEnabled(YGExperimentalFeatureRounding, rounding);
+  int sharedCalls = 0;
+  int plainCalls = 0;
+  for (int t = 0; t < 100; t++) {
+    const unsigned seed = gYGTestSeed;
+    const YGNodeRef shared = buildGrid(seed, true);
+    const YGNodeRef plain = buildGrid(seed, false);
+    gYGTestSeed = seed + 1;
+
+    for (int step = 0; step < 5; step++) {
+      const float width = 200 + YGTestRandom() % 400;
+      const float height = step % 2 == 0 ? YGUndefined : 300 + YGTestRandom() % 300;
+      // A tile that no longer matches the others is laid out on its own.
+      if (step == 2) {
+        changeLeaf(shared, plain, YGTestRandom() % TILE_COUNT);
+      }
+      gYGTestMeasureCalls = 0;
+      YGNodeCalculateLayout(shared, width, height, YGDirectionLTR);
+      sharedCalls += gYGTestMeasureCalls;
+      gYGTestMeasureCalls = 0;
+      YGNodeCalculateLayout(plain, width, height, YGDirectionLTR);
+      plainCalls += gYGTestMeasureCalls;
+      if (!YGTestSameLayout(shared, plain)) {
+        fprintf(stderr, "grid %d step %d\n", t, step);
+        exit(1);
+      }
+    }
+    YGNodeFreeRecursive(shared);
+    YGNodeFreeRecursive(plain);
+  }
+  YG_TEST_CHECK(sharedCalls * 3 < plainCalls);
+  YGSetExperimentalFeatureEnabled(YGExperimentalFeatureRounding, false);
+}
+
+static YGNodeRef buildTextTile(const bool keyed) {
+  const YGNodeRef tile = YGNodeNew();
+  YGNodeStyleSetPadding(tile, YGEdgeAll, 3);
+  for (uint32_t i = 0; i < 3; i++) {
+    const YGNodeRef text = YGNodeNew();
+    YGNodeSetContext(text, (void *) (long) (i + 5));
+    YGNodeSetMeasureFunc(text, YGTestMeasure);
+    YGNodeSetMeasureKey(text, keyed ? i + 5 : 0);
+    YGNodeInsertChild(tile, text, i);
+  }
+  return tile;
+}
+
+// Lines of a wrapping row stretched to different heights give the same tiles different
+// constraints.
+static void testDifferentConstraints(void) {
+  YGNodeRef roots[2];
+  for (uint32_t k = 0; k < 2; k++) {
+    roots[k] = YGNodeNew();
+    YGNodeStyleSetFlexDirection(roots[k], YGFlexDirectionRow);
+    YGNodeStyleSetFlexWrap(roots[k], YGWrapWrap);
+    YGNodeStyleSetWidth(roots[k], 200);
+    for (uint32_t i = 0; i < 4; i++) {
+      const YGNodeRef tile = buildTextTile(k == 0);
+      YGNodeStyleSetWidth(tile, 100);
+      YGNodeInsertChild(roots[k], tile, 2 * i);
+      const YGNodeRef spacer = YGNodeNew();
+      YGNodeStyleSetWidth(spacer, 100);
+      YGNodeStyleSetHeight(spacer, 100 + 40 * i);
+      YGNodeInsertChild(roots[k], spacer, 2 * i + 1);
+    }
+    YGNodeCalculateLayout(roots[k], YGUndefined, YGUndefined, YGDirectionLTR);
+  }
+  YG_TEST_CHECK(YGTestSameLayout(roots[0], roots[1]));
+  for (uint32_t i = 0; i < 4; i++) {
+    YG_TEST_CHECK(YGNodeLayoutGetHeight(YGNodeGetChild(roots[0], 2 * i)) == 100 + 40 * i);
+  }
+  for (uint32_t k = 0; k < 2; k++) {
+    YGNodeFreeRecursive(roots[k]);
+  }
+}
+
+static float baselineOfContext(YGNodeRef node, const float width, const float height) {
+  (void) width;
+  (void) height;
+  return (float) (long) YGNodeGetContext(node);
+}
+
+// The baseline function of a node inside a tile can answer differently in each tile.
+static void testBaselineFunctions(void) {
+  YGNodeRef roots[2];
+  for (uint32_t k = 0; k < 2; k++) {
+    roots[k] = YGNodeNew();
+    for (uint32_t i = 0; i < 4; i++) {
+      const YGNodeRef tile = buildTextTile(k == 0);
+      YGNodeStyleSetFlexDirection(tile, YGFlexDirectionRow);
+      YGNodeStyleSetAlignItems(tile, YGAlignBaseline);
+      const YGNodeRef icon = YGNodeNew();
+      YGNodeStyleSetWidth(icon, 20);
+      YGNodeStyleSetHeight(icon, 40);
+      YGNodeSetContext(icon, (void *) (long) (20 + 10 * i));
+      YGNodeSetBaselineFunc(icon, baselineOfContext);
+      YGNodeInsertChild(tile, icon, 0);
+      YGNodeInsertChild(roots[k], tile, i);
+    }
+    YGNodeCalculateLayout(roots[k], 300, YGUndefined, YGDirectionLTR);
+  }
+  YG_TEST_CHECK(YGTestSameLayout(roots[0], roots[1]));
+  const YGNodeRef first = YGNodeGetChild(YGNodeGetChild(roots[0], 0), 1);
+  const YGNodeRef last = YGNodeGetChild(YGNodeGetChild(roots[0], 3), 1);
+  YG_TEST_CHECK(YGNodeLayoutGetTop(last) - YGNodeLayoutGetTop(first) == 30);
+  for (uint32_t k = 0; k < 2; k++) {
+    YGNodeFreeRecursive(roots[k]);
+  }
+}
+
+// Children of a virtualized container measure as often with keys as without, also when it is laid
+// out in full for its reverse main axis.
+static void testVirtualizedParent(const YGFlexDirection direction) {
+  YGNodeRef roots[2];
+  int calls[2];
+  for (uint32_t k = 0; k < 2; k++) {
+    roots[k] = YGNodeNew();
+    YGNodeStyleSetWidth(roots[k], 300);
+    YGNodeStyleSetHeight(roots[k], 500);
+    YGNodeStyleSetFlexDirection(roots[k], direction);
+    YGNodeSetVirtualized(roots[k], 0, 500);
+    for (uint32_t i = 0; i < 40; i++) {
+      YGNodeInsertChild(roots[k], buildTextTile(k == 0), i);
+    }
+    gYGTestMeasureCalls = 0;
+    YGNodeCalculateLayout(roots[k], YGUndefined, YGUndefined, YGDirectionLTR);
+    calls[k] = gYGTestMeasureCalls;
+  }
+  YG_TEST_CHECK(calls[0] == calls[1] && calls[0] > 0);
+  YG_TEST_CHECK(YGTestSameLayout(roots[0], roots[1]));
+  for (uint32_t k = 0; k < 2; k++) {
+    YGNodeFreeRecursive(roots[k]);
+  }
+}
+
+// A new key marks a measured leaf and its ancestors dirty; the same key, or a key on a node
+// that is not measured, does not.
+static void testKeyChangeMarksDirty(void) {
+  const YGNodeRef root = YGNodeNew();
+  const YGNodeRef tile = buildTextTile(true);
+  YGNodeInsertChild(root, tile, 0);
+  YGNodeCalculateLayout(root, 300, YGUndefined, YGDirectionLTR);
+  const YGNodeRef text = YGNodeGetChild(tile, 1);
+
+  YGNodeSetMeasureKey(text, 6);
+  YGNodeSetMeasureKey(tile, 42);
+  YG_TEST_CHECK(!YGNodeIsDirty(root));
+  YGNodeSetMeasureKey(text, 7);
+  YG_TEST_CHECK(YGNodeGetMeasureKey(text) == 7);
+  YG_TEST_CHECK(YGNodeIsDirty(text) && YGNodeIsDirty(tile) && YGNodeIsDirty(root));
+  YG_TEST_CHECK(!YGNodeIsDirty(YGNodeGetChild(tile, 0)));
+  YGNodeFreeRecursive(root);
+}
+
+int main(void) {
+  testSharedMatchesUnshared(false);
+  testSharedMatchesUnshared(true);
+  testDifferentConstraints();
+  testBaselineFunctions();
+  testVirtualizedParent(YGFlexDirectionColumn);
+  testVirtualizedParent(YGFlexDirectionColumnReverse);
+  testKeyChangeMarksDirty();
+  YG_TEST_CHECK(YGNodeGetInstanceCount() == 0);
+  return 0;
+}
@@ -0,0 +1,129 @@
+/** Copyright (c) 2014-present, Facebook, Inc. */
+
+// A streaming container growing at the tail and retiring children at the head lays out its
+// children like plain YGNodeCalculateLayout lays out a copy that keeps every child.
+
+#include "YGTestUtils.h"
+
+#define MAX_RETIRED 400
+
+// The same item for the same index, of one of the kinds a feed holds.
+static YGNodeRef makeItem(const uint32_t index) {
+  const YGNodeRef item = YGNodeNew();
+  YGNodeSetContext(item, (void *) (long) index);
+  const unsigned r = (index * 2654435761u) >> 7;
+  switch (r % 4) {
+    case 0:
+      YGNodeStyleSetHeight(item, 20 + r % 37);
+      break;
+    case 1:
+      YGNodeSetMeasureFunc(item, YGTestMeasure);
+      break;
+    case 2: {
+      YGNodeStyleSetPadding(item, YGEdgeAll, 3);
+      const YGNodeRef text = YGNodeNew();
+      YGNodeSetContext(text, (void *) (long) (index + 7));
+      YGNodeSetMeasureFunc(text, YGTestMeasure);
+      YGNodeInsertChild(item, text, 0);
+      break;
+    }
+    default:
+      YGNodeStyleSetHeight(item, 15);
+      YGNodeStyleSetWidth(item, 40 + r % 50);
+      break;
+  }
+  if (r % 5 == 0) {
+    YGNodeStyleSetMargin(item, YGEdgeVertical, 1 + r % 6);
+  }
+  if (r % 7 == 0) {
+    YGNodeStyleSetAlignSelf(item, (YGAlign)(YGAlignFlexStart + r % 3));
+  }
+  if (r % 31 == 0) {
+    YGNodeStyleSetDisplay(item, YGDisplayNone);
+  }
+  if (r % 37 == 0) {
+    YGNodeStyleSetPositionType(item, YGPositionTypeAbsolute);
+    YGNodeStyleSetPosition(item, YGEdgeTop, 5);
+  }
+  return item;
+}
+
+static YGNodeRef makeFeed(const bool fixedHeight) {
+  const YGNodeRef feed = YGNodeNew();
+  YGNodeStyleSetWidth(feed, 300);
+  YGNodeStyleSetPadding(feed, YGEdgeAll, 4);
+  YGNodeStyleSetAlignItems(feed, fixedHeight ? YGAlignCenter : YGAlignFlexStart);
+  if (fixedHeight) {
+    YGNodeStyleSetHeight(feed, 500);
+  }
+  return feed;
+}
+
+static void testGrowingFeed(const bool fixedHeight, const bool rounding) {
+  YGSetExperimentalFeatureEnabled(YGExperimentalFeatureRounding, rounding);
+  const YGNodeRef streaming = makeFeed(fixedHeight);
+  const YGNodeRef plain = makeFeed(fixedHeight);
+  YGNodeSetStreaming(streaming, true);
+
+  uint32_t next = 1;
+  uint32_t retired = 0;
+  for (int t = 0; t < 400; t++) {
+    for (uint32_t count = 1 + YGTestRandom() % 20; count > 0; count--, next++) {
+      YGNodeInsertChild(streaming, makeItem(next), YGNodeGetChildCount(streaming));
+      YGNodeInsertChild(plain, makeItem(next), YGNodeGetChildCount(plain));
+    }
+    // A child changing, the feed resizing and layouts at other sizes in between.
+    if (t % 17 == 5) {
+      const uint32_t index = YGTestRandom() % YGNodeGetChildCount(streaming);
+      YGNodeStyleSetMargin(YGNodeGetChild(streaming, index), YGEdgeLeft, 3);
+      YGNodeStyleSetMargin(YGNodeGetChild(plain, retired + index), YGEdgeLeft, 3);
+    }
+    if (t % 53 == 20) {
+      const float width = 250 + YGTestRandom() % 100;
+      YGNodeStyleSetWidth(streaming, width);
+      YGNodeStyleSetWidth(plain, width);
+    }
+    if (t % 23 == 11) {
+      static YGFrameRecord frames[2][20000];
+      YGLayoutResultBuffer outs[2] = {{frames[0], 20000, 0}, {frames[1], 20000, 0}};
+      const YGSize sizes[2] = {{200, 400}, {YGUndefined, 300}};
+      YGNodeCalculateLayout(streaming, YGUndefined, YGUndefined, YGDirectionLTR);
+      YGNodeCalculateLayoutMulti(streaming, sizes, 2, YGDirectionLTR, outs);
+    }
+
+    YGNodeCalculateLayout(streaming, YGUndefined, YGUndefined, YGDirectionLTR);
+    YGNodeCalculateLayout(plain, YGUndefined, YGUndefined, YGDirectionLTR);
+    YG_TEST_CHECK(YGNodeLayoutGetWidth(streaming) == YGNodeLayoutGetWidth(plain));
+    YG_TEST_CHECK(YGNodeLayoutGetHeight(streaming) == YGNodeLayoutGetHeight(plain));
+    for (uint32_t i = 0; i < YGNodeGetChildCount(streaming); i++) {
+      YG_TEST_CHECK(
+          YGTestSameLayout(YGNodeGetChild(streaming, i), YGNodeGetChild(plain, retired + i)));
+    }
+
+    if (t % 9 == 8) {
+      const uint32_t count = YGTestRandom() % (YGNodeGetChildCount(streaming) + 1);
+      YGNodeRef detached[MAX_RETIRED];
+      YG_TEST_CHECK(count <= MAX_RETIRED);
+      for (uint32_t i = 0; i < count; i++) {
+        detached[i] = YGNodeGetChild(streaming, i);
+      }
+      YGNodeRetireChildren(streaming, count);
+      retired += count;
+      for (uint32_t i = 0; i < count; i++) {
+        YG_TEST_CHECK(YGNodeGetParent(detached[i]) == NULL);
+        YGNodeFreeRecursive(detached[i]);
+      }
+    }
+  }
+  YGNodeFreeRecursive(streaming);
+  YGNodeFreeRecursive(plain);
+  YGSetExperimentalFeatureEnabled(YGExperimentalFeatureRounding, false);
+}
+
+int main(void) {
+  testGrowingFeed(true, false);
+  testGrowingFeed(false, false);
+  testGrowingFeed(true, true);
+  testGrowingFeed(false, true);
+  return 0;
+}
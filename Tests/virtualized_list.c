@@ -0,0 +1,147 @@
+/** Copyright (c) 2014-present, Facebook, Inc. */
+
+// A virtualized container laid out for the first time far from its start only visits the
+// children around the viewport, and recycled virtual children are laid out for their new data.
+
+#include "YGTestUtils.h"
+
+#define CHILD_COUNT 10000
+#define VIEWPORT_START 50000
+#define VIEWPORT_LENGTH 800
+
+static int gChildCalls = 0;
+static int gLiveChildren = 0;
+
+static YGNodeRef makeRow(const uint32_t index) {
+  const YGNodeRef child = YGNodeNew();
+  YGNodeSetContext(child, (void *) (long) (index + 1));
+  YGNodeSetMeasureFunc(child, YGTestMeasure);
+  return child;
+}
+
+static uint32_t childCount(YGNodeRef node) {
+  (void) node;
+  return CHILD_COUNT;
+}
+
+static YGNodeRef childAt(YGNodeRef node, const uint32_t index) {
+  (void) node;
+  gChildCalls++;
+  gLiveChildren++;
+  return makeRow(index);
+}
+
+static void recycle(YGNodeRef node, YGNodeRef child) {
+  (void) node;
+  gLiveChildren--;
+  YGNodeFree(child);
+}
+
+// The children laid out cover the viewport and stand right after one another.
+static void checkWindow(const YGNodeRef root, const uint32_t first, const uint32_t end) {
+  YG_TEST_CHECK(first < end);
+  YG_TEST_CHECK(YGNodeLayoutGetTop(YGNodeGetChild(root, first)) <= VIEWPORT_START);
+  const YGNodeRef last = YGNodeGetChild(root, end - 1);
+  YG_TEST_CHECK(YGNodeLayoutGetTop(last) + YGNodeLayoutGetHeight(last) >=
+                VIEWPORT_START + VIEWPORT_LENGTH);
+  for (uint32_t i = first + 1; i < end; i++) {
+    const YGNodeRef previous = YGNodeGetChild(root, i - 1);
+    YG_TEST_CHECK(fabsf(YGNodeLayoutGetTop(previous) + YGNodeLayoutGetHeight(previous) -
+                        YGNodeLayoutGetTop(YGNodeGetChild(root, i))) < 0.001f);
+  }
+}
+
+static void testInsertedChildren(void) {
+  const YGNodeRef root = YGNodeNew();
+  YGNodeStyleSetWidth(root, 300);
+  YGNodeStyleSetHeight(root, VIEWPORT_LENGTH);
+  // The first child does not count for the estimate.
+  const YGNodeRef hidden = YGNodeNew();
+  YGNodeStyleSetDisplay(hidden, YGDisplayNone);
+  YGNodeInsertChild(root, hidden, 0);
+  for (uint32_t i = 1; i < CHILD_COUNT; i++) {
+    YGNodeInsertChild(root, makeRow(i), i);
+  }
+  YGNodeSetVirtualized(root, VIEWPORT_START, VIEWPORT_LENGTH);
+
+  gYGTestMeasureCalls = 0;
+  YGNodeCalculateLayout(root, YGUndefined, YGUndefined, YGDirectionLTR);
+  YG_TEST_CHECK(gYGTestMeasureCalls < 1000);
+
+  // Children outside of the window were never laid out.
+  uint32_t first = 0;
+  while (first < CHILD_COUNT && isnan(YGNodeLayoutGetHeight(YGNodeGetChild(root, first)))) {
+    first++;
+  }
+  uint32_t end = first;
+  while (end < CHILD_COUNT && !isnan(YGNodeLayoutGetHeight(YGNodeGetChild(root, end)))) {
+    end++;
+  }
+  YG_TEST_CHECK(first > 1 && end < CHILD_COUNT);
+  checkWindow(root, first, end);
+  YGNodeFreeRecursive(root);
+}
+
+static void testVirtualChildren(void) {
+  const YGNodeRef root = YGNodeNew();
+  YGNodeStyleSetWidth(root, 300);
+  YGNodeStyleSetHeight(root, VIEWPORT_LENGTH);
+  YGNodeSetVirtualized(root, VIEWPORT_START, VIEWPORT_LENGTH);
+  YGNodeSetVirtualChildren(root, childCount, childAt, recycle);
+
+  YGNodeCalculateLayout(root, YGUndefined, YGUndefined, YGDirectionLTR);
+  YG_TEST_CHECK(gChildCalls < 200);
+  YG_TEST_CHECK(gLiveChildren == (int) YGNodeGetChildCount(root));
+  checkWindow(root, 0, YGNodeGetChildCount(root));
+
+  YGNodeSetVirtualChildren(root, NULL, NULL, NULL);
+  YG_TEST_CHECK(gLiveChildren == 0);
+  YGNodeFree(root);
+}
+
+static YGNodeRef gPool[CHILD_COUNT];
+static uint32_t gPoolCount = 0;
+
+// Hands out pooled rows for other data without marking them dirty.
+static YGNodeRef pooledChildAt(YGNodeRef node, const uint32_t index) {
+  (void) node;
+  const YGNodeRef child = gPoolCount > 0 ? gPool[--gPoolCount] : makeRow(index);
+  YGNodeSetContext(child, (void *) (long) (index + 1));
+  return child;
+}
+
+static void pool(YGNodeRef node, YGNodeRef child) {
+  (void) node;
+  gPool[gPoolCount++] = child;
+}
+
+static void testRecycledChildren(void) {
+  const YGNodeRef root = YGNodeNew();
+  YGNodeStyleSetWidth(root, 300);
+  YGNodeStyleSetHeight(root, VIEWPORT_LENGTH);
+  YGNodeSetVirtualized(root, 0, VIEWPORT_LENGTH);
+  YGNodeSetVirtualChildren(root, childCount, pooledChildAt, pool);
+
+  for (float offset = 0; offset < 20000; offset += 370) {
+    YGNodeSetVirtualized(root, offset, VIEWPORT_LENGTH);
+    YGNodeCalculateLayout(root, YGUndefined, YGUndefined, YGDirectionLTR);
+    for (uint32_t i = 0; i < YGNodeGetChildCount(root); i++) {
+      const YGNodeRef child = YGNodeGetChild(root, i);
+      const int context = (int) (long) YGNodeGetContext(child);
+      YG_TEST_CHECK(YGNodeLayoutGetHeight(child) == 8 + (context % 5) * 3);
+    }
+  }
+
+  YGNodeSetVirtualChildren(root, NULL, NULL, NULL);
+  for (uint32_t i = 0; i < gPoolCount; i++) {
+    YGNodeFree(gPool[i]);
+  }
+  YGNodeFree(root);
+}
+
+int main(void) {
+  testInsertedChildren();
+  testVirtualChildren();
+  testRecycledChildren();
+  return 0;
+}
@@ -0,0 +1,112 @@
+/** Copyright (c) 2014-present, Facebook, Inc. */
+
+// A tree warmed up for the sizes it may get keeps its layout, then lays out at one of them like
+// plain YGNodeCalculateLayout lays out a copy never warmed, with fewer measurements.
+
+#include "YGTestUtils.h"
+
+#define CAPACITY 20000
+#define SIZE_COUNT 3
+
+static float gBefore[CAPACITY];
+static float gAfter[CAPACITY];
+
+// The node at the same place in another copy of the tree.
+static YGNodeRef sameNodeIn(const YGNodeRef root, const YGNodeRef node, const YGNodeRef copy) {
+  if (node == root) {
+    return copy;
+  }
+  const YGNodeRef parent = YGNodeGetParent(node);
+  uint32_t index = 0;
+  while (YGNodeGetChild(parent, index) != node) {
+    index++;
+  }
+  return YGNodeGetChild(sameNodeIn(root, parent, copy), index);
+}
+
+static YGNodeRef anyNode(YGNodeRef node) {
+  while (YGNodeGetChildCount(node) > 0 && YGTestRandom() % 3 != 0) {
+    node = YGNodeGetChild(node, YGTestRandom() % YGNodeGetChildCount(node));
+  }
+  return node;
+}
+
+// Layouts served from caches the warmup filled can differ from fresh ones in the last bits of a
+// float, and a point once rounded.
+static void testRandomTrees(const bool rounding) {
+  YGSetExperimentalFeatureEnabled(YGExperimentalFeatureRounding, rounding);
+  const float tolerance = rounding ? 1 : 0.001f;
+  int warmCalls = 0;
+  int coldCalls = 0;
+  for (int t = 0; t < 300; t++) {
+    // The tree to warm up, a copy laid out cold, and one that gets the same change later.
+    YGNodeRef trees[3];
+    YGTestBuildTrees(4, trees, 3);
+    const YGNodeRef warmed = trees[0], cold = trees[1], changed = trees[2];
+    const YGDirection direction = t % 5 == 0 ? YGDirectionRTL : YGDirectionLTR;
+    for (uint32_t i = 0; i < 3; i++) {
+      YGNodeStyleSetDirection(trees[i], direction);
+    }
+    const YGSize sizes[SIZE_COUNT] = {
+        {320, 480}, {480, 320}, {200 + YGTestRandom() % 300, t % 4 < 2 ? YGUndefined : 300},
+    };
+
+    if (t % 2 == 0) {
+      // A laid out tree keeps its frames and stays clean.
+      YGNodeCalculateLayout(warmed, 300, 400, direction);
+      uint32_t count = 0;
+      YGTestCollectLayout(warmed, gBefore, &count);
+      YG_TEST_CHECK(YGNodeWarmup(warmed, sizes, SIZE_COUNT, 1000000) == SIZE_COUNT);
+      uint32_t countAfter = 0;
+      YGTestCollectLayout(warmed, gAfter, &countAfter);
+      YG_TEST_CHECK(countAfter == count && memcmp(gBefore, gAfter, sizeof(float) * count) == 0);
+      YG_TEST_CHECK(!YGNodeIsDirty(warmed));
+    } else {
+      // A tree never laid out stays dirty.
+      YG_TEST_CHECK(YGNodeWarmup(warmed, sizes, SIZE_COUNT, 1000000) == SIZE_COUNT);
+      YG_TEST_CHECK(YGNodeIsDirty(warmed));
+    }
+
+    const YGSize size = sizes[YGTestRandom() % SIZE_COUNT];
+    gYGTestMeasureCalls = 0;
+    YGNodeCalculateLayout(warmed, size.width, size.height, direction);
+    warmCalls += gYGTestMeasureCalls;
+    gYGTestMeasureCalls = 0;
+    YGNodeCalculateLayout(cold, size.width, size.height, direction);
+    coldCalls += gYGTestMeasureCalls;
+    YG_TEST_CHECK(YGTestSameLayoutWithin(warmed, cold, tolerance));
+
+    // A change after the warmup is laid out, and the next warmup keeps it.
+    const YGNodeRef node = anyNode(warmed);
+    YGNodeStyleSetMargin(node, YGEdgeTop, 5);
+    YGNodeStyleSetMargin(sameNodeIn(warmed, node, changed), YGEdgeTop, 5);
+    YG_TEST_CHECK(YGNodeWarmup(warmed, sizes + 1, SIZE_COUNT - 1, 1000000) == SIZE_COUNT - 1);
+    YGNodeCalculateLayout(warmed, sizes[2].width, sizes[2].height, direction);
+    YGNodeCalculateLayout(changed, sizes[2].width, sizes[2].height, direction);
+    YG_TEST_CHECK(YGTestSameLayoutWithin(warmed, changed, tolerance));
+    for (uint32_t i = 0; i < 3; i++) {
+      YGNodeFreeRecursive(trees[i]);
+    }
+  }
+  YG_TEST_CHECK(warmCalls < coldCalls);
+  YGSetExperimentalFeatureEnabled(YGExperimentalFeatureRounding, false);
+}
+
+// A warmup out of budget still warms the first size.
+static void testBudget(void) {
+  YGNodeRef root = YGTestBuildTree(4);
+  const YGSize sizes[2] = {{320, 480}, {480, 320}};
+  YG_TEST_CHECK(YGNodeWarmup(root, sizes, 2, 0) == 1);
+  gYGTestMeasureCalls = 0;
+  YGNodeCalculateLayout(root, 320, 480, YGDirectionLTR);
+  const int warmCalls = gYGTestMeasureCalls;
+  YGNodeFreeRecursive(root);
+  YG_TEST_CHECK(warmCalls == 0);
+}
+
+int main(void) {
+  testRandomTrees(false);
+  testRandomTrees(true);
+  testBudget();
+  return 0;
+}